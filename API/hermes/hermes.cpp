@@ -20,11 +20,13 @@
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/DebuggerAPI.h"
 #include "hermes/Platform/Logging.h"
 #include "hermes/Public/RuntimeConfig.h"
 #include "hermes/Support/Algorithms.h"
-#include "hermes/Support/UTF16Stream.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/SHA1.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/Debugger/Debugger.h"
@@ -49,15 +51,17 @@
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_os_ostream.h"
 
 #include <algorithm>
 #include <atomic>
 #include <limits>
-#include <list>
 #include <mutex>
 #include <system_error>
+#include <type_traits>
+#include <vector>
 
 #ifdef HERMESJSI_ON_STACK
 #include <future>
@@ -273,7 +277,8 @@ class HermesRuntimeImpl final : public HermesRuntime,
                 .build())),
         runtime_(*rt_),
 #endif
-        crashMgr_(runtimeConfig.getCrashMgr()) {
+        crashMgr_(runtimeConfig.getCrashMgr()),
+        bytecodeCacheDir_(runtimeConfig.getBytecodeCacheDir()) {
     compileFlags_.optimize = false;
 #ifdef HERMES_ENABLE_DEBUGGER
     compileFlags_.debug = true;
@@ -285,27 +290,16 @@ class HermesRuntimeImpl final : public HermesRuntime,
 #endif
     runtime_.addCustomRootsFunction(
         [this](vm::GC *, vm::SlotAcceptor &acceptor) {
-          for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-            if (it->get() == 0) {
-              it = hermesValues_->erase(it);
-            } else {
-              acceptor.accept(const_cast<vm::PinnedHermesValue &>(it->phv));
-              ++it;
-            }
-          }
+          hermesValues_.forEach([&acceptor](HermesPointerValue &value) {
+            acceptor.accept(const_cast<vm::PinnedHermesValue &>(value.phv));
+          });
         });
     runtime_.addCustomWeakRootsFunction(
         [this](vm::GC *, vm::WeakRefAcceptor &acceptor) {
-          for (auto it = weakHermesValues_->begin();
-               it != weakHermesValues_->end();) {
-            if (it->get() == 0) {
-              it = weakHermesValues_->erase(it);
-            } else {
-              acceptor.accept(
-                  const_cast<vm::WeakRef<vm::HermesValue> &>(it->wr));
-              ++it;
-            }
-          }
+          weakHermesValues_.forEach([&acceptor](WeakRefPointerValue &value) {
+            acceptor.accept(
+                const_cast<vm::WeakRef<vm::HermesValue> &>(value.wr));
+          });
         });
   }
 
@@ -329,6 +323,13 @@ class HermesRuntimeImpl final : public HermesRuntime,
   }
 #endif
 
+  /// The part of a chunk of ManagedValues that its values access.
+  struct ManagedChunkHeader {
+    /// Set when a value in the chunk is released, and cleared when the chunk
+    /// is swept.
+    std::atomic<bool> hasReleased{false};
+  };
+
   struct CountedPointerValue : PointerValue {
     CountedPointerValue() : refCount(1) {}
 
@@ -350,7 +351,12 @@ class HermesRuntimeImpl final : public HermesRuntime,
     void dec() {
       auto oldCount = refCount.fetch_sub(1, std::memory_order_relaxed);
       assert(oldCount > 0 && "Ref count underflow");
-      (void)oldCount;
+      if (oldCount == 1) {
+        // Let the next sweep of the ManagedValues know where to look.
+        reinterpret_cast<ManagedChunkHeader *>(
+            reinterpret_cast<char *>(this) - chunkOffset)
+            ->hasReleased.store(true, std::memory_order_relaxed);
+      }
     }
 
     uint32_t get() const {
@@ -368,6 +374,10 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
 #endif
 
+    /// The offset of this value from the header of its chunk in
+    /// ManagedValues, which is set when the value is added.
+    uint32_t chunkOffset{0};
+
    private:
     std::atomic<uint32_t> refCount;
   };
@@ -403,13 +413,11 @@ class HermesRuntimeImpl final : public HermesRuntime,
   T add(::hermes::vm::HermesValue hv) {
     static_assert(
         std::is_base_of<jsi::Pointer, T>::value, "this type cannot be added");
-    hermesValues_->emplace_front(hv);
-    return make<T>(&(hermesValues_->front()));
+    return make<T>(hermesValues_.add(hv));
   }
 
   jsi::WeakObject addWeak(::hermes::vm::WeakRef<vm::HermesValue> wr) {
-    weakHermesValues_->emplace_front(wr);
-    return make<jsi::WeakObject>(&(weakHermesValues_->front()));
+    return make<jsi::WeakObject>(weakHermesValues_.add(wr));
   }
 
   // overriden from jsi::Instrumentation
@@ -655,6 +663,21 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
   }
 
+  /// Load the bytecode stored under \p key at \p path in the bytecode cache.
+  /// \return the bytecode, or null if it isn't cached or is invalid.
+  std::unique_ptr<hbc::BCProvider> loadCachedBytecode(
+      const std::string &path,
+      const ::hermes::SHA1 &key);
+
+#ifndef HERMESVM_LEAN
+  /// Store the bytecode module \p BM under \p key at \p path in the bytecode
+  /// cache. Failures are ignored, the source is then compiled again next time.
+  void storeCachedBytecode(
+      const std::string &path,
+      const ::hermes::SHA1 &key,
+      hbc::BytecodeModule &BM);
+#endif
+
   // Concrete declarations of jsi::Runtime pure virtual methods
 
   std::shared_ptr<const jsi::PreparedJavaScript> prepareJavaScript(
@@ -940,43 +963,177 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
   };
 
+  /// The values handed out to JSI, which are roots for the GC. The values are
+  /// allocated in chunks, whose free slots form an intrusive free list. A
+  /// value that is released (its ref count drops to zero) flags its chunk,
+  /// and is only reclaimed by the next sweep, which skips unflagged chunks.
+  /// Sweeps happen when the free slots run out and when a scope is popped.
   template <typename T>
-  struct ManagedValues {
-#ifdef ASSERT_ON_DANGLING_VM_REFS
-    // If we have active HermesValuePointers when deconstructing, these will
-    // now be dangling. We deliberately allocate and immediately leak heap
-    // memory to hold the internal list. This keeps alive memory holding the
-    // ref-count of the now dangling references, allowing them to detect the
-    // dangling case safely and assert when they are eventually released. By
-    // deferring the assert it's a bit easier to see what's holding the pointers
-    // for too long.
+  class ManagedValues {
+   public:
+    ManagedValues() = default;
+    ManagedValues(const ManagedValues &) = delete;
+    void operator=(const ManagedValues &) = delete;
+
     ~ManagedValues() {
+#ifdef ASSERT_ON_DANGLING_VM_REFS
+      // If we have active HermesValuePointers when deconstructing, these will
+      // now be dangling. We deliberately leak the chunks holding them. This
+      // keeps alive memory holding the ref-count of the now dangling
+      // references, allowing them to detect the dangling case safely and
+      // assert when they are eventually released. By deferring the assert
+      // it's a bit easier to see what's holding the pointers for too long.
       bool anyDangling = false;
-      for (auto it = values.begin(); it != values.end();) {
-        if (it->get() == 0) {
-          it = values.erase(it);
-        } else {
-          anyDangling = true;
-          it->markDangling();
-          ++it;
-        }
+      for (Chunk *chunk : chunks_) {
+        forEachUsed(chunk, [&anyDangling](T *value, uint32_t) {
+          if (value->get() != 0) {
+            anyDangling = true;
+            value->markDangling();
+          }
+        });
       }
       if (anyDangling) {
         // This is the deliberate memory leak described above.
-        new std::list<T>(std::move(values));
+        return;
       }
-    }
 #endif
+      for (Chunk *chunk : chunks_) {
+        forEachUsed(chunk, [](T *value, uint32_t) { value->~T(); });
+        delete chunk;
+      }
+    }
+
+    /// Add a value constructed from \p args, with a ref count of one.
+    template <typename... Args>
+    T *add(Args &&... args) {
+      if (LLVM_UNLIKELY(!current_ || !current_->freeList))
+        findFreeChunk();
+      Chunk *chunk = current_;
+      Slot *slot = chunk->freeList;
+      chunk->freeList = slot->nextFree;
+      uint32_t index = slot - chunk->slots;
+      chunk->used[index / 64] |= (uint64_t)1 << (index % 64);
+      ++chunk->numUsed;
+      ++numValues_;
+
+      T *value = new (&slot->storage) T(std::forward<Args>(args)...);
+      CountedPointerValue *counted = value;
+      counted->chunkOffset = reinterpret_cast<char *>(counted) -
+          reinterpret_cast<char *>(static_cast<ManagedChunkHeader *>(chunk));
+      return value;
+    }
+
+    /// Call \p f on every value that hasn't been released.
+    template <typename F>
+    void forEach(const F &f) {
+      for (Chunk *chunk : chunks_) {
+        forEachUsed(chunk, [&f](T *value, uint32_t) {
+          if (value->get() != 0)
+            f(*value);
+        });
+      }
+    }
+
+    /// Reclaim the slots of the released values. Only the chunks in which
+    /// values were released are visited. Chunks that become empty are freed,
+    /// except for one which is kept for new values.
+    void sweep() {
+      bool keptEmpty = false;
+      for (Chunk *&chunk : chunks_) {
+        if (!chunk->hasReleased.load(std::memory_order_relaxed)) {
+          keptEmpty |= chunk->numUsed == 0;
+          continue;
+        }
+        chunk->hasReleased.store(false, std::memory_order_relaxed);
+        forEachUsed(chunk, [this, chunk](T *value, uint32_t index) {
+          if (value->get() != 0)
+            return;
+          value->~T();
+          Slot *slot = &chunk->slots[index];
+          slot->nextFree = chunk->freeList;
+          chunk->freeList = slot;
+          chunk->used[index / 64] &= ~((uint64_t)1 << (index % 64));
+          --chunk->numUsed;
+          --numValues_;
+        });
+        if (chunk->numUsed == 0) {
+          if (keptEmpty) {
+            if (current_ == chunk)
+              current_ = nullptr;
+            delete chunk;
+            chunk = nullptr;
+          }
+          keptEmpty = true;
+        }
+      }
+      chunks_.erase(
+          std::remove(chunks_.begin(), chunks_.end(), nullptr), chunks_.end());
+    }
+
+    /// \return the number of values that haven't been reclaimed yet.
+    size_t size() const {
+      return numValues_;
+    }
+
+   private:
+    /// The number of values in a chunk.
+    static constexpr uint32_t kChunkValues = 512;
+
+    union Slot {
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+      Slot *nextFree;
+    };
+
+    struct Chunk : ManagedChunkHeader {
+      Chunk() {
+        for (uint32_t i = 0; i < kChunkValues; ++i)
+          slots[i].nextFree = i + 1 < kChunkValues ? &slots[i + 1] : nullptr;
+      }
+
+      /// The first free slot.
+      Slot *freeList{slots};
+      /// The number of slots that hold values, released or not.
+      uint32_t numUsed{0};
+      /// Bit i is set if slot i holds a value.
+      uint64_t used[kChunkValues / 64]{};
+      Slot slots[kChunkValues];
+    };
 
-    std::list<T> *operator->() {
-      return &values;
+    /// Call \p f with every value in \p chunk, and its index.
+    template <typename F>
+    static void forEachUsed(Chunk *chunk, const F &f) {
+      for (uint32_t word = 0; word < kChunkValues / 64; ++word) {
+        // Copy the bits, as f may free the value.
+        for (uint64_t bits = chunk->used[word]; bits; bits &= bits - 1) {
+          uint32_t index = word * 64 + llvm::countTrailingZeros(bits);
+          f(reinterpret_cast<T *>(&chunk->slots[index].storage), index);
+        }
+      }
     }
 
-    const std::list<T> *operator->() const {
-      return &values;
+    /// Make \c current_ a chunk with free slots, sweeping first. A new chunk
+    /// is allocated if the chunks are so full that sweeping would soon have to
+    /// be repeated.
+    void findFreeChunk() {
+      sweep();
+      Chunk *best = nullptr;
+      for (Chunk *chunk : chunks_) {
+        if (!best || chunk->numUsed < best->numUsed)
+          best = chunk;
+      }
+      if (!best || best->numUsed > kChunkValues - kChunkValues / 4) {
+        best = new Chunk();
+        chunks_.push_back(best);
+      }
+      current_ = best;
     }
 
-    std::list<T> values;
+    /// All the chunks.
+    std::vector<Chunk *> chunks_;
+    /// The chunk new values are added to, or null.
+    Chunk *current_{nullptr};
+    /// The number of values that haven't been reclaimed.
+    size_t numValues_{0};
   };
 
  protected:
@@ -1005,6 +1162,10 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
   /// Compilation flags used by prepareJavaScript().
   ::hermes::hbc::CompileFlags compileFlags_{};
+
+  /// The directory of the bytecode cache used by prepareJavaScript(), or empty
+  /// if source is always compiled.
+  std::string bytecodeCacheDir_;
 };
 
 namespace {
@@ -1234,7 +1395,7 @@ void HermesRuntime::unwatchTimeLimit() {
 }
 
 size_t HermesRuntime::rootsListLength() const {
-  return impl(this)->hermesValues_->size();
+  return impl(this)->hermesValues_.size();
 }
 
 namespace {
@@ -1267,8 +1428,91 @@ class HermesPreparedJavaScript final : public jsi::PreparedJavaScript {
   }
 };
 
+/// \return the key of the bytecode compiled from \p source with the URL
+///   \p sourceURL and the flags \p flags in the bytecode cache. It also
+///   covers the bytecode version, so that a new VM doesn't load bytecode
+///   cached by an older one.
+::hermes::SHA1 bytecodeCacheKey(
+    const ::hermes::Buffer &source,
+    llvm::StringRef sourceURL,
+    const hbc::CompileFlags &flags) {
+  // The cache always holds eagerly compiled bytecode, so the lazy flag is not
+  // part of the key.
+  const uint8_t flagBytes[] = {
+      flags.optimize,
+      flags.debug,
+      flags.allowFunctionToStringWithRuntimeSource,
+      flags.strict,
+      (uint8_t)(flags.staticBuiltins.hasValue()
+                    ? 1 + flags.staticBuiltins.getValue()
+                    : 0),
+      flags.emitAsyncBreakCheck,
+      flags.includeLibHermes,
+      flags.instrumentIR,
+  };
+  const uint32_t header[] = {
+      hbc::BYTECODE_VERSION, (uint32_t)sourceURL.size()};
+
+  llvm::SHA1 hasher;
+  hasher.update(llvm::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(header), sizeof(header)));
+  hasher.update(flagBytes);
+  // The URL ends up in the debug info.
+  hasher.update(sourceURL);
+  hasher.update(llvm::ArrayRef<uint8_t>(source.data(), source.size()));
+  auto rawHash = hasher.final();
+  ::hermes::SHA1 key{};
+  std::copy(rawHash.begin(), rawHash.end(), key.begin());
+  return key;
+}
+
 } // namespace
 
+std::unique_ptr<hbc::BCProvider> HermesRuntimeImpl::loadCachedBytecode(
+    const std::string &path,
+    const ::hermes::SHA1 &key) {
+  auto fileBuf = llvm::MemoryBuffer::getFile(
+      path, -1, /* RequiresNullTerminator */ false);
+  if (!fileBuf)
+    return nullptr;
+  auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<::hermes::OwnedMemoryBuffer>(std::move(*fileBuf)));
+  // The source hash of cached bytecode is its key, which catches truncated or
+  // foreign files.
+  if (!ret.first || ret.first->getSourceHash() != key)
+    return nullptr;
+  return std::move(ret.first);
+}
+
+#ifndef HERMESVM_LEAN
+void HermesRuntimeImpl::storeCachedBytecode(
+    const std::string &path,
+    const ::hermes::SHA1 &key,
+    hbc::BytecodeModule &BM) {
+  // Write to a temporary file which is renamed when it is complete, so that
+  // concurrent readers never see part of a file.
+  llvm::sys::fs::create_directories(bytecodeCacheDir_);
+  int fd;
+  llvm::SmallString<128> tmpPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%%%.tmp", fd, tmpPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS{fd, /* shouldClose */ true};
+    hbc::BytecodeSerializer BS{
+        OS, ::hermes::BytecodeGenerationOptions::defaults()};
+    BS.serialize(BM, key);
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(tmpPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(tmpPath, path))
+    llvm::sys::fs::remove(tmpPath);
+}
+#endif
+
 std::shared_ptr<const jsi::PreparedJavaScript>
 HermesRuntimeImpl::prepareJavaScript(
     const std::shared_ptr<const jsi::Buffer> &jsiBuffer,
@@ -1284,19 +1528,47 @@ HermesRuntimeImpl::prepareJavaScript(
       "HermesVM", "Prepare JS on %s.", isBytecode ? "bytecode" : "source");
 #endif
 
-  // Construct the BC provider either from buffer or source.
+  // Construct the BC provider either from buffer, the bytecode cache or
+  // source.
   if (isBytecode) {
     bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
         std::move(buffer));
   } else {
-    compileFlags_.lazy =
+    auto &stats = runtime_.getRuntimeStats();
+    ::hermes::SHA1 key{};
+    std::string cachePath;
+    if (!bytecodeCacheDir_.empty()) {
+      key = bytecodeCacheKey(*buffer, sourceURL, compileFlags_);
+      cachePath = bytecodeCacheDir_ + "/" + ::hermes::hashAsString(key) +
+          ".hbc";
+      if (auto cached = loadCachedBytecode(cachePath, key)) {
+        ++stats.bytecodeCacheHits;
+        return std::make_shared<const HermesPreparedJavaScript>(
+            std::move(cached), runtimeFlags, std::move(sourceURL));
+      }
+      ++stats.bytecodeCacheMisses;
+    }
+
+    // Bytecode that is written to the cache must be complete, so it is
+    // compiled eagerly.
+    compileFlags_.lazy = cachePath.empty() &&
         (buffer->size() >=
          ::hermes::hbc::kDefaultSizeThresholdForLazyCompilation);
 #if defined(HERMESVM_LEAN)
     bcErr.second = "prepareJavaScript source compilation not supported";
 #else
-    bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
-        std::move(buffer), sourceURL, compileFlags_);
+    std::pair<std::unique_ptr<hbc::BCProviderFromSrc>, std::string> srcErr;
+    {
+      const vm::instrumentation::RAIITimer timer{
+          "Compile JS", stats, stats.compileJS};
+      srcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+          std::move(buffer), sourceURL, compileFlags_);
+    }
+    if (srcErr.first && !cachePath.empty())
+      storeCachedBytecode(
+          cachePath, key, *srcErr.first->getBytecodeModule());
+    bcErr.first = std::move(srcErr.first);
+    bcErr.second = std::move(srcErr.second);
 #endif
   }
   if (!bcErr.first) {
@@ -1531,7 +1803,7 @@ jsi::Value HermesRuntimeImpl::createValueFromJsonUtf8(
     vm::GCScope gcScope(&runtime_);
     llvm::ArrayRef<uint8_t> ref(json, length);
     vm::CallResult<vm::HermesValue> res =
-        runtimeJSONParseRef(&runtime_, ::hermes::UTF16Stream(ref));
+        vm::runtimeJSONParseUTF8(&runtime_, ref);
     checkStatus(res.getStatus());
     return valueFromHermesValue(*res);
   });
@@ -1960,39 +2232,19 @@ bool HermesRuntimeImpl::instanceOf(
 }
 
 jsi::Runtime::ScopeState *HermesRuntimeImpl::pushScope() {
-  hermesValues_->emplace_front(
-      vm::HermesValue::encodeNativeUInt32(kSentinelNativeValue));
-  return reinterpret_cast<ScopeState *>(&hermesValues_->front());
+  return reinterpret_cast<ScopeState *>(hermesValues_.add(
+      vm::HermesValue::encodeNativeUInt32(kSentinelNativeValue)));
 }
 
 void HermesRuntimeImpl::popScope(ScopeState *prv) {
   HermesPointerValue *sentinel = reinterpret_cast<HermesPointerValue *>(prv);
   assert(sentinel->phv.isNativeValue());
   assert(sentinel->phv.getNativeUInt32() == kSentinelNativeValue);
+  assert(sentinel->get() == 1 && "Scope sentinel was shared");
 
-  for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-    auto &value = *it;
-
-    if (&value == sentinel) {
-      hermesValues_->erase(it);
-      return;
-    }
-
-    if (value.phv.isNativeValue()) {
-      // We reached another sentinel value or we started added another native
-      // value to the hermesValue_ list. This should not happen.
-      std::terminate();
-    }
-
-    if (value.get() == 0) {
-      it = hermesValues_->erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // We did not find a sentinel value.
-  std::terminate();
+  // Reclaim the values released in the scope along with the sentinel.
+  sentinel->dec();
+  hermesValues_.sweep();
 }
 
 void HermesRuntimeImpl::checkStatus(vm::ExecutionStatus status) {
@@ -19,7 +19,10 @@
 #include "hermes/Support/UTF8.h"
 #include "llvm/Support/Format.h"
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace llvm {
@@ -137,6 +140,38 @@ class DebugInfo {
   /// Get source filename as string id.
   OptValue<uint32_t> getFilenameForAddress(uint32_t debugOffset) const;
 
+  /// A point in the source locations of a function from which decoding can
+  /// resume.
+  struct LocationCheckpoint {
+    /// The location decoded at this point.
+    DebugSourceLocation location;
+    /// Offset of the entry that the location was decoded from.
+    uint32_t entryOffset;
+    /// Offset of the entry after it.
+    uint32_t nextOffset;
+  };
+
+  /// Number of source locations between two checkpoints. Functions with
+  /// fewer locations than this have no checkpoints.
+  static constexpr uint32_t kLocationCheckpointInterval = 16;
+
+  /// Checkpoints into the source locations of the functions looked up so
+  /// far, by debug offset. Built on the first lookup in each function, so
+  /// that later lookups can start decoding at the nearest checkpoint. The
+  /// lock makes lookups safe from several threads, as a DebugInfo may be
+  /// shared by several runtimes.
+  struct LocationIndex {
+    std::mutex lock;
+    std::unordered_map<uint32_t, std::vector<LocationCheckpoint>> checkpoints;
+  };
+  std::unique_ptr<LocationIndex> locationIndex_{new LocationIndex()};
+
+  /// \return the checkpoints of the function whose source locations start at
+  /// \p debugOffset, building them if needed. Checkpoints are sorted by
+  /// address.
+  const std::vector<LocationCheckpoint> &getLocationCheckpoints(
+      uint32_t debugOffset) const;
+
  public:
   explicit DebugInfo() = default;
   /*implicit*/ DebugInfo(DebugInfo &&that) = default;
@@ -97,6 +97,12 @@ static opt<double> OccupancyTarget(
     cat(GCCategory),
     init(GCConfig::getDefaultOccupancyTarget()));
 
+static opt<unsigned> GCNumWorkerThreads(
+    "gc-num-worker-threads",
+    desc("Number of extra threads that help with full collections."),
+    cat(GCCategory),
+    init(GCConfig::getDefaultNumGCWorkerThreads()));
+
 static opt<bool> SampleProfiling(
     "sample-profiling",
     init(false),
@@ -169,6 +175,13 @@ static opt<bool> TrackBytecodeIO(
         "Track bytecode I/O when executing bytecode. Only works with bytecode mode"),
     cat(RuntimeCategory));
 
+static opt<bool> LazyIdentifiers(
+    "Xlazy-identifiers",
+    desc("Register the identifiers of the bytecode when they are first used "
+         "rather than when it is loaded"),
+    init(RuntimeConfig::getDefaultLazyIdentifiers()),
+    cat(RuntimeCategory));
+
 static opt<bool> StableInstructionCount(
     "Xstable-instruction-count",
     init(false),
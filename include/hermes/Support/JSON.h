@@ -8,8 +8,52 @@
 #ifndef HERMES_SUPPORT_JSON_H
 #define HERMES_SUPPORT_JSON_H
 
+#include "llvm/ADT/ArrayRef.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
 namespace hermes {
 
+/// Appends \p ch to \p output, escaped if it can't appear as is in a JSON
+/// string.
+template <typename Output>
+void escapeCharForJSON(Output &output, char16_t ch) {
+#define ESCAPE(ch, replace)    \
+  case ch:                     \
+    output.push_back(u'\\');   \
+    output.push_back(replace); \
+    break
+
+  switch (ch) {
+    // Quote.2.a.
+    ESCAPE(u'\\', u'\\');
+    ESCAPE(u'"', u'"');
+    // Quote.2.b.
+    ESCAPE(u'\b', u'b');
+    ESCAPE(u'\f', u'f');
+    ESCAPE(u'\n', u'n');
+    ESCAPE(u'\r', u'r');
+    ESCAPE(u'\t', u't');
+    default:
+      if (ch < u' ') {
+        // Quote.2.c.
+        output.append({u'\\', u'u', u'0', u'0'});
+        output.push_back(u'0' + (ch / 16));
+        if (ch % 16 < 10) {
+          output.push_back(u'0' + (ch % 16));
+        } else {
+          output.push_back(u'a' + (ch % 16 - 10));
+        }
+      } else {
+        // Quote.2.d.
+        output.push_back(ch);
+      }
+  }
+#undef ESCAPE
+}
+
 /// Quotes a string given by \p view and puts the quoted version into \p output.
 /// \p view should be utf16-encoded, and \p output will be as well.
 /// \post output is a container that has a sequential list of utf16 characters
@@ -20,39 +64,58 @@ void quoteStringForJSON(Output &output, StringView view) {
   output.push_back(u'"');
   // Quote.2.
   for (char16_t ch : view) {
-#define ESCAPE(ch, replace)    \
-  case ch:                     \
-    output.push_back(u'\\');   \
-    output.push_back(replace); \
-    break
+    escapeCharForJSON(output, ch);
+  }
+  // Quote.3.
+  output.push_back(u'"');
+}
 
-    switch (ch) {
-      // Quote.2.a.
-      ESCAPE(u'\\', u'\\');
-      ESCAPE(u'"', u'"');
-      // Quote.2.b.
-      ESCAPE(u'\b', u'b');
-      ESCAPE(u'\f', u'f');
-      ESCAPE(u'\n', u'n');
-      ESCAPE(u'\r', u'r');
-      ESCAPE(u'\t', u't');
-      default:
-        if (ch < u' ') {
-          // Quote.2.c.
-          output.append({u'\\', u'u', u'0', u'0'});
-          output.push_back(u'0' + (ch / 16));
-          if (ch % 16 < 10) {
-            output.push_back(u'0' + (ch % 16));
-          } else {
-            output.push_back(u'a' + (ch % 16 - 10));
-          }
-        } else {
-          // Quote.2.d.
-          output.push_back(ch);
-        }
+/// \return the number of characters at the start of \p str which stand for
+/// themselves in a JSON string, i.e. anything but '"', '\\' and U+0000 thru
+/// U+001F. \p CharT is char for ASCII strings and char16_t for UTF-16 ones.
+template <typename CharT>
+size_t plainJSONStringPrefix(llvm::ArrayRef<CharT> str) {
+  using UCharT = typename std::make_unsigned<CharT>::type;
+  // Test a word of characters at a time: a lane of w is less than n if the
+  // lane's sign bit is clear in w but set after subtracting n. Borrows only
+  // propagate out of lanes which matched, so the test is exact about whether
+  // any lane matches.
+  constexpr uint64_t kOnes = ~uint64_t(0) / UCharT(~UCharT(0));
+  constexpr uint64_t kSigns = kOnes << (8 * sizeof(CharT) - 1);
+  constexpr size_t kLanes = sizeof(uint64_t) / sizeof(CharT);
+  auto anyLess = [](uint64_t w, uint64_t n) {
+    return (w - kOnes * n) & ~w & kSigns;
+  };
+  size_t i = 0;
+  for (; i + kLanes <= str.size(); i += kLanes) {
+    uint64_t w;
+    std::memcpy(&w, str.data() + i, sizeof(w));
+    if (anyLess(w, 0x20) | anyLess(w ^ (kOnes * '"'), 1) |
+        anyLess(w ^ (kOnes * '\\'), 1)) {
+      break;
     }
   }
-  // Quote.3.
+  for (; i < str.size(); ++i) {
+    UCharT ch = str[i];
+    if (ch == '"' || ch == '\\' || ch < 0x20)
+      break;
+  }
+  return i;
+}
+
+/// Same as quoteStringForJSON, for a string in contiguous memory. Runs of
+/// characters which need no escaping are copied at once.
+template <typename Output, typename CharT>
+void quoteStringRefForJSON(Output &output, llvm::ArrayRef<CharT> str) {
+  output.push_back(u'"');
+  while (!str.empty()) {
+    size_t n = plainJSONStringPrefix(str);
+    output.append(str.begin(), str.begin() + n);
+    if (n == str.size())
+      break;
+    escapeCharForJSON(output, str[n]);
+    str = str.drop_front(n + 1);
+  }
   output.push_back(u'"');
 }
 
@@ -59,6 +59,21 @@ class UTF16Stream {
     return *this;
   }
 
+  /// Returns the units from the current stream position which are available
+  /// without converting more input.
+  /// \pre hasChar returns true.
+  llvm::ArrayRef<char16_t> buffered() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return {cur_, end_};
+  }
+
+  /// Advances the stream by \p n units.
+  /// \pre \p n is at most the size of buffered().
+  void skip(size_t n) {
+    assert(n <= (size_t)(end_ - cur_) && "skipping past the buffered units");
+    cur_ += n;
+  }
+
  private:
   /// Tries to convert more data. Returns true if more data was converted.
   bool refill();
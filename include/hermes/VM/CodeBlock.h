@@ -21,6 +21,7 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/Support/TrailingObjects.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -33,9 +34,15 @@ class CodeBlock;
 /// A pointer to JIT-compiled function.
 typedef CallResult<HermesValue> (*JITCompiledFunctionPtr)(Runtime *runtime);
 
+/// A pointer to the on-stack replacement entry of a JIT-compiled function. It
+/// continues executing the current interpreter frame of the function at the
+/// loop header with bytecode offset \p offset, and returns from the function.
+typedef CallResult<HermesValue> (
+    *JITOSREntryPtr)(Runtime *runtime, uint32_t offset);
+
 /// A sequence of instructions representing the body of a function.
 class CodeBlock final
-    : private llvm::TrailingObjects<CodeBlock, PropertyCacheEntry> {
+    : private llvm::TrailingObjects<CodeBlock, PolymorphicPropertyCache> {
   friend TrailingObjects;
   /// Points to the runtime module with the information required for this code
   /// block.
@@ -53,15 +60,28 @@ class CodeBlock final
 #ifdef HERMESVM_JIT
   /// Set to true if for some reason we don't want to JIT this block, for
   /// example because it contains constructs that the JIT can't handle.
-  bool dontJIT_ = false;
+  /// Written by the JIT, possibly on its background thread.
+  std::atomic<bool> dontJIT_{false};
+
+  /// Set once the block has been handed to the JIT, so that it is only
+  /// compiled once. Cleared again when its compiled body is evicted, or by the
+  /// background thread when it ran out of executable memory compiling it.
+  std::atomic<bool> JITQueued_{false};
 
-  /// If this CodeBlock was compiled, a pointer to the body.
-  JITCompiledFunctionPtr JITCompiled_ = nullptr;
+  /// If this CodeBlock was compiled, a pointer to the body. It is installed by
+  /// the JIT, possibly on its background thread, once the body is complete.
+  std::atomic<JITCompiledFunctionPtr> JITCompiled_{nullptr};
+
+  /// If this CodeBlock was compiled and has loops, the entry used to continue
+  /// an interpreted frame of it in the compiled body.
+  std::atomic<JITOSREntryPtr> JITOSREntry_{nullptr};
 
   /// Function execution count.
-  /// Ideally, a function's hotness should also include if it has a loop and how
-  /// hot that loop is.
   uint32_t executionCount_ = 0;
+
+  /// Number of backward jumps taken in this function, which approximates how
+  /// hot its loops are.
+  uint32_t backEdgeCount_ = 0;
 #endif
 
   /// Total size of the property cache.
@@ -82,12 +102,13 @@ class CodeBlock final
   SourceErrorManager::SourceCoords getLazyFunctionLoc(bool start) const;
 
   /// \return the base pointer of the property cache.
-  PropertyCacheEntry *propertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>();
+  PolymorphicPropertyCache *propertyCache() {
+    return getTrailingObjects<PolymorphicPropertyCache>();
   }
 
-  PropertyCacheEntry *writePropertyCache() {
-    return getTrailingObjects<PropertyCacheEntry>() + writePropCacheOffset_;
+  PolymorphicPropertyCache *writePropertyCache() {
+    return getTrailingObjects<PolymorphicPropertyCache>() +
+        writePropCacheOffset_;
   }
 
   CodeBlock(
@@ -103,7 +124,8 @@ class CodeBlock final
         functionID_(functionID),
         propertyCacheSize_(cacheSize),
         writePropCacheOffset_(writePropCacheOffset) {
-    std::uninitialized_fill_n(propertyCache(), cacheSize, PropertyCacheEntry{});
+    std::uninitialized_fill_n(
+        propertyCache(), cacheSize, PolymorphicPropertyCache{});
   }
 
  public:
@@ -124,7 +146,7 @@ class CodeBlock final
       uint32_t functionID,
       uint32_t cacheSize,
       uint32_t writePropCacheOffset) {
-    auto allocSize = totalSizeToAlloc<PropertyCacheEntry>(cacheSize);
+    auto allocSize = totalSizeToAlloc<PolymorphicPropertyCache>(cacheSize);
     void *mem = checkedMalloc(allocSize);
     return new (mem) CodeBlock(
         runtimeModule,
@@ -261,23 +283,45 @@ class CodeBlock final
 #ifdef HERMESVM_JIT
   /// \return true if JIT is disabled for this function.
   bool getDontJIT() const {
-    return dontJIT_;
+    return dontJIT_.load(std::memory_order_relaxed);
   }
 
   /// Enable or disable JIT compilation of this function.
   void setDontJIT(bool dontJIT) {
-    dontJIT_ = dontJIT;
+    dontJIT_.store(dontJIT, std::memory_order_relaxed);
+  }
+
+  /// \return true if this function has already been handed to the JIT.
+  bool getJITQueued() const {
+    return JITQueued_.load(std::memory_order_relaxed);
+  }
+
+  /// Record whether this function has been handed to the JIT.
+  void setJITQueued(bool queued) {
+    JITQueued_.store(queued, std::memory_order_relaxed);
   }
 
   /// \return the native code for this function, or null if it hasn't been
   ///   compiled to native.
   JITCompiledFunctionPtr getJITCompiled() const {
-    return JITCompiled_;
+    return JITCompiled_.load(std::memory_order_acquire);
   }
 
-  /// Set the native code for this function.
+  /// Set the native code for this function. The code must be complete, since
+  /// the interpreter may call it as soon as it is visible.
   void setJITCompiled(JITCompiledFunctionPtr JITCompiled) {
-    JITCompiled_ = JITCompiled;
+    JITCompiled_.store(JITCompiled, std::memory_order_release);
+  }
+
+  /// \return the on-stack replacement entry of the native code for this
+  ///   function, or null if there is none.
+  JITOSREntryPtr getJITOSREntry() const {
+    return JITOSREntry_.load(std::memory_order_acquire);
+  }
+
+  /// Set the on-stack replacement entry of the native code for this function.
+  void setJITOSREntry(JITOSREntryPtr JITOSREntry) {
+    JITOSREntry_.store(JITOSREntry, std::memory_order_release);
   }
 
   /// Increment the function execution count.
@@ -294,6 +338,21 @@ class CodeBlock final
   void clearExecutionCount() {
     executionCount_ = 0;
   }
+
+  /// Increment the backward jump count and \return the new count.
+  uint32_t incrementBackEdgeCount() {
+    return ++backEdgeCount_;
+  }
+
+  /// \return the backward jump count.
+  uint32_t getBackEdgeCount() const {
+    return backEdgeCount_;
+  }
+
+  /// Reset the backward jump count to 0.
+  void clearBackEdgeCount() {
+    backEdgeCount_ = 0;
+  }
 #else
   /// \return true if JIT is disabled for this function.
   bool getDontJIT() const {
@@ -312,6 +371,15 @@ class CodeBlock final
   /// Set the native code for this function.
   void setJITCompiled(JITCompiledFunctionPtr JITCompiled) {}
 
+  /// \return the on-stack replacement entry of the native code for this
+  ///   function, or null if there is none.
+  JITOSREntryPtr getJITOSREntry() const {
+    return nullptr;
+  }
+
+  /// Set the on-stack replacement entry of the native code for this function.
+  void setJITOSREntry(JITOSREntryPtr JITOSREntry) {}
+
   /// Increment the function executionCount_ count
   void incrementExecutionCount() {}
 
@@ -322,14 +390,24 @@ class CodeBlock final
 
   /// Reset the function executionCount_ count to 0
   void clearExecutionCount() {}
+
+  /// Increment the backward jump count; always 0 if the JIT is not enabled.
+  uint32_t incrementBackEdgeCount() {
+    return 0;
+  }
+
+  /// \return the backward jump count as 0 if the JIT is not enabled.
+  uint32_t getBackEdgeCount() const {
+    return 0;
+  }
 #endif
 
-  inline PropertyCacheEntry *getReadCacheEntry(uint8_t idx) {
+  inline PolymorphicPropertyCache *getReadCache(uint8_t idx) {
     assert(idx < writePropCacheOffset_ && "idx out of ReadCache bound");
     return &propertyCache()[idx];
   }
 
-  inline PropertyCacheEntry *getWriteCacheEntry(uint8_t idx) {
+  inline PolymorphicPropertyCache *getWriteCache(uint8_t idx) {
     assert(
         writePropCacheOffset_ + idx < propertyCacheSize_ &&
         "idx out of WriteCache bound");
@@ -348,7 +426,7 @@ class CodeBlock final
   /// \return an estimate of the size of additional memory used by this
   /// CodeBlock.
   size_t additionalMemorySize() const {
-    return propertyCacheSize_ * sizeof(PropertyCacheEntry);
+    return propertyCacheSize_ * sizeof(PolymorphicPropertyCache);
   }
 
 #ifdef HERMES_ENABLE_DEBUGGER
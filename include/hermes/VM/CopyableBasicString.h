@@ -121,6 +121,10 @@ class CopyableBasicString {
     get().reserve();
   }
 
+  void resize(size_t count) {
+    get().resize(count);
+  }
+
   const T *data() const {
     return get().data();
   }
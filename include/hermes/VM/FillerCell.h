@@ -41,6 +41,37 @@ class FillerCell final : public VariableSizeRuntimeCell {
   FillerCell(GC *gc, size_type size) : VariableSizeRuntimeCell(gc, &vt, size) {}
 };
 
+/// A FreelistCell is a chunk of free space in a heap that is not compacted.
+/// Like a FillerCell it keeps the heap parseable, and it links together free
+/// chunks of similar sizes so they can be reused for allocation.
+class FreelistCell final : public VariableSizeRuntimeCell {
+  static const VTable vt;
+
+ public:
+  /// The next free cell in the same freelist, or null.
+  FreelistCell *next_;
+
+  static const VTable *vtable() {
+    return &vt;
+  };
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::FreelistCellKind;
+  }
+
+  FreelistCell(GC *gc, uint32_t size, FreelistCell *next)
+      : VariableSizeRuntimeCell(gc, &vt, size), next_(next) {}
+
+  /// Shrink this cell to \p newSize bytes, which must be heap-aligned and
+  /// large enough to still hold a FreelistCell.
+  void setSize(uint32_t newSize) {
+    assert(
+        newSize >= sizeof(FreelistCell) && isSizeHeapAligned(newSize) &&
+        "Invalid FreelistCell size");
+    variableSize_ = newSize;
+  }
+};
+
 } // namespace vm
 } // namespace hermes
 
@@ -157,6 +157,11 @@ class Deserializer;
 ///      void writeBarrierRangeFill(GCHermesValue* start, uint32_t numHVs,
 ///                                 HermesValue value);
 ///
+///   The mutator obtained the given symbol from the identifier table, or is
+///   storing it into the heap outside of a HermesValue.  GCs that trace the
+///   heap concurrently with the mutator must treat it as live.
+///      void symbolBarrier(SymbolID symbol);
+///
 ///   In debug builds: is a write barrier necessary for a write of the given
 ///   GC pointer \p value to the given \p loc?
 ///      bool needsWriteBarrier(void *loc, void *value);
@@ -689,6 +694,7 @@ class GCBase {
       GCHermesValue *start,
       uint32_t numHVs,
       HermesValue value) {}
+  inline void symbolBarrier(SymbolID symbol) {}
 #ifndef NDEBUG
   bool needsWriteBarrier(void *loc, void *value) {
     return false;
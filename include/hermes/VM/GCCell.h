@@ -12,9 +12,11 @@
 #include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/VTable.h"
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 namespace hermes {
 namespace vm {
@@ -41,6 +43,8 @@ static constexpr uint32_t cellSize() {
 /// traversal in a contiguous space: given a pointer to the head, you
 /// can get the size, and thus get to the head of the next cell.
 class GCCell {
+  friend struct ObjectOffsets;
+
   /// Pointer to the virtual table which also serves as a forwarding pointer.
   const VTable *vtp_;
 
@@ -158,6 +162,48 @@ class GCCell {
     return isMarked();
   }
 
+  /// The next four functions let several GC threads race to forward the
+  /// same cell.  The thread that claims the cell copies it and then publishes
+  /// the marked forwarding pointer; the others wait for it.
+
+  /// Try to claim this cell for forwarding.
+  /// \return the cell's VTable if this call claimed the cell, or null if the
+  /// cell was already claimed (and possibly forwarded).
+  /// NOTE: this should only be used by the GC.
+  const VTable *tryClaimForForwarding() {
+    auto *vtp = reinterpret_cast<std::atomic<const VTable *> *>(&vtp_);
+    const VTable *vt = vtp->load(std::memory_order_acquire);
+    if (isMarked(vt) ||
+        !vtp->compare_exchange_strong(
+            vt, claimedVTable(), std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return vt;
+  }
+
+  /// Copy this cell, claimed by the calling thread, to the \p size bytes at
+  /// \p dest, restoring its VTable \p vt in the copy.
+  /// NOTE: this should only be used by the GC.
+  void copyClaimedTo(void *dest, const VTable *vt, uint32_t size) const {
+    memcpy(dest, this, size);
+    static_cast<GCCell *>(dest)->vtp_ = vt;
+  }
+
+  /// Publish the forwarding pointer of a cell claimed by the calling thread.
+  /// NOTE: this should only be used by the GC.
+  void publishMarkedForwardingPointer(const GCCell *cell) {
+    assert(vtp_ == claimedVTable() && "Cell must be claimed first");
+    reinterpret_cast<std::atomic<const VTable *> *>(&vtp_)->store(
+        reinterpret_cast<const VTable *>(
+            reinterpret_cast<uintptr_t>(cell) | 0x1),
+        std::memory_order_release);
+  }
+
+  /// Wait until the forwarding pointer of this cell has been published.
+  /// \return the forwarding pointer.
+  /// NOTE: this should only be used by the GC.
+  GCCell *waitForMarkedForwardingPointer() const;
+
   const GCCell *nextCell() const {
     return reinterpret_cast<const GCCell *>(
         reinterpret_cast<const char *>(this) + getAllocatedSize());
@@ -232,6 +278,12 @@ class GCCell {
   }
 
  private:
+  /// The contents of vtp_ while a cell is claimed for forwarding: marked, but
+  /// with no forwarding pointer.
+  static const VTable *claimedVTable() {
+    return reinterpret_cast<const VTable *>(0x1);
+  }
+
   /// This version assumes that the bit is set, and that it can
   /// therefore subtract 1.
   template <typename T>
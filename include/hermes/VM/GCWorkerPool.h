@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_GCWORKERPOOL_H
+#define HERMES_VM_GCWORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class GCCell;
+
+/// A fixed set of threads that help the GC with the phases of a collection
+/// that can be split into independent pieces of work.  The thread that starts
+/// the work always takes part in it, so a pool with no threads runs
+/// everything on the caller.
+///
+/// Work is handed out in rounds: a round runs one function on every worker,
+/// and does not return until all of them have finished.  The workers never
+/// touch the heap between rounds, so the mutator may run freely then.
+class GCWorkerPool final {
+ public:
+  /// Start \p numThreads helper threads.
+  explicit GCWorkerPool(unsigned numThreads);
+  ~GCWorkerPool();
+
+  GCWorkerPool(const GCWorkerPool &) = delete;
+  GCWorkerPool &operator=(const GCWorkerPool &) = delete;
+
+  /// \return the number of workers that take part in a round, including the
+  /// calling thread.
+  unsigned numWorkers() const {
+    return threads_.size() + 1;
+  }
+
+  /// Call \p fn once on every worker, passing the index of the worker.  The
+  /// calling thread is worker 0.  Returns once every call has returned.
+  /// \return the CPU time, in seconds, spent in \p fn by the helper threads.
+  /// The caller's share is included in its own thread CPU time.
+  double runOnAllWorkers(const std::function<void(unsigned worker)> &fn);
+
+  /// Call \p task for each index in [0, numTasks), spreading the indices over
+  /// the workers.  Returns once every task has run.
+  /// \return the CPU time, in seconds, spent in the tasks by the helper
+  /// threads.
+  double forEachTask(
+      size_t numTasks,
+      const std::function<void(size_t task, unsigned worker)> &task);
+
+ private:
+  /// The body of every helper thread.
+  void workerLoop(unsigned worker);
+
+  /// The helper threads.  Worker i + 1 runs on threads_[i].
+  std::vector<std::thread> threads_;
+
+  /// Protects all the fields below.
+  std::mutex mtx_;
+
+  /// Signalled when a new round starts, or the pool shuts down.
+  std::condition_variable workCond_;
+
+  /// Signalled when the last helper thread finishes its part of a round.
+  std::condition_variable doneCond_;
+
+  /// The function run by the current round.
+  const std::function<void(unsigned)> *job_{nullptr};
+
+  /// Incremented at the start of every round, so helpers can tell a new round
+  /// from a spurious wakeup.
+  uint64_t round_{0};
+
+  /// The number of helper threads still running the current round.
+  unsigned pending_{0};
+
+  /// The CPU time spent by helper threads in the current round.
+  double helperCPUSecs_{0.0};
+
+  /// Set when the pool is destroyed.
+  bool shutdown_{false};
+};
+
+/// The cells waiting to be scanned by the workers of a parallel phase.  Each
+/// worker scans from a stack of its own.  When some worker runs out of work,
+/// the others move half of their stacks to a shared list, which idle workers
+/// take from.
+class ParallelWorkList final {
+ public:
+  explicit ParallelWorkList(unsigned numWorkers) : numWorkers_(numWorkers) {}
+
+  /// \return whether some worker is waiting for work.
+  bool wantsWork() const {
+    return numIdle_.load(std::memory_order_relaxed) > 0;
+  }
+
+  /// Move the bottom half of \p stack to the shared list.
+  void shareWork(std::vector<GCCell *> &stack);
+
+  /// Wait for shared work, and move some of it to \p stack.
+  /// \return false if every worker is out of work, so the phase is complete.
+  bool takeWork(std::vector<GCCell *> &stack);
+
+ private:
+  /// The most cells an idle worker takes from the shared list at a time.
+  static constexpr size_t kMaxTake = 256;
+
+  const unsigned numWorkers_;
+
+  /// Protects shared_ and done_, and all writes to numIdle_.
+  std::mutex mtx_;
+  std::condition_variable cond_;
+
+  /// Cells that have not been scanned, and are not on any worker's stack.
+  std::vector<GCCell *> shared_;
+
+  /// The number of workers waiting in takeWork.
+  std::atomic<unsigned> numIdle_{0};
+
+  /// Set once every worker has run out of work.
+  bool done_{false};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_GCWORKERPOOL_H
@@ -22,6 +22,7 @@
 #include "hermes/VM/GCCell.h"
 #include "hermes/VM/GCPointer.h"
 #include "hermes/VM/GCSegmentAddressIndex.h"
+#include "hermes/VM/GCWorkerPool.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/LogFailStorageProvider.h"
 #include "hermes/VM/OldGenNC.h"
@@ -33,6 +34,7 @@
 
 #include <deque>
 #include <limits>
+#include <memory>
 #include <vector>
 
 // We assume this file is only included by GC.h, which declares GCBase.
@@ -54,6 +56,10 @@ class WeakRef;
 /// The old generation is also a single contiguous-allocation space,
 /// but it is collected using mark-sweep-compact.  (Actually, a full
 /// collection collects both generations.)
+///
+/// If GCConfig::NumGCWorkerThreads is non-zero, full collections spread the
+/// transitive marking, the reference update, and the compaction over a pool of
+/// worker threads.  The mutator is stopped throughout, as before.
 class GenGC final : public GCBase {
  public:
   class Size final {
@@ -680,6 +686,33 @@ class GenGC final : public GCBase {
   /// close the mark bits.
   void completeMarking();
 
+  /// Transitively close the mark bits from the cells in
+  /// parallelMarkRoots_, using all the workers of workerPool_.  Reachable
+  /// WeakMaps are added to markState_, but not marked through, as in the
+  /// serial marking.
+  void completeMarkingParallel();
+
+  /// Gather the segments that were swept, in the order in which they were
+  /// swept, into \p segments.
+  void sweptSegments(std::vector<AlignedHeapSegment *> &segments);
+
+  /// \return the displaced VTable pointers of the cells in the \p i'th swept
+  /// segment.
+  static SweepResult::VTablesRemaining segmentVTables(
+      const SweepResult &sweepResult,
+      size_t i);
+
+  /// Update the references in the swept segments in parallel.
+  void updateReferencesParallel(const SweepResult &sweepResult);
+
+  /// Compact the swept segments, in parallel where that is safe.
+  void compactParallel(const SweepResult &sweepResult);
+
+  /// \return whether the object ID and allocation location trackers are off.
+  /// They are not thread-safe, so the phases that update them can only run in
+  /// parallel when they are.
+  bool canRunPhasesInParallel() const;
+
   /// In the first phase of marking, before this is called, we treat
   /// JSWeakMaps specially: when we mark a reachable JSWeakMap, we do
   /// not mark from it, but rather save a pointer to it in a vector.
@@ -892,6 +925,22 @@ class GenGC final : public GCBase {
   double updateReferencesSecs_ = 0.0;
   double compactSecs_ = 0.0;
 
+  /// Cumulative by-phase CPU times for full collection, summed over the
+  /// mutator thread and any GC worker threads.
+  double markRootsCPUSecs_ = 0.0;
+  double markTransitiveCPUSecs_ = 0.0;
+  double sweepCPUSecs_ = 0.0;
+  double updateReferencesCPUSecs_ = 0.0;
+  double compactCPUSecs_ = 0.0;
+
+  /// The threads that help with full collections, or null if full collections
+  /// run only on the mutator thread.
+  std::unique_ptr<GCWorkerPool> workerPool_;
+
+  /// The cells marked directly by the roots, used to seed the parallel
+  /// marking.  Only filled in when workerPool_ is non-null.
+  std::vector<GCCell *> parallelMarkRoots_;
+
   /// The sum of the pre-collection sizes of the heap before/after
   /// full collections.
   gcheapsize_t cumPreBytes_ = 0;
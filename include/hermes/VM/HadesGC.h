@@ -9,13 +9,25 @@
 #define HERMES_VM_HADESGC_H
 
 #include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/GCBase.h"
 
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseSet.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace hermes {
 namespace vm {
 
+class FreelistCell;
 class WeakRefBase;
 template <class T>
 class WeakRef;
@@ -29,13 +41,20 @@ class WeakRef;
 ///
 /// The old generation is a collection of heap segments, and allocations in the
 /// old gen are done with a freelist (not a bump-pointer). When the old
-/// collection is nearly full, it starts a backthround thread that will mark all
+/// collection is nearly full, it starts a background thread that will mark all
 /// objects in the old gen, and then sweep the dead ones onto freelists.
 ///
-/// Compaction is done in the old gen on a per-segment basis.
+/// Old gen objects never move.  The background thread only ever runs while
+/// holding gcMutex_, and yields it between bounded chunks of work, so all
+/// collector data structures are protected by that lock.  The mutator takes it
+/// for young-gen collections and old-gen allocations, which are the only
+/// points where it interacts with the old gen besides write barriers.
 ///
-/// NOTE: Currently HadesGC is only a stub, meant to get things to compile.
-/// It will be filled out to actually work later.
+/// Marking is incremental-update: while the old gen is being marked, the write
+/// barrier records every new pointer and symbol value stored into the old gen,
+/// and those are handed to the marker.  Marking is finished with a short
+/// pause that re-scans the roots and the young gen, processes weak references
+/// and WeakMaps, and runs finalizers for dead old-gen objects.
 class HadesGC final : public GCBase {
  public:
   /// Initialize the GC with the give \p gcCallbacks and \p gcConfig.
@@ -64,10 +83,20 @@ class HadesGC final : public GCBase {
   /// \name GCBase overrides
   /// \{
 
+  void getHeapInfo(HeapInfo &info) override;
   void getHeapInfoWithMallocSize(HeapInfo &info) override;
   void getCrashManagerHeapInfo(CrashManager::HeapInformation &info) override;
   void createSnapshot(llvm::raw_ostream &os) override;
 
+#ifdef HERMESVM_SERIALIZE
+  void serializeWeakRefs(Serializer &s) override;
+  void deserializeWeakRefs(Deserializer &d) override;
+  void serializeHeap(Serializer &s) override;
+  void deserializeHeap(Deserializer &d) override;
+  void deserializeStart() override;
+  void deserializeEnd() override;
+#endif
+
   /// \}
 
   /// \name GC non-virtual API
@@ -86,6 +115,7 @@ class HadesGC final : public GCBase {
   /// Like alloc above, but the resulting object is expected to be long-lived.
   /// Allocate directly in the old generation (doing a full collection if
   /// necessary to create room).
+  /// \pre heapAlignSize(size) >= kMinOldGenAllocSize.
   /// \tparam hasFinalizer Indicates whether the object being allocated will
   ///   have a finalizer.
   template <HasFinalizer hasFinalizer = HasFinalizer::No>
@@ -98,20 +128,39 @@ class HadesGC final : public GCBase {
   /// Run the finalizers for all heap objects.
   void finalizeAll();
 
+  /// \return true iff this is collecting the entire heap, or false if it is
+  /// only a portion of the heap.
+  /// \pre Assumes inGC() is true, or else this has no meaning.
+  bool inFullCollection() const {
+    return inOldGenCollection_;
+  }
+
+  /// \return true if \p ptr points into the young generation.
+  bool inYoungGen(const void *ptr) const {
+    return AlignedStorage::start(ptr) == youngGen_.lowLim();
+  }
+
+  /// The given amount of external memory is credited to \p alloc.
+  void creditExternalMemory(GCCell *alloc, uint32_t size);
+
+  /// The given amount of external memory is debited from \p alloc.
+  void debitExternalMemory(GCCell *alloc, uint32_t size);
+
   /// \name Write Barriers
   /// \{
 
-  /// NOTE: For all write barriers and read barriers:
-  /// The call to writeBarrier/readBarrier must happen *before* the write/read
-  /// to memory occurs.
+  /// NOTE: For all write barriers:
+  /// The call to writeBarrier must happen *after* the write to memory occurs,
+  /// since the young-gen card marking and the old-gen marking barrier both
+  /// only look at the new value.
 
   /// The given value is being written at the given loc (required to
   /// be in the heap). If value is a pointer, execute a write barrier.
-  void writeBarrier(void *loc, HermesValue value);
+  inline void writeBarrier(void *loc, HermesValue value);
 
   /// The given pointer value is being written at the given loc (required to
   /// be in the heap). The value is may be null. Execute a write barrier.
-  void writeBarrier(void *loc, void *value);
+  inline void writeBarrier(void *loc, void *value);
 
   /// We copied HermesValues into the given region. Note that \p numHVs is
   /// the number of HermesValues in the the range, not the char length.
@@ -121,6 +170,25 @@ class HadesGC final : public GCBase {
   ///     the heap.
   void writeBarrierRange(GCHermesValue *start, uint32_t numHVs);
 
+  /// We filled numHVs slots starting at start with the given value.
+  /// Do any necessary barriers.
+  void writeBarrierRangeFill(
+      GCHermesValue *start,
+      uint32_t numHVs,
+      HermesValue value);
+
+  /// The mutator has obtained \p symbol from the identifier table, which
+  /// might be the only thing keeping it alive.  If the old gen is being
+  /// marked, make sure the symbol is marked too.
+  inline void symbolBarrier(SymbolID symbol);
+
+#ifndef NDEBUG
+  /// \return true if a write of \p value into \p loc requires a barrier.
+  bool needsWriteBarrier(void *loc, void *value) {
+    return value && !inYoungGen(loc) && inYoungGen(value);
+  }
+#endif
+
   /// \}
 
   /// Returns whether an external allocation of the given \p size fits
@@ -131,6 +199,7 @@ class HadesGC final : public GCBase {
   bool canAllocExternalMemory(uint32_t size);
 
   /// Mark a symbol id as being used.
+  /// \pre gcMutex_ is held and the old gen is being marked.
   void markSymbol(SymbolID symbolID);
 
   WeakRefSlot *allocWeakSlot(HermesValue init);
@@ -168,20 +237,430 @@ class HadesGC final : public GCBase {
   /// \}
 #endif
 
+// Mangling scheme used by MSVC encode public/private into the name.
+// As a result, vanilla "ifdef public" trick leads to link errors.
+#if defined(UNIT_TEST) || defined(_MSC_VER)
+ public:
+#else
  private:
+#endif
+  /// The phases of an old-gen collection.
+  enum class Phase : uint8_t {
+    /// No collection of the old gen is in progress.
+    None,
+    /// The background thread is marking the old gen.
+    Mark,
+    /// Marking is complete, and the background thread is sweeping segments.
+    Sweep,
+  };
+
+  /// Number of freelist buckets for exact small sizes: bucket i holds free
+  /// cells of exactly i * HeapAlign bytes.
+  static constexpr size_t kNumSmallFreelistBuckets = 32;
+  /// log2 of the smallest size that does not go in an exact bucket.
+  static constexpr size_t kLogMinLargeFreelistSize = 8;
+  static_assert(
+      kNumSmallFreelistBuckets * HeapAlign == 1 << kLogMinLargeFreelistSize,
+      "Small buckets must cover all sizes below the first large bucket");
+  /// Number of freelist buckets for larger sizes: bucket i holds free cells
+  /// in [2^(8 + i), 2^(9 + i)).
+  static constexpr size_t kNumLargeFreelistBuckets =
+      AlignedStorage::kLogSize - kLogMinLargeFreelistSize + 1;
+  static constexpr size_t kNumFreelistBuckets =
+      kNumSmallFreelistBuckets + kNumLargeFreelistBuckets;
+
+  /// Allocations at least this large skip the young gen.
+  static constexpr uint32_t kLargeAllocThreshold = AlignedStorage::size() / 8;
+
+  /// The smallest cell that can be allocated directly in the old gen: such a
+  /// cell is kept parseable by a FillerCell until the caller constructs it.
+  /// Smaller cells only reach the old gen through evacuation.
+  static const uint32_t kMinOldGenAllocSize;
+
+  /// Number of entries the barrier buffer may hold before it is handed to the
+  /// marker.
+  static constexpr size_t kBarrierBufferLimit = 512;
+
+  /// One old-gen segment.  Its storage starts with an
+  /// AlignedHeapSegment::Contents (card table, mark bits, guard page), and the
+  /// rest is always completely covered by cells, free space being represented
+  /// by FreelistCells.
+  class HeapSegment {
+   public:
+    explicit HeapSegment(AlignedStorage &&storage);
+
+    HeapSegment(HeapSegment &&) = default;
+    HeapSegment &operator=(HeapSegment &&) = default;
+
+    /// \return the first address at which cells can live.
+    char *start() const {
+      return storage_.lowLim() + AlignedHeapSegment::offsetOfAllocRegion;
+    }
+
+    /// \return one past the last address at which cells can live.
+    char *end() const {
+      return storage_.hiLim();
+    }
+
+    /// Heads of the freelists for each bucket, within this segment.
+    std::array<FreelistCell *, kNumFreelistBuckets> freelistHeads{};
+
+   private:
+    AlignedStorage storage_;
+  };
+
+  struct MarkAcceptor;
+  struct EvacAcceptor;
+  struct WeakSlotMarkAcceptor;
+  struct YoungGenWeakRootAcceptor;
+
+  /// The size limits set on construction.
+  const gcheapsize_t maxHeapSize_;
+  const double occupancyTarget_;
+
+  /// Where to get storage for segments.
+  std::shared_ptr<StorageProvider> provider_;
+
+  /// \name Young generation
+  /// \{
+
+  /// The storage of the young gen.  The whole region is used for allocation.
+  AlignedStorage youngGen_;
+
+  /// The current allocation position in the young gen.
+  char *ygLevel_{nullptr};
+
+  /// The end of the young gen allocation region.
+  char *ygEnd_{nullptr};
+
+  /// Cells in the young gen that have finalizers.
+  std::vector<GCCell *> youngGenFinalizables_;
+
+  /// \}
+
+  /// \name Old generation
+  /// \{
+
+  /// The segments of the old gen.  Indices are stable: segments are never
+  /// removed.
+  std::vector<HeapSegment> oldGen_;
+
+  /// The lowLim of each old gen segment, for validating pointers.
+  llvm::DenseSet<const void *> oldGenSegmentStarts_;
+
+  /// For each freelist bucket, the set of segments with a non-empty list.
+  std::array<llvm::BitVector, kNumFreelistBuckets> bucketSegments_;
+
+  /// The set of buckets that are non-empty in some segment.
+  llvm::BitVector nonEmptyBuckets_{kNumFreelistBuckets};
+
+  /// The number of bytes in old gen cells that are not free.  Only written
+  /// with gcMutex_ held, but read without it for heap statistics.
+  std::atomic<uint64_t> ogAllocatedBytes_{0};
+
+  /// The number of bytes of external memory credited to the heap.
+  uint64_t externalBytes_{0};
+
+  /// When ogAllocatedBytes_ + externalBytes_ goes past this, a collection of
+  /// the old gen is started.
+  uint64_t ogThreshold_;
+
+  /// Cells in the old gen that have finalizers.  Finalizers only run on the
+  /// mutator, so this is not protected by gcMutex_.
+  std::vector<GCCell *> oldGenFinalizables_;
+
+  /// \}
+
+  /// \name Old-gen collection state
+  /// \{
+
+  /// Protects everything about the old gen, including the marking state.
+  std::mutex gcMutex_;
+
+  /// Signalled when there is new work for the background thread.
+  std::condition_variable bgCond_;
+
+  /// The current phase of the old gen collection.
+  Phase phase_{Phase::None};
+
+  /// Whether the write barrier should record values for the old gen marker.
+  /// Only written and read by the mutator.
+  bool ogMarkingBarriers_{false};
+
+  /// Set by the background thread once it has found the worklist empty.
+  bool markingDone_{false};
+
+  /// Set when the background thread finishes a sweep, so the mutator can
+  /// record statistics.
+  bool ogCollectionCompleted_{false};
+
+  /// True while inside an old gen remark or full collection pause.
+  bool inOldGenCollection_{false};
+
+  /// Tells the background thread to exit.
+  bool shutdown_{false};
+
+  /// The state of the marker.
+  std::unique_ptr<MarkAcceptor> oldGenMarker_;
+
+  /// Values written during marking, not yet given to the marker.
+  std::vector<HermesValue> barrierBuffer_;
+
+  /// Old-gen cells allocated directly (not promoted) while marking, which have
+  /// to be re-scanned in the final pause, since their initializing stores may
+  /// have been done without barriers.
+  std::vector<GCCell *> rescanCells_;
+
+  /// The next segment the sweeper will look at.
+  size_t sweepIndex_{0};
+
+  /// Timing for the current old gen collection.
+  std::chrono::steady_clock::time_point ogCycleStart_;
+  double ogCycleCPUSecs_{0};
+  uint64_t ogUsedBefore_{0};
+
+  std::thread backgroundThread_;
+
+  /// \}
+
+  /// \name Weak references
+  /// \{
+
+  std::deque<WeakRefSlot> weakSlots_;
+  WeakRefSlot *firstFreeWeak_{nullptr};
+
+  /// \}
+
+  /// \name Statistics
+  /// \{
+
+  CumulativeHeapStats youngGenCumStats_;
+  CumulativeHeapStats oldGenCumStats_;
+
+  /// Time spent in the pauses that start and finish old gen marking.
+  double ogPauseSecs_{0};
+  /// Time spent by the background thread marking and sweeping.
+  double ogMarkSecs_{0};
+  double ogSweepSecs_{0};
+  /// Number of completed old gen collections that ran concurrently.
+  unsigned numConcurrentOGCollections_{0};
+
+  /// \}
+
+  /// \return true if \p ptr points into the allocated region of an old gen
+  /// segment.
+  bool inOldGen(const void *ptr) const {
+    return oldGenSegmentStarts_.count(AlignedStorage::start(ptr));
+  }
+
+  /// \return true if \p ptr is exactly the start of a live or dead (not free)
+  /// old gen cell.  Used to validate pointers read concurrently with the
+  /// mutator.
+  bool isOldGenCellStart(const void *ptr) const;
+
+  /// Slow path of alloc: collects the young gen or allocates directly in the
+  /// old gen.
+  void *allocSlow(uint32_t sz);
+
+  /// Allocate directly in the old gen, taking gcMutex_.  The result is a
+  /// FillerCell until the caller constructs the real cell.
+  /// \pre sz >= kMinOldGenAllocSize.
+  void *allocInOldGen(uint32_t sz);
+
+  /// Allocate \p sz bytes from the old gen freelists, adding segments as
+  /// needed.  The returned cell is initialized to a FillerCell, if it is at
+  /// least kMinOldGenAllocSize.
+  /// \return nullptr if the old gen is full.
+  /// \pre gcMutex_ is held.
+  GCCell *oldGenAlloc(uint32_t sz);
+
+  /// Allocate from the existing freelists only.
+  GCCell *oldGenFreelistAlloc(uint32_t sz);
+
+  /// Add a new segment to the old gen.  \return false if the heap is at its
+  /// maximum size, or storage could not be obtained.
+  bool addSegment();
+
+  /// \return the number of old gen segments the maximum heap size allows.
+  size_t maxOldGenSegments() const;
+
+  /// \return the freelist bucket for a free cell of \p size bytes.
+  static unsigned getFreelistBucket(uint32_t size);
+
+  /// Make [start, end) a free cell in \p segmentIdx, and put it on the
+  /// appropriate freelist.  Runs too small for a FreelistCell become
+  /// FillerCells.
+  void addToFreelist(size_t segmentIdx, char *start, char *end);
+
+  /// Push \p cell onto the freelist of \p bucket in \p segmentIdx.
+  void pushFreelistCell(size_t segmentIdx, unsigned bucket, FreelistCell *cell);
+
+  /// Empty all freelists of \p segmentIdx.
+  void clearFreelists(size_t segmentIdx);
+
+  /// Point the card boundaries covering [start, end) at \p start.
+  static void updateCardBoundaries(char *start, char *end);
+
+  /// Collect the young gen, promoting all surviving objects into the old gen.
+  /// \pre gcMutex_ is held.
+  void youngGenCollection();
+
+  /// Make sure the old gen can hold \p bytes more, by adding segments or
+  /// finishing a collection of the old gen.
+  void ensureOldGenSpace(uint64_t bytes);
+
+  /// Visit every cell in the young gen, which must be parseable.
+  void forYoungGenObjs(const std::function<void(GCCell *)> &callback);
+
+  /// Called after a young gen collection: move the old gen collection along.
+  void updateOldGenCollection();
+
+  /// Hand the barrier buffer to the marker.
+  /// \pre gcMutex_ is held.
+  void flushBarrierBuffer();
+
+  /// Slow path of the marking barrier.
+  void barrierBufferSlow(HermesValue value);
+
+  /// Begin marking the old gen.  This is a short pause that marks the roots.
+  /// \pre gcMutex_ is held, and no collection of the old gen is in progress.
+  void startOldGenCollection();
+
+  /// Finish marking, process weak references, free symbols, and either run or
+  /// schedule the sweep.  This is a pause.
+  /// \pre gcMutex_ is held and the phase is Mark.
+  void completeMarking();
+
+  /// Drain the marking worklist, for at most \p maxCells cells.
+  /// \return true if the worklist is empty.
+  bool drainMarkWorklist(size_t maxCells);
+
+  /// Sweep the segment at \p segmentIdx, rebuilding its freelists.
+  /// \p updateTrackers is true when dead cells have to be reported to the ID
+  /// tracker and allocation location tracker.
+  void sweepSegment(size_t segmentIdx, bool updateTrackers);
+
+  /// Called after the last segment has been swept.
+  void finishSweep();
+
+  /// Synchronously finish the current collection of the old gen, if any.
+  /// \pre gcMutex_ is held.
+  void finishOldGenCollection();
+
+  /// Record statistics for an old gen collection that finished since the last
+  /// time this was called.
+  void recordOldGenStats();
+
+  /// The body of the background thread.
+  void backgroundThreadLoop();
+
+  /// \return true if the background thread has something to do.
+  bool hasBackgroundWork() const {
+    return (phase_ == Phase::Mark && !markingDone_) || phase_ == Phase::Sweep;
+  }
+
+  /// See \c GCBase::printStats.
+  void printStats(llvm::raw_ostream &os, bool trailingComma) override;
 };
 
+/// @name Free standing functions
+/// @{
+
+template <class ToType>
+ToType *vmcast_during_gc(GCCell *cell, GC *gc) {
+  return static_cast<ToType *>(cell);
+}
+
+/// @}
+
 /// \name Inline implementations
 /// \{
 
 template <bool fixedSize, HasFinalizer hasFinalizer>
 void *HadesGC::alloc(uint32_t sz) {
-  return nullptr;
+  assert(noAllocLevel_ == 0 && "no alloc allowed right now");
+  sz = heapAlignSize(sz);
+  void *res;
+  if (LLVM_LIKELY(
+          !shouldSanitizeHandles() &&
+          static_cast<size_t>(ygEnd_ - ygLevel_) >= sz)) {
+    res = ygLevel_;
+    ygLevel_ += sz;
+  } else {
+    res = allocSlow(sz);
+  }
+  if (hasFinalizer == HasFinalizer::Yes) {
+    if (inYoungGen(res)) {
+      youngGenFinalizables_.push_back(static_cast<GCCell *>(res));
+    } else {
+      oldGenFinalizables_.push_back(static_cast<GCCell *>(res));
+    }
+  }
+  totalAllocatedBytes_ += sz;
+#ifndef NDEBUG
+  ++numAllocatedObjects_;
+#endif
+#if !defined(HERMES_ENABLE_ALLOCATION_LOCATION_TRACES) && !defined(NDEBUG)
+  // Assert that the IP is correctly set at this point, see MallocGC::alloc.
+  (void)gcCallbacks_->getCurrentIPSlow();
+#endif
+#ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
+  getAllocationLocationTracker().newAlloc(res);
+#endif
+  return res;
 }
 
 template <HasFinalizer hasFinalizer>
 void *HadesGC::allocLongLived(uint32_t size) {
-  return nullptr;
+  assert(noAllocLevel_ == 0 && "no alloc allowed right now");
+  size = heapAlignSize(size);
+  // Young collections don't scan long-lived roots, so the cell must not be
+  // put in the young gen, even if it is too small to be a FillerCell.
+  assert(
+      size >= kMinOldGenAllocSize &&
+      "Long-lived cells must be large enough to allocate in the old gen");
+  void *res = allocInOldGen(size);
+  if (hasFinalizer == HasFinalizer::Yes) {
+    oldGenFinalizables_.push_back(static_cast<GCCell *>(res));
+  }
+  totalAllocatedBytes_ += size;
+#ifndef NDEBUG
+  ++numAllocatedObjects_;
+#endif
+#ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
+  getAllocationLocationTracker().newAlloc(res);
+#endif
+  return res;
+}
+
+void HadesGC::writeBarrier(void *loc, HermesValue value) {
+  if (inYoungGen(loc)) {
+    return;
+  }
+  if (LLVM_UNLIKELY(ogMarkingBarriers_)) {
+    barrierBufferSlow(value);
+  }
+  if (value.isPointer() && inYoungGen(value.getPointer())) {
+    AlignedHeapSegment::cardTableCovering(loc)->dirtyCardForAddress(loc);
+  }
+}
+
+void HadesGC::writeBarrier(void *loc, void *value) {
+  if (!value || inYoungGen(loc)) {
+    return;
+  }
+  if (LLVM_UNLIKELY(ogMarkingBarriers_)) {
+    barrierBufferSlow(HermesValue::encodeObjectValue(value));
+  }
+  if (inYoungGen(value)) {
+    AlignedHeapSegment::cardTableCovering(loc)->dirtyCardForAddress(loc);
+  }
+}
+
+void HadesGC::symbolBarrier(SymbolID symbol) {
+  if (LLVM_UNLIKELY(ogMarkingBarriers_)) {
+    barrierBufferSlow(HermesValue::encodeSymbolValue(symbol));
+  }
 }
 
 /// \}
@@ -60,7 +60,6 @@ HERMES_VM_GCOBJECT(JSError);
 HERMES_VM_GCOBJECT(JSGenerator);
 HERMES_VM_GCOBJECT(Domain);
 HERMES_VM_GCOBJECT(RequireContext);
-HERMES_VM_GCOBJECT(HashMapEntry);
 HERMES_VM_GCOBJECT(OrderedHashMap);
 HERMES_VM_GCOBJECT(JSWeakMapImplBase);
 HERMES_VM_GCOBJECT(JSArrayIterator);
@@ -107,6 +106,10 @@ template <typename T>
 class BufferedStringPrimitive;
 template <typename T>
 struct IsGCObject<BufferedStringPrimitive<T>> : public std::true_type {};
+template <typename T>
+class RopeStringPrimitive;
+template <typename T>
+struct IsGCObject<RopeStringPrimitive<T>> : public std::true_type {};
 
 template <typename T, bool isGCObject = IsGCObject<T>::value>
 struct HermesValueTraits;
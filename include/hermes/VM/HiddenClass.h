@@ -48,6 +48,15 @@ struct ClassFlags {
   /// hidden class is never added to an inline cache.
   uint8_t dictionaryNoCacheMode : 1;
 
+  /// If dictionaryMode is set, this indicates that the slots of the dictionary
+  /// act as property cells: deleting or updating a property always creates a
+  /// new hidden class for the owning object, and the class never enters
+  /// no-cache mode. A slot cached together with the class thus stays valid,
+  /// for reads and writes, until the property is deleted or reconfigured.
+  /// It is used for the global object, which has too many properties for
+  /// class mode and is accessed through inline caches all the time.
+  uint8_t propertyCells : 1;
+
   /// Set when we have index-like named properties (e.g. "0", "1", etc) defined
   /// using defineOwnProperty. Array accesses will have to check the named
   /// properties first. The absence of this flag is important as it indicates
@@ -314,6 +323,19 @@ class HiddenClass final : public GCCell {
     return flags_.dictionaryNoCacheMode;
   }
 
+  /// \return true if this class is a dictionary whose slots are property
+  /// cells (see ClassFlags::propertyCells).
+  bool hasPropertyCells() const {
+    return flags_.propertyCells;
+  }
+
+  /// \return true if the slot of a writable property can be cached together
+  /// with this class for writes. The flags of the properties of a dictionary
+  /// may be updated in place, unless its slots are property cells.
+  bool canCacheWrites() const {
+    return !isDictionary() || hasPropertyCells();
+  }
+
   bool getHasIndexLikeProperties() const {
     return flags_.hasIndexLikeProperties;
   }
@@ -465,6 +487,13 @@ class HiddenClass final : public GCCell {
       PropertyFlags flagsToSet,
       OptValue<llvm::ArrayRef<SymbolID>> props);
 
+  /// Create a dictionary copy of \p selfHandle whose slots are property cells
+  /// (see ClassFlags::propertyCells). The class must not be in no-cache mode.
+  /// \return the new class.
+  static Handle<HiddenClass> convertToPropertyCells(
+      Handle<HiddenClass> selfHandle,
+      Runtime *runtime);
+
   /// Create a new class where the next slot is reserved, by calling addProperty
   /// with an internal property name. Only slots with index less than
   /// InternalProperty::NumInternalProperties can be reserved.
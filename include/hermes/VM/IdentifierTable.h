@@ -96,6 +96,10 @@ class IdentifierTable {
   StringPrimitive *getExistingStringPrimitiveOrNull(
       Runtime *runtime,
       llvm::ArrayRef<char16_t> str);
+  /// As above, for an ASCII string \p str.
+  StringPrimitive *getExistingStringPrimitiveOrNull(
+      Runtime *runtime,
+      llvm::ArrayRef<char> str);
 
   /// Register a lazy ASCII identifier from a bytecode module or as predefined
   /// identifier.
@@ -37,7 +37,22 @@ class JITContext {
   ///     allocated.
   /// \param maxMemory amount of executable memory that can be allocated by the
   ///     JIT.
-  JITContext(bool enable, size_t blockSize, size_t maxMemory) {}
+  /// \param callThreshold number of calls after which a function is compiled.
+  /// \param loopThreshold number of backward jumps after which a function is
+  ///     compiled.
+  /// \param background whether to compile on a background thread.
+  /// \param perfMap whether to describe compiled code in /tmp/perf-<pid>.map.
+  /// \param perfDump whether to describe compiled code in
+  ///     /tmp/jit-<pid>.dump, in the jitdump format.
+  JITContext(
+      bool enable,
+      size_t blockSize,
+      size_t maxMemory,
+      uint32_t callThreshold,
+      uint32_t loopThreshold,
+      bool background,
+      bool perfMap,
+      bool perfDump) {}
   ~JITContext() = default;
 
   JITContext(const JITContext &) = delete;
@@ -52,6 +67,44 @@ class JITContext {
     return codeBlock->getJITCompiled();
   }
 
+  /// Called by the interpreter on every backward jump in \p codeBlock.
+  /// \return the on-stack replacement entry of the compiled body of
+  ///   \p codeBlock, or nullptr if it has none.
+  inline JITOSREntryPtr onBackEdge(Runtime *runtime, CodeBlock *codeBlock) {
+    return nullptr;
+  }
+
+  /// Stop compiling any CodeBlock owned by \p runtimeModule.
+  void removeRuntimeModule(RuntimeModule *runtimeModule) {}
+
+  /// \return the number of functions that were successfully compiled.
+  uint32_t getNumCompiled() const {
+    return 0;
+  }
+
+  /// \return the number of times an interpreted frame continued in native code.
+  uint32_t getNumOSREntries() const {
+    return 0;
+  }
+
+  /// \return the number of bytes of executable memory used by the bodies of
+  ///   compiled functions.
+  size_t getCompiledBytes() const {
+    return 0;
+  }
+
+  /// \return the number of compiled bodies that were evicted to free
+  ///   executable memory.
+  uint32_t getNumEvictions() const {
+    return 0;
+  }
+
+  /// \return the number of functions that were compiled again after their
+  ///   body was evicted.
+  uint32_t getNumRecompiles() const {
+    return 0;
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return false;
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JIT_PERFMAP_H
+#define HERMES_VM_JIT_PERFMAP_H
+
+#include "llvm/ADT/StringRef.h"
+
+#include <cstddef>
+
+namespace hermes {
+namespace vm {
+
+/// Describes JIT compiled code to the Linux perf tool, which otherwise reports
+/// samples in it as unknown addresses. Two formats are supported:
+/// - The perf map, /tmp/perf-<pid>.map, a text file with the address range
+///   and name of every symbol, which perf report reads directly.
+/// - The jitdump, /tmp/jit-<pid>.dump, a binary log of timestamped code
+///   loads including the code itself. It is picked up by `perf inject --jit`
+///   on a profile recorded with `perf record -k mono`.
+/// Both files describe the whole process, so they are shared by all the
+/// JITPerfMaps of the process: they are created by the first one, and only
+/// ever appended to. Both are read after the process has exited, so code that
+/// is freed keeps its entry, and code which later reuses its addresses gets a
+/// new entry after it. In the jitdump, the timestamp of the new load tells
+/// perf which samples belong to which.
+/// The class is thread safe.
+class JITPerfMap {
+ public:
+  /// Start describing code in the output files, creating them if this is
+  /// the first JITPerfMap of the process to use them.
+  /// \param perfMap whether to write the perf map.
+  /// \param jitDump whether to write the jitdump.
+  JITPerfMap(bool perfMap, bool jitDump);
+  ~JITPerfMap();
+
+  JITPerfMap(const JITPerfMap &) = delete;
+  void operator=(const JITPerfMap &) = delete;
+
+  /// \return true if any output is being written.
+  bool isEnabled() const {
+    return perfMap_ || jitDump_;
+  }
+
+  /// Record that the \p size bytes at \p code hold the compiled code of the
+  /// function \p name, superseding any code previously added at the same
+  /// addresses. The code must not change afterwards.
+  void addCode(const void *code, size_t size, llvm::StringRef name);
+
+ private:
+  /// Whether this instance writes to the perf map.
+  bool perfMap_{false};
+  /// Whether this instance writes to the jitdump.
+  bool jitDump_{false};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_PERFMAP_H
@@ -8,6 +8,7 @@
 #ifndef HERMES_VM_JIT_POOLHEAP_H
 #define HERMES_VM_JIT_POOLHEAP_H
 
+#include <cstddef>
 #include <map>
 
 namespace llvm {
@@ -768,6 +768,10 @@ class Emitter {
     _dpfpRegToReg<fp, 0xEF>(src, dst);
   }
 
+  template <S s, unsigned scale = 0>
+  void addRmToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    _opRMToReg<s, scale, 0x02>(srcBase, srcIndex, srcOffset, dst);
+  }
   template <S s, unsigned scale = 0>
   void orRmToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
     _opRMToReg<s, scale, 0x0a>(srcBase, srcIndex, srcOffset, dst);
@@ -811,10 +815,24 @@ class Emitter {
     emitConst(out, imm);
   }
 
+  /// shift \p reg to the left by \p imm bits
+  void shlImm8ToReg(typename OperandType<S::B>::type imm, Reg reg) {
+    emitREX<S::Q>(out, reg, Reg::none, 4);
+    *out++ = 0xc1;
+    *out++ = ModeSel<AddrMode::Reg>::modRM(reg, 4);
+    emitConst(out, imm);
+  }
+
   void retq() {
     *out++ = 0xc3;
   }
 
+  /// Emit "ud2", which raises an invalid opcode exception.
+  void ud2() {
+    *out++ = 0x0F;
+    *out++ = 0x0B;
+  }
+
   void call(const uint8_t *target) {
     auto offset = target - out - 5;
     assert(isInt32(offset) && "operand must be 32-bit");
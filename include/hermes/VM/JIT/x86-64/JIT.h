@@ -11,6 +11,16 @@
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/JIT/ExecHeap.h"
 #include "hermes/VM/JIT/NativeDisassembler.h"
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace hermes {
 namespace vm {
@@ -24,9 +34,25 @@ class JITContext {
   /// \param enable whether JIT is enabled.
   /// \param blockSize the size of individual blocks of executable memory to be
   ///     allocated.
-  /// \param maximum amount of executable memory that can be allocated by the
-  ///     JIT.
-  JITContext(bool enable, size_t blockSize, size_t maxMemory);
+  /// \param maxMemory amount of executable memory that can be allocated by the
+  ///     JIT. Once it is used up, the bodies of the least recently called
+  ///     functions are evicted to make room for new ones.
+  /// \param callThreshold number of calls after which a function is compiled.
+  /// \param loopThreshold number of backward jumps after which a function is
+  ///     compiled.
+  /// \param background whether to compile on a background thread.
+  /// \param perfMap whether to describe compiled code in /tmp/perf-<pid>.map.
+  /// \param perfDump whether to describe compiled code in
+  ///     /tmp/jit-<pid>.dump, in the jitdump format.
+  JITContext(
+      bool enable,
+      size_t blockSize,
+      size_t maxMemory,
+      uint32_t callThreshold,
+      uint32_t loopThreshold,
+      bool background,
+      bool perfMap,
+      bool perfDump);
   ~JITContext();
 
   JITContext(const JITContext &) = delete;
@@ -34,9 +60,51 @@ class JITContext {
 
   /// Compile a function to native code and return the native pointer. If the
   /// function was previously compiled, return the existing body. If it cannot
-  /// be compiled, return nullptr.
+  /// be compiled, is not hot enough yet, or is being compiled in the
+  /// background, return nullptr.
   inline JITCompiledFunctionPtr compile(Runtime *runtime, CodeBlock *codeBlock);
 
+  /// Called by the interpreter on every backward jump in \p codeBlock. Once
+  /// the jumps reach the loop threshold, the function is queued for
+  /// compilation.
+  /// \return the on-stack replacement entry of the compiled body of
+  ///   \p codeBlock, so that the interpreter can continue the current frame in
+  ///   native code at the loop header, or nullptr if it has not been compiled
+  ///   yet.
+  inline JITOSREntryPtr onBackEdge(Runtime *runtime, CodeBlock *codeBlock);
+
+  /// Stop compiling any CodeBlock owned by \p runtimeModule, which is about to
+  /// be destroyed, waiting for one that is being compiled in the background.
+  void removeRuntimeModule(RuntimeModule *runtimeModule);
+
+  /// \return the number of functions that were successfully compiled.
+  uint32_t getNumCompiled() const {
+    return numCompiled_.load(std::memory_order_relaxed);
+  }
+
+  /// \return the number of times an interpreted frame continued in native code.
+  uint32_t getNumOSREntries() const {
+    return numOSREntries_;
+  }
+
+  /// \return the number of bytes of executable memory used by the bodies of
+  ///   compiled functions.
+  size_t getCompiledBytes() const {
+    return compiledBytes_.load(std::memory_order_relaxed);
+  }
+
+  /// \return the number of compiled bodies that were evicted to free
+  ///   executable memory.
+  uint32_t getNumEvictions() const {
+    return numEvictions_;
+  }
+
+  /// \return the number of functions that were compiled again after their
+  ///   body was evicted.
+  uint32_t getNumRecompiles() const {
+    return numRecompiles_.load(std::memory_order_relaxed);
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return enabled_;
@@ -78,13 +146,43 @@ class JITContext {
   }
 
  private:
-  /// Slow path that actually performs the compilation of the specified
-  /// CodeBlock.
+  /// \return true if \p codeBlock has run often enough to be compiled.
+  bool isHot(CodeBlock *codeBlock) const {
+    return codeBlock->getExecutionCount() >= callThreshold_ ||
+        codeBlock->getBackEdgeCount() >= loopThreshold_;
+  }
+
+  /// Slow path that hands the specified CodeBlock to the compiler, either
+  /// compiling it right away or queueing it for the background thread.
   JITCompiledFunctionPtr compileImpl(Runtime *runtime, CodeBlock *codeBlock);
 
+  /// Compile \p codeBlock on the current thread, installing the result into it
+  /// on success.
+  void compileNow(CodeBlock *codeBlock);
+
+  /// Body of the background compilation thread.
+  void workerMain();
+
+  /// Free the compiled bodies of the functions called least often since the
+  /// previous call, so that their executable memory can be reused. Functions
+  /// with a frame on the stack of \p runtime keep their body, since it may be
+  /// executing. Must be called on the interpreter thread.
+  /// \return the number of evicted bodies.
+  unsigned evictColdFunctions(Runtime *runtime);
+
+  /// Free the compiled body of \p codeBlock and reset it to be interpreted
+  /// until it becomes hot again. compileMutex_ must be held.
+  void evict(CodeBlock *codeBlock);
+
  private:
   /// Whether JIT compilation is enabled.
   bool enabled_{false};
+  /// Number of calls after which a function is compiled.
+  const uint32_t callThreshold_;
+  /// Number of backward jumps after which a function is compiled.
+  const uint32_t loopThreshold_;
+  /// Whether functions are compiled on a background thread.
+  const bool background_;
   /// Executable heap where all executable code is allocated.
   ExecHeap heap_;
   /// whether to dump JIT'ed code
@@ -92,12 +190,62 @@ class JITContext {
   /// whether to fatally crash on JIT compilation errors
   bool crashOnError_{false};
 
+  /// Describes the compiled code to the Linux perf tool. Guarded by
+  /// compileMutex_.
+  JITPerfMap perfMap_;
+
   /// The disassembler for our target.
   std::unique_ptr<NativeDisassembler> dis_ =
       NativeDisassembler::create(NativeDisassembler::x86_64_unknown_linux_gnu);
 
-  /// The JIT compile threshold for function execution count
-  static constexpr uint32_t COMPILE_THRESHOLD = 0;
+  /// Number of functions successfully compiled.
+  std::atomic<uint32_t> numCompiled_{0};
+  /// Number of on-stack replacements. Only accessed on the interpreter thread.
+  uint32_t numOSREntries_{0};
+
+  /// Serializes compilations and evictions, which share the executable heap.
+  std::mutex compileMutex_;
+
+  /// The executable memory of a compiled function.
+  struct CompiledBody {
+    /// The fast path and slow path blocks allocated in \c heap_.
+    ExecHeap::BlockPair blocks;
+    /// Number of bytes used in both blocks.
+    size_t size;
+    /// Execution count of the function at the previous eviction, so that only
+    /// the calls made since then count towards keeping it.
+    uint32_t lastExecutionCount;
+  };
+
+  /// The bodies of all compiled functions. Guarded by compileMutex_.
+  llvm::DenseMap<CodeBlock *, CompiledBody> compiled_{};
+  /// Functions whose body was evicted and that have not been compiled again
+  /// since. Guarded by compileMutex_.
+  llvm::DenseSet<CodeBlock *> evicted_{};
+  /// Set when a compilation failed because the executable heap was full. The
+  /// next compilation request from the interpreter evicts cold functions.
+  std::atomic<bool> outOfMemory_{false};
+  /// Number of bytes used by the bodies in \c compiled_.
+  std::atomic<size_t> compiledBytes_{0};
+  /// Number of evicted bodies. Only accessed on the interpreter thread.
+  uint32_t numEvictions_{0};
+  /// Number of functions compiled again after an eviction.
+  std::atomic<uint32_t> numRecompiles_{0};
+
+  /// Protects the background compilation state below.
+  std::mutex queueMutex_;
+  /// Signalled when a CodeBlock is queued or on shutdown.
+  std::condition_variable queueCond_;
+  /// Signalled when the background thread finishes a CodeBlock.
+  std::condition_variable doneCond_;
+  /// CodeBlocks waiting to be compiled in the background, oldest first.
+  std::deque<CodeBlock *> queue_{};
+  /// The CodeBlock being compiled in the background, if any.
+  CodeBlock *compiling_{nullptr};
+  /// Set to make the background thread exit.
+  bool shutdown_{false};
+  /// The background compilation thread, started with the first request.
+  std::thread worker_{};
 };
 
 LLVM_ATTRIBUTE_ALWAYS_INLINE
@@ -105,17 +253,36 @@ inline JITCompiledFunctionPtr JITContext::compile(
     Runtime *runtime,
     CodeBlock *codeBlock) {
   auto ptr = codeBlock->getJITCompiled();
-  if (LLVM_LIKELY(ptr))
+  if (LLVM_LIKELY(ptr)) {
+    // Keep counting calls, which decide what to evict when memory runs out.
+    codeBlock->incrementExecutionCount();
     return ptr;
+  }
   if (LLVM_LIKELY(!enabled_))
     return nullptr;
-  if (LLVM_LIKELY(codeBlock->getDontJIT()))
+  if (LLVM_LIKELY(codeBlock->getDontJIT() || codeBlock->getJITQueued()))
     return nullptr;
-  if (LLVM_LIKELY(codeBlock->getExecutionCount() < COMPILE_THRESHOLD))
+  if (LLVM_LIKELY(!isHot(codeBlock)))
     return nullptr;
   return compileImpl(runtime, codeBlock);
 }
 
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline JITOSREntryPtr JITContext::onBackEdge(
+    Runtime *runtime,
+    CodeBlock *codeBlock) {
+  if (LLVM_UNLIKELY(
+          codeBlock->incrementBackEdgeCount() == loopThreshold_ && enabled_ &&
+          !codeBlock->getDontJIT() && !codeBlock->getJITQueued() &&
+          !codeBlock->getJITCompiled())) {
+    compileImpl(runtime, codeBlock);
+  }
+  JITOSREntryPtr osrEntry = codeBlock->getJITOSREntry();
+  if (LLVM_UNLIKELY(osrEntry != nullptr))
+    ++numOSREntries_;
+  return osrEntry;
+}
+
 } // namespace x86_64
 } // namespace vm
 } // namespace hermes
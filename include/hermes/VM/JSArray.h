@@ -19,6 +19,7 @@ namespace vm {
 class ArrayImpl : public JSObject {
   using Super = JSObject;
   friend void ArrayImplBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend struct ObjectOffsets;
 
  public:
 #ifdef HERMESVM_SERIALIZE
@@ -87,6 +88,26 @@ class ArrayImpl : public JSObject {
         .set(value, &runtime->getHeap());
   }
 
+  /// Overwrite the element at index \p index with \p value if it is present in
+  /// storage, the array has no index-like named properties and it is not
+  /// frozen, which makes the element a writable data property that a [[Set]]
+  /// would simply update.
+  /// \return false if nothing was written, and a full [[Set]] is needed.
+  static bool trySetExistingElementAt(
+      ArrayImpl *self,
+      Runtime *runtime,
+      size_type index,
+      HermesValue value) {
+    if (!self->flags_.fastIndexProperties || self->flags_.frozen ||
+        self->at(runtime, index).isEmpty()) {
+      return false;
+    }
+    self->indexedStorage_.getNonNull(runtime)
+        ->at(index - self->beginIndex_)
+        .set(value, &runtime->getHeap());
+    return true;
+  }
+
   /// Set the element at index \p index to empty. This does not affect the
   /// storage size or array length.
   /// \return true if the operation succeeded (which is always in this class).
@@ -23,6 +23,12 @@ CallResult<HermesValue> runtimeJSONParse(
 /// Alternative interface to runtimeJSONParse for strings outside the JS heap.
 CallResult<HermesValue> runtimeJSONParseRef(Runtime *runtime, UTF16Stream &&s);
 
+/// As runtimeJSONParseRef, for UTF-8 \p utf8 outside the JS heap. The bytes
+/// are scanned in place rather than converted to UTF-16 first.
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime *runtime,
+    llvm::ArrayRef<uint8_t> utf8);
+
 /// Returns a String in JSON format representing an ECMAScript value,
 /// according to 15.12.3.
 CallResult<HermesValue> runtimeJSONStringify(
@@ -61,19 +61,20 @@ class JSMapImpl final : public JSObject {
     return static_cast<bool>(storage_);
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry) {
-    return storage_.get(runtime)->iteratorNext(runtime, entry);
+  /// Advance the iteration position (\p table, \p index) to the next entry.
+  /// \return false if there are no more entries.
+  bool iteratorNext(Runtime *runtime, SegmentedArray *&table, uint32_t &index) {
+    return storage_.get(runtime)->iteratorNext(runtime, table, index);
   }
 
   /// Add a value.
-  static void addValue(
+  static ExecutionStatus addValue(
       Handle<JSMapImpl> self,
       Runtime *runtime,
       Handle<> key,
       Handle<> value) {
     self->assertInitialized();
-    OrderedHashMap::insert(
+    return OrderedHashMap::insert(
         runtime->makeHandle<OrderedHashMap>(self->storage_),
         runtime,
         key,
@@ -111,7 +112,8 @@ class JSMapImpl final : public JSObject {
   /// Clear all elements from the storage.
   static void clear(Handle<JSMapImpl> self, Runtime *runtime) {
     self->assertInitialized();
-    self->storage_.get(runtime)->clear(runtime);
+    OrderedHashMap::clear(
+        runtime->makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -121,12 +123,19 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
-    for (entry = self->storage_.get(runtime)->iteratorNext(runtime); entry;
-         entry =
-             self->storage_.get(runtime)->iteratorNext(runtime, entry.get())) {
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+    MutableHandle<SegmentedArray> table{runtime};
+    uint32_t index = 0;
+    GCScopeMarkerRAII marker{runtime};
+    for (;; ++index) {
+      marker.flush();
+      SegmentedArray *tablePtr = table.get();
+      if (!self->storage_.get(runtime)->iteratorNext(
+              runtime, tablePtr, index)) {
+        break;
+      }
+      table = tablePtr;
+      HermesValue key = OrderedHashMap::keyAt(tablePtr, index);
+      HermesValue value = OrderedHashMap::valueAt(tablePtr, index);
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -215,18 +224,17 @@ class JSMapIteratorImpl final : public JSObject {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.get(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          &runtime->getHeap());
-      if (self->itr_) {
+      SegmentedArray *table = self->itrTable_.get(runtime);
+      uint32_t index = self->itrIndex_;
+      if (self->data_.get(runtime)->iteratorNext(runtime, table, index)) {
+        self->itrTable_.set(runtime, table, &runtime->getHeap());
+        self->itrIndex_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.get(runtime)->key;
+            value = OrderedHashMap::keyAt(table, index);
             break;
           case IterationKind::Value:
-            value = self->itr_.get(runtime)->value;
+            value = OrderedHashMap::valueAt(table, index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
@@ -236,9 +244,11 @@ class JSMapIteratorImpl final : public JSObject {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = runtime->makeHandle(std::move(*arrRes));
-            value = self->itr_.get(runtime)->key;
+            table = self->itrTable_.getNonNull(runtime);
+            value = OrderedHashMap::keyAt(table, index);
             JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.get(runtime)->value;
+            value = OrderedHashMap::valueAt(
+                self->itrTable_.getNonNull(runtime), index);
             JSArray::setElementAt(arrHandle, runtime, 1, value);
             value = arrHandle.getHermesValue();
             break;
@@ -252,6 +262,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_ = nullptr;
+        self->itrTable_ = nullptr;
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -281,8 +292,13 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The entry table of the Map that itrIndex_ refers to. It is nullptr
+  /// before the iteration starts, and may be a table that the Map has since
+  /// replaced.
+  GCPointer<SegmentedArray> itrTable_{nullptr};
+
+  /// The index in itrTable_ of the next entry to look at.
+  uint32_t itrIndex_{0};
 
   IterationKind iterationKind_;
 
@@ -311,6 +311,7 @@ struct ObjectVTable {
 /// available.
 class JSObject : public GCCell {
   friend void ObjectBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend struct ObjectOffsets;
 
  protected:
   /// A light-weight constructor which performs no GC allocations. Its purpose
@@ -813,14 +814,14 @@ class JSObject : public GCCell {
   /// The following three methods implement ES5.1 8.12.3.
   /// getNamed is an optimized path for getting a property with a SymbolID when
   /// it is statically known that the SymbolID is not index-like.
-  /// If \p cacheEntry is not null, and the result is suitable for use in a
+  /// If \p cache is not null, and the result is suitable for use in a
   /// property cache, populate the cache.
   static CallResult<HermesValue> getNamed_RJS(
       Handle<JSObject> selfHandle,
       Runtime *runtime,
       SymbolID name,
       PropOpFlags opFlags = PropOpFlags(),
-      PropertyCacheEntry *cacheEntry = nullptr);
+      PolymorphicPropertyCache *cache = nullptr);
 
   /// Like getNamed, but with a \c receiver.  The receiver is
   /// generally only relevant when JavaScript code is executed.  If an
@@ -834,7 +835,7 @@ class JSObject : public GCCell {
       SymbolID name,
       Handle<> receiver,
       PropOpFlags opFlags = PropOpFlags(),
-      PropertyCacheEntry *cacheEntry = nullptr);
+      PolymorphicPropertyCache *cache = nullptr);
 
   // getNamedOrIndexed accesses a property with a SymbolIDs which may be
   // index-like.
@@ -1092,6 +1093,12 @@ class JSObject : public GCCell {
       PropertyFlags flagsToSet,
       OptValue<llvm::ArrayRef<SymbolID>> props);
 
+  /// Switch \p selfHandle to a dictionary class whose slots are property
+  /// cells, so that inline caches keep hitting its properties no matter how
+  /// many there are, until they are deleted or reconfigured. Meant for the
+  /// global object.
+  static void usePropertyCells(Handle<JSObject> selfHandle, Runtime *runtime);
+
   /// First call \p indexedCB, passing each indexed property's \c uint32_t
   /// index and \c ComputedPropertyDescriptor. Then call \p namedCB passing each
   /// named property's \c SymbolID and \c  NamedPropertyDescriptor as
@@ -1429,6 +1436,12 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
     uint32_t &beginIndex,
     uint32_t &endIndex);
 
+/// \return true if \p arr is the for-in cache of the class of \p obj, and
+/// \p obj's prototypes still have the classes recorded in it.  Every name
+/// that getForInPropertyNames listed in \p arr is then still a property of
+/// \p obj, so for-in need not look each one up again.
+bool isForInCacheValid(Runtime *runtime, JSObject *obj, BigStorage *arr);
+
 /// This object is the value of a property which has a getter and/or setter.
 class PropertyAccessor final : public GCCell {
  protected:
@@ -1704,9 +1717,9 @@ inline CallResult<HermesValue> JSObject::getNamed_RJS(
     Runtime *runtime,
     SymbolID name,
     PropOpFlags opFlags,
-    PropertyCacheEntry *cacheEntry) {
+    PolymorphicPropertyCache *cache) {
   return getNamedWithReceiver_RJS(
-      selfHandle, runtime, name, selfHandle, opFlags, cacheEntry);
+      selfHandle, runtime, name, selfHandle, opFlags, cache);
 }
 
 inline CallResult<HermesValue> JSObject::getComputed_RJS(
@@ -69,14 +69,16 @@ class JSRegExp final : public JSObject {
   /// error. If valid, set the source and flags to the given strings, and set
   /// the standard properties of the RegExp according to the flags. Note that
   /// RegExps are not mutable (with the exception of the lastIndex property).
-  /// If \p bytecode is given, initialize the regex with that bytecode.
-  /// Otherwise compile the pattern and flags into a new regexp.
+  /// If \p bytecode is given, initialize the regex with that bytecode, and if
+  /// \p cacheBytecode is set, add it to the runtime's RegExpCache. Otherwise
+  /// compile the pattern and flags into a new regexp.
   static ExecutionStatus initialize(
       Handle<JSRegExp> selfHandle,
       Runtime *runtime,
       Handle<StringPrimitive> pattern,
       Handle<StringPrimitive> flags,
-      OptValue<llvm::ArrayRef<uint8_t>> bytecode = llvm::None);
+      OptValue<llvm::ArrayRef<uint8_t>> bytecode = llvm::None,
+      bool cacheBytecode = false);
 
   /// \return the pattern string used to initialize this RegExp.
   /// Note this is not suitable for interpolation between //, nor for
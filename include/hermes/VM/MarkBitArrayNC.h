@@ -15,6 +15,8 @@
 
 #include "llvm/Support/MathExtras.h"
 
+#include <atomic>
+
 namespace hermes {
 namespace vm {
 
@@ -56,6 +58,10 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Like mark, but safe to call from several threads at once.
+  /// \return true if this call set the bit, false if it was already set.
+  inline bool markAtomic(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -147,6 +153,20 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_[ind / kBitsPerVal] |= (size_t)1 << (ind % kBitsPerVal);
 }
 
+bool MarkBitArrayNC::markAtomic(size_t ind) {
+  assert(
+      ind < kValidIndices &&
+      "precondition: ind must be within the index range");
+  static_assert(
+      sizeof(std::atomic<size_t>) == sizeof(size_t),
+      "Bit array words must be usable as atomics");
+
+  const size_t mask = (size_t)1 << (ind % kBitsPerVal);
+  auto *word =
+      reinterpret_cast<std::atomic<size_t> *>(&bitArray_[ind / kBitsPerVal]);
+  return !(word->fetch_or(mask, std::memory_order_relaxed) & mask);
+}
+
 void MarkBitArrayNC::clear() {
   ::memset(bitArray_, 0, sizeof(bitArray_));
 }
@@ -252,6 +252,29 @@ class OldGen : public GCGeneration {
   /// youngGen, and apply the current mark function to them.
   void markYoungGenPointers(Location originalLevel);
 
+  /// The part of a segment whose dirty cards are scanned by
+  /// markYoungGenPointers.  Unlike the segment itself, it remains valid while
+  /// promotion adds segments to the generation.
+  struct YoungGenPointerRegion {
+    char *lowLim;
+    char *hiLim;
+    char *start;
+    /// The level of the segment at the start of the collection.
+    const char *level;
+  };
+
+  /// \return the regions that markYoungGenPointers scans, if the level of the
+  /// generation was \p originalLevel at the start of the collection.
+  std::vector<YoungGenPointerRegion> youngGenPointerRegions(
+      Location originalLevel);
+
+  /// Scan the dirty cards of \p region, as markYoungGenPointers does, using
+  /// \p acceptor to evacuate the referents.  Different regions may be scanned
+  /// on different threads at the same time.
+  void markYoungGenPointersInRegion(
+      const YoungGenPointerRegion &region,
+      YoungGen::ParallelEvacAcceptor &acceptor);
+
   /// Complete an in-progress young-gen collection.  Some number of
   /// young-gen objects have been found reachable and promoted into
   /// the current generation (e.g., by root or card scanning).  The
@@ -391,6 +414,13 @@ class OldGen : public GCGeneration {
   /// segment, collection, etc).
   void updateCardTableBoundary();
 
+  /// Implementation of markYoungGenPointersInRegion, for the serial and
+  /// parallel evacuation acceptors.
+  template <typename Acceptor>
+  void markYoungGenPointersInRegionImpl(
+      const YoungGenPointerRegion &region,
+      Acceptor &acceptor);
+
   /// Slow path for allocation: allocation in the current allocation
   /// segment failed.  Attempt in the next segment, if one exists,
   /// returning a failure if no it does not.
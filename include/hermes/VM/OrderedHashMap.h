@@ -9,80 +9,29 @@
 #define HERMES_VM_ORDERED_HASHMAP_H
 
 #include "hermes/Support/ErrorHandling.h"
-#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/SegmentedArray.h"
 
 #include <vector>
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
- public:
-  static VTable vt;
-
-  /// The key.
-  GCHermesValue key;
-
-  /// The value.
-  GCHermesValue value;
-
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
-
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
-
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
-
-  static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
-  }
-
-  static CallResult<HermesValue> create(Runtime *runtime);
-
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
-  }
-
-  /// Mark this entry as deleted.
-  void markDeleted() {
-    key.setNonPtr(HermesValue::encodeEmptyValue());
-    value.setNonPtr(HermesValue::encodeEmptyValue());
-  }
-
- protected:
-#ifdef HERMESVM_SERIALIZE
-  explicit HashMapEntry(Deserializer &d);
-
-  friend void HashMapEntryDeserialize(Deserializer &d, CellKind kind);
-#endif
-
-  HashMapEntry(Runtime *runtime) : GCCell(&runtime->getHeap(), &vt) {}
-}; // HashMapEntry
-
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// It is a deterministic hash table: the entries live in a flat SegmentedArray
+/// in insertion order, and a second SegmentedArray of buckets holds the index
+/// of the most recently inserted entry of each hash chain. Every entry takes
+/// \c kEntrySize slots in the entry table: its key, its value, and the index
+/// of the next entry in its chain.
+///
+/// Deleting an entry empties its slots in place, so entry indices remain
+/// stable and an iteration is simply a walk over increasing indices.
+/// When the entry table is full, or mostly deleted entries, it is replaced by
+/// a new one holding only the live entries. The old table is then retired:
+/// its header points to its successor, so that an iterator still referring
+/// to it can translate its index (by discounting the deleted entries before
+/// it) and carry on in the new table. Retired tables are kept alive by such
+/// iterators only.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -111,12 +60,8 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
-
-  /// Insert a key/value pair into the map, if not already existing.
+  /// Insert a key/value pair into the map, or update the value if the key
+  /// already exists.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
       Runtime *runtime,
@@ -127,49 +72,86 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime *runtime);
+  /// Clear the map.
+  static void clear(Handle<OrderedHashMap> self, Runtime *runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry = nullptr)
+  /// Find the first live entry at or after the iteration position (\p table,
+  /// \p index), and update the position to refer to it. A null \p table
+  /// starts a new iteration. A table that has been replaced since the
+  /// position was recorded is followed to the current one.
+  /// \return false if there are no more entries.
+  bool iteratorNext(Runtime *runtime, SegmentedArray *&table, uint32_t &index)
       const;
 
+  /// \return the key of the entry at \p index in \p table.
+  static HermesValue keyAt(const SegmentedArray *table, uint32_t index) {
+    return table->at(slot(index, kKeyField));
+  }
+
+  /// \return the value of the entry at \p index in \p table.
+  static HermesValue valueAt(const SegmentedArray *table, uint32_t index) {
+    return table->at(slot(index, kValueField));
+  }
+
  protected:
-  OrderedHashMap(Runtime *runtime, Handle<ArrayStorage> hashTableStorage);
+  OrderedHashMap(
+      Runtime *runtime,
+      Handle<SegmentedArray> hashTable,
+      Handle<SegmentedArray> entries);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorage> hashTable_{nullptr};
+  /// @name Layout of the entry table.
+  /// @{
+
+  /// Once the table is retired, the table that replaced it. Empty otherwise.
+  static constexpr uint32_t kNextTableSlot = 0;
+  /// Once the table is retired, true if it was retired by \c clear().
+  static constexpr uint32_t kClearedSlot = 1;
+  /// The number of entries that have been used, deleted or not, as a native
+  /// uint32.
+  static constexpr uint32_t kUsedSlot = 2;
+  static constexpr uint32_t kHeaderSize = 3;
+
+  static constexpr uint32_t kKeyField = 0;
+  static constexpr uint32_t kValueField = 1;
+  /// The index of the next entry in the same hash chain, as a native uint32,
+  /// or empty at the end of the chain.
+  static constexpr uint32_t kChainField = 2;
+  static constexpr uint32_t kEntrySize = 3;
+
+  /// @}
+
+  /// \return the index in the entry table of \p field of entry \p index.
+  static uint32_t slot(uint32_t index, uint32_t field) {
+    return kHeaderSize + index * kEntrySize + field;
+  }
 
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
+  /// \return the number of entries that have been used in \p table.
+  static uint32_t usedEntries(const SegmentedArray *table) {
+    return table->at(kUsedSlot).getNativeUInt32();
+  }
+
+  /// The buckets: each is the index of the first entry of its chain, as a
+  /// native uint32, or empty. There are half as many buckets as entries.
+  GCPointer<SegmentedArray> hashTable_{nullptr};
 
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+  /// The current entry table, with room for capacity_ entries.
+  GCPointer<SegmentedArray> entries_{nullptr};
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  /// Initial number of entries in the entry table.
+  static constexpr uint32_t INITIAL_CAPACITY = 8;
 
   /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  /// TODO(T31421960): Use constexpr std::min.
+  /// SegmentedArray.
   static constexpr uint32_t MAX_CAPACITY =
-      ArrayStorage::maxElements() < UINT32_MAX / 4 ? ArrayStorage::maxElements()
-                                                   : UINT32_MAX / 4;
+      (SegmentedArray::maxElements() - kHeaderSize) / kEntrySize;
 
-  /// Capacity of the hash table.
+  /// Number of entries the entry table can hold, always a power of 2.
   uint32_t capacity_{INITIAL_CAPACITY};
 
   /// Number of alive entries in the storage.
@@ -179,25 +161,27 @@ class OrderedHashMap final : public GCCell {
   static uint32_t
   hashToBucket(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key) {
     auto hash = runtime->gcStableHashHermesValue(key);
-    assert(
-        (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-        "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+    return hash & (self->capacity_ / 2 - 1);
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime *runtime, HashMapEntry *entry, GC *gc);
+  /// Lookup the entry with key \p key in a given \p bucket.
+  /// \return its index, or None if there is none.
+  OptValue<uint32_t>
+  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key) const;
 
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key);
+  /// Allocate empty bucket and entry tables for \p capacity entries.
+  static ExecutionStatus allocateTables(
+      Runtime *runtime,
+      uint32_t capacity,
+      MutableHandle<SegmentedArray> &hashTable,
+      MutableHandle<SegmentedArray> &entries);
 
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
+  /// Replace the tables with ones for \p newCapacity entries, holding only
+  /// the live entries, and retire the old entry table.
+  static ExecutionStatus rehash(
       Handle<OrderedHashMap> self,
-      Runtime *runtime);
+      Runtime *runtime,
+      uint32_t newCapacity);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
@@ -59,10 +59,6 @@ inline uint32_t BasedPointer::getOffset() const {
   return segAndOffset_ & ((1 << AlignedStorage::kLogSize) - 1);
 }
 
-inline uint32_t BasedPointer::getRawValue() const {
-  return segAndOffset_;
-}
-
 inline void *PointerBase::basedToPointer(BasedPointer ptr) const {
   // The value
   char *segBase = reinterpret_cast<char *>(segmentMap_[ptr.getSegmentIndex()]);
@@ -64,6 +64,8 @@ class BasedPointer final {
 /// This is used to implement a mechanism where 32-bit offsets are used as
 /// pointers instead of a full pointer.
 class PointerBase {
+  friend struct RuntimeOffsets;
+
  public:
   /// Initialize the PointerBase.
   inline PointerBase();
@@ -148,6 +150,10 @@ inline bool BasedPointer::operator!=(BasedPointer other) const {
   return !(segAndOffset_ == other.segAndOffset_);
 }
 
+inline uint32_t BasedPointer::getRawValue() const {
+  return segAndOffset_;
+}
+
 inline PointerBase::PointerBase() {
   segmentMap_[kNullPtrSegmentIndex] = nullptr;
 }
@@ -8,6 +8,7 @@
 #ifndef INLINECACHE_PROFILER_H
 #define INLINECACHE_PROFILER_H
 
+#include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/SymbolID.h"
 #include "llvm/ADT/DenseMap.h"
 
@@ -25,6 +26,10 @@ class Runtime;
 
 class InlineCacheProfiler {
  public:
+  /// The number of values of PropertyCacheState.
+  static constexpr size_t kNumPropertyCacheStates =
+      static_cast<size_t>(PropertyCacheState::Megamorphic) + 1;
+
   using ClassId = uint64_t;
   using PropertyId = uint32_t;
   using ICSrcKey = std::pair<uint32_t, CodeBlock *>;
@@ -55,6 +60,16 @@ class InlineCacheProfiler {
       ++hitCount;
     }
 
+    /// Record that the inline cache at the source location was found in
+    /// \p newState, counting a transition if it was last seen in another.
+    void recordState(PropertyCacheState newState) {
+      if (newState != state) {
+        ++transitions[static_cast<size_t>(state)]
+                     [static_cast<size_t>(newState)];
+        state = newState;
+      }
+    }
+
     /// Total number of inline caching misses at the source location.
     uint64_t missCount{0};
 
@@ -64,6 +79,14 @@ class InlineCacheProfiler {
     /// Internal map that keeps track of the mapping between
     /// <property, object hidden class, cached hidden class> and its frequency.
     llvm::DenseMap<ICMissKey, uint64_t> hiddenClasses;
+
+    /// The state of the inline cache when the source location last ran.
+    PropertyCacheState state{PropertyCacheState::Uninitialized};
+
+    /// transitions[from][to] is the number of times the inline cache was seen
+    /// to move from state \c from to state \c to.
+    uint64_t transitions[kNumPropertyCacheStates][kNumPropertyCacheStates] =
+        {};
   };
 
   using ICMissList = std::vector<std::pair<ICSrcKey, ICMiss>>;
@@ -83,6 +106,13 @@ class InlineCacheProfiler {
   /// Record an inline caching hit.
   bool insertICHit(CodeBlock *codeblock, uint32_t instOffset);
 
+  /// Record the state of the inline cache at a source location, each time
+  /// the location runs.
+  void recordState(
+      CodeBlock *codeblock,
+      uint32_t instOffset,
+      PropertyCacheState state);
+
   /// Get the total number of inline caching misses.
   uint32_t getTotalMisses() {
     return totalMisses_;
@@ -139,6 +169,9 @@ class InlineCacheProfiler {
       Runtime *runtime,
       llvm::raw_ostream &ostream);
 
+  /// Dump the state transitions of the inline cache at a source location.
+  void dumpStateTransitions(ICMiss &icMiss, llvm::raw_ostream &ostream);
+
   /// Dump a inline caching miss record, which
   /// includes the hidden classes, property, and frequency.
   void dumpInlineCachingMissRecord(
@@ -9,13 +9,22 @@
 #define PROJECT_PROPERTYCACHE_H
 
 #include "hermes/VM/GCPointer.h"
+#include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/SymbolID.h"
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/ErrorHandling.h"
+
+#include <array>
+#include <cassert>
+
 namespace hermes {
 namespace vm {
 using SlotIndex = uint32_t;
 
 class HiddenClass;
+class JSObject;
+class Runtime;
 
 /// A cache entry for a property lookup.
 /// If the class operation that we are performing
@@ -29,6 +38,264 @@ struct PropertyCacheEntry {
   SlotIndex slot{0};
 };
 
+/// The states of the inline cache of a property access site, in the order a
+/// site moves through them as it sees objects of more classes.
+enum class PropertyCacheState : uint8_t {
+  /// No class has been cached.
+  Uninitialized,
+  /// One class has been cached.
+  Monomorphic,
+  /// Between two and PolymorphicPropertyCache::kNumEntries classes have been
+  /// cached.
+  Polymorphic,
+  /// More classes have been seen than the site can hold; misses are looked up
+  /// in the MegamorphicPropertyCache.
+  Megamorphic,
+};
+
+/// \return a printable name for \p state.
+inline const char *propertyCacheStateName(PropertyCacheState state) {
+  switch (state) {
+    case PropertyCacheState::Uninitialized:
+      return "uninitialized";
+    case PropertyCacheState::Monomorphic:
+      return "monomorphic";
+    case PropertyCacheState::Polymorphic:
+      return "polymorphic";
+    case PropertyCacheState::Megamorphic:
+      return "megamorphic";
+  }
+  llvm_unreachable("invalid PropertyCacheState");
+}
+
+/// The inline cache of one property access site: up to kNumEntries classes,
+/// each with the slot of the property in objects of that class.  Once the
+/// site sees more classes than that, it becomes megamorphic and stops adding
+/// entries; the entries it has still hit.
+class PolymorphicPropertyCache {
+ public:
+  using ClassStorageType = GCPointer<HiddenClass>::StorageType;
+
+  /// The most classes cached by one site.
+  static constexpr unsigned kNumEntries = 4;
+
+  /// \return the entry for \p clazz, or null if it is not cached.
+  const PropertyCacheEntry *find(ClassStorageType clazz) const {
+    assert(clazz && "Looking up a null class");
+    for (const PropertyCacheEntry &entry : entries_) {
+      if (entry.clazz == clazz) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Cache \p slot as the slot of the property in objects of class \p clazz.
+  /// If every entry is taken, the site becomes megamorphic instead.
+  /// \return false if the site is megamorphic, so nothing was cached.
+  bool add(ClassStorageType clazz, SlotIndex slot) {
+    assert(clazz && "Caching a null class");
+    if (megamorphic_) {
+      return false;
+    }
+    PropertyCacheEntry *free = nullptr;
+    for (PropertyCacheEntry &entry : entries_) {
+      if (entry.clazz == clazz) {
+        entry.slot = slot;
+        return true;
+      }
+      if (!entry.clazz && !free) {
+        free = &entry;
+      }
+    }
+    if (!free) {
+      megamorphic_ = true;
+      return false;
+    }
+    free->clazz = clazz;
+    free->slot = slot;
+    return true;
+  }
+
+  /// \return whether the site has seen more classes than it can cache.
+  bool isMegamorphic() const {
+    return megamorphic_;
+  }
+
+  /// \return the current state of the site.  Entries whose class was
+  /// collected no longer count.
+  PropertyCacheState getState() const {
+    if (megamorphic_) {
+      return PropertyCacheState::Megamorphic;
+    }
+    unsigned numClasses = 0;
+    for (const PropertyCacheEntry &entry : entries_) {
+      numClasses += entry.clazz ? 1 : 0;
+    }
+    return numClasses == 0 ? PropertyCacheState::Uninitialized
+        : numClasses == 1  ? PropertyCacheState::Monomorphic
+                           : PropertyCacheState::Polymorphic;
+  }
+
+  /// \return the first cached class, or null if there is none.
+  ClassStorageType getFirstClass() const {
+    for (const PropertyCacheEntry &entry : entries_) {
+      if (entry.clazz) {
+        return entry.clazz;
+      }
+    }
+    return ClassStorageType{};
+  }
+
+  /// \return the entries, so the GC can update or clear their classes.
+  llvm::MutableArrayRef<PropertyCacheEntry> entries() {
+    return entries_;
+  }
+
+ private:
+  PropertyCacheEntry entries_[kNumEntries];
+
+  /// Set once the site has seen more than kNumEntries classes.
+  bool megamorphic_{false};
+};
+
+/// A runtime-wide cache from (class, property) to the slot of the property in
+/// objects of that class, which megamorphic sites consult when their own
+/// entries miss.  It is direct-mapped: adding an entry replaces whatever
+/// entry had the same hash.  Only own, non-accessor properties are cached.
+class MegamorphicPropertyCache {
+ public:
+  using ClassStorageType = GCPointer<HiddenClass>::StorageType;
+
+  struct Entry {
+    ClassStorageType clazz{};
+    SymbolID id{};
+    SlotIndex slot{0};
+    /// Whether the slot may be written through this entry: the property is
+    /// writable, has no internal setter, and the class can cache writes (see
+    /// HiddenClass::canCacheWrites()).
+    bool writable{false};
+  };
+
+  /// \return the entry for property \p id in class \p clazz, or null if it
+  /// is not cached.
+  const Entry *find(ClassStorageType clazz, SymbolID id) const {
+    const Entry &entry = entries_[index(clazz, id)];
+    return entry.clazz == clazz && entry.id == id ? &entry : nullptr;
+  }
+
+  /// Cache \p slot as the slot of property \p id in objects of class
+  /// \p clazz.  \p writable is as in Entry.
+  void add(ClassStorageType clazz, SymbolID id, SlotIndex slot, bool writable) {
+    assert(clazz && "Caching a null class");
+    Entry &entry = entries_[index(clazz, id)];
+    entry.clazz = clazz;
+    entry.id = id;
+    entry.slot = slot;
+    entry.writable = writable;
+  }
+
+  /// \return the entries, so the GC can update or clear their classes.
+  llvm::MutableArrayRef<Entry> entries() {
+    return entries_;
+  }
+
+ private:
+  /// The number of entries; a power of two.
+  static constexpr size_t kNumEntries = 1024;
+
+  static size_t index(ClassStorageType clazz, SymbolID id) {
+#ifdef HERMESVM_COMPRESSED_POINTERS
+    const uintptr_t rawClass = clazz.getRawValue();
+#else
+    const uintptr_t rawClass = reinterpret_cast<uintptr_t>(clazz);
+#endif
+    // Cells are heap-aligned, so the low bits of the class carry nothing.
+    return ((rawClass >> LogHeapAlign) ^ (id.unsafeGetRaw() * 0x9e3779b1u)) &
+        (kNumEntries - 1);
+  }
+
+  std::array<Entry, kNumEntries> entries_;
+};
+
+/// A runtime-wide cache of property lookups that went past the receiver:
+/// for a prototype and a property, either the object further up the chain
+/// that holds the property and its slot there, or the fact that no object
+/// in the chain has the property.  The caller must establish that the
+/// receiver has no own property of that name.
+///
+/// An entry is only valid while every prototype it walked still has the
+/// class it had when the entry was made, so each entry records the classes
+/// of those prototypes and a lookup checks them all.  Adding, deleting or
+/// reconfiguring a property of a prototype changes its class, except for
+/// additions to a dictionary; so no dictionary may appear in the chain,
+/// apart from a holder whose class may still be cached.  Like
+/// MegamorphicPropertyCache, the cache is direct-mapped, and only caches
+/// non-accessor properties.
+class ProtoChainPropertyCache {
+ public:
+  using ClassStorageType = GCPointer<HiddenClass>::StorageType;
+
+  /// The most prototypes an entry can walk.
+  static constexpr unsigned kMaxDepth = 4;
+
+  struct Entry {
+    /// The classes of the prototypes walked, starting at the prototype the
+    /// lookup starts at.  The first \c depth are valid.
+    ClassStorageType chain[kMaxDepth]{};
+    SymbolID id{};
+    /// The slot of the property in the last prototype walked, if found.
+    SlotIndex slot{0};
+    uint8_t depth{0};
+    /// Whether the last prototype walked holds the property.  If not, it
+    /// has no parent, and none of the prototypes have the property.
+    bool found{false};
+  };
+
+  /// Look up property \p id in \p proto and its prototypes.
+  /// \return false on a miss.  On a hit, \p holder is set to the object
+  /// that holds the property and \p slot to its slot; or, if no object in
+  /// the chain has the property, \p holder is set to null.
+  bool find(
+      Runtime *runtime,
+      JSObject *proto,
+      SymbolID id,
+      JSObject *&holder,
+      SlotIndex &slot) const;
+
+  /// Cache the result of looking up property \p id in \p proto and its
+  /// prototypes: \p holder is the object in that chain that holds the
+  /// property, at \p slot, or null if none does.  Lookups that cannot be
+  /// cached are ignored.
+  void add(
+      Runtime *runtime,
+      JSObject *proto,
+      SymbolID id,
+      JSObject *holder,
+      SlotIndex slot);
+
+  /// \return the entries, so the GC can update or clear their classes.
+  llvm::MutableArrayRef<Entry> entries() {
+    return entries_;
+  }
+
+ private:
+  /// The number of entries; a power of two.
+  static constexpr size_t kNumEntries = 512;
+
+  static size_t index(ClassStorageType clazz, SymbolID id) {
+#ifdef HERMESVM_COMPRESSED_POINTERS
+    const uintptr_t rawClass = clazz.getRawValue();
+#else
+    const uintptr_t rawClass = reinterpret_cast<uintptr_t>(clazz);
+#endif
+    return ((rawClass >> LogHeapAlign) ^ (id.unsafeGetRaw() * 0x9e3779b1u)) &
+        (kNumEntries - 1);
+  }
+
+  std::array<Entry, kNumEntries> entries_;
+};
+
 } // namespace vm
 } // namespace hermes
 #endif // PROJECT_PROPERTYCACHE_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A runtime-wide cache of compiled regular expression bytecode, so that
+/// RegExps built repeatedly from the same source are parsed and compiled
+/// only once. Entries are keyed by the pattern and by the syntax flags it was
+/// compiled with, and evicted in least recently used order once there are
+/// more than a fixed number of them.
+class RegExpCache {
+ public:
+  /// A cache key: the syntax flags as the first character, then the pattern.
+  using Key = std::u16string;
+
+  /// Create a cache holding at most \p capacity entries. A capacity of 0
+  /// disables the cache.
+  explicit RegExpCache(unsigned capacity) : capacity_(capacity) {}
+
+  /// \return false if the cache has no capacity, and never holds anything.
+  bool isEnabled() const {
+    return capacity_ != 0;
+  }
+
+  /// \return the key for \p pattern compiled with \p syntaxFlags.
+  static Key makeKey(llvm::ArrayRef<char16_t> pattern, uint8_t syntaxFlags) {
+    Key key;
+    key.reserve(pattern.size() + 1);
+    key.push_back(syntaxFlags);
+    key.append(pattern.begin(), pattern.end());
+    return key;
+  }
+
+  /// \return the bytecode cached for \p key, or an empty ArrayRef if there is
+  /// none. The entry becomes the most recently used. The bytecode is valid
+  /// until the next call to \c insert().
+  llvm::ArrayRef<uint8_t> find(const Key &key);
+
+  /// Cache \p bytecode for \p key, replacing any previous bytecode, and evict
+  /// the least recently used entry if the cache is full.
+  void insert(const Key &key, llvm::ArrayRef<uint8_t> bytecode);
+
+  /// Remove all entries.
+  void clear();
+
+  /// \return the number of entries in the cache.
+  size_t size() const {
+    return map_.size();
+  }
+
+  /// \return the number of bytes of bytecode held by the cache.
+  size_t getBytecodeSize() const {
+    return bytecodeSize_;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    std::vector<uint8_t> bytecode;
+  };
+
+  /// The entries, most recently used first.
+  std::list<Entry> entries_;
+
+  /// Map from key to entry in entries_.
+  std::unordered_map<Key, std::list<Entry>::iterator> map_;
+
+  /// Maximum number of entries.
+  const unsigned capacity_;
+
+  /// Sum of the bytecode sizes of the entries.
+  size_t bytecodeSize_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
@@ -31,6 +31,7 @@
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/RuntimeStats.h"
@@ -303,6 +304,21 @@ class Runtime : public HandleRootOwner,
   /// the builtins header header.
   inline NativeFunction *getBuiltinNativeFunction(unsigned builtinMethodID);
 
+  /// \return the cache of compiled RegExp bytecode.
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
+  /// \return the cache consulted by megamorphic property access sites.
+  MegamorphicPropertyCache &getMegamorphicPropertyCache() {
+    return megamorphicPropCache_;
+  }
+
+  /// \return the cache of property lookups on prototype chains.
+  ProtoChainPropertyCache &getProtoChainPropertyCache() {
+    return protoChainPropCache_;
+  }
+
   IdentifierTable &getIdentifierTable() {
     return identifierTable_;
   }
@@ -670,6 +686,11 @@ class Runtime : public HandleRootOwner,
   /// Track time spent of each opcode in the interpreter, in CPU cycles.
   uint64_t timeSpent[256] = {0};
 
+  /// Track how often each opcode is immediately followed by each other opcode
+  /// in the interpreter, indexed by the first opcode and then the second. The
+  /// most frequent pairs are candidates for superinstructions.
+  uint32_t opcodePairFrequency[256][256] = {{0}};
+
   /// Dump opcode stats to a stream.
   void dumpOpcodeStats(llvm::raw_ostream &os) const;
 #endif
@@ -745,6 +766,12 @@ class Runtime : public HandleRootOwner,
     return vmExperimentFlags_;
   }
 
+  /// \return whether the identifiers of persistent modules are registered
+  /// when first used.
+  bool hasLazyIdentifiers() const {
+    return lazyIdentifiers_;
+  }
+
   // Return a reference to the runtime's CrashManager.
   inline CrashManager &getCrashManager();
 
@@ -797,13 +824,15 @@ class Runtime : public HandleRootOwner,
   /// collected.
   void preventHCGC(HiddenClass *hc);
 
-  /// Inserts Hidden Classes into InlineCacheProfiler
+  /// Inserts Hidden Classes into InlineCacheProfiler, along with the state
+  /// \p cacheState of the inline cache of the site.
   void recordHiddenClass(
       CodeBlock *codeBlock,
       const Inst *cacheMissInst,
       SymbolID symbolID,
       HiddenClass *objectHiddenClass,
-      HiddenClass *cachedHiddenClass);
+      HiddenClass *cachedHiddenClass,
+      PropertyCacheState cacheState);
 
   /// Resolve HiddenClass pointers from its hidden class Id.
   HiddenClass *resolveHiddenClassId(ClassId classId);
@@ -978,6 +1007,10 @@ class Runtime : public HandleRootOwner,
   // Signal-based I/O tracking. Slows down execution.
   const bool trackIO_;
 
+  /// Set to true if the identifiers of persistent modules should be
+  /// registered when first used.
+  const bool lazyIdentifiers_;
+
   /// This value can be passed to the runtime as flags to test experimental
   /// features. Each experimental feature decides how to interpret these
   /// values. Generally each experiment is associated with one or more bits of
@@ -1020,6 +1053,9 @@ class Runtime : public HandleRootOwner,
   /// Set of runtime statistics.
   instrumentation::RuntimeStats runtimeStats_;
 
+  /// Compiled RegExp bytecode, by pattern and flags.
+  RegExpCache regExpCache_;
+
   /// Shared location to place native objects required by JSLib
   std::shared_ptr<RuntimeCommonStorage> commonStorage_;
 
@@ -1094,6 +1130,12 @@ class Runtime : public HandleRootOwner,
   /// Cache for property lookups in non-JS code.
   PropertyCacheEntry fixedPropCache_[(size_t)PropCacheID::_COUNT];
 
+  /// Cache for property lookups at megamorphic GetById/PutById sites.
+  MegamorphicPropertyCache megamorphicPropCache_;
+
+  /// Cache for GetById lookups that go past the receiver.
+  ProtoChainPropertyCache protoChainPropCache_;
+
   /// StringPrimitive representation of the first 256 characters.
   /// These are allocated as "long-lived" objects, so they don't need
   /// to be scanned as roots in young-gen collections.
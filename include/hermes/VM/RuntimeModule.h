@@ -17,6 +17,7 @@
 #include "hermes/VM/StringRefUtils.h"
 #include "hermes/VM/WeakRef.h"
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/simple_ilist.h"
 
 namespace hermes {
@@ -80,6 +81,25 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// SymbolID.
   std::vector<SymbolID> stringIDMap_;
 
+  /// A run of consecutive identifiers in the string table. Their precomputed
+  /// hashes are consecutive too.
+  struct IdentifierRun {
+    /// The string ID of the first identifier.
+    StringID firstStringID;
+    /// The number of identifiers.
+    uint32_t count;
+    /// The index of the hash of the first identifier.
+    uint32_t firstHashIndex;
+  };
+
+  /// The runs of identifiers in the string table, sorted by string ID. It is
+  /// only populated if the identifiers are registered when first used, which
+  /// requires their precomputed hashes to be found by string ID.
+  std::vector<IdentifierRun> identifierRuns_{};
+
+  /// The number of entries of stringIDMap_ which have been mapped to symbols.
+  uint32_t numMappedStrings_{0};
+
   /// Weak pointer to a GC-managed Domain that owns this RuntimeModule.
   /// NOTE: This will not be made invalid through marking, because the domain
   /// updates the WeakRefs on the RuntimeModule when it is marked.
@@ -121,6 +141,9 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// A map from template object ids to template objects.
   llvm::DenseMap<uint32_t, JSObject *> templateMap_;
 
+  /// The regexp ids whose bytecode has been added to the RegExpCache.
+  llvm::BitVector regExpsCached_;
+
   /// Registers the created RuntimeModule with \p domain, resulting in
   /// \p domain owning it. The RuntimeModule will be freed when the
   /// domain is collected..
@@ -238,12 +261,27 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// For opcodes that use a stringID as identifier explicitly, we know that
   /// the compiler would have marked the stringID as identifier, and hence
   /// we should have created the symbol during identifier table initialization.
-  /// The symbol must already exist in the map. This is a fast path.
+  /// The symbol must already exist in the map, unless the identifiers are
+  /// registered when first used, which doesn't allocate. This is a fast path.
   SymbolID getSymbolIDMustExist(StringID stringID) {
-    assert(
-        stringIDMap_[stringID].isValid() &&
-        "Symbol must exist for this string ID");
-    return stringIDMap_[stringID];
+    SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid())) {
+      id = registerLazyIdentifier(stringID);
+    }
+    return id;
+  }
+
+  /// \return whether the identifiers of this module are registered when first
+  /// used rather than when it is loaded.
+  bool hasLazyIdentifiers() const {
+    return !identifierRuns_.empty();
+  }
+
+  /// \return the number of strings of this module which have been mapped to
+  /// symbols, which includes every identifier unless they are registered
+  /// lazily.
+  uint32_t getNumMappedStrings() const {
+    return numMappedStrings_;
   }
 
   /// \return the \c SymbolID for a string by string index. The symbol may not
@@ -254,7 +292,8 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     if (LLVM_UNLIKELY(!id.isValid())) {
       // Materialize this lazily created symbol.
       auto entry = bcProvider_->getStringTableEntry(stringID);
-      id = createSymbolFromStringIDMayAllocate(stringID, entry, llvm::None);
+      id = createSymbolFromStringIDMayAllocate(
+          stringID, entry, getIdentifierHash(stringID));
     }
     assert(id.isValid() && "Failed to create symbol for stringID");
     return id;
@@ -272,6 +311,10 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   llvm::ArrayRef<uint8_t> getRegExpBytecodeFromRegExpID(
       uint32_t regExpId) const;
 
+  /// \return true the first time it is called for \p regExpId, so that the
+  /// bytecode of each regexp is added to the RegExpCache only once.
+  bool markRegExpCached(uint32_t regExpId);
+
   /// \return the number of functions in the function map.
   uint32_t getNumCodeBlocks() const {
     return functionMap_.size();
@@ -285,6 +328,13 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return getCodeBlockSlowPath(index);
   }
 
+  /// \return the CodeBlock for a function by function index if it has
+  /// already been created, nullptr otherwise. Unlike getCodeBlockMayAllocate,
+  /// this never modifies the module.
+  CodeBlock *getCodeBlockIfCreated(unsigned index) const {
+    return functionMap_[index];
+  }
+
   /// \return whether this RuntimeModule has been initialized.
   bool isInitialized() const {
     return !bcProvider_->isLazy();
@@ -443,6 +493,15 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
       const StringTableEntry &entry,
       OptValue<uint32_t> mhash);
 
+  /// Register the identifier \p stringID, which has not been used yet, in the
+  /// identifier table without allocating. This module must have lazy
+  /// identifiers. \return its symbol ID.
+  SymbolID registerLazyIdentifier(StringID stringID);
+
+  /// \return the precomputed hash of the identifier \p stringID, or None if
+  /// it is not an identifier or the hashes are no longer available.
+  OptValue<uint32_t> getIdentifierHash(StringID stringID) const;
+
   /// \return a unqiue hash key for object literal hidden class cache.
   /// \param keyBufferIndex value of NewObjectWithBuffer instruction(must be
   /// less than 2^24).
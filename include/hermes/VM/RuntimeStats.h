@@ -51,6 +51,24 @@ struct RuntimeStats {
   /// Measure of of jsi Function calls (incoming to VM).
   Statistic incomingFunction;
 
+  /// Measure of source compilation in prepareJavaScript.
+  Statistic compileJS;
+
+  /// Number of for-in loops whose property names were found in the for-in
+  /// cache of the object's hidden class, and number that had to build them.
+  uint64_t forInCacheHits{0};
+  uint64_t forInCacheMisses{0};
+
+  /// Number of RegExps whose bytecode was found in the RegExp cache, and
+  /// number that had to be compiled.
+  uint64_t regExpCacheHits{0};
+  uint64_t regExpCacheMisses{0};
+
+  /// Number of prepareJavaScript calls whose bytecode was found in the
+  /// bytecode cache, and number that had to compile the source.
+  uint64_t bytecodeCacheHits{0};
+  uint64_t bytecodeCacheMisses{0};
+
   /// The topmost RAIITimer in the stack.
   RAIITimer *timerStack{nullptr};
 
@@ -21,7 +21,7 @@ enum class RelocationKind { NativePointer, GCPointer, HermesValue };
 
 constexpr uint32_t SD_MAGIC = 0xad082463;
 
-constexpr uint32_t SD_HEADER_VERSION = 2;
+constexpr uint32_t SD_HEADER_VERSION = 3;
 
 constexpr uint32_t NATIVE_FUNCTION_VERSION = NATIVE_FUNCTION_VERSION_VALUE;
 
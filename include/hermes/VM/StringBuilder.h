@@ -120,6 +120,7 @@ class StringBuilder {
     assert(
         index_ + length <= strPrim_->getStringLength() &&
         "StringBuilder append out of bound");
+    StringPrimitive::ensureFlat(runtime_, other);
     if (other->isASCII()) {
       appendASCIIRef({other->castToASCIIPointer(), length});
     } else if (!strPrim_->isASCII()) {
@@ -35,6 +35,8 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   friend class StringView;
   template <typename T>
   friend class BufferedStringPrimitive;
+  template <typename T>
+  friend class RopeStringPrimitive;
 
   friend llvm::raw_ostream &operator<<(
       llvm::raw_ostream &OS,
@@ -248,20 +250,13 @@ class StringPrimitive : public VariableSizeRuntimeCell {
       size_t length);
 
   /// Flatten the string if it's a rope, possibly causing allocation/GC.
-  static Handle<StringPrimitive> ensureFlat(
+  static inline Handle<StringPrimitive> ensureFlat(
       Runtime *runtime,
-      Handle<StringPrimitive> self) {
-    // In the future, ensureFlat may trigger GC as it might allocate for
-    // ropes. Move the heap here.
-    runtime->potentiallyMoveHeap();
-    return self;
-    // TODO: Deal with different subclasses (e.g. rope)
-  }
+      Handle<StringPrimitive> self);
 
-  /// \return true if the string is flat.
-  bool isFlat() const {
-    return true;
-  }
+  /// \return true if the string is flat, i.e. it is not a rope whose
+  /// characters haven't been gathered yet.
+  inline bool isFlat() const;
 
   /// \return a StringView of this string. In the case of a rope, we will need
   /// to resolve the rope, which might involve object allocations.
@@ -276,6 +271,7 @@ class StringPrimitive : public VariableSizeRuntimeCell {
 
   /// \return the character at \p index.
   /// Use it only when you cannot use a StringView.
+  /// \pre the string is flat, see ensureFlat().
   inline char16_t at(uint32_t index) const;
 
   /// Whether this is an ASCII string.
@@ -286,6 +282,7 @@ class StringPrimitive : public VariableSizeRuntimeCell {
 
   /// Get a StringRef of T. T must be char or char16_t corresponding to whether
   /// this string is ASCII or UTF-16.
+  /// \pre the string is flat, see ensureFlat().
   template <typename T>
   llvm::ArrayRef<T> getStringRef() const {
     return llvm::ArrayRef<T>{castToPointer<T>(), getStringLength()};
@@ -297,6 +294,10 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// only be called in rare cases carefully.
   void copyUTF16String(char16_t *ptr) const;
 
+  /// Gather the characters of a rope and credit them to the GC of \p runtime.
+  /// \pre the string isn't flat.
+  void flatten(Runtime *runtime);
+
   /// Get a read-only raw char pointer, assert that this is ASCII string.
   const char *castToASCIIPointer() const;
 
@@ -640,6 +641,8 @@ class BufferedStringPrimitive final : public StringPrimitive {
   friend class IdentifierTable;
   friend class StringBuilder;
   friend class StringPrimitive;
+  template <typename U>
+  friend class RopeStringPrimitive;
   friend PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
       Runtime *runtime,
       Handle<StringPrimitive> leftHnd,
@@ -703,6 +706,17 @@ class BufferedStringPrimitive final : public StringPrimitive {
         "length exceeds size of concatenation buffer");
   }
 
+#ifdef HERMESVM_SERIALIZE
+  /// Construct a BufferedStringPrimitive with the specified length \p length,
+  /// whose concatenation buffer is then read by the deserializer.
+  BufferedStringPrimitive(Runtime *runtime, uint32_t length)
+      : StringPrimitive(
+            runtime,
+            &vt,
+            sizeof(BufferedStringPrimitive<T>),
+            length) {}
+#endif
+
   /// Allocate a BufferedStringPrimitive with the specified length \p length
   /// and the associated concatenation buffer \p storage. Note that the length
   /// of the primitive may be smaller than the length of the buffer.
@@ -764,20 +778,179 @@ class BufferedStringPrimitive final : public StringPrimitive {
   GCHermesValue concatBufferHV_;
 };
 
+/// An immutable JavaScript primitive representing the concatenation of two
+/// other strings, its children. Unlike BufferedStringPrimitive, which only
+/// helps when appending to the most recent result of a concatenation, a rope
+/// makes every concatenation with a large operand O(1): prepending, joining
+/// two large strings, or building a string out of a tree of concatenations.
+///
+/// The characters are gathered by ensureFlat(), which must be called before
+/// they are read through a raw pointer: they are copied to a malloc'd buffer
+/// owned by the rope and credited to the GC as external memory, and the
+/// children are released. Code without a runtime, such as comparisons, copies
+/// the characters of a rope which hasn't been flattened instead.
+/// The children may themselves be ropes. Their nesting is bounded by
+/// \c kMaxDepth, and flattening walks them with an explicit stack.
+template <typename T>
+class RopeStringPrimitive final : public StringPrimitive {
+  friend class StringPrimitive;
+  friend PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
+      Runtime *runtime,
+      Handle<StringPrimitive> leftHnd,
+      Handle<StringPrimitive> rightHnd);
+  friend void RopeASCIIStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend void RopeUTF16StringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+#ifdef HERMESVM_SERIALIZE
+  template <typename>
+  friend void serializeRopeStringImpl(Serializer &s, const GCCell *cell);
+
+  template <typename>
+  friend void deserializeRopeStringImpl(Deserializer &d);
+#endif
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::RopeUTF16StringPrimitiveKind
+        : CellKind::RopeASCIIStringPrimitiveKind;
+  }
+
+ public:
+  /// The maximum nesting of ropes. A concatenation which would exceed it is
+  /// copied to a concatenation buffer instead, which bounds the work deferred
+  /// to a single flatten and the length of the chains the GC has to mark.
+  /// Further appends go to that buffer in place, but prepending large strings
+  /// still copies the whole string once every \c kMaxDepth concatenations.
+  static constexpr uint32_t kMaxDepth = 1024;
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == RopeStringPrimitive::getCellKind();
+  }
+
+  /// \return true if the characters of the rope have been gathered.
+  bool isFlattened() const {
+    return flat_ != nullptr;
+  }
+
+  /// \return the nesting of ropes in this one, 1 if the children are flat and
+  /// 0 if the rope itself has been flattened.
+  uint32_t getDepth() const {
+    return depth_;
+  }
+
+  /// \return the first child.
+  /// \pre the rope hasn't been flattened.
+  StringPrimitive *getLeft() const {
+    assert(!isFlattened() && "flattened ropes have no children");
+    return vmcast<StringPrimitive>(leftHV_);
+  }
+
+  /// \return the second child.
+  /// \pre the rope hasn't been flattened.
+  StringPrimitive *getRight() const {
+    assert(!isFlattened() && "flattened ropes have no children");
+    return vmcast<StringPrimitive>(rightHV_);
+  }
+
+ private:
+  static const VTable vt;
+
+  /// Construct a rope of length \p length and depth \p depth, concatenating
+  /// \p left and \p right.
+  RopeStringPrimitive(
+      Runtime *runtime,
+      uint32_t length,
+      uint32_t depth,
+      StringPrimitive *left,
+      StringPrimitive *right)
+      : StringPrimitive(runtime, &vt, sizeof(RopeStringPrimitive<T>), length),
+        depth_(depth) {
+    leftHV_.set(HermesValue::encodeStringValue(left), &runtime->getHeap());
+    rightHV_.set(HermesValue::encodeStringValue(right), &runtime->getHeap());
+  }
+
+#ifdef HERMESVM_SERIALIZE
+  /// Construct a flattened rope of length \p length, which takes ownership of
+  /// the malloc'd characters \p flat.
+  RopeStringPrimitive(Runtime *runtime, uint32_t length, T *flat)
+      : StringPrimitive(runtime, &vt, sizeof(RopeStringPrimitive<T>), length),
+        depth_(0),
+        flat_(flat) {
+    leftHV_.setNonPtr(HermesValue::encodeEmptyValue());
+    rightHV_.setNonPtr(HermesValue::encodeEmptyValue());
+  }
+#endif
+
+  /// Allocate a rope concatenating \p leftHnd and \p rightHnd, or a
+  /// BufferedStringPrimitive if the rope would be nested too deeply.
+  /// \pre The types must be compatible with respect to T (cannot append UTF16
+  /// to ASCII) and the combined length must have been validated.
+  static PseudoHandle<StringPrimitive> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> leftHnd,
+      Handle<StringPrimitive> rightHnd);
+
+  /// \return a const pointer to the first character of the string.
+  /// \pre the rope has been flattened by ensureFlat().
+  const T *getRawPointer() const {
+    assert(flat_ && "ropes must be flattened by ensureFlat() first");
+    return flat_;
+  }
+
+  /// Copy the characters of the children to \c flat_, release them, and
+  /// credit \c flat_ to \p gc as external memory.
+  /// \pre the rope hasn't been flattened.
+  void flattenAndCredit(GC *gc);
+
+  /// \return the size of \c flat_ in bytes.
+  uint32_t flatSize() const {
+    return this->getStringLength() * sizeof(T);
+  }
+
+  static void _finalizeImpl(GCCell *cell, GC *gc);
+  static size_t _mallocSizeImpl(GCCell *cell);
+  static gcheapsize_t _externalMemorySizeImpl(const GCCell *cell);
+  static std::string _snapshotNameImpl(GCCell *cell, GC *gc);
+
+  /// The children, or empty once the rope has been flattened.
+  /// GCHermesValue is used for the same reason as in BufferedStringPrimitive.
+  GCHermesValue leftHV_;
+  GCHermesValue rightHV_;
+
+  /// The nesting of ropes in this one, see getDepth().
+  uint32_t depth_;
+
+  /// The characters, or null until the rope is flattened. The buffer lives in
+  /// the malloc heap, so that flattening doesn't move the rope.
+  T *flat_{nullptr};
+};
+
 /// \return true if this is one of the BufferedStringPrimitive classes.
 inline bool isBufferedStringPrimitive(const GCCell *cell) {
   return cell->getKind() == CellKind::BufferedUTF16StringPrimitiveKind ||
       cell->getKind() == CellKind::BufferedASCIIStringPrimitiveKind;
 }
 
+/// \return true if this is one of the RopeStringPrimitive classes.
+inline bool isRopeStringPrimitive(const GCCell *cell) {
+  return cell->getKind() == CellKind::RopeUTF16StringPrimitiveKind ||
+      cell->getKind() == CellKind::RopeASCIIStringPrimitiveKind;
+}
+
 /// This function is not part of the API and is not supposed to be called
 /// directly. It is used internally by StringPrimitive::concat. It is used
 /// to handle the case when the result string exceeds the minimal length for
 /// buffered concatenation, or when the left string is already a
 /// BufferedStringPrimitive. Internally it does the right thing by either
-/// appending to an existing concatenation buffer, if it can, or by allocating a
-/// new one.
-/// Some cases where it needs to allocate a new buffer include:
+/// appending to an existing concatenation buffer, if it can, creating a rope,
+/// or by allocating a new concatenation buffer.
+/// A rope is created when the right string is large, or when the left string
+/// is a rope which hasn't been flattened. Otherwise, some cases where it needs
+/// to allocate a new buffer include:
 /// - the left string is not a BufferedStringPrimitive
 /// - appending UTF16 to ASCII
 /// - appending to the middle of the concatenation chain.
@@ -853,12 +1026,37 @@ const VTable BufferedStringPrimitive<T>::vt = VTable(
 using BufferedUTF16StringPrimitive = BufferedStringPrimitive<char16_t>;
 using BufferedASCIIStringPrimitive = BufferedStringPrimitive<char>;
 
+template <typename T>
+const VTable RopeStringPrimitive<T>::vt = VTable(
+    RopeStringPrimitive<T>::getCellKind(),
+    sizeof(RopeStringPrimitive<T>),
+    RopeStringPrimitive<T>::_finalizeImpl,
+    nullptr, // markWeak.
+    RopeStringPrimitive<T>::_mallocSizeImpl,
+    nullptr,
+    nullptr,
+    RopeStringPrimitive<T>::_externalMemorySizeImpl,
+    VTable::HeapSnapshotMetadata{
+        HeapSnapshot::NodeType::String,
+        RopeStringPrimitive<T>::_snapshotNameImpl,
+        nullptr,
+        nullptr,
+        nullptr});
+
+using RopeUTF16StringPrimitive = RopeStringPrimitive<char16_t>;
+using RopeASCIIStringPrimitive = RopeStringPrimitive<char>;
+
 //===----------------------------------------------------------------------===//
 // StringPrimitive inline methods.
 
 inline llvm::raw_ostream &operator<<(
     llvm::raw_ostream &OS,
     const StringPrimitive *str) {
+  if (LLVM_UNLIKELY(!str->isFlat())) {
+    llvm::SmallVector<char16_t, 32> chars;
+    str->copyUTF16String(chars);
+    return OS << UTF16Ref(chars);
+  }
   if (str->isASCII()) {
     return OS << str->castToASCIIRef();
   }
@@ -990,8 +1188,10 @@ inline const char *StringPrimitive::castToASCIIPointer() const {
     return vmcast<DynamicUniquedASCIIStringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicASCIIStringPrimitive>(this)) {
     return vmcast<DynamicASCIIStringPrimitive>(this)->getRawPointer();
-  } else {
+  } else if (vmisa<BufferedASCIIStringPrimitive>(this)) {
     return vmcast<BufferedASCIIStringPrimitive>(this)->getRawPointer();
+  } else {
+    return vmcast<RopeASCIIStringPrimitive>(this)->getRawPointer();
   }
 }
 
@@ -1002,8 +1202,10 @@ inline const char16_t *StringPrimitive::castToUTF16Pointer() const {
     return vmcast<DynamicUniquedUTF16StringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicUTF16StringPrimitive>(this)) {
     return vmcast<DynamicUTF16StringPrimitive>(this)->getRawPointer();
-  } else {
+  } else if (vmisa<BufferedUTF16StringPrimitive>(this)) {
     return vmcast<BufferedUTF16StringPrimitive>(this)->getRawPointer();
+  } else {
+    return vmcast<RopeUTF16StringPrimitive>(this)->getRawPointer();
   }
 }
 
@@ -1043,6 +1245,24 @@ inline char16_t StringPrimitive::at(uint32_t index) const {
   }
 }
 
+inline bool StringPrimitive::isFlat() const {
+  if (LLVM_LIKELY(!isRopeStringPrimitive(this)))
+    return true;
+  return isASCII() ? vmcast<RopeASCIIStringPrimitive>(this)->isFlattened()
+                   : vmcast<RopeUTF16StringPrimitive>(this)->isFlattened();
+}
+
+inline Handle<StringPrimitive> StringPrimitive::ensureFlat(
+    Runtime *runtime,
+    Handle<StringPrimitive> self) {
+  // In the future, ensureFlat may trigger GC as it might allocate for
+  // ropes. Move the heap here.
+  runtime->potentiallyMoveHeap();
+  if (LLVM_UNLIKELY(!self->isFlat()))
+    self->flatten(runtime);
+  return self;
+}
+
 inline bool StringPrimitive::isASCII() const {
   // Abstractly, we're doing the following test:
   // return getKind() == CellKind::DynamicASCIIStringPrimitiveKind ||
@@ -1057,6 +1277,8 @@ inline bool StringPrimitive::isASCII() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -1076,6 +1298,8 @@ inline bool StringPrimitive::isExternal() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -28,6 +28,10 @@ struct SweepResult {
   /// pointers, in the order they were displaced.
   std::vector<const VTable *> displacedVtablePtrs;
 
+  /// For each segment swept, in sweep order, the index in displacedVtablePtrs
+  /// of the first VTable pointer displaced from that segment.
+  std::vector<size_t> segmentVTableStarts;
+
   /// An abstraction over the space available to compact into, as well as how
   /// much to use, and the next address to compact into.
   CompactionResult compactionResult;
@@ -10,9 +10,15 @@
 
 #include "hermes/VM/YoungGenNC.h"
 
+#include "hermes/VM/CardTableNC.h"
 #include "hermes/VM/GC.h"
+#include "hermes/VM/GCWorkerPool.h"
 #include "hermes/VM/SlotAcceptorDefault.h"
 
+#include <mutex>
+#include <utility>
+#include <vector>
+
 namespace hermes {
 namespace vm {
 
@@ -36,6 +42,87 @@ struct YoungGen::EvacAcceptor final : public SlotAcceptorDefault {
   }
 };
 
+/// The acceptor used by each worker of a parallel evacuation of the young
+/// generation.  Workers race to forward each cell: the one that claims it
+/// copies it into a promotion buffer of its own in the old gen, and pushes the
+/// copy on its stack of cells to scan.
+struct YoungGen::ParallelEvacAcceptor final : public SlotAcceptorDefault {
+  YoungGen &gen;
+  ParallelWorkList &workList;
+  /// Protects allocation in the old gen.
+  std::mutex &allocMutex;
+
+  /// Promoted cells that this worker has yet to scan.
+  std::vector<GCCell *> stack;
+
+  /// The unused part of this worker's current promotion buffer.
+  char *bufLevel{nullptr};
+  char *bufEnd{nullptr};
+  /// The next card boundary that an allocation in the buffer could cross.
+  CardTable::Boundary bufBoundary;
+
+  /// The unused ends of the promotion buffers this worker has filled.  They
+  /// are made into filler cells once the evacuation is complete.
+  std::vector<std::pair<char *, char *>> unusedRanges;
+
+  /// The number of bytes of cells this worker promoted.
+  size_t promotedBytes{0};
+
+#ifndef NDEBUG
+  /// The number of cells this worker promoted, and how many of them were put
+  /// in promotion buffers, rather than allocated directly in the old gen.
+  unsigned numPromoted{0};
+  unsigned numBuffered{0};
+  /// The number of promotion buffers this worker allocated.
+  unsigned numBuffers{0};
+  /// The hidden classes this worker promoted.
+  unsigned numHiddenClasses{0};
+  unsigned numLeafHiddenClasses{0};
+#endif
+
+  ParallelEvacAcceptor(
+      GC &gc,
+      YoungGen &gen,
+      ParallelWorkList &workList,
+      std::mutex &allocMutex)
+      : SlotAcceptorDefault(gc),
+        gen(gen),
+        workList(workList),
+        allocMutex(allocMutex) {}
+
+  using SlotAcceptorDefault::accept;
+
+  void accept(void *&ptr) override {
+    if (gen.contains(ptr)) {
+      ptr = forward(static_cast<GCCell *>(ptr));
+    }
+  }
+
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      GCCell *cell = static_cast<GCCell *>(hv.getPointer());
+      if (gen.contains(cell)) {
+        hv.setInGC(hv.updatePointer(forward(cell)), &gc);
+      }
+    }
+  }
+
+  /// Scan the cells on this worker's stack, and any it takes from the
+  /// work list, until every worker has run out of work.
+  void drain();
+
+  /// Record the unused end of the current promotion buffer in unusedRanges.
+  void retireBuffer();
+
+ private:
+  /// \return the new location of \p cell, a young-gen cell, copying it to the
+  /// old gen if no worker has done so yet.
+  GCCell *forward(GCCell *cell);
+
+  /// \return space for a promoted cell of \p size bytes.
+  char *allocPromoted(uint32_t size);
+};
+
 } // namespace vm
 } // namespace hermes
 
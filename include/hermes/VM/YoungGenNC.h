@@ -20,6 +20,7 @@
 
 #include "llvm/Support/MathExtras.h"
 
+#include <chrono>
 #include <functional>
 
 namespace hermes {
@@ -209,6 +210,10 @@ class YoungGen : public GCGeneration {
   /// Forward declaration of the acceptor used to evacuate the young generation.
   struct EvacAcceptor;
 
+  /// Forward declaration of the acceptor used by each worker of a parallel
+  /// evacuation of the young generation.
+  struct ParallelEvacAcceptor;
+
  private:
   /// Slow path taken when we can't attempt young-gen collection
   /// because there is insufficient free space in the older generation
@@ -247,6 +252,20 @@ class YoungGen : public GCGeneration {
   /// of the copied GCCell.
   GCCell *forwardPointer(GCCell *ptr);
 
+  /// \return whether this collection can evacuate the young gen in parallel:
+  /// the GC has worker threads, and the old gen has room for every young-gen
+  /// cell to survive, along with the space the workers may leave unused at the
+  /// ends of their promotion buffers.
+  bool canEvacuateInParallel();
+
+  /// Evacuate every reachable young-gen cell to the old gen, using all the
+  /// workers of the GC's pool.  The workers share the roots, the dirty cards
+  /// of the old gen up to its level at the start of the collection, and the
+  /// cells they promote.  \p rootsEnd is set to the time at which the roots
+  /// were done.
+  /// \return the number of bytes of cells promoted.
+  size_t evacuateParallel(std::chrono::steady_clock::time_point &rootsEnd);
+
 #ifdef HERMESVM_API_TRACE_DEBUG
   // If we're doing trace debugging, we may want to record the sequence of
   // young-gen allocations in the the trace.  This will return a tuple
@@ -284,6 +303,18 @@ class YoungGen : public GCGeneration {
   double updateWeakRefsSecs_ = 0.0;
   double finalizersSecs_ = 0.0;
 
+  /// The CPU time spent finding and promoting reachable cells (the first three
+  /// phases above), summed over every thread that took part.
+  double evacuationCPUSecs_ = 0.0;
+
+  /// The size of the buffers in the old gen that the workers of a parallel
+  /// evacuation promote cells into.
+  static constexpr uint32_t kPromotionBufferSize = 64 * 1024;
+
+  /// Cells larger than this are promoted directly into the old gen, rather
+  /// than into a buffer, to bound the space left unused at buffer ends.
+  static constexpr uint32_t kMaxBufferedCellSize = 2 * 1024;
+
   /// The sum of the pre-collection sizes of the young gen before
   /// collection, and the number of bytes promoted.  The latter over
   /// the former will yield the survival rate.
@@ -10,6 +10,8 @@
 #include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
 
+#include <algorithm>
+
 using namespace hermes;
 using namespace hbc;
 
@@ -28,6 +30,15 @@ struct FunctionDebugInfoDeserializer {
     current_.column = decode1Int();
   }
 
+  /// Construct a deserializer that resumes deserializing at \p offset in \p
+  /// data, where the last location decoded was \p current. The function index
+  /// is not known in that case.
+  FunctionDebugInfoDeserializer(
+      llvm::ArrayRef<uint8_t> data,
+      uint32_t offset,
+      const DebugSourceLocation &current)
+      : data_(data), offset_(offset), functionIndex_(0), current_(current) {}
+
   /// \return the next debug location, or None if we reach the end.
   /// Sample usage: while (auto loc = fdid.next()) {...}
   OptValue<DebugSourceLocation> next() {
@@ -117,13 +128,72 @@ OptValue<uint32_t> DebugInfo::getFilenameForAddress(
   return value;
 }
 
+constexpr uint32_t DebugInfo::kLocationCheckpointInterval;
+
+const std::vector<DebugInfo::LocationCheckpoint> &
+DebugInfo::getLocationCheckpoints(uint32_t debugOffset) const {
+  {
+    std::lock_guard<std::mutex> lk{locationIndex_->lock};
+    auto it = locationIndex_->checkpoints.find(debugOffset);
+    if (it != locationIndex_->checkpoints.end()) {
+      return it->second;
+    }
+  }
+
+  // Decode the whole function once, without holding the lock.
+  std::vector<LocationCheckpoint> checkpoints;
+  FunctionDebugInfoDeserializer fdid(data_.getData(), debugOffset);
+  uint32_t entryOffset = fdid.getOffset();
+  uint32_t count = 0;
+  uint32_t lastAddress = 0;
+  while (auto loc = fdid.next()) {
+    if (loc->address < lastAddress) {
+      // A binary search needs sorted addresses. Fall back to decoding the
+      // function from the start.
+      checkpoints.clear();
+      break;
+    }
+    lastAddress = loc->address;
+    if (++count % kLocationCheckpointInterval == 0) {
+      checkpoints.push_back({*loc, entryOffset, fdid.getOffset()});
+    }
+    entryOffset = fdid.getOffset();
+  }
+
+  std::lock_guard<std::mutex> lk{locationIndex_->lock};
+  // Another thread may have gotten here first, in which case its checkpoints
+  // are kept. Elements of an unordered_map are never moved.
+  return locationIndex_->checkpoints
+      .emplace(debugOffset, std::move(checkpoints))
+      .first->second;
+}
+
 OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
     uint32_t debugOffset,
     uint32_t offsetInFunction) const {
   assert(debugOffset < data_.size() && "Debug offset out of range");
-  FunctionDebugInfoDeserializer fdid(data_.getData(), debugOffset);
+  // Start from the last checkpoint at or before the address, if any. Every
+  // location before it has a lower address, so it is where a decode from the
+  // start of the function would have gotten to.
+  const auto &checkpoints = getLocationCheckpoints(debugOffset);
+  auto checkpoint = std::upper_bound(
+      checkpoints.begin(),
+      checkpoints.end(),
+      offsetInFunction,
+      [](uint32_t address, const LocationCheckpoint &cp) {
+        return address < cp.location.address;
+      });
+  FunctionDebugInfoDeserializer fdid =
+      checkpoint == checkpoints.begin()
+      ? FunctionDebugInfoDeserializer(data_.getData(), debugOffset)
+      : FunctionDebugInfoDeserializer(
+            data_.getData(),
+            std::prev(checkpoint)->nextOffset,
+            std::prev(checkpoint)->location);
   DebugSourceLocation lastLocation = fdid.getCurrent();
-  uint32_t lastLocationOffset = debugOffset;
+  uint32_t lastLocationOffset = checkpoint == checkpoints.begin()
+      ? debugOffset
+      : std::prev(checkpoint)->entryOffset;
   uint32_t nextLocationOffset = fdid.getOffset();
   while (auto loc = fdid.next()) {
     if (loc->address > offsetInFunction)
@@ -1283,8 +1283,24 @@ CallResult<HermesValue> JSFunction::_callImpl(
     Handle<Callable> selfHandle,
     Runtime *runtime) {
   auto *self = vmcast<JSFunction>(selfHandle.get());
-  if (auto *jitPtr = self->getCodeBlock()->getJITCompiled())
+  if (auto *jitPtr = self->getCodeBlock()->getJITCompiled()) {
+    // Keep counting calls, which decide what the JIT evicts.
+    self->getCodeBlock()->incrementExecutionCount();
+    // Compiled code does not track native recursion or check the register
+    // stack in its prologue, so do both before entering it.
+    ScopedNativeDepthTracker depthTracker{runtime};
+    if (LLVM_UNLIKELY(depthTracker.overflowed())) {
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::NativeStack);
+    }
+    if (LLVM_UNLIKELY(!runtime->checkAvailableStack(
+            self->getCodeBlock()->getFrameSize() +
+            StackFrameLayout::CalleeExtraRegistersAtStart))) {
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::JSRegisterStack);
+    }
     return (*jitPtr)(runtime);
+  }
   return runtime->interpretFunction(self->getCodeBlock());
 }
 
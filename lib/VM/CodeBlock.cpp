@@ -343,10 +343,12 @@ void CodeBlock::lazyCompileImpl(Runtime *runtime) {
 void CodeBlock::markCachedHiddenClasses(
     Runtime *runtime,
     WeakRootAcceptor &acceptor) {
-  for (auto &prop :
+  for (auto &cache :
        llvm::makeMutableArrayRef(propertyCache(), propertyCacheSize_)) {
-    if (prop.clazz) {
-      acceptor.acceptWeak(prop.clazz);
+    for (auto &prop : cache.entries()) {
+      if (prop.clazz) {
+        acceptor.acceptWeak(prop.clazz);
+      }
     }
   }
 }
@@ -430,7 +432,7 @@ void CodeBlock::uninstallBreakpointAtOffset(
 void CodeBlock::serialize(Serializer &s) const {
   // The identity of a CodeBlock is its functionId. Note: We don't
   // serialize/deserialize PropertyCache as of now.
-  // TODO: serialize/deserialize PropertyCacheEntry.
+  // TODO: serialize/deserialize PolymorphicPropertyCache.
   s.writeInt<uint32_t>(getFunctionID());
   s.endObject(this);
 }
@@ -306,6 +306,7 @@ DictPropertyMap::findOrAdd(
   auto *descPair = self->getDescriptorPairs() + self->numDescriptors_;
 
   descPair->first = id;
+  runtime->getHeap().symbolBarrier(id);
   ++self->numDescriptors_;
 
   return std::make_pair(&descPair->second, true);
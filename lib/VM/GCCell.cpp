@@ -8,6 +8,8 @@
 #include "hermes/VM/GCCell.h"
 #include "hermes/VM/GC.h"
 
+#include <thread>
+
 namespace hermes {
 namespace vm {
 
@@ -35,5 +37,17 @@ GCCell::GCCell(GC *gc, const VTable *vtp)
 }
 #endif
 
+GCCell *GCCell::waitForMarkedForwardingPointer() const {
+  auto *vtp = reinterpret_cast<const std::atomic<const VTable *> *>(&vtp_);
+  const VTable *vt;
+  while ((vt = vtp->load(std::memory_order_acquire)) == claimedVTable()) {
+    // The claiming thread is copying the cell; that takes little time.
+    std::this_thread::yield();
+  }
+  assert(isMarked(vt) && "Cell was not forwarded");
+  return reinterpret_cast<GCCell *>(
+      const_cast<VTable *>(removeKnownMarkBit(vt)));
+}
+
 } // namespace vm
 } // namespace hermes
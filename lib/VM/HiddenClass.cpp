@@ -430,9 +430,13 @@ Handle<HiddenClass> HiddenClass::deleteProperty(
     PropertyPos pos) {
   // We convert to dictionary if we're not yet a dictionary
   // (transition to a cacheable dictionary), or if we are, but not yet
-  // in no-cache mode (transition to no-cache mode).
+  // in no-cache mode (transition to no-cache mode). Property cells stay
+  // cacheable, and only the new class is.
   auto newHandle = LLVM_UNLIKELY(!selfHandle->isDictionaryNoCache())
-      ? copyToNewDictionary(selfHandle, runtime, selfHandle->isDictionary())
+      ? copyToNewDictionary(
+            selfHandle,
+            runtime,
+            selfHandle->isDictionary() && !selfHandle->hasPropertyCells())
       : selfHandle;
 
   --newHandle->numProperties_;
@@ -621,9 +625,11 @@ Handle<HiddenClass> HiddenClass::updateProperty(
     DictPropertyMap::getDescriptorPair(
         selfHandle->propertyMap_.get(runtime), pos)
         ->second.flags = newFlags;
-    // If it's still cacheable, make it non-cacheable.
+    // If it's still cacheable, make it non-cacheable. Property cells are
+    // invalidated by moving to a new class which remains cacheable.
     if (!selfHandle->isDictionaryNoCache()) {
-      selfHandle = copyToNewDictionary(selfHandle, runtime, /*noCache*/ true);
+      selfHandle = copyToNewDictionary(
+          selfHandle, runtime, /*noCache*/ !selfHandle->hasPropertyCells());
     }
     return selfHandle;
   }
@@ -812,8 +818,9 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
     PropertyFlags flagsToSet,
     OptValue<llvm::ArrayRef<SymbolID>> props) {
   // Result must be in dictionary mode, since it's a non-empty orphan.
+  // Property cells must not change in place.
   MutableHandle<HiddenClass> classHandle{runtime};
-  if (selfHandle->isDictionary()) {
+  if (selfHandle->isDictionary() && !selfHandle->hasPropertyCells()) {
     classHandle = *selfHandle;
   } else {
     classHandle = *copyToNewDictionary(selfHandle, runtime);
@@ -847,6 +854,14 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
   return std::move(classHandle);
 }
 
+Handle<HiddenClass> HiddenClass::convertToPropertyCells(
+    Handle<HiddenClass> selfHandle,
+    Runtime *runtime) {
+  auto newHandle = copyToNewDictionary(selfHandle, runtime);
+  newHandle->flags_.propertyCells = true;
+  return newHandle;
+}
+
 CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::reserveSlot(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime) {
@@ -148,7 +148,9 @@ CallResult<Handle<SymbolID>> IdentifierTable::getSymbolHandleFromPrimitive(
   assert(str && "null string primitive");
   if (str->isUniqued()) {
     // If the string was already uniqued, we can return directly.
-    return runtime->makeHandle(str->getUniqueID());
+    SymbolID id = str->getUniqueID();
+    runtime->getHeap().symbolBarrier(id);
+    return runtime->makeHandle(id);
   }
   auto handle = runtime->makeHandle(std::move(str));
   // Force the string primitive to flatten if it's a rope.
@@ -233,7 +235,7 @@ std::string IdentifierTable::convertSymbolToUTF8(SymbolID id) {
 void IdentifierTable::markIdentifiers(SlotAcceptor &acceptor, GC *gc) {
   for (auto &vectorEntry : lookupVector_) {
     if (!vectorEntry.isFreeSlot() && vectorEntry.isStringPrim()) {
-#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) || defined(HERMESVM_GC_HADES)
       assert(
           !gc->inYoungGen(vectorEntry.getStringPrimRef()) &&
           "Identifiers must be allocated in the old gen");
@@ -349,7 +351,9 @@ CallResult<SymbolID> IdentifierTable::getOrCreateIdentifier(
 
   auto idx = hashTable_.lookupString(str, hash);
   if (hashTable_.isValid(idx)) {
-    return SymbolID::unsafeCreate(hashTable_.get(idx));
+    SymbolID id = SymbolID::unsafeCreate(hashTable_.get(idx));
+    runtime->getHeap().symbolBarrier(id);
+    return id;
   }
 
   // It is tempting here to check whether the incoming StringPrimitive can be
@@ -374,7 +378,9 @@ CallResult<SymbolID> IdentifierTable::getOrCreateIdentifier(
 
   // Allocate the id after we have performed memory allocations because a GC
   // would have freed id.
-  return SymbolID::unsafeCreate(allocIDAndInsert(idx, cr->get()));
+  SymbolID id = SymbolID::unsafeCreate(allocIDAndInsert(idx, cr->get()));
+  runtime->getHeap().symbolBarrier(id);
+  return id;
 }
 
 StringPrimitive *IdentifierTable::getExistingStringPrimitiveOrNull(
@@ -389,6 +395,17 @@ StringPrimitive *IdentifierTable::getExistingStringPrimitiveOrNull(
   return getStringPrim(runtime, *sym);
 }
 
+StringPrimitive *IdentifierTable::getExistingStringPrimitiveOrNull(
+    Runtime *runtime,
+    llvm::ArrayRef<char> str) {
+  auto idx = hashTable_.lookupString(str, hashString(str));
+  if (!hashTable_.isValid(idx)) {
+    return nullptr;
+  }
+  Handle<SymbolID> sym(runtime, SymbolID::unsafeCreate(hashTable_.get(idx)));
+  return getStringPrim(runtime, *sym);
+}
+
 template <typename T>
 SymbolID IdentifierTable::registerLazyIdentifierImpl(
     llvm::ArrayRef<T> str,
@@ -510,7 +527,7 @@ CallResult<SymbolID> IdentifierTable::createNotUniquedSymbol(
     Handle<StringPrimitive> desc) {
   uint32_t nextID = allocNextID();
 
-#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) || defined(HERMESVM_GC_HADES)
   if (runtime->getHeap().inYoungGen(desc.get())) {
     // Need to reallocate in the old gen if the description is in the young gen.
     CallResult<PseudoHandle<StringPrimitive>> longLivedStr = desc->isASCII()
@@ -534,7 +551,9 @@ CallResult<SymbolID> IdentifierTable::createNotUniquedSymbol(
   new (&lookupVector_[nextID]) LookupEntry(*desc, true);
 #endif
 
-  return SymbolID::unsafeCreateNotUniqued(nextID);
+  SymbolID id = SymbolID::unsafeCreateNotUniqued(nextID);
+  runtime->getHeap().symbolBarrier(id);
+  return id;
 }
 
 llvm::raw_ostream &operator<<(llvm::raw_ostream &OS, SymbolID symbolID) {
@@ -51,8 +51,14 @@ HERMES_SLOW_STATISTIC(
     NumGetByIdProtoHits,
     "NumGetByIdProtoHits: Number of property 'read by id' cache hits for the prototype");
 HERMES_SLOW_STATISTIC(
-    NumGetByIdCacheEvicts,
-    "NumGetByIdCacheEvicts: Number of property 'read by id' cache evictions");
+    NumGetByIdProtoChainHits,
+    "NumGetByIdProtoChainHits: Number of property 'read by id' hits on deeper prototypes");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdNegativeHits,
+    "NumGetByIdNegativeHits: Number of property 'read by id' cached as missing");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdMegamorphicHits,
+    "NumGetByIdMegamorphicHits: Number of property 'read by id' megamorphic cache hits");
 HERMES_SLOW_STATISTIC(
     NumGetByIdFastPaths,
     "NumGetByIdFastPaths: Number of property 'read by id' fast paths");
@@ -82,8 +88,8 @@ HERMES_SLOW_STATISTIC(
     NumPutByIdCacheHits,
     "NumPutByIdCacheHits: Number of property 'write by id' cache hits");
 HERMES_SLOW_STATISTIC(
-    NumPutByIdCacheEvicts,
-    "NumPutByIdCacheEvicts: Number of property 'write by id' cache evictions");
+    NumPutByIdMegamorphicHits,
+    "NumPutByIdMegamorphicHits: Number of property 'write by id' megamorphic cache hits");
 HERMES_SLOW_STATISTIC(
     NumPutByIdFastPaths,
     "NumPutByIdFastPaths: Number of property 'write by id' fast paths");
@@ -386,8 +392,9 @@ OptValue<HermesValue> Interpreter::getByValTransientFast(
     // Otherwise we need to fall back to prototype lookup.
     if (arrayIndex &&
         arrayIndex.getValue() < base->getString()->getStringLength()) {
-      return runtime
-          ->getCharacterString(base->getString()->at(arrayIndex.getValue()))
+      auto str = StringPrimitive::ensureFlat(
+          runtime, Handle<StringPrimitive>::vmcast(base));
+      return runtime->getCharacterString(str->at(arrayIndex.getValue()))
           .getHermesValue();
     }
   }
@@ -1010,6 +1017,12 @@ CallResult<HermesValue> Interpreter::interpretFunction(
 
   if (!SingleStep) {
     if (auto jitPtr = runtime->jitContext_.compile(runtime, curCodeBlock)) {
+      if (LLVM_UNLIKELY(!runtime->checkAvailableStack(
+              curCodeBlock->getFrameSize() +
+              StackFrameLayout::CalleeExtraRegistersAtStart))) {
+        return runtime->raiseStackOverflow(
+            Runtime::StackOverflowKind::JSRegisterStack);
+      }
       return (*jitPtr)(runtime);
     }
   }
@@ -1019,6 +1032,11 @@ CallResult<HermesValue> Interpreter::interpretFunction(
   MutableHandle<> tmpHandle(runtime);
   CallResult<HermesValue> res{ExecutionStatus::EXCEPTION};
   CallResult<bool> boolRes{ExecutionStatus::EXCEPTION};
+#ifdef HERMESVM_JIT
+  // The entry into the compiled body of the current function, used when
+  // performing on-stack replacement at a loop header.
+  JITOSREntryPtr osrEntry = nullptr;
+#endif
 
   // Mark the gcScope so we can clear all allocated handles.
   // Remember how many handles the scope has so we can clear them in the loop.
@@ -1329,6 +1347,27 @@ tailCall:
     DISPATCH;                                                            \
   }
 
+/// Set ip to the target \p dest of a jump. With the JIT, backward jumps count
+/// towards the hotness of the function, and once it has been compiled, the
+/// rest of the current frame is executed by the compiled body, entering it at
+/// the loop header (on-stack replacement).
+#ifdef HERMESVM_JIT
+#define JUMP(dest)                                                           \
+  do {                                                                       \
+    const Inst *jumpTarget = (dest);                                         \
+    if (!SingleStep && jumpTarget < ip &&                                    \
+        LLVM_UNLIKELY(                                                       \
+            (osrEntry =                                                      \
+                 runtime->jitContext_.onBackEdge(runtime, curCodeBlock)))) { \
+      ip = jumpTarget;                                                       \
+      goto enterOSR;                                                         \
+    }                                                                        \
+    ip = jumpTarget;                                                         \
+  } while (0)
+#else
+#define JUMP(dest) ip = (dest)
+#endif
+
 /// Implement a comparison conditional jump with a fast path where both
 /// operands are numbers.
 /// \param name the name of the instruction. The fast path case will have a
@@ -1349,10 +1388,10 @@ tailCall:
         if (O2REG(name##N##suffix)                                        \
                 .getNumber() oper O3REG(name##N##suffix)                  \
                 .getNumber()) {                                           \
-          ip = trueDest;                                                  \
+          JUMP(trueDest);                                                 \
           DISPATCH;                                                       \
         }                                                                 \
-        ip = falseDest;                                                   \
+        JUMP(falseDest);                                                  \
         DISPATCH;                                                         \
       }                                                                   \
     }                                                                     \
@@ -1366,10 +1405,10 @@ tailCall:
       goto exception;                                                     \
     gcScope.flushToSmallCount(KEEP_HANDLES);                              \
     if (boolRes.getValue()) {                                             \
-      ip = trueDest;                                                      \
+      JUMP(trueDest);                                                     \
       DISPATCH;                                                           \
     }                                                                     \
-    ip = falseDest;                                                       \
+    JUMP(falseDest);                                                      \
     DISPATCH;                                                             \
   }
 
@@ -1381,10 +1420,10 @@ tailCall:
 #define JCOND_STRICT_EQ_IMPL(name, suffix, trueDest, falseDest)         \
   CASE(name##suffix) {                                                  \
     if (strictEqualityTest(O2REG(name##suffix), O3REG(name##suffix))) { \
-      ip = trueDest;                                                    \
+      JUMP(trueDest);                                                   \
       DISPATCH;                                                         \
     }                                                                   \
-    ip = falseDest;                                                     \
+    JUMP(falseDest);                                                    \
     DISPATCH;                                                           \
   }
 
@@ -1406,10 +1445,10 @@ tailCall:
     }                                                    \
     gcScope.flushToSmallCount(KEEP_HANDLES);             \
     if (res->getBool()) {                                \
-      ip = trueDest;                                     \
+      JUMP(trueDest);                                    \
       DISPATCH;                                          \
     }                                                    \
-    ip = falseDest;                                      \
+    JUMP(falseDest);                                     \
     DISPATCH;                                            \
   }
 
@@ -1863,6 +1902,11 @@ tailCall:
         // Store the return value.
         res = O1REG(Ret);
 
+#ifdef HERMESVM_JIT
+      // We arrive here with the return value in res when the compiled body
+      // that was entered with on-stack replacement returns.
+      returnFromOSR:
+#endif
         ip = FRAME.getSavedIP();
         curCodeBlock = FRAME.getSavedCodeBlock();
 
@@ -2301,7 +2345,7 @@ tailCall:
       if (LLVM_LIKELY(O2REG(GetById).isObject())) {
         auto *obj = vmcast<JSObject>(O2REG(GetById));
         auto cacheIdx = ip->iGetById.op3;
-        auto *cacheEntry = curCodeBlock->getReadCacheEntry(cacheIdx);
+        auto *cache = curCodeBlock->getReadCache(cacheIdx);
 
 #ifdef HERMESVM_PROFILER_BB
         {
@@ -2309,10 +2353,19 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime->makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              GCPointerBase::storageTypeToPointer(cacheEntry->clazz, runtime)));
+          auto clazzStorage = obj->getClassGCPtr().getStorageType();
+          auto cacheHCPtr = vmcast_or_null<HiddenClass>(
+              static_cast<GCCell *>(GCPointerBase::storageTypeToPointer(
+                  cache->find(clazzStorage) ? clazzStorage
+                                            : cache->getFirstClass(),
+                  runtime)));
           CAPTURE_IP(runtime->recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock,
+              ip,
+              ID(idVal),
+              obj->getClass(runtime),
+              cacheHCPtr,
+              cache->getState()));
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2328,7 +2381,9 @@ tailCall:
 
         // If we have a cache hit, reuse the cached offset and immediately
         // return the property.
-        if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+        const PropertyCacheEntry *cacheEntry =
+            cache->find(clazzGCPtr.getStorageType());
+        if (LLVM_LIKELY(cacheEntry != nullptr)) {
           ++NumGetByIdCacheHits;
           CAPTURE_IP_ASSIGN(
               O1REG(GetById),
@@ -2338,6 +2393,19 @@ tailCall:
           DISPATCH;
         }
         auto id = ID(idVal);
+        // A megamorphic site falls back to the runtime-wide cache.
+        if (LLVM_UNLIKELY(cache->isMegamorphic())) {
+          if (auto *megaEntry = runtime->getMegamorphicPropertyCache().find(
+                  clazzGCPtr.getStorageType(), id)) {
+            ++NumGetByIdMegamorphicHits;
+            CAPTURE_IP_ASSIGN(
+                O1REG(GetById),
+                JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+                    obj, runtime, megaEntry->slot));
+            ip = nextIP;
+            DISPATCH;
+          }
+        }
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
             OptValue<bool> fastPathResult,
@@ -2352,16 +2420,17 @@ tailCall:
           auto *clazz = clazzGCPtr.getNonNull(runtime);
           if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-#ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz &&
-                cacheEntry->clazz != clazzGCPtr.getStorageType())
-              ++NumGetByIdCacheEvicts;
-#else
-            (void)NumGetByIdCacheEvicts;
-#endif
-            // Cache the class, id and property slot.
-            cacheEntry->clazz = clazzGCPtr.getStorageType();
-            cacheEntry->slot = desc.slot;
+            // Cache the class and property slot, in the runtime-wide cache
+            // if the site has no room.
+            if (LLVM_UNLIKELY(
+                    !cache->add(clazzGCPtr.getStorageType(), desc.slot))) {
+              runtime->getMegamorphicPropertyCache().add(
+                  clazzGCPtr.getStorageType(),
+                  id,
+                  desc.slot,
+                  desc.flags.writable && !desc.flags.internalSetter &&
+                      clazz->canCacheWrites());
+            }
           }
 
           CAPTURE_IP_ASSIGN(
@@ -2374,21 +2443,46 @@ tailCall:
         // This value is only reliable if the fast path was a definite
         // not-found.
         if (fastPathResult.hasValue() && !fastPathResult.getValue() &&
-            !obj->isProxyObject()) {
+            !obj->isProxyObject() && !obj->isHostObject()) {
           CAPTURE_IP_ASSIGN(JSObject * parent, obj->getParent(runtime));
           // TODO: This isLazy check is because a lazy object is reported as
           // having no properties and therefore cannot contain the property.
           // This check does not belong here, it should be merged into
           // tryGetOwnNamedDescriptorFast().
-          if (parent &&
-              cacheEntry->clazz == parent->getClassGCPtr().getStorageType() &&
-              LLVM_LIKELY(!obj->isLazy())) {
-            ++NumGetByIdProtoHits;
-            CAPTURE_IP_ASSIGN(
-                O1REG(GetById),
-                JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot));
-            ip = nextIP;
-            DISPATCH;
+          if (parent && LLVM_LIKELY(!obj->isLazy())) {
+            if (const PropertyCacheEntry *protoEntry =
+                    cache->find(parent->getClassGCPtr().getStorageType())) {
+              ++NumGetByIdProtoHits;
+              CAPTURE_IP_ASSIGN(
+                  O1REG(GetById),
+                  JSObject::getNamedSlotValue(
+                      parent, runtime, protoEntry->slot));
+              ip = nextIP;
+              DISPATCH;
+            }
+            // Deeper prototypes, and properties missing from the whole
+            // chain, are cached runtime-wide.
+            JSObject *holder;
+            SlotIndex holderSlot;
+            if (runtime->getProtoChainPropertyCache().find(
+                    runtime, parent, id, holder, holderSlot)) {
+              if (holder) {
+                ++NumGetByIdProtoChainHits;
+                CAPTURE_IP_ASSIGN(
+                    O1REG(GetById),
+                    JSObject::getNamedSlotValue(holder, runtime, holderSlot));
+                ip = nextIP;
+                DISPATCH;
+              }
+              // TryGetById throws on a missing property; leave that to the
+              // slow path.
+              if (!tryProp) {
+                ++NumGetByIdNegativeHits;
+                O1REG(GetById) = HermesValue::encodeUndefinedValue();
+                ip = nextIP;
+                DISPATCH;
+              }
+            }
           }
         }
 
@@ -2409,11 +2503,6 @@ tailCall:
         (void)NumGetByIdAccessor;
         (void)NumGetByIdProto;
         (void)NumGetByIdNotFound;
-#endif
-#ifdef HERMES_SLOW_DEBUG
-        auto savedClass = cacheIdx != hbc::PROPERTY_CACHING_DISABLED
-            ? cacheEntry->clazz
-            : GCPointer<HiddenClass>::StorageType{};
 #endif
         ++NumGetByIdSlow;
         CAPTURE_IP_ASSIGN(
@@ -2424,17 +2513,10 @@ tailCall:
                 id,
                 !tryProp ? defaultPropOpFlags
                          : defaultPropOpFlags.plusMustExist(),
-                cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry
-                                                           : nullptr));
+                cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cache : nullptr));
         if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
-#ifdef HERMES_SLOW_DEBUG
-        if (cacheIdx != hbc::PROPERTY_CACHING_DISABLED && savedClass &&
-            cacheEntry->clazz != savedClass) {
-          ++NumGetByIdCacheEvicts;
-        }
-#endif
       } else {
         ++NumGetByIdTransient;
         assert(!tryProp && "TryGetById can only be used on the global object");
@@ -2481,7 +2563,7 @@ tailCall:
       if (LLVM_LIKELY(O1REG(PutById).isObject())) {
         auto *obj = vmcast<JSObject>(O1REG(PutById));
         auto cacheIdx = ip->iPutById.op3;
-        auto *cacheEntry = curCodeBlock->getWriteCacheEntry(cacheIdx);
+        auto *cache = curCodeBlock->getWriteCache(cacheIdx);
 
 #ifdef HERMESVM_PROFILER_BB
         {
@@ -2489,10 +2571,19 @@ tailCall:
               gcScope.getHandleCountDbg() == KEEP_HANDLES &&
               "unaccounted handles were created");
           auto objHandle = runtime->makeHandle(obj);
-          auto cacheHCPtr = vmcast_or_null<HiddenClass>(static_cast<GCCell *>(
-              GCPointerBase::storageTypeToPointer(cacheEntry->clazz, runtime)));
+          auto clazzStorage = obj->getClassGCPtr().getStorageType();
+          auto cacheHCPtr = vmcast_or_null<HiddenClass>(
+              static_cast<GCCell *>(GCPointerBase::storageTypeToPointer(
+                  cache->find(clazzStorage) ? clazzStorage
+                                            : cache->getFirstClass(),
+                  runtime)));
           CAPTURE_IP(runtime->recordHiddenClass(
-              curCodeBlock, ip, ID(idVal), obj->getClass(runtime), cacheHCPtr));
+              curCodeBlock,
+              ip,
+              ID(idVal),
+              obj->getClass(runtime),
+              cacheHCPtr,
+              cache->getState()));
           // obj may be moved by GC due to recordHiddenClass
           obj = objHandle.get();
         }
@@ -2501,7 +2592,9 @@ tailCall:
         auto clazzGCPtr = obj->getClassGCPtr();
         // If we have a cache hit, reuse the cached offset and immediately
         // return the property.
-        if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+        const PropertyCacheEntry *cacheEntry =
+            cache->find(clazzGCPtr.getStorageType());
+        if (LLVM_LIKELY(cacheEntry != nullptr)) {
           ++NumPutByIdCacheHits;
           CAPTURE_IP(JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
               obj, runtime, cacheEntry->slot, O2REG(PutById)));
@@ -2509,6 +2602,18 @@ tailCall:
           DISPATCH;
         }
         auto id = ID(idVal);
+        // A megamorphic site falls back to the runtime-wide cache.
+        if (LLVM_UNLIKELY(cache->isMegamorphic())) {
+          auto *megaEntry = runtime->getMegamorphicPropertyCache().find(
+              clazzGCPtr.getStorageType(), id);
+          if (megaEntry && megaEntry->writable) {
+            ++NumPutByIdMegamorphicHits;
+            CAPTURE_IP(JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+                obj, runtime, megaEntry->slot, O2REG(PutById)));
+            ip = nextIP;
+            DISPATCH;
+          }
+        }
         NamedPropertyDescriptor desc;
         CAPTURE_IP_ASSIGN(
             OptValue<bool> hasOwnProp,
@@ -2521,18 +2626,15 @@ tailCall:
           // cacheIdx == 0 indicates no caching so don't update the cache in
           // those cases.
           auto *clazz = clazzGCPtr.getNonNull(runtime);
-          if (LLVM_LIKELY(!clazz->isDictionary()) &&
+          if (LLVM_LIKELY(clazz->canCacheWrites()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-#ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz &&
-                cacheEntry->clazz != clazzGCPtr.getStorageType())
-              ++NumPutByIdCacheEvicts;
-#else
-            (void)NumPutByIdCacheEvicts;
-#endif
-            // Cache the class and property slot.
-            cacheEntry->clazz = clazzGCPtr.getStorageType();
-            cacheEntry->slot = desc.slot;
+            // Cache the class and property slot, in the runtime-wide cache
+            // if the site has no room.
+            if (LLVM_UNLIKELY(
+                    !cache->add(clazzGCPtr.getStorageType(), desc.slot))) {
+              runtime->getMegamorphicPropertyCache().add(
+                  clazzGCPtr.getStorageType(), id, desc.slot, true);
+            }
           }
 
           CAPTURE_IP(JSObject::setNamedSlotValue(
@@ -2679,15 +2781,21 @@ tailCall:
           uint32_t idx = O4REG(GetNextPName).getNumber();
           uint32_t size = O5REG(GetNextPName).getNumber();
           MutableHandle<JSObject> propObj{runtime};
-          // Loop until we find a property which is present.
-          while (idx < size) {
+          // If neither the object nor its prototypes have changed class since
+          // the names were cached, the next name is still present.
+          if (idx < size && isForInCacheValid(runtime, *obj, *arr)) {
             tmpHandle = arr->at(idx);
-            ComputedPropertyDescriptor desc;
-            CAPTURE_IP(JSObject::getComputedPrimitiveDescriptor(
-                obj, runtime, tmpHandle, propObj, desc));
-            if (LLVM_LIKELY(propObj))
-              break;
-            ++idx;
+          } else {
+            // Loop until we find a property which is present.
+            while (idx < size) {
+              tmpHandle = arr->at(idx);
+              ComputedPropertyDescriptor desc;
+              CAPTURE_IP(JSObject::getComputedPrimitiveDescriptor(
+                  obj, runtime, tmpHandle, propObj, desc));
+              if (LLVM_LIKELY(propObj))
+                break;
+              ++idx;
+            }
           }
           if (idx < size) {
             // We must return the property as a string
@@ -2762,51 +2870,51 @@ tailCall:
       }
 
       CASE(Jmp) {
-        ip = IPADD(ip->iJmp.op1);
+        JUMP(IPADD(ip->iJmp.op1));
         DISPATCH;
       }
       CASE(JmpLong) {
-        ip = IPADD(ip->iJmpLong.op1);
+        JUMP(IPADD(ip->iJmpLong.op1));
         DISPATCH;
       }
       CASE(JmpTrue) {
         if (toBoolean(O2REG(JmpTrue)))
-          ip = IPADD(ip->iJmpTrue.op1);
+          JUMP(IPADD(ip->iJmpTrue.op1));
         else
           ip = NEXTINST(JmpTrue);
         DISPATCH;
       }
       CASE(JmpTrueLong) {
         if (toBoolean(O2REG(JmpTrueLong)))
-          ip = IPADD(ip->iJmpTrueLong.op1);
+          JUMP(IPADD(ip->iJmpTrueLong.op1));
         else
           ip = NEXTINST(JmpTrueLong);
         DISPATCH;
       }
       CASE(JmpFalse) {
         if (!toBoolean(O2REG(JmpFalse)))
-          ip = IPADD(ip->iJmpFalse.op1);
+          JUMP(IPADD(ip->iJmpFalse.op1));
         else
           ip = NEXTINST(JmpFalse);
         DISPATCH;
       }
       CASE(JmpFalseLong) {
         if (!toBoolean(O2REG(JmpFalseLong)))
-          ip = IPADD(ip->iJmpFalseLong.op1);
+          JUMP(IPADD(ip->iJmpFalseLong.op1));
         else
           ip = NEXTINST(JmpFalseLong);
         DISPATCH;
       }
       CASE(JmpUndefined) {
         if (O2REG(JmpUndefined).isUndefined())
-          ip = IPADD(ip->iJmpUndefined.op1);
+          JUMP(IPADD(ip->iJmpUndefined.op1));
         else
           ip = NEXTINST(JmpUndefined);
         DISPATCH;
       }
       CASE(JmpUndefinedLong) {
         if (O2REG(JmpUndefinedLong).isUndefined())
-          ip = IPADD(ip->iJmpUndefinedLong.op1);
+          JUMP(IPADD(ip->iJmpUndefinedLong.op1));
         else
           ip = NEXTINST(JmpUndefinedLong);
         DISPATCH;
@@ -3360,7 +3468,14 @@ tailCall:
                   ip->iCreateRegExp.op4));
           CAPTURE_IP_ASSIGN(
               auto initRes,
-              JSRegExp::initialize(re, runtime, pattern, flags, bytecode));
+              JSRegExp::initialize(
+                  re,
+                  runtime,
+                  pattern,
+                  flags,
+                  bytecode,
+                  curCodeBlock->getRuntimeModule()->markRegExpCached(
+                      ip->iCreateRegExp.op4)));
           if (LLVM_UNLIKELY(initRes == ExecutionStatus::EXCEPTION)) {
             goto exception;
           }
@@ -3510,6 +3625,25 @@ tailCall:
 
     llvm_unreachable("unreachable");
 
+#ifdef HERMESVM_JIT
+  // We arrive here from a backward jump to the loop header at ip, once the
+  // current function has been compiled. The compiled body executes the rest of
+  // the current frame and returns from it.
+  enterOSR:
+    SLOW_DEBUG(
+        dbgs() << "OSR entry at offset " << CUROFFSET << " of function "
+               << curCodeBlock->getFunctionID() << "\n");
+    CAPTURE_IP_ASSIGN(res, osrEntry(runtime, CUROFFSET));
+    PROFILER_EXIT_FUNCTION(curCodeBlock);
+#ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
+    runtime->popCallStack();
+#endif
+    gcScope.flushToSmallCount(KEEP_HANDLES);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+      goto handleExceptionInParent;
+    goto returnFromOSR;
+#endif
+
   // We arrive here if we couldn't allocate the registers for the current frame.
   stackOverflow:
     CAPTURE_IP(runtime->raiseStackOverflow(
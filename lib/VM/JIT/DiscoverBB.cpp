@@ -40,10 +40,18 @@ void discoverBasicBlocks(
   while (ip != end) {
     auto decoded = decodeInstruction((const Inst *)ip);
     bool branch = false;
-    // FIXME: implement SwitchImm.
-    assert(
-        decoded.meta.opCode != OpCode::SwitchImm &&
-        "SwitchImm not implemented yet");
+    if (decoded.meta.opCode == OpCode::SwitchImm) {
+      // Every entry of the jump table, which follows the bytecode, is a
+      // branch destination too.
+      auto *inst = (const Inst *)ip;
+      const uint32_t *table = (const uint32_t *)llvm::alignAddr(
+          ip + inst->iSwitchImm.op2, sizeof(uint32_t));
+      for (uint32_t i = 0, e = inst->iSwitchImm.op5 - inst->iSwitchImm.op4;
+           i <= e;
+           ++i) {
+        addLabel(ip + table[i]);
+      }
+    }
     if (decoded.meta.opCode == OpCode::Catch) {
       addLabel(ip);
       ip += decoded.meta.size;
@@ -11,6 +11,7 @@
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/JSRegExp.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/Runtime-inline.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 
 namespace hermes {
@@ -48,25 +49,33 @@ ExecutionStatus externCallDeclareGlobalVar(
     Runtime *runtime,
     uint32_t stringID) {
   GCScopeMarkerRAII marker{runtime};
-  DefinePropertyFlags dpf{};
-  dpf.setWritable = 1;
-  dpf.setConfigurable = 1;
-  dpf.setEnumerable = 1;
-  dpf.writable = 1;
-  dpf.enumerable = 1;
+  DefinePropertyFlags dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
   dpf.configurable = 0;
-
-  return JSObject::defineOwnProperty(
-             runtime->getGlobal(),
-             runtime,
-             runtime->getCurrentFrame()
-                 ->getCalleeCodeBlock()
-                 ->getRuntimeModule()
-                 ->getSymbolIDMustExist(stringID),
-             dpf,
-             Runtime::getUndefinedValue(),
-             PropOpFlags().plusThrowOnError())
-      .getStatus();
+  // Do not overwrite existing globals with undefined.
+  dpf.setValue = 0;
+
+  SymbolID id = runtime->getCurrentFrame()
+                    ->getCalleeCodeBlock()
+                    ->getRuntimeModule()
+                    ->getSymbolIDMustExist(stringID);
+  if (LLVM_LIKELY(
+          JSObject::defineOwnProperty(
+              runtime->getGlobal(),
+              runtime,
+              id,
+              dpf,
+              Runtime::getUndefinedValue(),
+              PropOpFlags().plusThrowOnError()) !=
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::RETURNED;
+  }
+  // If the property already exists, e.g. because it is non-configurable, this
+  // should be a noop, so swallow the exception.
+  NamedPropertyDescriptor desc;
+  if (!JSObject::getOwnNamedDescriptor(runtime->getGlobal(), runtime, id, desc))
+    return ExecutionStatus::EXCEPTION;
+  runtime->clearThrownValue();
+  return ExecutionStatus::RETURNED;
 }
 
 CallResult<HermesValue> externCreateEnvironment(
@@ -101,6 +110,103 @@ CallResult<HermesValue> externCreateClosure(
       .getHermesValue();
 }
 
+CallResult<HermesValue> externCreateGeneratorClosure(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env) {
+  GCScopeMarkerRAII marker{runtime};
+  return Interpreter::createGeneratorClosure(
+      runtime, runtimeModule, funcIndex, Handle<Environment>::vmcast(env));
+}
+
+CallResult<HermesValue> externCreateGenerator(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env,
+    PinnedHermesValue *currentFrame) {
+  GCScopeMarkerRAII marker{runtime};
+  return Interpreter::createGenerator_RJS(
+      runtime,
+      runtimeModule,
+      funcIndex,
+      Handle<Environment>::vmcast(env),
+      StackFramePtr(currentFrame).getNativeArgs());
+}
+
+uint32_t externStartGenerator(Runtime *runtime, CodeBlock *codeBlock) {
+  auto *innerFn = vmcast<GeneratorInnerFunction>(
+      runtime->getCurrentFrame().getCalleeClosure());
+  uint32_t resumeOffset = 0;
+  if (innerFn->getState() != GeneratorInnerFunction::State::SuspendedStart) {
+    resumeOffset = codeBlock->getOffsetOf(innerFn->getNextIP());
+    innerFn->restoreStack(runtime);
+  }
+  innerFn->setState(GeneratorInnerFunction::State::Executing);
+  return resumeOffset;
+}
+
+void externSaveGenerator(Runtime *runtime, const Inst *resumeIP) {
+  auto *innerFn = vmcast<GeneratorInnerFunction>(
+      runtime->getCurrentFrame().getCalleeClosure());
+  innerFn->saveStack(runtime);
+  innerFn->setNextIP(resumeIP);
+  innerFn->setState(GeneratorInnerFunction::State::SuspendedYield);
+}
+
+ExecutionStatus externResumeGenerator(
+    Runtime *runtime,
+    PinnedHermesValue *result,
+    PinnedHermesValue *isReturn) {
+  auto *innerFn = vmcast<GeneratorInnerFunction>(
+      runtime->getCurrentFrame().getCalleeClosure());
+  *result = innerFn->getResult();
+  *isReturn = HermesValue::encodeBoolValue(
+      innerFn->getAction() == GeneratorInnerFunction::Action::Return);
+  innerFn->clearResult();
+  if (innerFn->getAction() == GeneratorInnerFunction::Action::Throw) {
+    runtime->setThrownValue(*result);
+    return ExecutionStatus::EXCEPTION;
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+void externCompleteGenerator(Runtime *runtime) {
+  vmcast<GeneratorInnerFunction>(runtime->getCurrentFrame().getCalleeClosure())
+      ->setState(GeneratorInnerFunction::State::Completed);
+}
+
+ExecutionStatus externCatch(Runtime *runtime, PinnedHermesValue *dst) {
+  assert(!runtime->getThrownValue().isEmpty() && "Invalid thrown value");
+  if (LLVM_UNLIKELY(isUncatchableError(runtime->getThrownValue())))
+    return ExecutionStatus::EXCEPTION;
+  *dst = runtime->getThrownValue();
+  runtime->clearThrownValue();
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus externIteratorClose(
+    Runtime *runtime,
+    PinnedHermesValue *iter,
+    bool ignoreInnerException) {
+  GCScopeMarkerRAII marker{runtime};
+  // The iterator must be closed if it's still an object. That means it was
+  // never an index and is not done iterating.
+  if (LLVM_LIKELY(!iter->isObject()))
+    return ExecutionStatus::RETURNED;
+  auto res = iteratorClose(
+      runtime, Handle<JSObject>::vmcast(iter), Runtime::getEmptyValue());
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    if (!ignoreInnerException ||
+        isUncatchableError(runtime->getThrownValue())) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    runtime->clearThrownValue();
+  }
+  return ExecutionStatus::RETURNED;
+}
+
 ExecutionStatus externPutById(
     Runtime *runtime,
     PropOpFlags opFlags,
@@ -115,17 +221,27 @@ ExecutionStatus externPutById(
   if (LLVM_LIKELY(target->isObject())) {
     auto *obj = vmcast<JSObject>(*target);
     auto clazzGCPtr = obj->getClassGCPtr();
-    auto *cacheEntry = codeBlock->getWriteCacheEntry(cacheIdx);
+    auto *cache = codeBlock->getWriteCache(cacheIdx);
 
     // If we have a cache hit, reuse the cached offset and immediately
     // return the property.
-    if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+    if (auto *cacheEntry = cache->find(clazzGCPtr.getStorageType())) {
       JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
           obj, runtime, cacheEntry->slot, *prop);
       return ExecutionStatus::RETURNED;
     }
     auto *clazz = clazzGCPtr.getNonNull(runtime);
     auto id = SymbolID::unsafeCreate(sid);
+    // A megamorphic site falls back to the runtime-wide cache.
+    if (LLVM_UNLIKELY(cache->isMegamorphic())) {
+      auto *megaEntry = runtime->getMegamorphicPropertyCache().find(
+          clazzGCPtr.getStorageType(), id);
+      if (megaEntry && megaEntry->writable) {
+        JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+            obj, runtime, megaEntry->slot, *prop);
+        return ExecutionStatus::RETURNED;
+      }
+    }
     NamedPropertyDescriptor desc;
     if (LLVM_LIKELY(
             JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc)) &&
@@ -133,11 +249,14 @@ ExecutionStatus externPutById(
         !desc.flags.internalSetter) {
       // cacheIdx == 0 indicates no caching so don't update the cache in
       // those cases.
-      if (LLVM_LIKELY(!clazz->isDictionary()) &&
+      if (LLVM_LIKELY(clazz->canCacheWrites()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-        // Cache the class and property slot.
-        cacheEntry->clazz = clazzGCPtr.getStorageType();
-        cacheEntry->slot = desc.slot;
+        // Cache the class and property slot, in the runtime-wide cache if
+        // the site has no room.
+        if (!cache->add(clazzGCPtr.getStorageType(), desc.slot)) {
+          runtime->getMegamorphicPropertyCache().add(
+              clazzGCPtr.getStorageType(), id, desc.slot, true);
+        }
       }
 
       JSObject::setNamedSlotValue(obj, runtime, desc.slot, *prop);
@@ -173,15 +292,23 @@ CallResult<HermesValue> externGetById(
   if (LLVM_LIKELY(target->isObject())) {
     auto *obj = vmcast<JSObject>(*target);
     auto clazzGCPtr = obj->getClassGCPtr();
-    auto *cacheEntry = codeBlock->getReadCacheEntry(cacheIdx);
+    auto *cache = codeBlock->getReadCache(cacheIdx);
 
     // If we have a cache hit, reuse the cached offset and immediately
     // return the property.
-    if (LLVM_LIKELY(cacheEntry->clazz == clazzGCPtr.getStorageType())) {
+    if (auto *cacheEntry = cache->find(clazzGCPtr.getStorageType())) {
       return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
           obj, runtime, cacheEntry->slot);
     }
     auto id = SymbolID::unsafeCreate(sid);
+    // A megamorphic site falls back to the runtime-wide cache.
+    if (LLVM_UNLIKELY(cache->isMegamorphic())) {
+      if (auto *megaEntry = runtime->getMegamorphicPropertyCache().find(
+              clazzGCPtr.getStorageType(), id)) {
+        return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+            obj, runtime, megaEntry->slot);
+      }
+    }
     NamedPropertyDescriptor desc;
     OptValue<bool> fastPathResult =
         JSObject::tryGetOwnNamedDescriptorFast(obj, runtime, id, desc);
@@ -190,11 +317,18 @@ CallResult<HermesValue> externGetById(
         !desc.flags.accessor) {
       // cacheIdx == 0 indicates no caching so don't update the cache in
       // those cases.
-      if (LLVM_LIKELY(!clazz->isDictionary()) &&
+      if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
-        // Cache the class, id and property slot.
-        cacheEntry->clazz = clazzGCPtr.getStorageType();
-        cacheEntry->slot = desc.slot;
+        // Cache the class and property slot, in the runtime-wide cache if
+        // the site has no room.
+        if (!cache->add(clazzGCPtr.getStorageType(), desc.slot)) {
+          runtime->getMegamorphicPropertyCache().add(
+              clazzGCPtr.getStorageType(),
+              id,
+              desc.slot,
+              desc.flags.writable && !desc.flags.internalSetter &&
+                  clazz->canCacheWrites());
+        }
       }
 
       return JSObject::getNamedSlotValue(obj, runtime, desc);
@@ -204,21 +338,38 @@ CallResult<HermesValue> externGetById(
     // This value is only reliable if the fast path was a definite
     // not-found.
     if (fastPathResult.hasValue() && !fastPathResult.getValue() &&
-        !obj->isProxyObject()) {
+        !obj->isProxyObject() && !obj->isHostObject()) {
       JSObject *parent = obj->getParent(runtime);
       // TODO: This isLazy check is because a lazy object is reported as
       // having no properties and therefore cannot contain the property.
       // This check does not belong here, it should be merged into
       // tryGetOwnNamedDescriptorFast().
-      if (parent &&
-          cacheEntry->clazz == parent->getClassGCPtr().getStorageType() &&
-          LLVM_LIKELY(!obj->isLazy())) {
-        return JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
+      if (parent && LLVM_LIKELY(!obj->isLazy())) {
+        if (auto *protoEntry =
+                cache->find(parent->getClassGCPtr().getStorageType())) {
+          return JSObject::getNamedSlotValue(
+              parent, runtime, protoEntry->slot);
+        }
+        JSObject *holder;
+        SlotIndex holderSlot;
+        if (runtime->getProtoChainPropertyCache().find(
+                runtime, parent, id, holder, holderSlot)) {
+          if (holder) {
+            return JSObject::getNamedSlotValue(holder, runtime, holderSlot);
+          }
+          if (!opFlags.getMustExist()) {
+            return HermesValue::encodeUndefinedValue();
+          }
+        }
       }
     }
 
     return JSObject::getNamed_RJS(
-        Handle<JSObject>::vmcast(target), runtime, id, opFlags);
+        Handle<JSObject>::vmcast(target),
+        runtime,
+        id,
+        opFlags,
+        cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cache : nullptr);
   } else {
     /* Slow path. */
     return Interpreter::getByIdTransient_RJS(
@@ -288,6 +439,71 @@ CallResult<HermesValue> externConstruct(
   return res;
 }
 
+CallResult<HermesValue> externCallDirect(
+    Runtime *runtime,
+    CodeBlock *calleeBlock,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame) {
+  GCScopeMarkerRAII marker{runtime};
+
+  StackFramePtr frame(previousFrame);
+  (void)StackFramePtr::initFrame(
+      stackPointer,
+      frame,
+      ip,
+      // See externCall for why no code block is saved.
+      nullptr, /* SavedCodeBlock */
+      argCount - 1,
+      HermesValue::encodeNativePointer(calleeBlock),
+      HermesValue::encodeUndefinedValue());
+  runtime->setCurrentIP(ip);
+
+  ScopedNativeDepthTracker depthTracker{runtime};
+  if (LLVM_UNLIKELY(depthTracker.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+  calleeBlock->lazyCompile(runtime);
+  return runtime->interpretFunction(calleeBlock);
+}
+
+CallResult<HermesValue> externCallBuiltin(
+    Runtime *runtime,
+    uint32_t builtinIndex,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame) {
+  GCScopeMarkerRAII marker{runtime};
+
+  NativeFunction *nf = runtime->getBuiltinNativeFunction(builtinIndex);
+  StackFramePtr frame(previousFrame);
+  auto newFrame = StackFramePtr::initFrame(
+      stackPointer,
+      frame,
+      ip,
+      nullptr, /* SavedCodeBlock */
+      argCount - 1,
+      nf,
+      false);
+  // "thisArg" is implicitly assumed to "undefined".
+  newFrame.getThisArgRef() = HermesValue::encodeUndefinedValue();
+  runtime->setCurrentIP(ip);
+  return NativeFunction::_nativeCall(nf, runtime);
+}
+
+ExecutionStatus externThrowIfUndefined(Runtime *runtime) {
+  GCScopeMarkerRAII marker{runtime};
+  return runtime->raiseReferenceError("accessing an uninitialized variable");
+}
+
+ExecutionStatus externAsyncBreakCheck(Runtime *runtime) {
+  GCScopeMarkerRAII marker{runtime};
+  if (runtime->testAndClearTimeoutAsyncBreakRequest())
+    return runtime->notifyTimeout();
+  return ExecutionStatus::RETURNED;
+}
+
 /// Implement a slow path call for a binary operator.
 /// \param name the name of the slow path call
 /// \param oper the binary operator to use against numbers.
@@ -381,6 +597,19 @@ HermesValue externNewObject(Runtime *runtime) {
   return JSObject::create(runtime).getHermesValue();
 }
 
+HermesValue externNewObjectWithParent(
+    Runtime *runtime,
+    PinnedHermesValue *parent) {
+  GCScopeMarkerRAII marker{runtime};
+  return JSObject::create(
+             runtime,
+             parent->isObject() ? Handle<JSObject>::vmcast(parent)
+                 : parent->isNull()
+                 ? Runtime::makeNullHandle<JSObject>()
+                 : Handle<JSObject>::vmcast(&runtime->objectPrototype))
+      .getHermesValue();
+}
+
 CallResult<HermesValue> externCreateThis(
     Runtime *runtime,
     PinnedHermesValue *proto,
@@ -428,15 +657,18 @@ ExecutionStatus externPutNewOwnById(
     Runtime *runtime,
     PinnedHermesValue *target,
     PinnedHermesValue *prop,
-    uint32_t sid) {
+    uint32_t sid,
+    bool enumerable) {
   GCScopeMarkerRAII marker{runtime};
+  auto flags = enumerable ? PropertyFlags::defaultNewNamedPropertyFlags()
+                          : PropertyFlags::nonEnumerablePropertyFlags();
   if (LLVM_LIKELY((*target).isObject())) {
     if (LLVM_UNLIKELY(
             JSObject::defineNewOwnProperty(
                 Handle<JSObject>::vmcast(target),
                 runtime,
                 SymbolID::unsafeCreate(sid),
-                PropertyFlags::defaultNewNamedPropertyFlags(),
+                flags,
                 Handle<>(prop)) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     };
@@ -453,7 +685,7 @@ ExecutionStatus externPutNewOwnById(
                 Handle<JSObject>::vmcast(&scratch),
                 runtime,
                 SymbolID::unsafeCreate(sid),
-                PropertyFlags::defaultNewNamedPropertyFlags(),
+                flags,
                 Handle<>(prop)) == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -595,24 +827,8 @@ void externStoreToEnvironment(
     uint32_t idx,
     PinnedHermesValue *val,
     Runtime *runtime) {
-  // TODO: emit a check if \p val is non-pointer in fast path, if yes, set the
-  // value directly inline without emitting an external call
   vmcast<Environment>(*env)->slot(idx).set(*val, &runtime->getHeap());
 }
-void externStoreNPToEnvironment(
-    PinnedHermesValue *env,
-    uint32_t idx,
-    PinnedHermesValue *val) {
-  // TODO: emit the value setting directly in fast path without emitting an
-  // external call
-  vmcast<Environment>(*env)->slot(idx).setNonPtr(*val);
-}
-
-HermesValue externLoadFromEnvironment(PinnedHermesValue *env, uint32_t idx) {
-  // TODO: emit the instruction directly in fast path instead of emitting an
-  // external call
-  return vmcast<Environment>(*env)->slot(idx);
-}
 
 CallResult<HermesValue>
 externMod(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2) {
@@ -911,7 +1127,13 @@ CallResult<HermesValue> externCreateRegExpMayAllocate(
   auto bytecode =
       codeBlock->getRuntimeModule()->getRegExpBytecodeFromRegExpID(bytecodeIdx);
   if (LLVM_UNLIKELY(
-          JSRegExp::initialize(re, runtime, pattern, flags, bytecode) ==
+          JSRegExp::initialize(
+              re,
+              runtime,
+              pattern,
+              flags,
+              bytecode,
+              codeBlock->getRuntimeModule()->markRegExpCached(bytecodeIdx)) ==
           ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
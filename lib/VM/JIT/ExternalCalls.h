@@ -54,6 +54,74 @@ CallResult<HermesValue> externCreateClosure(
     CodeBlock *codeBlock,
     PinnedHermesValue *env);
 
+/// An external call invoked by JIT compiled code to allocate a
+/// GeneratorFunction for the specified function and the specified environment.
+/// \param runtimeModule the runtime module of the current code block.
+/// \param funcIndex function index in the global function table.
+/// \param env the environment of the closure to be created.
+/// \return a newly created GeneratorFunction.
+CallResult<HermesValue> externCreateGeneratorClosure(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env);
+
+/// An external call invoked by JIT compiled code to allocate a generator for
+/// the specified function, environment and the arguments of the current frame.
+/// \param runtimeModule the runtime module of the current code block.
+/// \param funcIndex function index in the global function table.
+/// \param env the environment of the generator to be created.
+/// \param currentFrame the current frame on the stack.
+/// \return a newly created generator.
+CallResult<HermesValue> externCreateGenerator(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t funcIndex,
+    PinnedHermesValue *env,
+    PinnedHermesValue *currentFrame);
+
+/// An external call invoked by JIT compiled code to start or resume the
+/// generator inner function running in the current frame. A suspended
+/// generator has its saved registers restored into the frame.
+/// \param codeBlock the code block of the generator inner function.
+/// \return the bytecode offset to resume at, or 0 if the generator was just
+///   created and starts from the beginning.
+uint32_t externStartGenerator(Runtime *runtime, CodeBlock *codeBlock);
+
+/// An external call invoked by JIT compiled code to save the registers of the
+/// generator inner function running in the current frame and suspend it.
+/// \param resumeIP the instruction to resume at.
+void externSaveGenerator(Runtime *runtime, const Inst *resumeIP);
+
+/// An external call invoked by JIT compiled code to read the value and the
+/// action a generator was resumed with, throwing the value if the generator
+/// was resumed with throw().
+/// \param result set to the value passed to the generator.
+/// \param isReturn set to whether the generator was resumed with return().
+ExecutionStatus externResumeGenerator(
+    Runtime *runtime,
+    PinnedHermesValue *result,
+    PinnedHermesValue *isReturn);
+
+/// An external call invoked by JIT compiled code to mark the generator inner
+/// function running in the current frame as completed.
+void externCompleteGenerator(Runtime *runtime);
+
+/// An external call invoked by JIT compiled code when an exception reaches a
+/// catch handler. The thrown value is moved into \p dst, unless it is
+/// uncatchable, in which case it is left in place to unwind the frame.
+/// \return EXCEPTION if the thrown value is uncatchable.
+ExecutionStatus externCatch(Runtime *runtime, PinnedHermesValue *dst);
+
+/// An external call invoked by JIT compiled code to close the iterator \p iter
+/// if it is still an object.
+/// \param ignoreInnerException whether an exception thrown while closing the
+///   iterator is discarded, unless it is uncatchable.
+ExecutionStatus externIteratorClose(
+    Runtime *runtime,
+    PinnedHermesValue *iter,
+    bool ignoreInnerException);
+
 /// An external call invoked by JIT compiled code to set an object property by
 /// string index.
 /// \param opFlags property access flags.
@@ -116,6 +184,43 @@ CallResult<HermesValue> externConstruct(
     Inst const *ip,
     PinnedHermesValue *previousFrame);
 
+/// An external call invoked by JIT compiled code to call the function with
+/// the code block \p calleeBlock directly, without a closure.
+/// \param argCount the count of arguments, including the "thisArg"
+/// \param stackPointer the runtime stack pointer
+/// \param ip the ip in the caller code block to be saved before the call
+/// \param previousFrame the previous frame to be saved before the call
+CallResult<HermesValue> externCallDirect(
+    Runtime *runtime,
+    CodeBlock *calleeBlock,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    Inst const *ip,
+    PinnedHermesValue *previousFrame);
+
+/// An external call invoked by JIT compiled code to call a builtin function
+/// with an undefined "thisArg".
+/// \param builtinIndex the index of the builtin function.
+/// \param argCount the count of arguments, including the "thisArg"
+/// \param stackPointer the runtime stack pointer
+/// \param ip the ip in the caller code block to be saved before the call
+/// \param previousFrame the previous frame to be saved before the call
+CallResult<HermesValue> externCallBuiltin(
+    Runtime *runtime,
+    uint32_t builtinIndex,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    Inst const *ip,
+    PinnedHermesValue *previousFrame);
+
+/// An external call invoked by JIT compiled code to throw a ReferenceError for
+/// accessing an uninitialized variable.
+ExecutionStatus externThrowIfUndefined(Runtime *runtime);
+
+/// An external call invoked by JIT compiled code when an asynchronous break
+/// has been requested, to service a pending timeout request.
+ExecutionStatus externAsyncBreakCheck(Runtime *runtime);
+
 /// An slow path invoked by JIT compiled code to convert operands to number
 /// and do subtraction (op1 - op2)
 CallResult<HermesValue>
@@ -180,6 +285,14 @@ CallResult<HermesValue> externAbstractEqualityTest(
 /// JSObject::create
 HermesValue externNewObject(Runtime *runtime);
 
+/// An external call invoked by JIT compiled code to call JSObject::create
+/// with an explicit parent.
+/// \param parent the parent of the object to be created if it is an object,
+///   no parent if it is null, otherwise Object.prototype.
+HermesValue externNewObjectWithParent(
+    Runtime *runtime,
+    PinnedHermesValue *parent);
+
 /// An external call invoked by JIT compiled code to call
 /// Callable::newObject
 /// \param proto prototype of the object to be created
@@ -210,11 +323,13 @@ ExecutionStatus externPutOwnByIndex(
 /// \param target the target to put a property in.
 /// \param prop the property to be put.
 /// \param sid the SymbolID of the property which must already exist in the map.
+/// \param enumerable whether the new property is enumerable.
 ExecutionStatus externPutNewOwnById(
     Runtime *runtime,
     PinnedHermesValue *target,
     PinnedHermesValue *prop,
-    uint32_t sid);
+    uint32_t sid,
+    bool enumerable);
 
 /// An slow path invoked by JIT compiled code to coerce \p thisVal assumed to
 /// contain 'this' to an object
@@ -262,17 +377,6 @@ void externStoreToEnvironment(
     PinnedHermesValue *val,
     Runtime *runtime);
 
-/// An external call invoked by JIT compiled code to store a non-pointer value
-/// \p val to an environment \p env, by the index slot number \p idx
-void externStoreNPToEnvironment(
-    PinnedHermesValue *env,
-    uint32_t idx,
-    PinnedHermesValue *val);
-
-/// An external call invoked by JIT compiled code to \return a value from an
-/// environment \p env, by the index slot number \p idx
-HermesValue externLoadFromEnvironment(PinnedHermesValue *env, uint32_t idx);
-
 /// An external call invoked by JIT compiled code to do mod (op1 % op2)
 CallResult<HermesValue>
 externMod(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2);
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cassert>
+#include <cerrno>
+#include <mutex>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// The jitdump format, as specified in
+/// tools/perf/Documentation/jitdump-specification.txt in the Linux sources.
+/// All fields are in the native byte order.
+
+/// "JiTD", which also identifies the byte order.
+constexpr uint32_t kJITDumpMagic = 0x4A695444;
+constexpr uint32_t kJITDumpVersion = 1;
+/// The ELF machine of the code, EM_X86_64.
+constexpr uint32_t kJITDumpElfMach = 62;
+
+/// Record types.
+enum : uint32_t {
+  JIT_CODE_LOAD = 0,
+  JIT_CODE_CLOSE = 3,
+};
+
+/// The header at the start of the file.
+struct JITDumpHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t totalSize;
+  uint32_t elfMach;
+  uint32_t pad1;
+  uint32_t pid;
+  uint64_t timestamp;
+  uint64_t flags;
+};
+
+/// The header at the start of every record.
+struct JITDumpRecordHeader {
+  uint32_t id;
+  uint32_t totalSize;
+  uint64_t timestamp;
+};
+
+/// A JIT_CODE_LOAD record. It is followed by the zero terminated name of the
+/// function and its code.
+struct JITDumpCodeLoad {
+  JITDumpRecordHeader header;
+  uint32_t pid;
+  uint32_t tid;
+  uint64_t vma;
+  uint64_t codeAddr;
+  uint64_t codeSize;
+  uint64_t codeIndex;
+};
+
+/// \return the timestamp of a record, from the clock that `perf record -k
+///   mono` uses.
+uint64_t jitDumpTimestamp() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/// Write a buffer in its entirety to the file descriptor \p fd.
+void writeAll(int fd, const void *data, size_t size) {
+  auto *p = static_cast<const char *>(data);
+  while (size) {
+    ssize_t written = ::write(fd, p, size);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    p += written;
+    size -= written;
+  }
+}
+
+/// Open the file at \p path for appending, with the additional \p flags.
+/// The file is truncated the first time it is opened by the process, as
+/// recorded in \p opened, since it may be left over from an earlier process
+/// with the same pid.
+int openForAppend(const std::string &path, int flags, bool &opened) {
+  flags |= O_CREAT | O_APPEND;
+  if (!opened)
+    flags |= O_TRUNC;
+  int fd = ::open(path.c_str(), flags, 0666);
+  if (fd >= 0)
+    opened = true;
+  return fd;
+}
+
+/// The output files, shared by the JITPerfMaps of the process. Each file is
+/// open while some JITPerfMap uses it.
+struct PerfSink {
+  /// Protects all the fields, and keeps the records of concurrent writers
+  /// from interleaving.
+  std::mutex mutex{};
+
+  /// The number of JITPerfMaps writing to the perf map.
+  unsigned perfMapUsers{0};
+  /// The file descriptor of the perf map, or -1 if it isn't open.
+  int perfMapFD{-1};
+  /// Whether the perf map was opened by this process.
+  bool perfMapOpened{false};
+
+  /// The number of JITPerfMaps writing to the jitdump.
+  unsigned jitDumpUsers{0};
+  /// The file descriptor of the jitdump, or -1 if it isn't open.
+  int jitDumpFD{-1};
+  /// Whether the jitdump was opened by this process.
+  bool jitDumpOpened{false};
+  /// The marker mapping of the jitdump, which tells perf record where the
+  /// jitdump is.
+  void *jitDumpMarker{nullptr};
+  /// The size of \c jitDumpMarker.
+  size_t jitDumpMarkerSize{0};
+  /// The index of the next code load in the jitdump.
+  uint64_t nextCodeIndex{0};
+
+  /// \return whether the perf map could be opened.
+  bool addPerfMapUser();
+  void removePerfMapUser();
+  /// \return whether the jitdump could be opened.
+  bool addJITDumpUser();
+  void removeJITDumpUser();
+};
+
+bool PerfSink::addPerfMapUser() {
+  if (perfMapUsers == 0) {
+    std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+    perfMapFD = openForAppend(path, O_WRONLY, perfMapOpened);
+    if (perfMapFD < 0)
+      return false;
+  }
+  ++perfMapUsers;
+  return true;
+}
+
+void PerfSink::removePerfMapUser() {
+  assert(perfMapUsers && "the perf map has no users");
+  if (--perfMapUsers == 0) {
+    ::close(perfMapFD);
+    perfMapFD = -1;
+  }
+}
+
+bool PerfSink::addJITDumpUser() {
+  if (jitDumpUsers) {
+    ++jitDumpUsers;
+    return true;
+  }
+
+  std::string path = "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+  jitDumpFD = openForAppend(path, O_RDWR, jitDumpOpened);
+  if (jitDumpFD < 0)
+    return false;
+
+  // perf record finds the jitdump through an executable mapping of it.
+  jitDumpMarkerSize = getpagesize();
+  jitDumpMarker = ::mmap(
+      nullptr,
+      jitDumpMarkerSize,
+      PROT_READ | PROT_EXEC,
+      MAP_PRIVATE,
+      jitDumpFD,
+      0);
+  if (jitDumpMarker == MAP_FAILED) {
+    jitDumpMarker = nullptr;
+    ::close(jitDumpFD);
+    jitDumpFD = -1;
+    return false;
+  }
+
+  // The file is reopened without a header if it was already written to.
+  if (::lseek(jitDumpFD, 0, SEEK_END) == 0) {
+    JITDumpHeader header{};
+    header.magic = kJITDumpMagic;
+    header.version = kJITDumpVersion;
+    header.totalSize = sizeof(header);
+    header.elfMach = kJITDumpElfMach;
+    header.pid = getpid();
+    header.timestamp = jitDumpTimestamp();
+    writeAll(jitDumpFD, &header, sizeof(header));
+  }
+  ++jitDumpUsers;
+  return true;
+}
+
+void PerfSink::removeJITDumpUser() {
+  assert(jitDumpUsers && "the jitdump has no users");
+  if (--jitDumpUsers)
+    return;
+  JITDumpRecordHeader close{};
+  close.id = JIT_CODE_CLOSE;
+  close.totalSize = sizeof(close);
+  close.timestamp = jitDumpTimestamp();
+  writeAll(jitDumpFD, &close, sizeof(close));
+  ::munmap(jitDumpMarker, jitDumpMarkerSize);
+  jitDumpMarker = nullptr;
+  ::close(jitDumpFD);
+  jitDumpFD = -1;
+}
+
+/// \return the sink of the process. It is never destroyed, so that runtimes
+/// destroyed during static destruction can still use it.
+PerfSink &perfSink() {
+  static PerfSink *sink = new PerfSink();
+  return *sink;
+}
+
+} // namespace
+
+JITPerfMap::JITPerfMap(bool perfMap, bool jitDump) {
+  PerfSink &sink = perfSink();
+  std::lock_guard<std::mutex> lk{sink.mutex};
+  perfMap_ = perfMap && sink.addPerfMapUser();
+  jitDump_ = jitDump && sink.addJITDumpUser();
+}
+
+JITPerfMap::~JITPerfMap() {
+  PerfSink &sink = perfSink();
+  std::lock_guard<std::mutex> lk{sink.mutex};
+  if (perfMap_)
+    sink.removePerfMapUser();
+  if (jitDump_)
+    sink.removeJITDumpUser();
+}
+
+void JITPerfMap::addCode(const void *code, size_t size, llvm::StringRef name) {
+  PerfSink &sink = perfSink();
+  std::lock_guard<std::mutex> lk{sink.mutex};
+
+  if (perfMap_) {
+    // Write the entry at once, so that a reader never sees part of it.
+    llvm::SmallString<128> line;
+    llvm::raw_svector_ostream OS{line};
+    OS << llvm::format_hex_no_prefix((uint64_t)code, 1) << ' '
+       << llvm::format_hex_no_prefix(size, 1) << ' ' << name << '\n';
+    writeAll(sink.perfMapFD, line.data(), line.size());
+  }
+
+  if (jitDump_) {
+    JITDumpCodeLoad load{};
+    load.header.id = JIT_CODE_LOAD;
+    load.header.totalSize = sizeof(load) + name.size() + 1 + size;
+    load.header.timestamp = jitDumpTimestamp();
+    load.pid = getpid();
+    load.tid = oscompat::thread_id();
+    load.vma = (uint64_t)code;
+    load.codeAddr = (uint64_t)code;
+    load.codeSize = size;
+    load.codeIndex = sink.nextCodeIndex++;
+    writeAll(sink.jitDumpFD, &load, sizeof(load));
+    writeAll(sink.jitDumpFD, name.data(), name.size());
+    writeAll(sink.jitDumpFD, "", 1);
+    writeAll(sink.jitDumpFD, code, size);
+  }
+}
+
+} // namespace vm
+} // namespace hermes
@@ -13,6 +13,8 @@
 #include "hermes/VM/JIT/DiscoverBB.h"
 #include "hermes/VM/Operations.h"
 
+#include <algorithm>
+
 #define DEBUG_TYPE "jit"
 
 namespace hermes {
@@ -20,6 +22,13 @@ namespace vm {
 namespace x86_64 {
 using hermes::inst::Inst;
 
+#ifdef HERMESVM_COMPRESSED_POINTERS
+/// The operand size of a GCPointer field in a heap object.
+static constexpr S kGCPointerSize = S::L;
+#else
+static constexpr S kGCPointerSize = S::Q;
+#endif
+
 FastJIT::FastJIT(JITContext *context, CodeBlock *codeBlock)
     : context_(context), codeBlock_(codeBlock) {}
 
@@ -62,6 +71,7 @@ void FastJIT::compile() {
   // Emit the function epilogue.
   nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
   emit = emitEpilogue(emit);
+  emit = emitOSREntry(emit);
 
   resolveRelocations();
 
@@ -70,10 +80,10 @@ void FastJIT::compile() {
     disassembleResult(emit, llvm::outs(), false);
 
   if (!error_) {
-    context_->getHeap().freeRemaining(
-        *blocks,
-        {emit.fast.current() - fast_.data(),
-         emit.slow.current() - slow_.data()});
+    codeSizes_ = {emit.fast.current() - fast_.data(),
+                  emit.slow.current() - slow_.data()};
+    context_->getHeap().freeRemaining(*blocks, codeSizes_);
+    codeBlock_->setJITOSREntry((JITOSREntryPtr)osrEntry_);
     codeBlock_->setJITCompiled((JITCompiledFunctionPtr)fast_.data());
 
     // Dump the heap at the end.
@@ -106,7 +116,10 @@ llvm::Optional<ExecHeap::BlockPair> FastJIT::allocRWX(
   if (!blocks) {
     auto newPool = context_->getHeap().addPool();
     if (!newPool) {
-      error("out of executable memory");
+      // Not an error: the function can be compiled once cold functions have
+      // been evicted.
+      LLVM_DEBUG(llvm::dbgs() << "FastJIT: out of executable memory\n");
+      outOfMemory_ = true;
       return llvm::None;
     }
     initializeNewPool(newPool);
@@ -148,6 +161,11 @@ void FastJIT::disassembleResult(
     last = nativeBBAddress_[i];
     OS << "BB" << i << ":\n";
   }
+  if (osrEntry_) {
+    disassembleRange(last, osrEntry_, OS, withAddr);
+    last = osrEntry_;
+    OS << "OSR:\n";
+  }
   disassembleRange(last, emit.fast.current(), OS, withAddr);
 
 #ifndef NDEBUG
@@ -181,6 +199,10 @@ void FastJIT::applyRelocation(const Relo &relo, const uint8_t *target) {
       *reinterpret_cast<uint32_t *>(relo.address) = offset;
       break;
 
+    case ReloKind::Abs64:
+      *reinterpret_cast<uint64_t *>(relo.address) = (uint64_t)target;
+      break;
+
     case ReloKind::None:
       llvm_unreachable("ReloKind::None can not be relocated. ");
   }
@@ -225,8 +247,10 @@ Emitters FastJIT::emitPrologue(Emitters emit) {
 
   // Push runtime->currentFrame into the native stack.
   emit.fast.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
-  // Align the native stack to 16 bytes.
-  emit.fast.pushqReg(Reg::rcx);
+  // Push runtime->currentIP, which external calls overwrite but an
+  // interpreted caller reloads its ip from. This also aligns the native stack
+  // to 16 bytes.
+  emit.fast.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentIP);
 
   // Load runtime->stackPointer_ top into RegFrame
   emit.fast.movRMToReg<S::Q>(
@@ -263,8 +287,8 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
   emit.fast.movRegToRM<S::Q>(
       RegFrame, RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer);
 
-  // Pop the stack alignment.
-  emit.fast.popqReg(Reg::rcx);
+  // Pop runtime->currentIP from the native stack.
+  emit.fast.popqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentIP);
   // Pop runtime->currentFrame_ from the native stack.
   emit.fast.popqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
 
@@ -278,6 +302,47 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
   return emit;
 }
 
+Emitters FastJIT::emitOSREntry(Emitters emit) {
+  if (loopHeaders_.empty())
+    return emit;
+  if (!checkSpace(emit))
+    return emit;
+
+  osrEntry_ = emit.fast.current();
+
+  // Save the same state as the prologue, so the epilogue can be shared.
+  emit.fast.pushqReg(Reg::rbp);
+  emit.fast.movRegToReg<S::Q>(Reg::rsp, Reg::rbp);
+  emit.fast.pushqReg(RegFrame);
+  emit.fast.pushqReg(RegRuntime);
+  emit.fast.movRegToReg<S::Q>(Reg::rdi, RegRuntime);
+  emit.fast.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
+  emit.fast.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentIP);
+
+  // The interpreter has already allocated the frame, which is the current
+  // one, so RegFrame is runtime->currentFrame_ and the epilogue leaves it
+  // current.
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame, RegFrame);
+
+  // Dispatch on the bytecode offset of the loop header.
+  std::sort(loopHeaders_.begin(), loopHeaders_.end());
+  loopHeaders_.erase(
+      std::unique(loopHeaders_.begin(), loopHeaders_.end()),
+      loopHeaders_.end());
+  for (unsigned bb : loopHeaders_) {
+    if (!checkSpace(emit))
+      return emit;
+    emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(
+        bcBasicBlocks_[bb], Reg::esi, Reg::NoIndex, 0);
+    emit.fast.cjump<CCode::E, OffsetType::Auto>(nativeBBAddress_[bb]);
+  }
+  // The interpreter only enters at the target of a backward jump.
+  emit.fast.ud2();
+
+  return emit;
+}
+
 // Calculate the address of the next instruction given the name of the current
 // one.
 #define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
@@ -441,7 +506,17 @@ Emitters FastJIT::compileBB(Emitters emit) {
 
       CASE(DeclareGlobalVar);
       CASE(CreateEnvironment);
-      CASE(CreateClosure);
+      CASE_WITH_SUFFIX(CreateClosure, , op3);
+      CASE_WITH_SUFFIX(CreateClosure, LongIndex, op3);
+      CASE_WITH_SUFFIX(CreateGeneratorClosure, , op3);
+      CASE_WITH_SUFFIX(CreateGeneratorClosure, LongIndex, op3);
+      CASE_WITH_SUFFIX(CreateGenerator, , op3);
+      CASE_WITH_SUFFIX(CreateGenerator, LongIndex, op3);
+      CASE(StartGenerator);
+      CASE_WITH_SUFFIX(SaveGenerator, , op1);
+      CASE_WITH_SUFFIX(SaveGenerator, Long, op1);
+      CASE(ResumeGenerator);
+      CASE(CompleteGenerator);
       CASE(GetGlobalObject);
       CASE(PutById);
       CASE(TryPutById);
@@ -462,10 +537,15 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE(CallLong);
       CASE(Construct);
       CASE(ConstructLong);
+      CASE_WITH_SUFFIX(CallDirect, , op3);
+      CASE_WITH_SUFFIX(CallDirect, LongIndex, op3);
+      CASE(CallBuiltin);
       CASE(LoadConstZero);
       LOAD_CONST_STRING(LoadConstString);
       LOAD_CONST_STRING(LoadConstStringLongIndex);
-      CASE(LoadParam);
+      CASE_WITH_SUFFIX(LoadParam, , op2);
+      CASE_WITH_SUFFIX(LoadParam, Long, op2);
+      CASE(GetNewTarget);
       BINOP(Add);
       CASE(AddN);
       BINOP(Sub);
@@ -529,6 +609,7 @@ Emitters FastJIT::compileBB(Emitters emit) {
       LOAD_CONST_INT(LoadConstNull, HermesValue::encodeNullValue());
 
       CASE(NewObject);
+      CASE(NewObjectWithParent);
       CASE_3REG(CreateThis);
       CASE(SelectObject);
       CASE(NewArray);
@@ -539,12 +620,14 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE_WITH_SUFFIX(PutNewOwnById, , op3);
       CASE_WITH_SUFFIX(PutNewOwnById, Short, op3);
       CASE_WITH_SUFFIX(PutNewOwnById, Long, op3);
+      CASE_WITH_SUFFIX(PutNewOwnNEById, , op3);
+      CASE_WITH_SUFFIX(PutNewOwnNEById, Long, op3);
       CASE(LoadThisNS);
       CASE(CoerceThisNS);
       CASE(Throw);
       CASE(NewObjectWithBuffer);
       CASE(NewObjectWithBufferLong);
-      CASE_3REG(GetByVal);
+      CASE(GetByVal);
       CASE(PutByVal);
       CASE(DelByVal);
       CASE(StoreToEnvironment);
@@ -573,6 +656,35 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE_3REG(IsIn);
       CASE_3REG(InstanceOf);
       CASE(CreateRegExp);
+      CASE(SwitchImm);
+      CASE(ThrowIfUndefinedInst);
+      CASE(AsyncBreakCheck);
+      CASE(IteratorClose);
+
+/// Compile instructions that are implemented out of line by the interpreter.
+#define INTERPRETER_CASE(name)                                             \
+  case OpCode::name:                                                       \
+    emit = callInterpreterCase(emit, ip, (void *)Interpreter::case##name); \
+    ip = NEXTINST(name);                                                   \
+    break
+
+      INTERPRETER_CASE(DirectEval);
+      INTERPRETER_CASE(PutOwnByVal);
+      INTERPRETER_CASE(PutOwnGetterSetterByVal);
+      INTERPRETER_CASE(IteratorBegin);
+      INTERPRETER_CASE(IteratorNext);
+
+      // Compiled code doesn't support the debugger or the sampling profiler.
+      case OpCode::Debugger:
+        ip = NEXTINST(Debugger);
+        break;
+      case OpCode::ProfilePoint:
+        ip = NEXTINST(ProfilePoint);
+        break;
+      case OpCode::Unreachable:
+        emit.fast.ud2();
+        ip = NEXTINST(Unreachable);
+        break;
 
       default:
         error(
@@ -636,7 +748,10 @@ FastJIT::loadConstantIntoNativeReg(Emitters emit, HermesValue cval, Reg reg) {
 }
 
 Emitters
-FastJIT::loadConstantAddrIntoNativeReg(Emitters emit, void *addr, Reg reg) {
+FastJIT::loadConstantAddrIntoNativeReg(
+    Emitters emit,
+    const void *addr,
+    Reg reg) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, addr, constAddr);
 
@@ -730,11 +845,20 @@ inline Emitter FastJIT::callAbsolute(Emitter emit, const void *dest) {
   return emit;
 }
 
+Emitter FastJIT::captureIP(Emitter emit, const Inst *ip) {
+  emit.movqImmToReg((uint64_t)ip, Reg::rax);
+  emit.movRegToRM<S::Q>(
+      Reg::rax, RegRuntime, Reg::NoIndex, RuntimeOffsets::currentIP);
+  return emit;
+}
+
 Emitter FastJIT::callExternal(
     Emitter emit,
     const uint8_t *dest,
     OperandReg32 resultReg,
     const Inst *ip) {
+  emit = captureIP(emit, ip);
+
   // Runtime -> arg1.
   emit.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
 
@@ -760,6 +884,8 @@ Emitter FastJIT::callExternalNoReturnedVal(
     Emitter emit,
     const uint8_t *dest,
     const Inst *ip) {
+  emit = captureIP(emit, ip);
+
   // Runtime -> arg1.
   emit.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
 
@@ -808,7 +934,7 @@ Emitters FastJIT::callHelper(
       RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
 
   // ip -> arg5
-  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r8);
+  emit = loadConstantAddrIntoNativeReg(emit, ip, Reg::r8);
 
   // currentFrame -> arg6
   emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
@@ -893,6 +1019,7 @@ Emitter FastJIT::jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB) {
 
   // Backwards branch doesn't need a relocation and we can determine the offset.
   if (bytecodeBB <= curBytecodeBBIndex_) {
+    loopHeaders_.push_back(bytecodeBB);
     emit.jmp<OffsetType::Auto>(nativeBBAddress_[bytecodeBB]);
   } else {
     // Forward branch: emit a long jump and record a relocation.
@@ -906,6 +1033,7 @@ Emitter
 FastJIT::cjmpToBytecodeBB(Emitter emit, uint8_t opCode, unsigned bytecodeBB) {
   // Backwards branch doesn't need a relocation and we can determine the offset.
   if (bytecodeBB <= curBytecodeBBIndex_) {
+    loopHeaders_.push_back(bytecodeBB);
     emit.cjumpOP<OffsetType::Auto>(opCode, nativeBBAddress_[bytecodeBB]);
   } else {
     // Forward branch: emit a long jump and record a relocation.
@@ -977,28 +1105,56 @@ inline Emitters FastJIT::getByIdHelper(
       : PropOpFlags();
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
+  auto cacheIdx = ip->iGetById.op3;
+
+  uint8_t *codeBlockAddr;
+  emit.slow = getConstant(emit.slow, codeBlock_, codeBlockAddr);
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externGetById, constAddr);
+
+  // Without a cache there is no fast path, so the call is emitted inline.
+  bool cached = cacheIdx != hbc::PROPERTY_CACHING_DISABLED;
+  const uint8_t *slowPathAddr = emit.slow.current();
+  Emitter &call = cached ? emit.slow : emit.fast;
+
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  call.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
 
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the string id map, so we could just pass
   // the IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  call.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iGetById.op2, Reg::rcx);
+  call = leaHermesReg(call, ip->iGetById.op2, Reg::rcx);
   // cacheIdx -> arg5
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iGetById.op3, Reg::r8d);
+  call.movImmToReg<S::L>(cacheIdx, Reg::r8d);
   // current code block -> arg6
-  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::r9);
+  call.movRMToReg<S::Q, ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0, Reg::r9);
+  applyRIP32Offset(call.current(), codeBlockAddr);
 
-  uint8_t *constAddr;
-  emit.slow = getConstant(emit.slow, (void *)externGetById, constAddr);
-  emit.fast = callExternal(emit.fast, constAddr, ip->iGetById.op1, ip);
+  call = callExternal(call, constAddr, ip->iGetById.op1, ip);
+  if (!cached)
+    return emit;
+
+  emit.slow.jmp<OffsetType::Int32>(emit.slow.current());
+  Relo relo{ReloKind::Int32, emit.slow.current() - 4, 0};
+  describeSlowPathSection(emit.slow, false);
+
+  // Fast path: read a direct property of an object whose class is cached.
+  emit.fast =
+      loadObjectPointer(emit.fast, ip->iGetById.op2, Reg::rdx, slowPathAddr);
+  emit = propertyCacheCheck(
+      emit, codeBlock_->getReadCache(cacheIdx), slowPathAddr);
+  emit.fast.movRMToReg<S::Q, 8>(
+      Reg::rdx, Reg::rsi, ObjectOffsets::directProps, Reg::rax);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetById.op1);
+
+  applyRelocation(relo, emit.fast.current());
   return emit;
 }
 
@@ -1068,27 +1224,54 @@ inline Emitters FastJIT::putByIdHelper(
       : PropOpFlags();
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
+  auto cacheIdx = ip->iPutById.op3;
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externPutById, constAddr);
+
+  // Without a cache there is no fast path, so the call is emitted inline.
+  bool cached = cacheIdx != hbc::PROPERTY_CACHING_DISABLED;
+  const uint8_t *slowPathAddr = emit.slow.current();
+  Emitter &call = cached ? emit.slow : emit.fast;
+
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  call.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the map, so we could just pass the
   // IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  call.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op1, Reg::rcx);
+  call = leaHermesReg(call, ip->iPutById.op1, Reg::rcx);
   //&prop -> arg5
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op2, Reg::r8);
+  call = leaHermesReg(call, ip->iPutById.op2, Reg::r8);
   // cacheIdx -> arg6
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iPutById.op3, Reg::r9d);
+  call.movImmToReg<S::L>(cacheIdx, Reg::r9d);
 
-  uint8_t *constAddr;
-  emit.slow = getConstant(emit.slow, (void *)externPutById, constAddr);
-  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+  call = callExternalNoReturnedVal(call, constAddr, ip);
+  if (!cached)
+    return emit;
+
+  emit.slow.jmp<OffsetType::Int32>(emit.slow.current());
+  Relo relo{ReloKind::Int32, emit.slow.current() - 4, 0};
+  describeSlowPathSection(emit.slow, false);
+
+  // Fast path: overwrite a direct property of an object whose class is
+  // cached. Storing a pointer needs a write barrier, so it takes the slow path.
+  emit.fast = isNonPointer(emit.fast, ip->iPutById.op2, slowPathAddr);
+  emit.fast =
+      loadObjectPointer(emit.fast, ip->iPutById.op1, Reg::rdx, slowPathAddr);
+  emit = propertyCacheCheck(
+      emit, codeBlock_->getWriteCache(cacheIdx), slowPathAddr);
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iPutById.op2, Reg::rax);
+  emit.fast.movRegToRM<S::Q, 8>(
+      Reg::rax, Reg::rdx, Reg::rsi, ObjectOffsets::directProps);
+
+  applyRelocation(relo, emit.fast.current());
   return emit;
 }
 
@@ -1131,13 +1314,14 @@ Emitters FastJIT::compileCreateEnvironment(Emitters emit, const Inst *ip) {
   return emit;
 }
 
-Emitters FastJIT::compileCreateClosure(Emitters emit, const Inst *ip) {
+Emitters
+FastJIT::compileCreateClosure(Emitters emit, const Inst *ip, uint32_t idx) {
   // Code blocks are allocated in C heap, so their addresses are constant,
   // and can be embedded in JIT'ed code.
   // &calleeCodeBlock  -> arg2
   CodeBlock *calleeBlock =
-      codeBlock_->getRuntimeModule()->getCodeBlockMayAllocate(
-          ip->iCreateClosure.op3);
+      codeBlock_->getRuntimeModule()->getCodeBlockIfCreated(idx);
+  assert(calleeBlock && "closure CodeBlock must be created before compiling");
   emit = loadConstantAddrIntoNativeReg(emit, calleeBlock, Reg::rsi);
 
   //&env -> arg3
@@ -1320,7 +1504,7 @@ inline Emitter FastJIT::cmpSomeNPTag(Emitter emit, uint32_t regIndex) {
       tag < FirstPointerTag,
       "String or object tag could not be compared directly with a HermesValue's higher 32 bits.");
   emit.cmpImmToRM<S::L>(
-      tag << (32 - HermesValue::kTagWidth),
+      tag << (HermesValue::kNumDataBits - 32),
       RegFrame,
       Reg::NoIndex,
       // Compare the higher 32 bits (tag) of the HermesValue
@@ -1333,7 +1517,7 @@ inline Emitter FastJIT::cmpSomeNPETag(Emitter emit, uint32_t regIndex) {
       etag < ETag::FirstPointer,
       "String or object tag could not be compared directly with a HermesValue's higher 32 bits.");
   emit.cmpImmToRM<S::L>(
-      (uint32_t)etag << (32 - HermesValue::kETagWidth),
+      (uint32_t)etag << (HermesValue::kNumDataBits - 1 - 32),
       RegFrame,
       Reg::NoIndex,
       // Compare the higher 32 bits (tag) of the HermesValue
@@ -1359,12 +1543,13 @@ Emitters FastJIT::compileJmpUndefinedLong(Emitters emit, const Inst *ip) {
       emit, ip, ip->iJmpUndefinedLong.op1, ip->iJmpUndefinedLong.op2);
 }
 
-Emitters FastJIT::compileLoadParam(Emitters emit, const Inst *ip) {
+Emitters
+FastJIT::compileLoadParam(Emitters emit, const Inst *ip, uint32_t idx) {
   // rax = undefined
   emit = loadConstantIntoNativeReg(
       emit, HermesValue::encodeUndefinedValue(), Reg::rax);
   emit.fast.cmpImmToRM<S::L>(
-      ip->iLoadParam.op2,
+      idx,
       RegFrame,
       Reg::NoIndex,
       sizeof(HermesValue) * StackFrameLayout::ArgCount);
@@ -1375,7 +1560,7 @@ Emitters FastJIT::compileLoadParam(Emitters emit, const Inst *ip) {
   emit.fast.movRMToReg<S::Q>(
       RegFrame,
       Reg::NoIndex,
-      sizeof(HermesValue) * StackFrameLayout::argOffset(ip->iLoadParam.op2 - 1),
+      sizeof(HermesValue) * StackFrameLayout::argOffset(idx - 1),
       Reg::rax);
 
   applyRelocation(relo, emit.fast.current());
@@ -1447,7 +1632,7 @@ Emitters FastJIT::compileDivN(Emitters emit, const Inst *ip) {
 
 Emitter FastJIT::isNumber(Emitter emit, uint32_t regIndex, uint8_t *callStub) {
   emit.cmpImmToRM<S::L>(
-      FirstTag << (32 - HermesValue::kTagWidth),
+      FirstTag << (HermesValue::kNumDataBits - 32),
       RegFrame,
       Reg::NoIndex,
       // Compare the higher 32 bits (tag) of the HermesValue
@@ -1462,6 +1647,20 @@ Emitter FastJIT::isString(Emitter emit, uint32_t regIndex, uint8_t *callStub) {
   return emit;
 }
 
+Emitter FastJIT::isNonPointer(
+    Emitter emit,
+    uint32_t regIndex,
+    const uint8_t *callStub) {
+  emit.cmpImmToRM<S::L>(
+      FirstPointerTag << (HermesValue::kNumDataBits - 32),
+      RegFrame,
+      Reg::NoIndex,
+      // Compare the higher 32 bits (tag) of the HermesValue
+      localHermesRegByteOffset(regIndex) + 4);
+  emit.cjump<CCode::AE, OffsetType::Int32>(callStub);
+  return emit;
+}
+
 Emitters FastJIT::callSlowPathBinOp(
     Emitters emit,
     const Inst *ip,
@@ -1746,6 +1945,19 @@ FastJIT::compilePutOwnByIndex(Emitters emit, const Inst *ip, uint32_t idx) {
 
 Emitters
 FastJIT::compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx) {
+  return putNewOwnByIdHelper(emit, ip, idx, true);
+}
+
+Emitters
+FastJIT::compilePutNewOwnNEById(Emitters emit, const Inst *ip, uint32_t idx) {
+  return putNewOwnByIdHelper(emit, ip, idx, false);
+}
+
+Emitters FastJIT::putNewOwnByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t idx,
+    bool enumerable) {
   // Object to put property in -> arg2
   emit.fast = leaHermesReg(emit.fast, ip->iPutOwnByIndex.op1, Reg::rsi);
   // Property to be put -> arg3
@@ -1757,6 +1969,8 @@ FastJIT::compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx) {
           ->getSymbolIDMustExist(idx)
           .unsafeGetIndex(),
       Reg::ecx);
+  // Whether the property is enumerable -> arg5
+  emit.fast.movImmToReg<S::L>(enumerable, Reg::r8d);
 
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externPutNewOwnById, constAddr);
@@ -1776,7 +1990,9 @@ Emitters FastJIT::compileCoerceThisNS(Emitters emit, const Inst *ip) {
 }
 
 inline Emitter FastJIT::cmpNullOrUndefinedTag(Emitter emit, uint32_t regIdx) {
-  return cmpSomeNPTag<UndefinedNullTag>(emit, regIdx);
+  // Undefined and null only differ in the extended tag bit, so compare the
+  // tag alone.
+  return cmpSomePointerTag(emit, regIdx, UndefinedNullTag);
 }
 
 Emitters
@@ -1884,18 +2100,22 @@ unsigned FastJIT::getCatchHandlerBBIndex(const Inst *ip) {
 }
 
 Emitters FastJIT::compileCatch(Emitters emit, const Inst *ip) {
+  // &dst -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iCatch.op1, Reg::rsi);
+
   uint8_t *constAddr;
-  emit.slow =
-      getConstant(emit.slow, HermesValue::encodeEmptyValue(), constAddr);
+  emit.slow = getConstant(emit.slow, (void *)externCatch, constAddr);
 
-  emit.fast = movRuntimeVarToHermesReg(
-      emit.fast, RuntimeOffsets::thrownValue, ip->iCatch.op1);
-  // Clear Runtime::thrownValue_
-  emit.fast.movRMToReg<S::Q, ScaleRIPAddr32>(
-      Reg::none, Reg::NoIndex, 0, Reg::rax);
+  // Runtime -> arg1.
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
   applyRIP32Offset(emit.fast.current(), constAddr);
-  emit.fast.movRegToRM<S::Q>(
-      Reg::rax, RegRuntime, Reg::NoIndex, RuntimeOffsets::thrownValue);
+
+  // An uncatchable error skips every handler in this function, as in the
+  // interpreter, and is returned from the exit block.
+  emit.fast.testRegToReg<S::L>(Reg::eax, Reg::eax);
+  emit.fast = cjmpToBytecodeBB(
+      emit.fast, CJumpOp<CCode::Z>::OP, bcBasicBlocks_.size() - 1);
 
   return emit;
 }
@@ -1945,22 +2165,79 @@ Emitters FastJIT::newObjectWithBufferHelper(
   return emit;
 }
 
+Emitters FastJIT::compileGetByVal(Emitters emit, const Inst *ip) {
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externGetByVal, constAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // Slow path: object -> arg2, nameVal -> arg3
+  emit.slow = leaHermesReg(emit.slow, ip->iGetByVal.op2, Reg::rsi);
+  emit.slow = leaHermesReg(emit.slow, ip->iGetByVal.op3, Reg::rdx);
+  emit.slow = callExternal(emit.slow, constAddr, ip->iGetByVal.op1, ip);
+  emit.slow.jmp<OffsetType::Int32>(emit.slow.current());
+  Relo relo{ReloKind::Int32, emit.slow.current() - 4, 0};
+  describeSlowPathSection(emit.slow, false);
+
+  // Fast path: read an existing element of an array.
+  emit.fast =
+      loadObjectPointer(emit.fast, ip->iGetByVal.op2, Reg::rdx, slowPathAddr);
+  emit = arrayIndexCheck(emit, ip->iGetByVal.op3, slowPathAddr);
+  emit.fast.movRMToReg<S::Q, 8>(
+      Reg::rcx,
+      Reg::rax,
+      ObjectOffsets::segmentedArrayInlineStorage,
+      Reg::rax);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetByVal.op1);
+
+  applyRelocation(relo, emit.fast.current());
+  return emit;
+}
+
 Emitters FastJIT::compilePutByVal(Emitters emit, const Inst *ip) {
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externPutByVal, constAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
   // object -> arg2
-  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op1, Reg::rsi);
+  emit.slow = leaHermesReg(emit.slow, ip->iPutByVal.op1, Reg::rsi);
   // nameVal -> arg3
-  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op2, Reg::rdx);
+  emit.slow = leaHermesReg(emit.slow, ip->iPutByVal.op2, Reg::rdx);
   // property value -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iPutByVal.op3, Reg::rcx);
+  emit.slow = leaHermesReg(emit.slow, ip->iPutByVal.op3, Reg::rcx);
   // PropOpFlags -> arg5
   auto defaultPropOpFlags = codeBlock_->isStrictMode()
       ? PropOpFlags().plusThrowOnError()
       : PropOpFlags();
-  emit.fast.movImmToReg<S::L>(defaultPropOpFlags.getRaw(), Reg::r8d);
+  emit.slow.movImmToReg<S::L>(defaultPropOpFlags.getRaw(), Reg::r8d);
 
-  uint8_t *constAddr;
-  emit.slow = getConstant(emit.slow, (void *)externPutByVal, constAddr);
-  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+  emit.slow = callExternalNoReturnedVal(emit.slow, constAddr, ip);
+  emit.slow.jmp<OffsetType::Int32>(emit.slow.current());
+  Relo relo{ReloKind::Int32, emit.slow.current() - 4, 0};
+  describeSlowPathSection(emit.slow, false);
+
+  // Fast path: overwrite an existing element of an array that is not frozen,
+  // as ArrayImpl::trySetExistingElementAt does. Storing a pointer needs a
+  // write barrier, so it takes the slow path.
+  emit.fast = isNonPointer(emit.fast, ip->iPutByVal.op3, slowPathAddr);
+  emit.fast =
+      loadObjectPointer(emit.fast, ip->iPutByVal.op1, Reg::rdx, slowPathAddr);
+  ObjectFlags frozen;
+  frozen.frozen = true;
+  emit.fast.testImmToRM<S::L>(
+      ObjectOffsets::objectFlagsBits(frozen),
+      Reg::rdx,
+      Reg::NoIndex,
+      ObjectOffsets::objectFlags);
+  emit.fast.cjump<CCode::NZ, OffsetType::Int32>(slowPathAddr);
+  emit = arrayIndexCheck(emit, ip->iPutByVal.op2, slowPathAddr);
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iPutByVal.op3, Reg::rdx);
+  emit.fast.movRegToRM<S::Q, 8>(
+      Reg::rdx,
+      Reg::rcx,
+      Reg::rax,
+      ObjectOffsets::segmentedArrayInlineStorage);
+
+  applyRelocation(relo, emit.fast.current());
   return emit;
 }
 
@@ -1979,27 +2256,46 @@ Emitters FastJIT::storeToEnvironmentHelper(
     uint32_t idx,
     uint32_t op3,
     bool isNP) {
-  // environment -> arg1
-  emit.fast = leaHermesReg(emit.fast, op1, Reg::rdi);
-  // slot index -> arg2
-  emit.fast.movImmToReg<S::L>(idx, Reg::rsi);
-  // value -> arg3
-  emit.fast = leaHermesReg(emit.fast, op3, Reg::rdx);
-
-  if (!isNP)
+  uint8_t *slowPathAddr = nullptr;
+  Relo relo{ReloKind::None, nullptr, 0};
+  if (!isNP) {
+    uint8_t *constAddr;
+    emit.slow =
+        getConstant(emit.slow, (void *)externStoreToEnvironment, constAddr);
+    slowPathAddr = emit.slow.current();
+
+    // environment -> arg1
+    emit.slow = leaHermesReg(emit.slow, op1, Reg::rdi);
+    // slot index -> arg2
+    emit.slow.movImmToReg<S::L>(idx, Reg::esi);
+    // value -> arg3
+    emit.slow = leaHermesReg(emit.slow, op3, Reg::rdx);
     // runtime -> arg4
-    emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rcx);
+    emit.slow.movRegToReg<S::Q>(RegRuntime, Reg::rcx);
+    emit.slow.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+    applyRIP32Offset(emit.slow.current(), constAddr);
+    // the external call returns void
 
-  uint8_t *constAddr;
-  emit.slow = getConstant(
-      emit.slow,
-      isNP ? (void *)externStoreNPToEnvironment
-           : (void *)externStoreToEnvironment,
-      constAddr);
-  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
-  applyRIP32Offset(emit.fast.current(), constAddr);
-  // the external call returns void
+    emit.slow.jmp<OffsetType::Int32>(emit.slow.current());
+    relo = {ReloKind::Int32, emit.slow.current() - 4, 0};
+    describeSlowPathSection(emit.slow, false);
 
+    emit.fast = isNonPointer(emit.fast, op3, slowPathAddr);
+  }
+
+  // Fast path: store the value to the slot directly.
+  emit.fast = movHermesRegToNativeReg(emit.fast, op1, Reg::rcx);
+  emit.fast.shlImm8ToReg(64 - HermesValue::kNumDataBits, Reg::rcx);
+  emit.fast.shrImm8ToReg(64 - HermesValue::kNumDataBits, Reg::rcx);
+  emit.fast = movHermesRegToNativeReg(emit.fast, op3, Reg::rax);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rax,
+      Reg::rcx,
+      Reg::NoIndex,
+      ObjectOffsets::environmentSlots + idx * sizeof(GCHermesValue));
+
+  if (!isNP)
+    applyRelocation(relo, emit.fast.current());
   return emit;
 }
 Emitters FastJIT::compileStoreToEnvironment(Emitters emit, const Inst *ip) {
@@ -2039,13 +2335,16 @@ Emitters FastJIT::compileLoadFromEnvironment(
     Emitters emit,
     const Inst *ip,
     uint32_t idx) {
-  emit.fast = leaHermesReg(emit.fast, ip->iLoadFromEnvironment.op2, Reg::rdi);
-  emit.fast.movImmToReg<S::L>(idx, Reg::rsi);
-  uint8_t *constAddr;
-  emit.slow =
-      getConstant(emit.slow, (void *)externLoadFromEnvironment, constAddr);
-  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
-  applyRIP32Offset(emit.fast.current(), constAddr);
+  // Load the value from the slot of the environment directly.
+  emit.fast = movHermesRegToNativeReg(
+      emit.fast, ip->iLoadFromEnvironment.op2, Reg::rcx);
+  emit.fast.shlImm8ToReg(64 - HermesValue::kNumDataBits, Reg::rcx);
+  emit.fast.shrImm8ToReg(64 - HermesValue::kNumDataBits, Reg::rcx);
+  emit.fast.movRMToReg<S::Q>(
+      Reg::rcx,
+      Reg::NoIndex,
+      ObjectOffsets::environmentSlots + idx * sizeof(GCHermesValue),
+      Reg::rax);
 
   emit.fast = movNativeRegToHermesReg(
       emit.fast, Reg::rax, ip->iLoadFromEnvironment.op1);
@@ -2172,13 +2471,18 @@ Emitters FastJIT::compileNegate(Emitters emit, const Inst *ip) {
 }
 
 Emitters FastJIT::compileGetPNameList(Emitters emit, const Inst *ip) {
+  return callInterpreterCase(
+      emit, ip, (void *)Interpreter::handleGetPNameList);
+}
+
+Emitters
+FastJIT::callInterpreterCase(Emitters emit, const Inst *ip, void *caseImpl) {
   uint8_t *externAddr;
-  emit.slow = getConstant(
-      emit.slow, (void *)Interpreter::handleGetPNameList, externAddr);
-  // The frameRegs used in Interpreter::handleGetPNameList is actually the first
-  // local variable, not the stack pointer; so we just pass the address of r0.
+  emit.slow = getConstant(emit.slow, caseImpl, externAddr);
+  // The frameRegs used by the interpreter is actually the first local
+  // variable, not the stack pointer; so we just pass the address of r0.
   emit.fast = leaHermesReg(emit.fast, 0, Reg::rsi);
-  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rdx);
+  emit = loadConstantAddrIntoNativeReg(emit, ip, Reg::rdx);
   emit.fast = callExternalNoReturnedVal(emit.fast, externAddr, ip);
   return emit;
 }
@@ -2315,6 +2619,426 @@ Emitters FastJIT::compileCreateRegExp(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitter FastJIT::loadObjectPointer(
+    Emitter emit,
+    uint32_t regIndex,
+    Reg dst,
+    const uint8_t *notObject) {
+  assert(dst != Reg::rax && "%rax is clobbered by the tag check");
+  emit = movHermesRegToNativeReg(emit, regIndex, dst);
+  emit.movRegToReg<S::Q>(dst, Reg::rax);
+  emit.shrImm8ToReg(HermesValue::kNumDataBits, Reg::rax);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(ObjectTag, Reg::eax, Reg::none, 0);
+  emit.cjump<CCode::NE, OffsetType::Int32>(notObject);
+  // Strip the tag.
+  emit.shlImm8ToReg(64 - HermesValue::kNumDataBits, dst);
+  emit.shrImm8ToReg(64 - HermesValue::kNumDataBits, dst);
+  return emit;
+}
+
+Emitter FastJIT::loadGCPointerField(
+    Emitter emit,
+    Reg base,
+    int32_t offset,
+    Reg dst,
+    Reg tmp) {
+  emit.movRMToReg<kGCPointerSize>(base, Reg::NoIndex, offset, dst);
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  // Add the biased start of the segment, which is indexed by the high bits of
+  // the BasedPointer; see PointerBase::basedToPointer().
+  emit.movRegToReg<S::Q>(dst, tmp);
+  emit.shrImm8ToReg(AlignedStorage::kLogSize, tmp);
+  emit.addRmToReg<S::Q, 8>(RegRuntime, tmp, RuntimeOffsets::segmentMap, dst);
+#else
+  (void)tmp;
+#endif
+  return emit;
+}
+
+Emitters FastJIT::arrayIndexCheck(
+    Emitters emit,
+    uint32_t regIndex,
+    const uint8_t *slowPath) {
+  // Is it a JSArray?
+  emit = loadConstantAddrIntoNativeReg(
+      emit, const_cast<VTable *>(&JSArray::vt.base), Reg::rax);
+  emit.fast.cmpRmToReg<S::Q>(
+      Reg::rdx, Reg::NoIndex, ObjectOffsets::vtable, Reg::rax);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPath);
+
+  // Are its elements ordinary data properties?
+  ObjectFlags fastIndex;
+  fastIndex.fastIndexProperties = true;
+  emit.fast.testImmToRM<S::L>(
+      ObjectOffsets::objectFlagsBits(fastIndex),
+      Reg::rdx,
+      Reg::NoIndex,
+      ObjectOffsets::objectFlags);
+  emit.fast.cjump<CCode::Z, OffsetType::Int32>(slowPath);
+  emit.fast.cmpImmToRM<S::L>(
+      0, Reg::rdx, Reg::NoIndex, ObjectOffsets::arrayBeginIndex);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPath);
+
+  // Is the index an integer?
+  emit.fast = isNumber(emit.fast, regIndex, const_cast<uint8_t *>(slowPath));
+  emit.fast = movHermesRegToNativeReg<true>(emit.fast, regIndex, Reg::XMM0);
+  emit.fast.cvttsd2siRegToReg(Reg::XMM0, Reg::eax);
+  emit.fast.cvtsi2sdRegToReg(Reg::eax, Reg::XMM1);
+  emit.fast.ucomisRegToReg(Reg::XMM0, Reg::XMM1);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPath);
+  emit.fast.cjump<CCode::P, OffsetType::Int32>(slowPath);
+
+  // Is it in range, and stored inline? A negative index is treated as a huge
+  // unsigned one.
+  emit.fast.cmpRmToReg<S::L>(
+      Reg::rdx, Reg::NoIndex, ObjectOffsets::arrayEndIndex, Reg::eax);
+  emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPath);
+  emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(
+      SegmentedArray::kValueToSegmentThreshold, Reg::eax, Reg::none, 0);
+  emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPath);
+
+  // Is the element present?
+  emit.fast = loadGCPointerField(
+      emit.fast, Reg::rdx, ObjectOffsets::arrayStorage, Reg::rcx, Reg::rsi);
+  emit.fast.cmpImmToRM<S::L, 8>(
+      (uint32_t)(HermesValue::encodeEmptyValue().getRaw() >> 32),
+      Reg::rcx,
+      Reg::rax,
+      ObjectOffsets::segmentedArrayInlineStorage + 4);
+  emit.fast.cjump<CCode::E, OffsetType::Int32>(slowPath);
+  return emit;
+}
+
+Emitters FastJIT::propertyCacheCheck(
+    Emitters emit,
+    PolymorphicPropertyCache *cache,
+    const uint8_t *slowPath) {
+  emit.fast.movRMToReg<kGCPointerSize>(
+      Reg::rdx, Reg::NoIndex, ObjectOffsets::objectClass, Reg::rax);
+  emit = loadConstantAddrIntoNativeReg(emit, cache->entries().data(), Reg::rcx);
+
+  // The entries are read when the code runs, so classes cached later hit too.
+  Relo found[PolymorphicPropertyCache::kNumEntries];
+  for (unsigned i = 0; i != PolymorphicPropertyCache::kNumEntries; ++i) {
+    int32_t entryOffset = i * sizeof(PropertyCacheEntry);
+    emit.fast.cmpRmToReg<kGCPointerSize>(
+        Reg::rcx,
+        Reg::NoIndex,
+        entryOffset + offsetof(PropertyCacheEntry, clazz),
+        Reg::rax);
+    emit.fast.cjump<CCode::NE, OffsetType::Int8>(emit.fast.current());
+    Relo next{ReloKind::Int8, emit.fast.current() - 1, 0};
+    emit.fast.movRMToReg<S::L>(
+        Reg::rcx,
+        Reg::NoIndex,
+        entryOffset + offsetof(PropertyCacheEntry, slot),
+        Reg::esi);
+    emit.fast.jmp<OffsetType::Int8>(emit.fast.current());
+    found[i] = {ReloKind::Int8, emit.fast.current() - 1, 0};
+    applyRelocation(next, emit.fast.current());
+  }
+  emit.fast.jmp<OffsetType::Int32>(slowPath);
+  for (const Relo &relo : found)
+    applyRelocation(relo, emit.fast.current());
+
+  // Only the direct property slots are accessed inline.
+  emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(
+      JSObject::DIRECT_PROPERTY_SLOTS, Reg::esi, Reg::none, 0);
+  emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPath);
+  return emit;
+}
+
+Emitters FastJIT::compileNewObjectWithParent(Emitters emit, const Inst *ip) {
+  // &parent -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iNewObjectWithParent.op2, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)externNewObjectWithParent, constAddr);
+  emit.fast = callExternalWithReturnedVal(
+      emit.fast, constAddr, ip->iNewObjectWithParent.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileGetNewTarget(Emitters emit, const Inst *ip) {
+  emit.fast.movRMToReg<S::Q>(
+      RegFrame,
+      Reg::NoIndex,
+      sizeof(HermesValue) * StackFrameLayout::NewTarget,
+      Reg::rax);
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iGetNewTarget.op1);
+  return emit;
+}
+
+Emitters
+FastJIT::compileCallDirect(Emitters emit, const Inst *ip, uint32_t idx) {
+  // &calleeCodeBlock -> arg2
+  CodeBlock *calleeBlock =
+      codeBlock_->getRuntimeModule()->getCodeBlockIfCreated(idx);
+  assert(calleeBlock && "callee CodeBlock must be created before compiling");
+  emit = loadConstantAddrIntoNativeReg(emit, calleeBlock, Reg::rsi);
+
+  // argCount (uint32_t) -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iCallDirect.op2, Reg::edx);
+
+  // stack pointer -> arg4
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
+
+  // ip -> arg5
+  emit = loadConstantAddrIntoNativeReg(emit, ip, Reg::r8);
+
+  // currentFrame -> arg6
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externCallDirect, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iCallDirect.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileCallBuiltin(Emitters emit, const Inst *ip) {
+  // builtin index -> arg2
+  emit.fast.movImmToReg<S::L>(ip->iCallBuiltin.op2, Reg::esi);
+
+  // argCount (uint32_t) -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iCallBuiltin.op3, Reg::edx);
+
+  // stack pointer -> arg4
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::stackPointer, Reg::rcx);
+
+  // ip -> arg5
+  emit = loadConstantAddrIntoNativeReg(emit, ip, Reg::r8);
+
+  // currentFrame -> arg6
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r9);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externCallBuiltin, constAddr);
+  emit.fast = callExternal(emit.fast, constAddr, ip->iCallBuiltin.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileThrowIfUndefinedInst(Emitters emit, const Inst *ip) {
+  uint8_t *slowPathConstAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)externThrowIfUndefined, slowPathConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = cmpSomeNPETag<ETag::Undefined>(
+      emit.fast, ip->iThrowIfUndefinedInst.op1);
+  emit.fast.cjump<CCode::E, OffsetType::Int32>(slowPathAddr);
+
+  // Slow path: always throws.
+  emit.slow = callExternalNoReturnedVal(emit.slow, slowPathConstAddr, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+  return emit;
+}
+
+Emitters FastJIT::compileAsyncBreakCheck(Emitters emit, const Inst *ip) {
+  uint8_t *slowPathConstAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)externAsyncBreakCheck, slowPathConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast.cmpImmToRM<S::B>(
+      0, RegRuntime, Reg::NoIndex, RuntimeOffsets::asyncBreakRequestFlag);
+  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+
+  // Slow path
+  emit.slow = callExternalNoReturnedVal(emit.slow, slowPathConstAddr, ip);
+  emit.slow.jmp<OffsetType::Auto>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
+  return emit;
+}
+
+Emitters FastJIT::compileSwitchImm(Emitters emit, const Inst *ip) {
+  uint32_t min = ip->iSwitchImm.op4;
+  uint32_t max = ip->iSwitchImm.op5;
+  // The value is converted to a signed 32-bit integer.
+  if (max > INT32_MAX) {
+    error("SwitchImm range too large");
+    return emit;
+  }
+  uint32_t numEntries = max - min + 1;
+  if ((size_t)(slow_.end() - emit.slow.current()) <
+      numEntries * sizeof(uint64_t) + kMinInstructionSpace) {
+    error("slow-path overflow");
+    return emit;
+  }
+
+  // Emit the table of the native addresses of the jump targets into the slow
+  // path buffer. They are filled in when relocations are resolved.
+  const uint32_t *bcTable = (const uint32_t *)llvm::alignAddr(
+      (const uint8_t *)ip + ip->iSwitchImm.op2, sizeof(uint32_t));
+  emit.slow.align<sizeof(uint64_t)>();
+  uint8_t *tableAddr = emit.slow.current();
+  for (uint32_t i = 0; i != numEntries; ++i) {
+    relocs_.emplace_back(
+        ReloKind::Abs64, emit.slow.current(), getBBIndex(ip, bcTable[i]));
+    emit.slow.numericConst((uint64_t)0);
+  }
+  describeSlowPathSection(emit.slow, true);
+
+  unsigned defaultBB = getBBIndex(ip, ip->iSwitchImm.op3);
+
+  // Non-numbers, non-integers and values out of range go to the default.
+  emit.fast.cmpImmToRM<S::L>(
+      FirstTag << (HermesValue::kNumDataBits - 32),
+      RegFrame,
+      Reg::NoIndex,
+      localHermesRegByteOffset(ip->iSwitchImm.op1) + 4);
+  emit.fast = cjmpToBytecodeBB(emit.fast, CJumpOp<CCode::AE>::OP, defaultBB);
+  emit.fast =
+      movHermesRegToNativeReg<true>(emit.fast, ip->iSwitchImm.op1, Reg::XMM0);
+  emit.fast.cvttsd2siRegToReg(Reg::XMM0, Reg::eax);
+  emit.fast.cvtsi2sdRegToReg(Reg::eax, Reg::XMM1);
+  emit.fast.ucomisRegToReg(Reg::XMM0, Reg::XMM1);
+  emit.fast = cjmpToBytecodeBB(emit.fast, CJumpOp<CCode::NE>::OP, defaultBB);
+  emit.fast = cjmpToBytecodeBB(emit.fast, CJumpOp<CCode::P>::OP, defaultBB);
+  // Unsigned comparisons also send negative values to the default.
+  emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(max, Reg::eax, Reg::none, 0);
+  emit.fast = cjmpToBytecodeBB(emit.fast, CJumpOp<CCode::A>::OP, defaultBB);
+  if (min) {
+    emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(min, Reg::eax, Reg::none, 0);
+    emit.fast = cjmpToBytecodeBB(emit.fast, CJumpOp<CCode::B>::OP, defaultBB);
+    emit.fast.leaRMToReg<S::L, S::Q>(Reg::rax, Reg::NoIndex, -min, Reg::eax);
+  }
+
+  // Jump through the table.
+  emit.fast.leaRMToReg<S::Q, S::Q, ScaleRIPAddr32>(
+      Reg::none, Reg::NoIndex, 0, Reg::rcx);
+  applyRIP32Offset(emit.fast.current(), tableAddr);
+  emit.fast.jmpRM<8>(Reg::rcx, Reg::rax, 0);
+  return emit;
+}
+
+Emitters FastJIT::compileCreateGeneratorClosure(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t idx) {
+  // runtime module -> arg2
+  emit = loadConstantAddrIntoNativeReg(
+      emit, codeBlock_->getRuntimeModule(), Reg::rsi);
+  // function index -> arg3
+  emit.fast.movImmToReg<S::L>(idx, Reg::edx);
+  // &env -> arg4
+  emit.fast =
+      leaHermesReg(emit.fast, ip->iCreateGeneratorClosure.op2, Reg::rcx);
+
+  uint8_t *constAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)externCreateGeneratorClosure, constAddr);
+  emit.fast = callExternal(
+      emit.fast, constAddr, ip->iCreateGeneratorClosure.op1, ip);
+  return emit;
+}
+
+Emitters
+FastJIT::compileCreateGenerator(Emitters emit, const Inst *ip, uint32_t idx) {
+  // runtime module -> arg2
+  emit = loadConstantAddrIntoNativeReg(
+      emit, codeBlock_->getRuntimeModule(), Reg::rsi);
+  // function index -> arg3
+  emit.fast.movImmToReg<S::L>(idx, Reg::edx);
+  // &env -> arg4
+  emit.fast = leaHermesReg(emit.fast, ip->iCreateGenerator.op2, Reg::rcx);
+  // current frame -> arg5
+  emit.fast.movRegToReg<S::Q>(RegFrame, Reg::r8);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externCreateGenerator, constAddr);
+  emit.fast =
+      callExternal(emit.fast, constAddr, ip->iCreateGenerator.op1, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileStartGenerator(Emitters emit, const Inst *ip) {
+  // current code block -> arg2
+  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externStartGenerator, constAddr);
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+
+  // eax: the bytecode offset to resume at, or 0 to start from the beginning.
+  // A generator can only resume after one of its SaveGenerator instructions,
+  // so dispatch to their targets.
+  auto *begin = codeBlock_->begin();
+  for (auto *cur = begin; cur != codeBlock_->end();) {
+    auto decoded = decodeInstruction((const Inst *)cur);
+    int32_t target = 0;
+    if (decoded.meta.opCode == OpCode::SaveGenerator)
+      target = ((const Inst *)cur)->iSaveGenerator.op1;
+    else if (decoded.meta.opCode == OpCode::SaveGeneratorLong)
+      target = ((const Inst *)cur)->iSaveGeneratorLong.op1;
+    if (target) {
+      uint32_t offset = cur + target - begin;
+      emit.fast.cmpImmToRM<S::L, ScaleRegAccess>(
+          offset, Reg::eax, Reg::none, 0);
+      emit.fast = cjmpToBytecodeBB(
+          emit.fast, CJumpOp<CCode::E>::OP, bcLabels_[offset]);
+    }
+    cur += decoded.meta.size;
+  }
+  return emit;
+}
+
+Emitters FastJIT::compileSaveGenerator(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset) {
+  // the instruction to resume at -> arg2
+  emit = loadConstantAddrIntoNativeReg(
+      emit, (const uint8_t *)ip + (int32_t)ipOffset, Reg::rsi);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externSaveGenerator, constAddr);
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+  return emit;
+}
+
+Emitters FastJIT::compileResumeGenerator(Emitters emit, const Inst *ip) {
+  // &result -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iResumeGenerator.op1, Reg::rsi);
+  // &isReturn -> arg3
+  emit.fast = leaHermesReg(emit.fast, ip->iResumeGenerator.op2, Reg::rdx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externResumeGenerator, constAddr);
+  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileCompleteGenerator(Emitters emit, const Inst *ip) {
+  uint8_t *constAddr;
+  emit.slow =
+      getConstant(emit.slow, (void *)externCompleteGenerator, constAddr);
+  emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rdi);
+  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.fast.current(), constAddr);
+  return emit;
+}
+
+Emitters FastJIT::compileIteratorClose(Emitters emit, const Inst *ip) {
+  // &iterator -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iIteratorClose.op1, Reg::rsi);
+  // ignoreInnerException -> arg3
+  emit.fast.movImmToReg<S::L>(ip->iIteratorClose.op2, Reg::edx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externIteratorClose, constAddr);
+  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+  return emit;
+}
+
 } // namespace x86_64
 } // namespace vm
 } // namespace hermes
@@ -32,6 +32,8 @@ enum class ReloKind : uint8_t {
   Int8,
   /// *((int32_t *)relo.address) = target - (relo.address + 4).
   Int32,
+  /// *((uint64_t *)relo.address) = target.
+  Abs64,
 };
 
 /// Information about a single relocation in the executable code.
@@ -70,6 +72,23 @@ class FastJIT {
   /// pointer in the CodeBlock will be set to the compiled body.
   void compile();
 
+  /// \return true if the compilation failed only because the executable heap
+  ///   was full, so it may succeed once memory has been freed.
+  bool isOutOfMemory() const {
+    return outOfMemory_;
+  }
+
+  /// \return the fast path and slow path blocks holding the compiled body.
+  ///   Only valid after a successful compile().
+  ExecHeap::BlockPair getCode() const {
+    return {fast_.data(), slow_.data()};
+  }
+
+  /// \return the number of bytes used in the blocks returned by getCode().
+  ExecHeap::SizePair getCodeSizes() const {
+    return codeSizes_;
+  }
+
   /// A pointer to binOpN instruction's compilation function.
   typedef Emitters (FastJIT::*compileBinOpNPtr)(Emitters emit, const Inst *ip);
 
@@ -78,7 +97,8 @@ class FastJIT {
   void error(const llvm::Twine &msg);
 
   /// Allocate executable memory using a conservative size estimate based on
-  /// bytecode length. On failure it sets the error message and flag.
+  /// bytecode length. If the heap is full it sets \c outOfMemory_, on any
+  /// other failure it sets the error message and flag.
   /// \param bytecodeLength the length of the bytecode we will be compiling.
   /// \param[out] sizes on successful exit contains the size of the two
   ///     allocatedmemory memory blocks (fast paths and slow paths). Undefined
@@ -156,6 +176,11 @@ class FastJIT {
   Emitters emitPrologue(Emitters emit);
   /// Emit the function epilogue. Calls checkSpace() before emitting.
   Emitters emitEpilogue(Emitters emit);
+  /// Emit the on-stack replacement entry, which takes over the current
+  /// interpreter frame and jumps to the loop header whose bytecode offset is
+  /// passed as its second parameter. Does nothing if the function has no
+  /// loops. Calls checkSpace() before emitting.
+  Emitters emitOSREntry(Emitters emit);
 
   /// Emit the code for a basic block. Calls checkSpace() before processing
   /// every bytecode instruction.
@@ -171,7 +196,7 @@ class FastJIT {
   Emitter getConstant(Emitter slow, HermesValue hv, uint8_t *&constAddr) {
     return getConstant(slow, hv.getRaw(), constAddr);
   }
-  Emitter getConstant(Emitter slow, void *addr, uint8_t *&constAddr) {
+  Emitter getConstant(Emitter slow, const void *addr, uint8_t *&constAddr) {
     return getConstant(slow, (uint64_t)addr, constAddr);
   }
 
@@ -190,7 +215,8 @@ class FastJIT {
   /// Load the specified address constant \p addr into the specified native
   /// register \p reg. The address must be in the C heap, which is constant
   /// and non-movable by GC.
-  Emitters loadConstantAddrIntoNativeReg(Emitters emit, void *addr, Reg reg);
+  Emitters
+  loadConstantAddrIntoNativeReg(Emitters emit, const void *addr, Reg reg);
 
   /// Load the specified double constant \p value into Hermes register \p
   /// hermesReg.
@@ -248,13 +274,19 @@ class FastJIT {
   /// Emit a 64-bit call to an absolute address.
   Emitter callAbsolute(Emitter emit, const void *dest);
 
+  /// Store \p ip to runtime->currentIP, as the interpreter does before calls
+  /// which may enter JavaScript or throw. Frames pushed by the call, such as
+  /// a getter's, save it as their return address.
+  Emitter captureIP(Emitter emit, const Inst *ip);
+
   /// Load rdi with the Runtime register and emit a call to an external
   /// function, check for exception and store the successful result in
   /// \p resultReg.
   /// \param dest the address of the location in the contant pool whose
   /// value points to the address of the external call
-  /// \param ip the current ip used to find the corresponding catch handler if
-  /// an exception is returned by the external call.
+  /// \param ip the current ip, captured in runtime->currentIP and used to
+  /// find the corresponding catch handler if an exception is returned by the
+  /// external call.
   Emitter callExternal(
       Emitter emit,
       const uint8_t *dest,
@@ -265,8 +297,9 @@ class FastJIT {
   /// function, check for exception, no return value.
   /// \param dest the address of the location in the contant pool whose
   /// value points to the address of the external call
-  /// \param ip the current ip used to find the corresponding catch handler if
-  /// an exception is returned by the external call.
+  /// \param ip the current ip, captured in runtime->currentIP and used to
+  /// find the corresponding catch handler if an exception is returned by the
+  /// external call.
   Emitter
   callExternalNoReturnedVal(Emitter emit, const uint8_t *dest, const Inst *ip);
 
@@ -307,6 +340,42 @@ class FastJIT {
   /// Receives and \returns the fast path emitter.
   Emitter cjmpToBytecodeBB(Emitter emit, uint8_t opCode, unsigned bytecodeBB);
 
+  /// Load the HermesValue in the Hermes register \p regIndex into \p dst and,
+  /// if it is an object, strip its tag so \p dst holds the object pointer.
+  /// Otherwise jump to \p notObject. Clobbers %rax, so \p dst must not be it.
+  Emitter loadObjectPointer(
+      Emitter emit,
+      uint32_t regIndex,
+      Reg dst,
+      const uint8_t *notObject);
+
+  /// Load the GCPointer stored at \p offset in the cell pointed to by \p base
+  /// into \p dst, decoding it if pointers are compressed. \p tmp may be
+  /// clobbered.
+  Emitter
+  loadGCPointerField(Emitter emit, Reg base, int32_t offset, Reg dst, Reg tmp);
+
+  /// Emit a check that the non-negative integer stored as a double in the
+  /// Hermes register \p regIndex is a valid index of the inline elements of
+  /// the JSArray pointed to by %rdx; if not, jump to \p slowPath. On success
+  /// %rcx points to the array's indexed storage and %rax holds the index.
+  Emitters
+  arrayIndexCheck(Emitters emit, uint32_t regIndex, const uint8_t *slowPath);
+
+  /// Emit the inline cache check of a property access: if the class of the
+  /// object pointed to by %rdx is cached in \p cache, with a direct property
+  /// slot, %rsi holds the slot; otherwise jump to \p slowPath.
+  Emitters propertyCacheCheck(
+      Emitters emit,
+      PolymorphicPropertyCache *cache,
+      const uint8_t *slowPath);
+
+  /// Emit a call to the out-of-line interpreter implementation \p caseImpl of
+  /// the instruction at \p ip, which operates on the frame registers
+  /// directly.
+  Emitters
+  callInterpreterCase(Emitters emit, const Inst *ip, void *caseImpl);
+
   Emitters
   getByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
   Emitters
@@ -357,8 +426,9 @@ class FastJIT {
       uint32_t keyIdx,
       uint32_t valIdx);
 
-  /// Emit an external call to externStoreToEnvironment or
-  /// externStoreNPToEnvironment depending on if the value \p op3 is a pointer.
+  /// Store the value \p op3 to the environment directly. Unless \p isNP, a
+  /// pointer value takes the slow path, an external call to
+  /// externStoreToEnvironment, which executes the write barrier.
   /// \param op1 the Hermes reg containing the environment
   /// \param idx the environment index slot number
   /// \param op3 the Hermes reg containing the value to be stored
@@ -405,6 +475,12 @@ class FastJIT {
   /// a string; if not, emit a jump to the slow path \p callStub.
   Emitter isString(Emitter emit, uint32_t regIndex, uint8_t *callStub);
 
+  /// Emit a check that whether the value in the Hermes register \p regIndex is
+  /// not a pointer, so it can be stored without a write barrier; if it is,
+  /// emit a jump to the slow path \p callStub.
+  Emitter
+  isNonPointer(Emitter emit, uint32_t regIndex, const uint8_t *callStub);
+
   /// Emit a comparison between the higher 32 bits of the value in the Hermes
   /// register \p regIndex and the given \p tag. The given \p tag could only be
   /// a non-pointer tag. The comparison instruction will set the flag registers
@@ -437,10 +513,10 @@ class FastJIT {
   // Individual instruction emitters.
   Emitters compileDeclareGlobalVar(Emitters emit, const Inst *ip);
   Emitters compileCreateEnvironment(Emitters emit, const Inst *ip);
-  Emitters compileCreateClosure(Emitters emit, const Inst *ip);
+  Emitters compileCreateClosure(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compileGetGlobalObject(Emitters emit, const Inst *ip);
   Emitters compileLoadConstZero(Emitters emit, const Inst *ip);
-  Emitters compileLoadParam(Emitters emit, const Inst *ip);
+  Emitters compileLoadParam(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compileBinOp(
       Emitters emit,
       const Inst *ip,
@@ -523,6 +599,12 @@ class FastJIT {
   compileNewArrayWithBuffer(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutOwnByIndex(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters compilePutNewOwnNEById(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters putNewOwnByIdHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t idx,
+      bool enumerable);
   Emitters compileLoadThisNS(Emitters emit, const Inst *ip);
   Emitters compileCoerceThisNS(Emitters emit, const Inst *ip);
 
@@ -534,6 +616,7 @@ class FastJIT {
   Emitters compileThrow(Emitters emit, const Inst *ip);
   Emitters compileNewObjectWithBuffer(Emitters emit, const Inst *ip);
   Emitters compileNewObjectWithBufferLong(Emitters emit, const Inst *ip);
+  Emitters compileGetByVal(Emitters emit, const Inst *ip);
   Emitters compilePutByVal(Emitters emit, const Inst *ip);
   Emitters compileDelByVal(Emitters emit, const Inst *ip);
   Emitters compileStoreToEnvironment(Emitters emit, const Inst *ip);
@@ -552,6 +635,22 @@ class FastJIT {
   Emitters compileBitNot(Emitters emit, const Inst *ip);
   Emitters compileGetArgumentsLength(Emitters emit, const Inst *ip);
   Emitters compileCreateRegExp(Emitters emit, const Inst *ip);
+  Emitters compileNewObjectWithParent(Emitters emit, const Inst *ip);
+  Emitters compileGetNewTarget(Emitters emit, const Inst *ip);
+  Emitters compileCallDirect(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters compileCallBuiltin(Emitters emit, const Inst *ip);
+  Emitters compileThrowIfUndefinedInst(Emitters emit, const Inst *ip);
+  Emitters compileAsyncBreakCheck(Emitters emit, const Inst *ip);
+  Emitters compileSwitchImm(Emitters emit, const Inst *ip);
+  Emitters
+  compileCreateGeneratorClosure(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters compileCreateGenerator(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters compileStartGenerator(Emitters emit, const Inst *ip);
+  Emitters
+  compileSaveGenerator(Emitters emit, const Inst *ip, uint32_t ipOffset);
+  Emitters compileResumeGenerator(Emitters emit, const Inst *ip);
+  Emitters compileCompleteGenerator(Emitters emit, const Inst *ip);
+  Emitters compileIteratorClose(Emitters emit, const Inst *ip);
 
   /// @}
 
@@ -578,6 +677,14 @@ class FastJIT {
   /// Relocations.
   std::vector<Relo> relocs_{};
 
+  /// Indices of the bytecode basic blocks that are the target of a backward
+  /// jump. Each of them is an on-stack replacement entry point. May contain
+  /// duplicates.
+  std::vector<unsigned> loopHeaders_{};
+
+  /// The on-stack replacement entry, if one was emitted.
+  uint8_t *osrEntry_ = nullptr;
+
   /// Index of the bytecode basic block (in \c bcBasicBlocks_) that we are
   /// currently compiling.
   unsigned curBytecodeBBIndex_ = 0;
@@ -586,11 +693,16 @@ class FastJIT {
   bool error_ = false;
   /// Optional error message, set the first time we record an error.
   std::string errorMsg_{};
+  /// Set if executable memory could not be allocated because the heap is
+  /// full.
+  bool outOfMemory_ = false;
 
   // The fast-path execution region.
   llvm::MutableArrayRef<uint8_t> fast_;
   // The slow-path execution region.
   llvm::MutableArrayRef<uint8_t> slow_;
+  /// The number of bytes of the two regions used by the compiled body.
+  ExecHeap::SizePair codeSizes_{0, 0};
 
   llvm::DenseMap<DenseUInt64, uint8_t *> doubleConstants_{};
 
@@ -9,21 +9,282 @@
 
 #include "FastJIT.h"
 
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvm/Support/Debug.h"
+
+#include <algorithm>
+
+#define DEBUG_TYPE "jit"
+
 namespace hermes {
 namespace vm {
 namespace x86_64 {
 
-JITContext::JITContext(bool enable, size_t blockSize, size_t maxMemory)
-    : enabled_(enable), heap_(blockSize / 2, blockSize / 2, maxMemory) {}
+/// \return whether the string operands of \p opCode are string values rather
+/// than property names.
+static bool hasStringValueOperand(inst::OpCode opCode) {
+  return opCode == inst::OpCode::LoadConstString ||
+      opCode == inst::OpCode::LoadConstStringLongIndex ||
+      opCode == inst::OpCode::CreateRegExp;
+}
+
+/// Create the CodeBlocks of all closures created and all functions called
+/// directly by \p codeBlock, and register the identifiers it uses if that is
+/// done lazily. The JIT'ed code embeds both, and creating them mutates the
+/// runtime, so this must happen on the interpreter thread before the function
+/// is compiled.
+static void resolveCodeBlockOperands(CodeBlock *codeBlock) {
+  RuntimeModule *runtimeModule = codeBlock->getRuntimeModule();
+  bool lazyIdentifiers = runtimeModule->hasLazyIdentifiers();
+  for (auto ip = codeBlock->begin(), end = codeBlock->end(); ip != end;) {
+    auto *inst = reinterpret_cast<const inst::Inst *>(ip);
+    switch (inst->opCode) {
+      case inst::OpCode::CreateClosure:
+        runtimeModule->getCodeBlockMayAllocate(inst->iCreateClosure.op3);
+        break;
+      case inst::OpCode::CreateClosureLongIndex:
+        runtimeModule->getCodeBlockMayAllocate(
+            inst->iCreateClosureLongIndex.op3);
+        break;
+      case inst::OpCode::CallDirect:
+        runtimeModule->getCodeBlockMayAllocate(inst->iCallDirect.op3);
+        break;
+      case inst::OpCode::CallDirectLongIndex:
+        runtimeModule->getCodeBlockMayAllocate(inst->iCallDirectLongIndex.op3);
+        break;
+      default:
+        if (lazyIdentifiers && !hasStringValueOperand(inst->opCode)) {
+          // The JIT'ed code embeds the symbols of property names.
+#define OPERAND_STRING_ID(name, operandNumber) \
+  if (inst->opCode == inst::OpCode::name)      \
+    runtimeModule->getSymbolIDMustExist(inst->i##name.op##operandNumber);
+#include "hermes/BCGen/HBC/BytecodeList.def"
+        }
+        break;
+    }
+    ip += inst::getInstSize(inst->opCode);
+  }
+}
+
+/// \return the name under which the compiled body of \p codeBlock is shown by
+/// profilers: the function name followed by its source location, if known.
+static std::string getProfilerName(CodeBlock *codeBlock) {
+  RuntimeModule *runtimeModule = codeBlock->getRuntimeModule();
+  std::string name = codeBlock->getNameString(
+      runtimeModule->getRuntime()->getHeap().getCallbacks());
+
+  std::string res;
+  llvm::raw_string_ostream OS{res};
+  OS << "JS:" << (name.empty() ? "anonymous" : name);
+  if (auto location = codeBlock->getSourceLocation()) {
+    OS << " ("
+       << runtimeModule->getBytecode()->getDebugInfo()->getFilenameByID(
+              location->filenameId)
+       << ':' << location->line << ':' << location->column << ')';
+  }
+  return OS.str();
+}
+
+JITContext::JITContext(
+    bool enable,
+    size_t blockSize,
+    size_t maxMemory,
+    uint32_t callThreshold,
+    uint32_t loopThreshold,
+    bool background,
+    bool perfMap,
+    bool perfDump)
+    : enabled_(enable),
+      callThreshold_(callThreshold),
+      loopThreshold_(loopThreshold),
+      background_(background),
+      heap_(blockSize / 2, blockSize / 2, maxMemory),
+      perfMap_(perfMap, perfDump) {}
 
-JITContext::~JITContext() = default;
+JITContext::~JITContext() {
+  {
+    std::lock_guard<std::mutex> lk{queueMutex_};
+    shutdown_ = true;
+    queue_.clear();
+  }
+  queueCond_.notify_one();
+  if (worker_.joinable())
+    worker_.join();
+}
 
 JITCompiledFunctionPtr JITContext::compileImpl(
     Runtime *runtime,
     CodeBlock *codeBlock) {
+  // A compilation failed because the executable heap was full. Make room
+  // before trying again, unless every compiled body is still needed.
+  if (LLVM_UNLIKELY(outOfMemory_.load(std::memory_order_relaxed))) {
+    outOfMemory_.store(false, std::memory_order_relaxed);
+    if (!evictColdFunctions(runtime)) {
+      codeBlock->setDontJIT(true);
+      return nullptr;
+    }
+  }
+
+  codeBlock->setJITQueued(true);
+  resolveCodeBlockOperands(codeBlock);
+
+  // Dumping must stay in order with the rest of the output, so it is done
+  // synchronously.
+  if (!background_ || dumpJITCode_) {
+    compileNow(codeBlock);
+    return codeBlock->getJITCompiled();
+  }
+
+  {
+    std::lock_guard<std::mutex> lk{queueMutex_};
+    queue_.push_back(codeBlock);
+    if (!worker_.joinable())
+      worker_ = std::thread{&JITContext::workerMain, this};
+  }
+  queueCond_.notify_one();
+  // The interpreter keeps running the function until the compiled body is
+  // installed.
+  return nullptr;
+}
+
+void JITContext::compileNow(CodeBlock *codeBlock) {
+  std::lock_guard<std::mutex> lk{compileMutex_};
   FastJIT impl{this, codeBlock};
   impl.compile();
-  return codeBlock->getJITCompiled();
+  if (impl.isOutOfMemory()) {
+    // Let the interpreter hand the function to us again once it has evicted
+    // cold functions.
+    outOfMemory_.store(true, std::memory_order_relaxed);
+    codeBlock->setJITQueued(false);
+    return;
+  }
+  if (!codeBlock->getJITCompiled())
+    return;
+
+  numCompiled_.fetch_add(1, std::memory_order_relaxed);
+  if (evicted_.erase(codeBlock))
+    numRecompiles_.fetch_add(1, std::memory_order_relaxed);
+  auto code = impl.getCode();
+  auto sizes = impl.getCodeSizes();
+  compiled_[codeBlock] = CompiledBody{code, sizes.first + sizes.second, 0};
+  compiledBytes_.fetch_add(
+      sizes.first + sizes.second, std::memory_order_relaxed);
+
+  if (perfMap_.isEnabled()) {
+    std::string name = getProfilerName(codeBlock);
+    perfMap_.addCode(code.first, sizes.first, name);
+    perfMap_.addCode(code.second, sizes.second, name + " [slow path]");
+  }
+}
+
+unsigned JITContext::evictColdFunctions(Runtime *runtime) {
+  // The compiled body of a function with a frame on the stack may be
+  // executing, or be returned to.
+  llvm::DenseSet<CodeBlock *> active{};
+  for (StackFramePtr frame : runtime->getStackFrames()) {
+    if (CodeBlock *codeBlock = frame.getCalleeCodeBlock())
+      active.insert(codeBlock);
+  }
+
+  std::lock_guard<std::mutex> lk{compileMutex_};
+
+  // Order the candidates by the number of calls since the previous eviction,
+  // coldest first.
+  std::vector<std::pair<uint32_t, CodeBlock *>> candidates{};
+  for (auto &entry : compiled_) {
+    CodeBlock *codeBlock = entry.first;
+    uint32_t count = codeBlock->getExecutionCount();
+    if (!active.count(codeBlock)) {
+      candidates.emplace_back(
+          count - entry.second.lastExecutionCount, codeBlock);
+    }
+    entry.second.lastExecutionCount = count;
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const std::pair<uint32_t, CodeBlock *> &a,
+         const std::pair<uint32_t, CodeBlock *> &b) {
+        return a.first < b.first;
+      });
+
+  // Evict the colder half. The hotter half is kept compiled, and the evicted
+  // functions have to become hot again before they are recompiled, so
+  // alternating between two working sets doesn't recompile on every call.
+  unsigned numEvicted = (candidates.size() + 1) / 2;
+  for (unsigned i = 0; i < numEvicted; ++i)
+    evict(candidates[i].second);
+
+  LLVM_DEBUG(
+      llvm::dbgs() << "JIT evicted " << numEvicted << " of "
+                   << compiled_.size() + numEvicted << " compiled functions\n");
+  return numEvicted;
+}
+
+void JITContext::evict(CodeBlock *codeBlock) {
+  auto it = compiled_.find(codeBlock);
+  assert(it != compiled_.end() && "evicting a function that isn't compiled");
+  codeBlock->setJITCompiled(nullptr);
+  codeBlock->setJITOSREntry(nullptr);
+  codeBlock->setJITQueued(false);
+  codeBlock->clearExecutionCount();
+  codeBlock->clearBackEdgeCount();
+
+  heap_.free(it->second.blocks);
+  compiledBytes_.fetch_sub(it->second.size, std::memory_order_relaxed);
+  compiled_.erase(it);
+  evicted_.insert(codeBlock);
+  ++numEvictions_;
+}
+
+void JITContext::workerMain() {
+  std::unique_lock<std::mutex> lk{queueMutex_};
+  for (;;) {
+    queueCond_.wait(lk, [this] { return shutdown_ || !queue_.empty(); });
+    if (shutdown_)
+      return;
+    compiling_ = queue_.front();
+    queue_.pop_front();
+
+    lk.unlock();
+    compileNow(compiling_);
+    lk.lock();
+
+    compiling_ = nullptr;
+    doneCond_.notify_all();
+  }
+}
+
+void JITContext::removeRuntimeModule(RuntimeModule *runtimeModule) {
+  std::unique_lock<std::mutex> lk{queueMutex_};
+  auto owned = [runtimeModule](CodeBlock *codeBlock) {
+    return codeBlock->getRuntimeModule() == runtimeModule;
+  };
+  queue_.erase(
+      std::remove_if(queue_.begin(), queue_.end(), owned), queue_.end());
+  doneCond_.wait(
+      lk, [this, &owned] { return !compiling_ || !owned(compiling_); });
+  lk.unlock();
+
+  // Free the compiled bodies, which can't be executing since the module is
+  // being destroyed.
+  std::lock_guard<std::mutex> compileLk{compileMutex_};
+  for (auto it = compiled_.begin(), e = compiled_.end(); it != e; ++it) {
+    if (owned(it->first)) {
+      heap_.free(it->second.blocks);
+      compiledBytes_.fetch_sub(it->second.size, std::memory_order_relaxed);
+      compiled_.erase(it);
+    }
+  }
+  for (auto it = evicted_.begin(), e = evicted_.end(); it != e; ++it) {
+    if (owned(*it))
+      evicted_.erase(it);
+  }
 }
 
 } // namespace x86_64
@@ -8,7 +8,10 @@
 #ifndef HERMES_VM_JIT_X86_64_RUNTIMEOFFSETS_H
 #define HERMES_VM_JIT_X86_64_RUNTIMEOFFSETS_H
 
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSArray.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/SegmentedArray.h"
 
 namespace hermes {
 namespace vm {
@@ -21,6 +24,40 @@ struct RuntimeOffsets {
   static constexpr uint32_t currentFrame = offsetof(Runtime, currentFrame_);
   static constexpr uint32_t globalObject = offsetof(Runtime, global_);
   static constexpr uint32_t thrownValue = offsetof(Runtime, thrownValue_);
+  static constexpr uint32_t currentIP = offsetof(Runtime, currentIP_);
+  static constexpr uint32_t asyncBreakRequestFlag =
+      offsetof(Runtime, asyncBreakRequestFlag_);
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  /// The table of biased segment starts used to decode a BasedPointer.
+  static constexpr uint32_t segmentMap = offsetof(Runtime, segmentMap_);
+#endif
+};
+
+/// Offsets of the fields of heap objects that compiled code accesses directly.
+struct ObjectOffsets {
+  static constexpr uint32_t vtable = offsetof(GCCell, vtp_);
+  static constexpr uint32_t objectFlags = offsetof(JSObject, flags_);
+  static constexpr uint32_t objectClass = offsetof(JSObject, clazz_);
+  static constexpr uint32_t directProps = JSObject::directPropsOffset();
+  static constexpr uint32_t arrayBeginIndex = offsetof(ArrayImpl, beginIndex_);
+  static constexpr uint32_t arrayEndIndex = offsetof(ArrayImpl, endIndex_);
+  static constexpr uint32_t arrayStorage = offsetof(ArrayImpl, indexedStorage_);
+  /// The inline elements of a SegmentedArray are its trailing objects.
+  static constexpr uint32_t segmentedArrayInlineStorage =
+      llvm::alignTo<alignof(GCHermesValue)>(sizeof(SegmentedArray));
+  /// The slots of an Environment are its trailing objects.
+  static constexpr uint32_t environmentSlots =
+      llvm::alignTo<alignof(GCHermesValue)>(sizeof(Environment));
+
+  /// \return the bits of ObjectFlags that are set in \p flags, as the 32-bit
+  /// word they occupy in a JSObject.
+  static uint32_t objectFlagsBits(ObjectFlags flags) {
+    static_assert(
+        sizeof(ObjectFlags) == sizeof(uint32_t), "ObjectFlags must be 32-bit");
+    uint32_t bits;
+    memcpy(&bits, &flags, sizeof(bits));
+    return bits;
+  }
 };
 
 #pragma GCC diagnostic pop
@@ -921,283 +921,71 @@ arrayPrototypePush(void *, Runtime *runtime, NativeArgs args) {
 }
 
 namespace {
-/// General object sorting model used by custom sorting routines.
-/// Provides a model by which to less and swap elements, using the [[Get]],
-/// [[Put]], and [[Delete]] internal methods of a supplied Object. Should be
-/// allocated on the stack, because it creates its own internal GCScope, with
-/// reusable MutableHandle<>-s that are used in the less and swap methods.
-/// These allow for quick accesses without allocating a great number of new
-/// handles every time we want to compare different elements.
-/// Usage example:
-///   StandardSortModel sm{runtime, obj, compareFn};
-///   quickSort(sm, 0, length);
-/// Note that this is generic and does nothing different if passed a JSArray.
-class StandardSortModel : public SortModel {
- private:
-  /// Runtime to sort in.
-  Runtime *runtime_;
-
-  /// Scope to allocate handles in, gets destroyed with this.
-  GCScope gcScope_;
-
-  /// JS comparison function, return -1 for less, 0 for equal, 1 for greater.
-  /// If null, then use the built in < operator.
-  Handle<Callable> compareFn_;
-
-  /// Object to sort elements [0, length).
-  Handle<JSObject> obj_;
-
-  /// Preallocate handles in the current GCScope so that we don't have to make
-  /// new handles in every method call.
-
-  /// Handles for two indices.
-  MutableHandle<> aHandle_;
-  MutableHandle<> bHandle_;
-
-  /// Handles for the values at two indices.
-  MutableHandle<> aValue_;
-  MutableHandle<> bValue_;
-
-  /// Handles for the objects the values are retrieved from.
-  MutableHandle<JSObject> aDescObjHandle_;
-  MutableHandle<JSObject> bDescObjHandle_;
-
-  /// Marker created after initializing all fields so handles allocated later
-  /// can be flushed.
-  GCScope::Marker gcMarker_;
-
+/// Orders the values collected by Array.prototype.sort, which the sort refers
+/// to by their index in \c items. The sort then only moves integers around,
+/// and is unaffected by the GC moving the values themselves.
+class SortCompare {
  public:
-  StandardSortModel(
+  /// \param keys the string keys of the items, used when there is no
+  ///   \p compareFn.
+  SortCompare(
       Runtime *runtime,
-      Handle<JSObject> obj,
-      Handle<Callable> compareFn)
-      : runtime_(runtime),
-        gcScope_(runtime),
-        compareFn_(compareFn),
-        obj_(obj),
-        aHandle_(runtime),
-        bHandle_(runtime),
-        aValue_(runtime),
-        bValue_(runtime),
-        aDescObjHandle_(runtime),
-        bDescObjHandle_(runtime),
-        gcMarker_(gcScope_.createMarker()) {}
-
-  /// Use getComputed and putComputed to swap the values at obj[a] and obj[b].
-  ExecutionStatus swap(uint32_t a, uint32_t b) override {
-    // Ensure that we don't leave here with any new handles.
-    GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
-
-    aHandle_ = HermesValue::encodeDoubleValue(a);
-    bHandle_ = HermesValue::encodeDoubleValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aDesc);
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bDesc);
-
-    if (aDescObjHandle_) {
-      if (LLVM_LIKELY(!aDesc.flags.proxyObject)) {
-        auto res = JSObject::getComputedPropertyValue_RJS(
-            obj_, runtime_, aDescObjHandle_, aDesc, aDescObjHandle_);
-        if (res == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (LLVM_LIKELY(!res->isEmpty())) {
-          aValue_ = *res;
-        }
-      } else {
-        auto keyRes = toPropertyKey(runtime_, aHandle_);
-        if (keyRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        aHandle_ = keyRes->get();
-        CallResult<bool> hasPropRes =
-            JSProxy::getOwnProperty(obj_, runtime_, aHandle_, aDesc, nullptr);
-        if (hasPropRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (*hasPropRes) {
-          auto res = JSProxy::getComputed(obj_, runtime_, aHandle_, obj_);
-          if (res == ExecutionStatus::EXCEPTION) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          aValue_ = *res;
-          // signal later code
-          aDescObjHandle_ = *obj_;
-        } else {
-          aDescObjHandle_ = nullptr;
-        }
-      }
+      Handle<Callable> compareFn,
+      Handle<BigStorage> items,
+      Handle<BigStorage> keys)
+      : runtime_(runtime), compareFn_(compareFn), items_(items), keys_(keys) {}
+
+  /// If compareFn isn't null, return compareFn(items[a], items[b]) < 0.
+  /// If compareFn is null, return keys[a] < keys[b].
+  CallResult<bool> operator()(uint32_t a, uint32_t b) {
+    if (!compareFn_) {
+      // Comparing the precomputed keys never runs JS.
+      return keys_->at(a).getString()->compare(keys_->at(b).getString()) < 0;
     }
-    if (bDescObjHandle_) {
-      if (LLVM_LIKELY(!bDesc.flags.proxyObject)) {
-        auto res = JSObject::getComputedPropertyValue_RJS(
-            obj_, runtime_, bDescObjHandle_, bDesc, bDescObjHandle_);
-        if (res == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (LLVM_LIKELY(!res->isEmpty())) {
-          bValue_ = *res;
-        }
-      } else {
-        auto keyRes = toPropertyKey(runtime_, bHandle_);
-        if (keyRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        bHandle_ = keyRes->get();
-        CallResult<bool> hasPropRes =
-            JSProxy::getOwnProperty(obj_, runtime_, bHandle_, bDesc, nullptr);
-        if (hasPropRes == ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
-        if (*hasPropRes) {
-          auto res = JSProxy::getComputed(obj_, runtime_, bHandle_, obj_);
-          if (res == ExecutionStatus::EXCEPTION) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          bValue_ = *res;
-          // signal later code
-          bDescObjHandle_ = *obj_;
-        } else {
-          bDescObjHandle_ = nullptr;
-        }
-      }
-    }
-
-    if (bDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  aHandle_,
-                  bValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, aHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
-
-    if (aDescObjHandle_) {
-      if (LLVM_UNLIKELY(
-              JSObject::putComputed_RJS(
-                  obj_,
-                  runtime_,
-                  bHandle_,
-                  aValue_,
-                  PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    } else {
-      if (LLVM_UNLIKELY(
-              JSObject::deleteComputed(
-                  obj_, runtime_, bHandle_, PropOpFlags().plusThrowOnError()) ==
-              ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-    }
-
-    return ExecutionStatus::RETURNED;
-  }
-
-  /// If compareFn isn't null, return compareFn(obj[a], obj[b]) < 0.
-  /// If compareFn is null, return obj[a] < obj[b].
-  CallResult<bool> less(uint32_t a, uint32_t b) override {
     // Ensure that we don't leave here with any new handles.
-    GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
-
-    aHandle_ = HermesValue::encodeDoubleValue(a);
-    bHandle_ = HermesValue::encodeDoubleValue(b);
-
-    ComputedPropertyDescriptor aDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, aHandle_, aDescObjHandle_, aDesc);
-    auto propRes = JSObject::getComputedPropertyValue_RJS(
-        obj_, runtime_, aDescObjHandle_, aDesc, aHandle_);
-    if (propRes == ExecutionStatus::EXCEPTION) {
+    GCScopeMarkerRAII marker{runtime_};
+    auto callRes = Callable::executeCall2(
+        compareFn_,
+        runtime_,
+        Runtime::getUndefinedValue(),
+        items_->at(a),
+        items_->at(b));
+    if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    if (propRes->isEmpty()) {
-      // Spec defines empty as greater than everything.
-      return false;
+    if (LLVM_LIKELY(callRes->isNumber())) {
+      return callRes->getNumber() < 0;
     }
-    aValue_ = *propRes;
-    assert(!aValue_->isEmpty());
-
-    ComputedPropertyDescriptor bDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        obj_, runtime_, bHandle_, bDescObjHandle_, bDesc);
-    if ((propRes = JSObject::getComputedPropertyValue_RJS(
-             obj_, runtime_, bDescObjHandle_, bDesc, bHandle_)) ==
-        ExecutionStatus::EXCEPTION) {
+    auto intRes = toNumber_RJS(runtime_, runtime_->makeHandle(*callRes));
+    if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    if (propRes->isEmpty()) {
-      // Spec defines empty as greater than everything.
-      return true;
-    }
-    bValue_ = *propRes;
-    assert(!bValue_->isEmpty());
+    return intRes->getNumber() < 0;
+  }
 
-    if (aValue_->isUndefined()) {
-      // Spec defines undefined as greater than everything.
-      return false;
-    }
-    if (bValue_->isUndefined()) {
-      // Spec defines undefined as greater than everything.
-      return true;
-    }
+ private:
+  Runtime *const runtime_;
 
-    if (compareFn_) {
-      // If we have a compareFn, just use that.
-      auto callRes = Callable::executeCall2(
-          compareFn_,
-          runtime_,
-          Runtime::getUndefinedValue(),
-          aValue_.get(),
-          bValue_.get());
-      if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      auto intRes = toNumber_RJS(runtime_, runtime_->makeHandle(*callRes));
-      if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      return intRes->getNumber() < 0;
-    } else {
-      // Convert both arguments to strings and use the lessOp on them.
-      auto aValueRes = toString_RJS(runtime_, aValue_);
-      if (LLVM_UNLIKELY(aValueRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      aValue_ = aValueRes->getHermesValue();
+  /// JS comparison function, return -1 for less, 0 for equal, 1 for greater.
+  /// If null, then compare the keys.
+  const Handle<Callable> compareFn_;
 
-      auto bValueRes = toString_RJS(runtime_, bValue_);
-      if (LLVM_UNLIKELY(bValueRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      bValue_ = bValueRes->getHermesValue();
+  /// The values being sorted.
+  const Handle<BigStorage> items_;
 
-      return lessOp_RJS(runtime_, aValue_, bValue_).getValue();
-    }
-  }
+  /// The results of ToString on each of the values being sorted.
+  const Handle<BigStorage> keys_;
 };
 } // anonymous namespace
 
-/// ES5.1 15.4.4.11.
+/// ES10 22.1.3.27 Array.prototype.sort.
+/// The values are read out of the object once, sorted with a stable merge
+/// sort that calls compareFn but never touches the object, and written back
+/// once, which is what the spec prescribes since ES2019 and fixes the number
+/// of property accesses at two per element.
 CallResult<HermesValue>
 arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope(runtime);
   // Null if not a callable compareFn.
   auto compareFn = Handle<Callable>::dyn_vmcast(args.getArgHandle(0));
   if (!args.getArg(0).isUndefined() && !compareFn) {
@@ -1221,13 +1009,127 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
-  StandardSortModel sm(runtime, O, compareFn);
+  // Collect the values that are present and not undefined. Undefined values
+  // sort after everything else and holes after them, so they are only
+  // counted.
+  auto arr = Handle<JSArray>::dyn_vmcast(O);
+  auto itemsRes = BigStorage::create(
+      runtime, arr ? std::min<uint64_t>(len, arr->getEndIndex()) : 0);
+  if (LLVM_UNLIKELY(itemsRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  MutableHandle<BigStorage> items{runtime, itemsRes->get()};
+  uint64_t numUndefined = 0;
+  // Set when a value isn't a string, and so needs a separate key.
+  bool needKeys = false;
+  MutableHandle<BigStorage> keys{runtime};
+  MutableHandle<> k{runtime};
+  MutableHandle<> value{runtime};
+  auto marker = gcScope.createMarker();
+  for (uint64_t i = 0; i < len; ++i) {
+    gcScope.flushToMarker(marker);
+    // Fast path: elements in indexed storage are plain data properties.
+    value = arr ? arr->at(runtime, i) : HermesValue::encodeEmptyValue();
+    if (value->isEmpty()) {
+      k = HermesValue::encodeNumberValue(i);
+      CallResult<bool> hasRes = JSObject::hasComputed(O, runtime, k);
+      if (LLVM_UNLIKELY(hasRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (!*hasRes) {
+        continue;
+      }
+      if (LLVM_UNLIKELY(
+              (propRes = JSObject::getComputed_RJS(O, runtime, k)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      value = *propRes;
+    }
+    if (value->isUndefined()) {
+      ++numUndefined;
+      continue;
+    }
+    needKeys |= !value->isString();
+    if (LLVM_UNLIKELY(
+            BigStorage::push_back(items, runtime, value) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  gcScope.flushToMarker(marker);
+  const BigStorage::size_type numItems = items->size();
+
+  // Without a compareFn, the values are ordered by their string conversions,
+  // which are computed once up front.
+  keys = *items;
+  if (!compareFn && needKeys) {
+    auto keysRes = BigStorage::create(runtime, numItems);
+    if (LLVM_UNLIKELY(keysRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    keys = keysRes->get();
+    for (BigStorage::size_type i = 0; i < numItems; ++i) {
+      gcScope.flushToMarker(marker);
+      value = items->at(i);
+      auto strRes = toString_RJS(runtime, value);
+      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      value = strRes->getHermesValue();
+      if (LLVM_UNLIKELY(
+              BigStorage::push_back(keys, runtime, value) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    gcScope.flushToMarker(marker);
+  }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
-  if (LLVM_UNLIKELY(quickSort(&sm, 0u, len) == ExecutionStatus::EXCEPTION))
+  std::vector<uint32_t> order(numItems);
+  for (uint32_t i = 0; i < numItems; ++i) {
+    order[i] = i;
+  }
+  SortCompare less{runtime, compareFn, items, keys};
+  if (LLVM_UNLIKELY(
+          timSort(order.data(), numItems, less) == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
+  }
+
+  // Write the sorted values back, followed by the undefined values, and
+  // delete the rest. Elements that are already in storage are updated in
+  // place, unless sorting made the array read-only.
+  arr = Handle<JSArray>::dyn_vmcast(O);
+  for (uint64_t i = 0; i < len; ++i) {
+    gcScope.flushToMarker(marker);
+    if (i < numItems + numUndefined) {
+      value = i < numItems ? HermesValue(items->at(order[i]))
+                           : HermesValue::encodeUndefinedValue();
+      if (arr &&
+          JSArray::trySetExistingElementAt(*arr, runtime, i, value.get())) {
+        continue;
+      }
+      k = HermesValue::encodeNumberValue(i);
+      if (LLVM_UNLIKELY(
+              JSObject::putComputed_RJS(
+                  O, runtime, k, value, PropOpFlags().plusThrowOnError()) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    } else {
+      if (arr && i >= JSArray::getLength(*arr)) {
+        // Nothing can be left past the end of the array.
+        break;
+      }
+      k = HermesValue::encodeNumberValue(i);
+      if (LLVM_UNLIKELY(
+              JSObject::deleteComputed(
+                  O, runtime, k, PropOpFlags().plusThrowOnError()) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+  }
 
   return O.getHermesValue();
 }
@@ -257,6 +257,28 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
     SET_PROP_NEW("js_markStackOverflows", info.numMarkStackOverflows);
   }
 
+  SET_PROP_NEW("js_forInCacheHits", stats.forInCacheHits);
+  SET_PROP_NEW("js_forInCacheMisses", stats.forInCacheMisses);
+  SET_PROP_NEW("js_regExpCacheHits", stats.regExpCacheHits);
+  SET_PROP_NEW("js_regExpCacheMisses", stats.regExpCacheMisses);
+  SET_PROP_NEW("js_regExpCacheEntries", runtime->getRegExpCache().size());
+  SET_PROP_NEW(
+      "js_regExpCacheBytes", runtime->getRegExpCache().getBytecodeSize());
+  SET_PROP_NEW("js_bytecodeCacheHits", stats.bytecodeCacheHits);
+  SET_PROP_NEW("js_bytecodeCacheMisses", stats.bytecodeCacheMisses);
+  SET_PROP_NEW("js_compileJSTime", stats.compileJS.wallDuration);
+  SET_PROP_NEW("js_compileJSCPUTime", stats.compileJS.cpuDuration);
+  SET_PROP_NEW("js_compileJSCount", stats.compileJS.count);
+  SET_PROP_NEW(
+      "js_jitCompiledFunctions", runtime->getJITContext().getNumCompiled());
+  SET_PROP_NEW(
+      "js_jitOSREntries", runtime->getJITContext().getNumOSREntries());
+  SET_PROP_NEW(
+      "js_jitCompiledBytes", runtime->getJITContext().getCompiledBytes());
+  SET_PROP_NEW("js_jitEvictions", runtime->getJITContext().getNumEvictions());
+  SET_PROP_NEW(
+      "js_jitRecompiles", runtime->getJITContext().getNumRecompiles());
+
   if (stats.shouldSample) {
     SET_PROP_NEW(
         "js_hermesVolCtxSwitches",
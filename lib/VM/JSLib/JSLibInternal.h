@@ -339,6 +339,7 @@ CallResult<HermesValue> splitInternal(
 /// If \p unicode is set and the character at \p index in \S is the start of a
 /// surrogate pair, \return index + 2. Otherwise \return index + 1.
 /// Note that this function does not allocate.
+/// \pre \p S is flat, see StringPrimitive::ensureFlat().
 uint64_t
 advanceStringIndex(const StringPrimitive *S, uint64_t index, bool unicode);
 
@@ -7,6 +7,8 @@
 
 #include "JSONLexer.h"
 
+#include "hermes/Support/JSON.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/StringPrimitive.h"
 
 #include "dtoa/dtoa.h"
@@ -23,7 +25,8 @@ static bool isJSONWhiteSpace(char16_t ch) {
   return (ch == u'\t' || ch == u'\r' || ch == u'\n' || ch == u' ');
 }
 
-ExecutionStatus JSONLexer::advance() {
+template <typename Stream>
+ExecutionStatus BasicJSONLexer<Stream>::advance() {
   // Skip whitespaces.
   while (curCharPtr_.hasChar() && isJSONWhiteSpace(*curCharPtr_)) {
     ++curCharPtr_;
@@ -66,14 +69,27 @@ ExecutionStatus JSONLexer::advance() {
       return scanNumber();
 
     case u'"':
-      return scanString();
+      return scanString(false, SymbolID{});
 
     default:
-      return errorWithChar(u"Unexpected token: ", *curCharPtr_);
+      return errorWithChar(u"Unexpected token: ", curCharForError());
   }
 }
 
-CallResult<char16_t> JSONLexer::consumeUnicode() {
+template <typename Stream>
+ExecutionStatus BasicJSONLexer<Stream>::advanceKey(SymbolID expectedKey) {
+  while (curCharPtr_.hasChar() && isJSONWhiteSpace(*curCharPtr_)) {
+    ++curCharPtr_;
+  }
+  if (curCharPtr_.hasChar() && *curCharPtr_ == u'"') {
+    token_.setFirstChar(u'"');
+    return scanString(true, expectedKey);
+  }
+  return advance();
+}
+
+template <typename Stream>
+CallResult<char16_t> BasicJSONLexer<Stream>::consumeUnicode() {
   uint16_t val = 0;
   for (unsigned i = 0; i < 4; ++i) {
     if (!curCharPtr_.hasChar()) {
@@ -85,7 +101,8 @@ CallResult<char16_t> JSONLexer::consumeUnicode() {
     } else if (ch >= 'a' && ch <= 'f') {
       ch -= 'a' - 10;
     } else {
-      return errorWithChar(u"Invalid unicode point character: ", *curCharPtr_);
+      return errorWithChar(
+          u"Invalid unicode point character: ", curCharForError());
     }
     val = (val << 4) + ch;
     ++curCharPtr_;
@@ -94,7 +111,44 @@ CallResult<char16_t> JSONLexer::consumeUnicode() {
   return static_cast<char16_t>(val);
 }
 
-ExecutionStatus JSONLexer::scanNumber() {
+template <typename Stream>
+CallResult<char16_t> BasicJSONLexer<Stream>::consumeEscape() {
+  if (!curCharPtr_.hasChar()) {
+    return error("Unexpected end of input");
+  }
+  char16_t ch = *curCharPtr_;
+  switch (ch) {
+    case u'"':
+    case u'/':
+    case u'\\':
+      break;
+    case 'b':
+      ch = 8;
+      break;
+    case 'f':
+      ch = 12;
+      break;
+    case 'n':
+      ch = 10;
+      break;
+    case 'r':
+      ch = 13;
+      break;
+    case 't':
+      ch = 9;
+      break;
+    case 'u':
+      ++curCharPtr_;
+      return consumeUnicode();
+    default:
+      return errorWithChar(u"Invalid escape sequence: ", curCharForError());
+  }
+  ++curCharPtr_;
+  return ch;
+}
+
+template <typename Stream>
+ExecutionStatus BasicJSONLexer<Stream>::scanNumber() {
   llvm::SmallVector<char, 32> str8;
   while (curCharPtr_.hasChar()) {
     auto ch = *curCharPtr_;
@@ -124,78 +178,92 @@ ExecutionStatus JSONLexer::scanNumber() {
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus JSONLexer::scanString() {
+/// \return the identifier of the property key \p str.
+static CallResult<Handle<SymbolID>> getKeySymbol(
+    Runtime *runtime,
+    ASCIIRef str) {
+  return runtime->getIdentifierTable().getSymbolHandle(runtime, str);
+}
+static CallResult<Handle<SymbolID>> getKeySymbol(
+    Runtime *runtime,
+    UTF16Ref str) {
+  // Keys which fit in ASCII are registered as ASCII, as they would be from a
+  // StringPrimitive.
+  if (isAllASCII(str.begin(), str.end())) {
+    llvm::SmallVector<char, 32> ascii(str.begin(), str.end());
+    return getKeySymbol(runtime, ASCIIRef(ascii));
+  }
+  return runtime->getIdentifierTable().getSymbolHandle(runtime, str);
+}
+
+template <typename Stream>
+template <typename CharT>
+ExecutionStatus BasicJSONLexer<Stream>::setStringToken(
+    llvm::ArrayRef<CharT> str,
+    bool isKey,
+    SymbolID expectedKey) {
+  if (isKey) {
+    // Comparing with the expected key is cheaper than hashing the key, and
+    // succeeds for all the keys of objects with the same shape.
+    if (expectedKey.isValid() &&
+        runtime_->getIdentifierTable()
+            .getStringView(runtime_, expectedKey)
+            .equals(str)) {
+      token_.setKey(expectedKey);
+      return ExecutionStatus::RETURNED;
+    }
+    auto symRes = getKeySymbol(runtime_, str);
+    if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    token_.setKey(symRes->get());
+    return ExecutionStatus::RETURNED;
+  }
+  // If the string exists in the identifier table, use that one.
+  if (auto existing =
+          runtime_->getIdentifierTable().getExistingStringPrimitiveOrNull(
+              runtime_, str)) {
+    token_.setString(runtime_->makeHandle<StringPrimitive>(existing));
+    return ExecutionStatus::RETURNED;
+  }
+  auto strRes = StringPrimitive::create(runtime_, str);
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  token_.setString(runtime_->makeHandle<StringPrimitive>(*strRes));
+  return ExecutionStatus::RETURNED;
+}
+
+template <typename Stream>
+ExecutionStatus BasicJSONLexer<Stream>::scanString(
+    bool isKey,
+    SymbolID expectedKey) {
   assert(*curCharPtr_ == '"');
   ++curCharPtr_;
   SmallU16String<32> tmpStorage;
 
   while (curCharPtr_.hasChar()) {
+    // Copy the characters which need no processing in bulk.
+    llvm::ArrayRef<char16_t> chars = curCharPtr_.buffered();
+    if (size_t n = plainJSONStringPrefix(chars)) {
+      tmpStorage.append(chars.begin(), chars.begin() + n);
+      curCharPtr_.skip(n);
+      continue;
+    }
     if (*curCharPtr_ == '"') {
       // End of string.
       ++curCharPtr_;
-      // If the string exists in the identifier table, use that one.
-      if (auto existing =
-              runtime_->getIdentifierTable().getExistingStringPrimitiveOrNull(
-                  runtime_, tmpStorage.arrayRef())) {
-        token_.setString(runtime_->makeHandle<StringPrimitive>(existing));
-        return ExecutionStatus::RETURNED;
-      }
-      auto strRes = StringPrimitive::create(runtime_, tmpStorage.arrayRef());
-      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      token_.setString(runtime_->makeHandle<StringPrimitive>(*strRes));
-      return ExecutionStatus::RETURNED;
+      return setStringToken(tmpStorage.arrayRef(), isKey, expectedKey);
     } else if (*curCharPtr_ <= '\u001F') {
       return error(u"U+0000 thru U+001F is not allowed in string");
     }
     if (*curCharPtr_ == u'\\') {
       ++curCharPtr_;
-      if (!curCharPtr_.hasChar()) {
-        return error("Unexpected end of input");
-      }
-      switch (*curCharPtr_) {
-        case u'"':
-        case u'/':
-        case u'\\':
-          tmpStorage.push_back(*curCharPtr_);
-          ++curCharPtr_;
-          break;
-
-        case 'b':
-          ++curCharPtr_;
-          tmpStorage.push_back(8);
-          break;
-        case 'f':
-          ++curCharPtr_;
-          tmpStorage.push_back(12);
-          break;
-        case 'n':
-          ++curCharPtr_;
-          tmpStorage.push_back(10);
-          break;
-        case 'r':
-          ++curCharPtr_;
-          tmpStorage.push_back(13);
-          break;
-        case 't':
-          ++curCharPtr_;
-          tmpStorage.push_back(9);
-          break;
-
-        case 'u': {
-          ++curCharPtr_;
-          CallResult<char16_t> cr = consumeUnicode();
-          if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
-            return ExecutionStatus::EXCEPTION;
-          }
-          tmpStorage.push_back(*cr);
-          break;
-        }
-
-        default:
-          return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
+      CallResult<char16_t> cr = consumeEscape();
+      if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
       }
+      tmpStorage.push_back(*cr);
     } else {
       tmpStorage.push_back(*curCharPtr_);
       ++curCharPtr_;
@@ -204,10 +272,115 @@ ExecutionStatus JSONLexer::scanString() {
   return error("Unexpected end of input");
 }
 
-ExecutionStatus JSONLexer::scanWord(const char *word, JSONTokenKind kind) {
+/// \return the length of the UTF-8 sequence starting with \p lead, or 1 if
+/// it isn't a valid lead byte, in which case the decoder rejects it.
+static size_t utf8SequenceLength(char lead) {
+  if ((lead & 0xE0) == 0xC0)
+    return 2;
+  if ((lead & 0xF0) == 0xE0)
+    return 3;
+  if ((lead & 0xF8) == 0xF0)
+    return 4;
+  return 1;
+}
+
+/// Decode the UTF-8 \p str, which doesn't contain a quote or a backslash,
+/// and append it to \p out. Invalid sequences are replaced with U+FFFD, like
+/// UTF16Stream does.
+static void appendUTF8(SmallU16String<32> &out, llvm::ArrayRef<char> str) {
+  const char *cur = str.begin();
+  const char *end = str.end();
+  auto it = std::back_inserter(out);
+  while (cur != end) {
+    if (LLVM_UNLIKELY(utf8SequenceLength(*cur) > (size_t)(end - cur))) {
+      // The sequence is truncated.
+      ++cur;
+      encodeUTF16(it, UNICODE_REPLACEMENT_CHARACTER);
+      continue;
+    }
+    encodeUTF16(it, decodeUTF8<false>(cur, [](const llvm::Twine &) {}));
+  }
+}
+
+/// Strings are scanned from the UTF-8 input directly: runs of plain ASCII
+/// characters are collected as ASCII, and the string is only widened to
+/// UTF-16 once a character outside of ASCII is met.
+template <>
+ExecutionStatus BasicJSONLexer<UTF8JSONStream>::scanString(
+    bool isKey,
+    SymbolID expectedKey) {
+  assert(*curCharPtr_ == '"');
+  ++curCharPtr_;
+
+  // Most strings have no escapes and are all ASCII: use them in place.
+  if (curCharPtr_.hasChar()) {
+    llvm::ArrayRef<char> chars = curCharPtr_.buffered();
+    size_t n = plainJSONStringPrefix(chars);
+    if (n < chars.size() && chars[n] == '"' &&
+        isAllASCII(chars.begin(), chars.begin() + n)) {
+      curCharPtr_.skip(n + 1);
+      return setStringToken(chars.take_front(n), isKey, expectedKey);
+    }
+  }
+
+  llvm::SmallVector<char, 32> ascii;
+  SmallU16String<32> utf16;
+  bool isASCII = true;
+  auto widen = [&]() {
+    utf16.append(ascii.begin(), ascii.end());
+    isASCII = false;
+  };
+
+  while (curCharPtr_.hasChar()) {
+    // Copy the characters which need no processing in bulk.
+    llvm::ArrayRef<char> chars = curCharPtr_.buffered();
+    if (size_t n = plainJSONStringPrefix(chars)) {
+      chars = chars.take_front(n);
+      if (isASCII) {
+        const char *firstNonASCII = std::find_if(
+            chars.begin(), chars.end(), [](char c) { return c & 0x80; });
+        ascii.append(chars.begin(), firstNonASCII);
+        chars = chars.drop_front(firstNonASCII - chars.begin());
+        if (!chars.empty())
+          widen();
+      }
+      if (!isASCII)
+        appendUTF8(utf16, chars);
+      curCharPtr_.skip(n);
+      continue;
+    }
+    if (*curCharPtr_ == '"') {
+      // End of string.
+      ++curCharPtr_;
+      return isASCII
+          ? setStringToken(llvm::ArrayRef<char>(ascii), isKey, expectedKey)
+          : setStringToken(utf16.arrayRef(), isKey, expectedKey);
+    } else if (*curCharPtr_ <= '\u001F') {
+      return error(u"U+0000 thru U+001F is not allowed in string");
+    }
+    assert(*curCharPtr_ == '\\' && "plain characters are consumed in bulk");
+    ++curCharPtr_;
+    CallResult<char16_t> cr = consumeEscape();
+    if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (isASCII && *cr >= 0x80)
+      widen();
+    if (isASCII)
+      ascii.push_back(*cr);
+    else
+      utf16.push_back(*cr);
+  }
+  return error("Unexpected end of input");
+}
+
+template <typename Stream>
+ExecutionStatus BasicJSONLexer<Stream>::scanWord(
+    const char *word,
+    JSONTokenKind kind) {
   while (*word && curCharPtr_.hasChar()) {
     if (*curCharPtr_ != *word) {
-      return errorWithChar(u"Unexpected token: ", *curCharPtr_);
+      return errorWithChar(u"Unexpected token: ", curCharForError());
     }
     ++curCharPtr_;
     ++word;
@@ -219,5 +392,24 @@ ExecutionStatus JSONLexer::scanWord(const char *word, JSONTokenKind kind) {
   return ExecutionStatus::RETURNED;
 }
 
+template <typename Stream>
+char16_t BasicJSONLexer<Stream>::curCharForError() {
+  return *curCharPtr_;
+}
+
+template <>
+char16_t BasicJSONLexer<UTF8JSONStream>::curCharForError() {
+  // Report the whole character rather than its lead byte.
+  llvm::ArrayRef<char> chars = curCharPtr_.buffered();
+  const char *cur = chars.begin();
+  if (utf8SequenceLength(*cur) > chars.size())
+    return UNICODE_REPLACEMENT_CHARACTER;
+  uint32_t cp = decodeUTF8<false>(cur, [](const llvm::Twine &) {});
+  return cp < 0x10000 ? cp : UNICODE_REPLACEMENT_CHARACTER;
+}
+
+template class BasicJSONLexer<UTF16Stream>;
+template class BasicJSONLexer<UTF8JSONStream>;
+
 } // namespace vm
 } // namespace hermes
@@ -46,6 +46,9 @@ class JSONToken {
   JSONTokenKind kind_{JSONTokenKind::None};
   double numberValue_{};
   MutableHandle<StringPrimitive> stringValue_;
+  /// The identifier of a string scanned as a key, in which case stringValue_
+  /// is not set.
+  MutableHandle<SymbolID> keyValue_;
 
   /// The starting character of this token.
   char16_t firstChar_{};
@@ -54,7 +57,8 @@ class JSONToken {
   const JSONToken &operator=(const JSONToken &) = delete;
 
  public:
-  explicit JSONToken(Runtime *runtime) : stringValue_(runtime) {}
+  explicit JSONToken(Runtime *runtime)
+      : stringValue_(runtime), keyValue_(runtime) {}
 
   JSONTokenKind getKind() const {
     return kind_;
@@ -66,10 +70,16 @@ class JSONToken {
   }
 
   Handle<StringPrimitive> getString() const {
-    assert(getKind() == JSONTokenKind::String);
+    assert(getKind() == JSONTokenKind::String && !isKey_);
     return stringValue_;
   }
 
+  /// \return the identifier of a string scanned by advanceKey().
+  Handle<SymbolID> getKey() const {
+    assert(getKind() == JSONTokenKind::String && isKey_);
+    return keyValue_;
+  }
+
   char16_t getFirstChar() const {
     return firstChar_;
   }
@@ -95,19 +105,78 @@ class JSONToken {
   void setString(Handle<StringPrimitive> str) {
     kind_ = JSONTokenKind::String;
     stringValue_ = str.get();
+#ifndef NDEBUG
+    isKey_ = false;
+#endif
+  }
+  void setKey(SymbolID key) {
+    kind_ = JSONTokenKind::String;
+    keyValue_ = key;
+#ifndef NDEBUG
+    isKey_ = true;
+#endif
+  }
+
+ private:
+#ifndef NDEBUG
+  /// Whether the string was scanned as a key.
+  bool isKey_{false};
+#endif
+};
+
+/// A stream of the bytes of a UTF-8 buffer, with the interface of UTF16Stream
+/// that the lexer uses. The bytes are scanned in place: only the contents of
+/// non-ASCII strings are converted to UTF-16.
+class UTF8JSONStream {
+ public:
+  explicit UTF8JSONStream(llvm::ArrayRef<uint8_t> utf8)
+      : cur_(utf8.begin()), end_(utf8.end()) {}
+
+  bool hasChar() const {
+    return cur_ != end_;
+  }
+
+  uint8_t operator*() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return *cur_;
+  }
+
+  UTF8JSONStream &operator++() {
+    assert(cur_ != end_ && "must check hasChar");
+    ++cur_;
+    return *this;
+  }
+
+  /// \return the bytes from the current position to the end of the input.
+  llvm::ArrayRef<char> buffered() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return {reinterpret_cast<const char *>(cur_),
+            reinterpret_cast<const char *>(end_)};
   }
+
+  void skip(size_t n) {
+    assert(n <= (size_t)(end_ - cur_) && "skipping past the end");
+    cur_ += n;
+  }
+
+ private:
+  const uint8_t *cur_;
+  const uint8_t *end_;
 };
 
-class JSONLexer {
+/// Scans JSON tokens from a \p Stream of code units, either a UTF16Stream or
+/// a UTF8JSONStream.
+template <typename Stream>
+class BasicJSONLexer {
  private:
-  UTF16Stream curCharPtr_;
+  Stream curCharPtr_;
 
   Runtime *runtime_;
 
   JSONToken token_;
 
  public:
-  JSONLexer(Runtime *runtime, UTF16Stream &&stream)
+  BasicJSONLexer(Runtime *runtime, Stream &&stream)
       : curCharPtr_(std::move(stream)), runtime_(runtime), token_(runtime) {}
 
   /// \return the current token.
@@ -123,6 +192,12 @@ class JSONLexer {
   /// All whitespace is skipped before the new token.
   LLVM_NODISCARD ExecutionStatus advance();
 
+  /// Like advance(), but a string is scanned as a property key: it is
+  /// registered in the identifier table without allocating an intermediate
+  /// string, and the token holds its identifier. If the key is equal to
+  /// \p expectedKey, that identifier is used without a table lookup.
+  LLVM_NODISCARD ExecutionStatus advanceKey(SymbolID expectedKey = {});
+
   /// Raise a JSON parse exception with message \p msg.
   /// token_ will also be invalidated.
   LLVM_NODISCARD ExecutionStatus error(const TwineChar16 &msg) {
@@ -142,8 +217,17 @@ class JSONLexer {
   /// Parse a JSONNumber.
   LLVM_NODISCARD ExecutionStatus scanNumber();
 
-  /// Parse a JSONString.
-  LLVM_NODISCARD ExecutionStatus scanString();
+  /// Parse a JSONString, as a property key if \p isKey is true.
+  /// \p expectedKey is the key the parser expects, if any.
+  LLVM_NODISCARD ExecutionStatus scanString(bool isKey, SymbolID expectedKey);
+
+  /// Set token_ to the string \p str, which is a property key if \p isKey
+  /// is true. \p CharT is char for ASCII strings and char16_t for UTF-16 ones.
+  template <typename CharT>
+  LLVM_NODISCARD ExecutionStatus setStringToken(
+      llvm::ArrayRef<CharT> str,
+      bool isKey,
+      SymbolID expectedKey);
 
   /// Parse a reserved keyword.
   LLVM_NODISCARD ExecutionStatus scanWord(const char *word, JSONTokenKind kind);
@@ -151,8 +235,30 @@ class JSONLexer {
   /// Parse a unicode code point and \return the char16 value.
   /// On error, \return llvm::None.
   CallResult<char16_t> consumeUnicode();
+
+  /// Parse the escape sequence after a backslash in a string, and \return
+  /// the character it stands for.
+  CallResult<char16_t> consumeEscape();
+
+  /// \return the character at the current position, to be reported in an
+  /// error message.
+  char16_t curCharForError();
 };
 
+/// Strings and error characters are decoded from UTF-8 as they are scanned.
+template <>
+ExecutionStatus BasicJSONLexer<UTF8JSONStream>::scanString(
+    bool isKey,
+    SymbolID expectedKey);
+template <>
+char16_t BasicJSONLexer<UTF8JSONStream>::curCharForError();
+
+using JSONLexer = BasicJSONLexer<UTF16Stream>;
+using UTF8JSONLexer = BasicJSONLexer<UTF8JSONStream>;
+
+extern template class BasicJSONLexer<UTF16Stream>;
+extern template class BasicJSONLexer<UTF8JSONStream>;
+
 } // namespace vm
 } // namespace hermes
 
@@ -307,8 +307,14 @@ mapPrototypeSet(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.set called on incompatible receiver");
   }
-  JSMap::addValue(
-      selfHandle, runtime, args.getArgHandle(0), args.getArgHandle(1));
+  if (LLVM_UNLIKELY(
+          JSMap::addValue(
+              selfHandle,
+              runtime,
+              args.getArgHandle(0),
+              args.getArgHandle(1)) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return selfHandle.getHermesValue();
 }
 
@@ -1036,7 +1036,9 @@ regExpPrototypeSymbolMatch(void *, Runtime *runtime, NativeArgs args) {
   if (strRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = runtime->makeHandle(std::move(*strRes));
+  // advanceStringIndex() reads the characters of S.
+  auto S = StringPrimitive::ensureFlat(
+      runtime, runtime->makeHandle(std::move(*strRes)));
   // 5. Let global be ToBoolean(Get(rx, "global")).
   // 6. ReturnIfAbrupt(global).
   auto propRes = JSObject::getNamed_RJS(
@@ -1225,7 +1227,9 @@ regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto S = runtime->makeHandle(std::move(*strRes));
+  // advanceStringIndex() reads the characters of S.
+  auto S = StringPrimitive::ensureFlat(
+      runtime, runtime->makeHandle(std::move(*strRes)));
   // 5. Let lengthS be the number of code unit elements in S.
   uint32_t lengthS = S->getStringLength();
   // 6. Let functionalReplace be IsCallable(replaceValue).
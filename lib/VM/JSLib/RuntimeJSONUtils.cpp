@@ -10,6 +10,7 @@
 #include "Object.h"
 
 #include "hermes/Support/Compiler.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSON.h"
 #include "hermes/Support/UTF16Stream.h"
 #include "hermes/VM/ArrayLike.h"
@@ -21,17 +22,22 @@
 
 #include "JSONLexer.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/SaveAndRestore.h"
 
+#include <array>
+
 namespace hermes {
 namespace vm {
 
 namespace {
 
 /// This class wraps the functionality required to parse a JSON string into
-/// a VM runtime value. It expects a UTF8 string as input, and returns a
-/// HermesValue when parse is called.
+/// a VM runtime value. It reads the string from a \p Stream, either a
+/// UTF16Stream or a UTF8JSONStream, and returns a HermesValue when parse is
+/// called.
+template <typename Stream>
 class RuntimeJSONParser {
  public:
   static constexpr int32_t MAX_RECURSION_DEPTH =
@@ -47,7 +53,7 @@ class RuntimeJSONParser {
   Runtime *runtime_;
 
   /// The lexer.
-  JSONLexer lexer_;
+  BasicJSONLexer<Stream> lexer_;
 
   /// Stores the optional reviver parameter.
   /// https://es5.github.io/#x15.12.2
@@ -63,15 +69,29 @@ class RuntimeJSONParser {
   /// If it drops below 0 while parsing, raise a stack overflow.
   int32_t remainingDepth_{MAX_RECURSION_DEPTH};
 
+  /// The number of nesting levels whose object shapes are cached.
+  static constexpr unsigned kShapeCacheLevels = 8;
+
+  /// The keys of the last object parsed at each of the first
+  /// kShapeCacheLevels nesting levels, in slot order. JSON data is often an
+  /// array of objects with the same keys, which can then be allocated with
+  /// their final hidden class instead of adding one property at a time.
+  std::array<llvm::SmallVector<SymbolID, 8>, kShapeCacheLevels> shapeKeys_{};
+
+  /// The hidden classes produced by the keys in shapeKeys_, indexed by nesting
+  /// level. Empty if no shape is cached at that level.
+  MutableHandle<PropStorage> shapeClasses_;
+
  public:
   explicit RuntimeJSONParser(
       Runtime *runtime,
-      UTF16Stream &&jsonString,
+      Stream &&jsonString,
       Handle<Callable> reviver)
       : runtime_(runtime),
         lexer_(runtime, std::move(jsonString)),
         reviver_(reviver),
-        tmpHandle_(runtime) {}
+        tmpHandle_(runtime),
+        shapeClasses_(runtime) {}
 
   /// Parse JSON string through lexer_, create objects using runtime_.
   /// If errors occur, this function will return undefined, and the error
@@ -92,6 +112,18 @@ class RuntimeJSONParser {
   /// When this function is finished, the current token must be "}".
   CallResult<HermesValue> parseObject();
 
+  /// Replace \p object, which was allocated with the hidden class cached at
+  /// nesting level \p level but only has its first \p numSet slots set, with
+  /// an object which has the same properties added one at a time.
+  ExecutionStatus leaveCachedShape(
+      MutableHandle<JSObject> &object,
+      unsigned level,
+      uint32_t numSet);
+
+  /// Cache the hidden class of \p object, which has \p numKeys keys, as the
+  /// shape of objects at nesting level \p level, if it can be shared.
+  void cacheShape(Handle<JSObject> object, unsigned level, uint32_t numKeys);
+
   /// Use reviver to filter the result.
   CallResult<HermesValue> revive(Handle<> value);
 
@@ -162,11 +194,49 @@ class JSONStringifyer {
   /// The max amount that depthCount_ is allowed to reach. Once it's reached, an
   /// exception will be thrown.
   static constexpr uint32_t MAX_RECURSION_DEPTH{
-      RuntimeJSONParser::MAX_RECURSION_DEPTH};
+      RuntimeJSONParser<UTF16Stream>::MAX_RECURSION_DEPTH};
 
   /// The output buffer. The serialization process will append into it.
   llvm::SmallVector<char16_t, 32> output_{};
 
+  /// The outcome of serializing a value with the fast path.
+  enum class FastResult {
+    /// The value was appended to output_.
+    Written,
+    /// The value serializes to undefined, and nothing was appended.
+    Undefined,
+    /// The value can't be serialized by the fast path.
+    Bail,
+  };
+
+  /// How the fast path serializes the objects of a hidden class.
+  struct FastShape {
+    /// Whether the objects can be serialized by the fast path.
+    bool plain{true};
+    /// The slots of the enumerable properties, in enumeration order.
+    llvm::SmallVector<SlotIndex, 8> slots{};
+    /// The quoted names of the properties, each followed by ':', back to back.
+    llvm::SmallVector<char16_t, 64> keys{};
+    /// The end of each name in keys.
+    llvm::SmallVector<uint32_t, 8> keyEnds{};
+  };
+
+  /// The shapes of the hidden classes met by the current fast path attempt,
+  /// indexed through fastShapeIndex_. They are discarded after the attempt,
+  /// since the classes may move or die once the GC runs.
+  std::vector<FastShape> fastShapes_{};
+  llvm::DenseMap<const HiddenClass *, unsigned> fastShapeIndex_{};
+
+  /// The objects being serialized by the fast path, innermost last. Together
+  /// with stackValue_, it is used to detect cyclical structures.
+  llvm::SmallVector<JSObject *, 8> fastStack_{};
+
+  /// Whether the fast path bailed on an object which is still being
+  /// serialized. Everything below it then uses the slow path: retrying the
+  /// fast path at each nested level would walk the parts it accepted again,
+  /// which is quadratic in the depth.
+  bool fastPathBailed_{false};
+
  public:
   explicit JSONStringifyer(Runtime *runtime)
       : runtime_(runtime),
@@ -236,6 +306,29 @@ class JSONStringifyer {
   /// It serializes an object.
   ExecutionStatus operationJO();
 
+  /// Try to serialize \p obj, the current last element in stackValue_,
+  /// without calling into JavaScript. This succeeds if everything reachable
+  /// from it is primitive data, arrays without holes, and objects of the
+  /// Object kind with only data properties, none of which have a toJSON
+  /// method. Property values are then read directly from their slots.
+  /// \return false, leaving output_ unchanged, if anything else is met, or
+  ///   there is a replacer. The slow path must then be used.
+  bool tryFastJSON(JSObject *obj);
+
+  /// Serialize \p value with the fast path, as Str would.
+  FastResult fastStr(HermesValue value);
+
+  /// Serialize \p obj with the fast path, as JO would.
+  /// \return false if the fast path can't be used.
+  bool fastJO(JSObject *obj);
+
+  /// Serialize \p arr with the fast path, as JA would.
+  /// \return false if the fast path can't be used.
+  bool fastJA(JSArray *arr);
+
+  /// \return the index in fastShapes_ of the shape of \p clazz.
+  unsigned getFastShape(HiddenClass *clazz);
+
   /// Append '\n' and indent to output_.
   /// The indent is constructed according to depthCount_.
   void indent();
@@ -254,10 +347,24 @@ class JSONStringifyer {
 
   /// Append the string indicated as \p str to output_.
   void appendToOutput(const StringPrimitive *str);
+
+  /// Append the ASCII string \p str to output_. Unlike the predefined
+  /// strings, it never needs to be allocated.
+  void appendToOutput(llvm::StringRef str) {
+    output_.append(str.begin(), str.end());
+  }
 };
 } // namespace
 
-CallResult<HermesValue> RuntimeJSONParser::parse() {
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::parse() {
+  auto arrRes = PropStorage::create(runtime_, kShapeCacheLevels);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  shapeClasses_ = vmcast<PropStorage>(*arrRes);
+  PropStorage::resizeWithinCapacity(shapeClasses_.get(), kShapeCacheLevels);
+
   // parseValue() requires one token to start with.
   if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
@@ -281,7 +388,8 @@ CallResult<HermesValue> RuntimeJSONParser::parse() {
   return parRes;
 }
 
-CallResult<HermesValue> RuntimeJSONParser::parseValue() {
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::parseValue() {
   llvm::SaveAndRestore<decltype(remainingDepth_)> oldDepth{remainingDepth_,
                                                            remainingDepth_ - 1};
   if (remainingDepth_ <= 0) {
@@ -338,7 +446,8 @@ CallResult<HermesValue> RuntimeJSONParser::parseValue() {
   return returnValue.getHermesValue();
 }
 
-CallResult<HermesValue> RuntimeJSONParser::parseArray() {
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::parseArray() {
   assert(
       lexer_.getCurToken()->getKind() == JSONTokenKind::LSquare &&
       "Wrong entrance to parseArray");
@@ -391,27 +500,61 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
   return array.getHermesValue();
 }
 
-CallResult<HermesValue> RuntimeJSONParser::parseObject() {
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::parseObject() {
   assert(
       lexer_.getCurToken()->getKind() == JSONTokenKind::LBrace &&
       "Wrong entrance to parseObject");
-  auto object = runtime_->makeHandle(JSObject::create(runtime_));
+  // parseValue() has already entered the nesting level of this object.
+  unsigned level = MAX_RECURSION_DEPTH - remainingDepth_ - 1;
+  bool cacheable = level < kShapeCacheLevels;
+
+  // If an object was already parsed at this level, assume this one has the
+  // same keys: allocate it with the final hidden class and store the values
+  // directly in their slots, for as long as the keys match.
+  MutableHandle<HiddenClass> shape{runtime_};
+  if (cacheable)
+    shape = dyn_vmcast<HiddenClass>(shapeClasses_->at(level));
+  MutableHandle<JSObject> object{
+      runtime_,
+      shape ? JSObject::create(runtime_, shape).get()
+            : JSObject::create(runtime_).get()};
+  uint32_t numKeys = 0;
+  // \return the key at index \p i of the cached shape, if any, which lets the
+  // lexer skip the identifier table lookup of a matching key.
+  auto expectedKey = [&](uint32_t i) {
+    return shape && i < shapeKeys_[level].size() ? shapeKeys_[level][i]
+                                                 : SymbolID{};
+  };
 
-  if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+  if (LLVM_UNLIKELY(
+          lexer_.advanceKey(expectedKey(0)) == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RBrace) {
-    MutableHandle<StringPrimitive> key{runtime_};
+    MutableHandle<SymbolID> key{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
-    for (;;) {
+    for (;; ++numKeys) {
       gcScope.flushToMarker(marker);
 
       if (LLVM_UNLIKELY(
               lexer_.getCurToken()->getKind() != JSONTokenKind::String)) {
         return lexer_.error("Expect a string key in JSON object");
       }
-      key = lexer_.getCurToken()->getString().get();
+      key = lexer_.getCurToken()->getKey().get();
+
+      if (shape) {
+        auto &keys = shapeKeys_[level];
+        if (numKeys >= keys.size() || keys[numKeys] != key.get()) {
+          if (LLVM_UNLIKELY(
+                  leaveCachedShape(object, level, numKeys) ==
+                  ExecutionStatus::EXCEPTION)) {
+            return ExecutionStatus::EXCEPTION;
+          }
+          shape = nullptr;
+        }
+      }
 
       if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -430,19 +573,28 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         return ExecutionStatus::EXCEPTION;
       }
 
-      (void)JSObject::defineOwnComputedPrimitive(
-          object,
-          runtime_,
-          key,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_->makeHandle(*parRes));
+      if (shape) {
+        JSObject::setNamedSlotValue(object.get(), runtime_, numKeys, *parRes);
+      } else {
+        // The object has no indexed storage, so index-like keys are named
+        // properties too.
+        (void)JSObject::defineOwnProperty(
+            object,
+            runtime_,
+            *key,
+            DefinePropertyFlags::getDefaultNewPropertyFlags(),
+            runtime_->makeHandle(*parRes));
+      }
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
-        if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+        if (LLVM_UNLIKELY(
+                lexer_.advanceKey(expectedKey(numKeys + 1)) ==
+                ExecutionStatus::EXCEPTION)) {
           return ExecutionStatus::EXCEPTION;
         }
         continue;
       } else if (lexer_.getCurToken()->getKind() == JSONTokenKind::RBrace) {
+        ++numKeys;
         break;
       } else {
         return lexer_.error("Expect '}'");
@@ -453,10 +605,72 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         "Unexpected stop for object parse");
   }
 
+  if (shape) {
+    // The object may have fewer keys than the cached shape.
+    if (numKeys == shapeKeys_[level].size())
+      return object.getHermesValue();
+    if (LLVM_UNLIKELY(
+            leaveCachedShape(object, level, numKeys) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  if (cacheable)
+    cacheShape(object, level, numKeys);
   return object.getHermesValue();
 }
 
-CallResult<HermesValue> RuntimeJSONParser::revive(Handle<> value) {
+template <typename Stream>
+ExecutionStatus RuntimeJSONParser<Stream>::leaveCachedShape(
+    MutableHandle<JSObject> &object,
+    unsigned level,
+    uint32_t numSet) {
+  auto newObject = runtime_->makeHandle(JSObject::create(runtime_));
+  GCScopeMarkerRAII marker{runtime_};
+  for (uint32_t slot = 0; slot < numSet; ++slot) {
+    tmpHandle_ = JSObject::getNamedSlotValue(object.get(), runtime_, slot);
+    if (LLVM_UNLIKELY(
+            JSObject::defineNewOwnProperty(
+                newObject,
+                runtime_,
+                shapeKeys_[level][slot],
+                PropertyFlags::defaultNewNamedPropertyFlags(),
+                tmpHandle_) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  tmpHandle_.clear();
+  object = newObject.get();
+  return ExecutionStatus::RETURNED;
+}
+
+template <typename Stream>
+void RuntimeJSONParser<Stream>::cacheShape(
+    Handle<JSObject> object,
+    unsigned level,
+    uint32_t numKeys) {
+  // Dictionaries can't be shared, and duplicate or index-like keys don't map
+  // one to one to slots.
+  HiddenClass *clazz = object->getClass(runtime_);
+  if (numKeys == 0 || clazz->isDictionary() ||
+      clazz->getNumProperties() != numKeys) {
+    return;
+  }
+
+  auto &keys = shapeKeys_[level];
+  keys.resize(numKeys);
+  HiddenClass::forEachPropertyNoAlloc(
+      clazz, runtime_, [&keys](SymbolID id, NamedPropertyDescriptor desc) {
+        assert(desc.slot < keys.size() && "keys must occupy the first slots");
+        keys[desc.slot] = id;
+      });
+  shapeClasses_->at(level).set(
+      HermesValue::encodeObjectValue(clazz), &runtime_->getHeap());
+}
+
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::revive(Handle<> value) {
   auto root = runtime_->makeHandle(JSObject::create(runtime_));
   auto status = JSObject::defineOwnProperty(
       root,
@@ -472,7 +686,8 @@ CallResult<HermesValue> RuntimeJSONParser::revive(Handle<> value) {
       root, runtime_->getPredefinedStringHandle(Predefined::emptyString));
 }
 
-CallResult<HermesValue> RuntimeJSONParser::operationWalk(
+template <typename Stream>
+CallResult<HermesValue> RuntimeJSONParser<Stream>::operationWalk(
     Handle<JSObject> holder,
     Handle<> property) {
   // The operation is recursive so it needs a GCScope.
@@ -536,7 +751,10 @@ CallResult<HermesValue> RuntimeJSONParser::operationWalk(
       reviver_, runtime_, holder, *tmpHandle, *valHandle);
 }
 
-ExecutionStatus RuntimeJSONParser::filter(Handle<JSObject> val, Handle<> key) {
+template <typename Stream>
+ExecutionStatus RuntimeJSONParser<Stream>::filter(
+    Handle<JSObject> val,
+    Handle<> key) {
   auto jsonRes = operationWalk(val, key);
   if (LLVM_UNLIKELY(jsonRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
@@ -578,18 +796,26 @@ CallResult<HermesValue> runtimeJSONParse(
     ref = storage;
   }
 
-  RuntimeJSONParser parser{runtime, UTF16Stream(ref), reviver};
+  RuntimeJSONParser<UTF16Stream> parser{runtime, UTF16Stream(ref), reviver};
   return parser.parse();
 }
 
 CallResult<HermesValue> runtimeJSONParseRef(
     Runtime *runtime,
     UTF16Stream &&stream) {
-  RuntimeJSONParser parser{
+  RuntimeJSONParser<UTF16Stream> parser{
       runtime, std::move(stream), Runtime::makeNullHandle<Callable>()};
   return parser.parse();
 }
 
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime *runtime,
+    llvm::ArrayRef<uint8_t> utf8) {
+  RuntimeJSONParser<UTF8JSONStream> parser{
+      runtime, UTF8JSONStream(utf8), Runtime::makeNullHandle<Callable>()};
+  return parser.parse();
+}
+
 ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
   if (!vmisa<JSObject>(*replacer))
     return ExecutionStatus::RETURNED;
@@ -867,12 +1093,22 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
     // Flush just before the recursive call (pushValueToStack can create
     // handles).
     marker.flush();
+    bool bailedHere = false;
+    if (!fastPathBailed_) {
+      if (tryFastJSON(vmcast<JSObject>(*operationStrValue_))) {
+        popValueFromStack();
+        return true;
+      }
+      fastPathBailed_ = bailedHere = true;
+    }
     CallResult<bool> isArrayRes =
         isArray(runtime_, vmcast<JSObject>(*operationStrValue_));
     if (LLVM_UNLIKELY(isArrayRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
     ExecutionStatus status = *isArrayRes ? operationJA() : operationJO();
+    if (bailedHere)
+      fastPathBailed_ = false;
     popValueFromStack();
     if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -884,8 +1120,20 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   return false;
 }
 
+/// Quote the string \p value into \p output.
+template <typename Output>
+static void quoteStringView(Output &output, StringView value) {
+  if (value.isASCII()) {
+    quoteStringRefForJSON(
+        output, ASCIIRef{value.castToCharPtr(), value.length()});
+  } else {
+    quoteStringRefForJSON(
+        output, UTF16Ref{value.castToChar16Ptr(), value.length()});
+  }
+}
+
 void JSONStringifyer::operationQuote(StringView value) {
-  quoteStringForJSON(output_, value);
+  quoteStringView(output_, value);
 }
 
 ExecutionStatus JSONStringifyer::operationJA() {
@@ -1084,6 +1332,257 @@ ExecutionStatus JSONStringifyer::operationJO() {
   return ExecutionStatus::RETURNED;
 }
 
+bool JSONStringifyer::tryFastJSON(JSObject *obj) {
+  if (replacerFunction_ || propertyList_)
+    return false;
+
+  // Nested objects and arrays must not inherit a toJSON method, which Str
+  // would call. The fast path only accepts those whose prototype is
+  // Object.prototype or Array.prototype, so check those once.
+  auto *objectProto = vmcast<JSObject>(runtime_->objectPrototype);
+  auto *arrayProto = vmcast<JSObject>(runtime_->arrayPrototype);
+  SymbolID toJSON = Predefined::getSymbolID(Predefined::toJSON);
+  if (objectProto->getParent(runtime_) ||
+      arrayProto->getParent(runtime_) != objectProto ||
+      HiddenClass::findPropertyNoAlloc(
+          objectProto->getClass(runtime_), runtime_, toJSON) ||
+      HiddenClass::findPropertyNoAlloc(
+          arrayProto->getClass(runtime_), runtime_, toJSON)) {
+    return false;
+  }
+
+  // The fast path holds raw pointers into the heap.
+  NoAllocScope noAlloc{runtime_};
+  auto savedSize = output_.size();
+  auto savedDepth = depthCount_;
+  bool success = false;
+  if (obj->getKind() == CellKind::ObjectKind) {
+    success = fastJO(obj);
+  } else if (obj->getKind() == CellKind::ArrayKind) {
+    success = fastJA(vmcast<JSArray>(obj));
+  }
+  fastStack_.clear();
+  fastShapes_.clear();
+  fastShapeIndex_.clear();
+  if (!success) {
+    output_.resize(savedSize);
+    depthCount_ = savedDepth;
+  }
+  return success;
+}
+
+JSONStringifyer::FastResult JSONStringifyer::fastStr(HermesValue value) {
+  if (value.isNull()) {
+    appendToOutput("null");
+    return FastResult::Written;
+  }
+  if (value.isBool()) {
+    appendToOutput(value.getBool() ? "true" : "false");
+    return FastResult::Written;
+  }
+  if (value.isString()) {
+    const StringPrimitive *str = value.getString();
+    if (LLVM_UNLIKELY(!str->isFlat())) {
+      // Ropes are only flattened with ensureFlat(), copy the characters.
+      llvm::SmallVector<char16_t, 32> chars;
+      str->copyUTF16String(chars);
+      quoteStringRefForJSON(output_, UTF16Ref(chars));
+    } else if (str->isASCII()) {
+      quoteStringRefForJSON(output_, str->getStringRef<char>());
+    } else {
+      quoteStringRefForJSON(output_, str->getStringRef<char16_t>());
+    }
+    return FastResult::Written;
+  }
+  if (value.isNumber()) {
+    double m = value.getNumber();
+    if (!std::isfinite(m)) {
+      appendToOutput("null");
+      return FastResult::Written;
+    }
+    char buf[NUMBER_TO_STRING_BUF_SIZE];
+    size_t len = numberToString(m, buf, sizeof(buf));
+    output_.append(buf, buf + len);
+    return FastResult::Written;
+  }
+  if (value.isUndefined() || value.isSymbol()) {
+    return FastResult::Undefined;
+  }
+  if (!value.isObject()) {
+    return FastResult::Bail;
+  }
+
+  auto *obj = vmcast<JSObject>(value);
+  for (JSObject *ancestor : fastStack_) {
+    if (ancestor == obj)
+      return FastResult::Bail;
+  }
+  for (uint32_t i = 0, len = stackValue_->size(); i < len; ++i) {
+    if (stackValue_->at(i).getObject() == obj)
+      return FastResult::Bail;
+  }
+
+  bool success;
+  fastStack_.push_back(obj);
+  if (obj->getKind() == CellKind::ObjectKind &&
+      obj->getParent(runtime_) == runtime_->objectPrototype.getObject()) {
+    // A toJSON property makes the shape not plain.
+    success = fastJO(obj);
+  } else if (
+      obj->getKind() == CellKind::ArrayKind &&
+      obj->getParent(runtime_) == runtime_->arrayPrototype.getObject() &&
+      !HiddenClass::findPropertyNoAlloc(
+          obj->getClass(runtime_),
+          runtime_,
+          Predefined::getSymbolID(Predefined::toJSON))) {
+    success = fastJA(vmcast<JSArray>(obj));
+  } else {
+    success = false;
+  }
+  fastStack_.pop_back();
+  return success ? FastResult::Written : FastResult::Bail;
+}
+
+bool JSONStringifyer::fastJO(JSObject *obj) {
+  if (depthCount_ + 1 >= MAX_RECURSION_DEPTH)
+    return false;
+  unsigned shapeIndex = getFastShape(obj->getClass(runtime_));
+  if (!fastShapes_[shapeIndex].plain)
+    return false;
+
+  auto stepBack = depthCount_;
+  depthCount_++;
+  output_.push_back(u'{');
+  auto beginningLoc = output_.size();
+  indent();
+
+  bool hasElement = false;
+  uint32_t keyBegin = 0;
+  for (uint32_t i = 0, e = fastShapes_[shapeIndex].slots.size(); i < e; ++i) {
+    auto savedLocation = output_.size();
+    if (hasElement) {
+      output_.push_back(u',');
+      indent();
+    }
+
+    // fastShapes_ may be reallocated by the recursion, so don't keep a
+    // reference to the shape across it.
+    const FastShape &shape = fastShapes_[shapeIndex];
+    uint32_t keyEnd = shape.keyEnds[i];
+    output_.append(shape.keys.begin() + keyBegin, shape.keys.begin() + keyEnd);
+    keyBegin = keyEnd;
+
+    HermesValue value =
+        JSObject::getNamedSlotValue(obj, runtime_, shape.slots[i]);
+    switch (fastStr(value)) {
+      case FastResult::Written:
+        hasElement = true;
+        break;
+      case FastResult::Undefined:
+        output_.resize(savedLocation);
+        break;
+      case FastResult::Bail:
+        return false;
+    }
+  }
+  depthCount_ = stepBack;
+
+  if (hasElement) {
+    indent();
+  } else {
+    output_.resize(beginningLoc);
+  }
+  output_.push_back(u'}');
+  return true;
+}
+
+bool JSONStringifyer::fastJA(JSArray *arr) {
+  if (depthCount_ + 1 >= MAX_RECURSION_DEPTH ||
+      arr->getClass(runtime_)->getHasIndexLikeProperties()) {
+    return false;
+  }
+
+  auto stepBack = depthCount_;
+  depthCount_++;
+  output_.push_back(u'[');
+  uint32_t len = JSArray::getLength(arr);
+  if (len > 0) {
+    indent();
+  }
+  for (uint32_t index = 0; index < len; ++index) {
+    if (index > 0) {
+      output_.push_back(u',');
+      indent();
+    }
+    // A hole would be looked up in the prototype chain.
+    HermesValue value = arr->at(runtime_, index);
+    if (value.isEmpty())
+      return false;
+    switch (fastStr(value)) {
+      case FastResult::Written:
+        break;
+      case FastResult::Undefined:
+        appendToOutput("null");
+        break;
+      case FastResult::Bail:
+        return false;
+    }
+  }
+  depthCount_ = stepBack;
+
+  if (len > 0) {
+    indent();
+  }
+  output_.push_back(u']');
+  return true;
+}
+
+unsigned JSONStringifyer::getFastShape(HiddenClass *clazz) {
+  auto it = fastShapeIndex_.find(clazz);
+  if (it != fastShapeIndex_.end())
+    return it->second;
+
+  unsigned index = fastShapes_.size();
+  fastShapeIndex_[clazz] = index;
+  fastShapes_.emplace_back();
+  FastShape &shape = fastShapes_.back();
+  // Index-like properties are enumerated first, in numeric order.
+  shape.plain = !clazz->getHasIndexLikeProperties();
+
+  GCScopeMarkerRAII marker{runtime_};
+  HiddenClass::forEachPropertyNoAlloc(
+      clazz,
+      runtime_,
+      [this, &shape, &marker](SymbolID id, NamedPropertyDescriptor desc) {
+        // Getting the name of a property may create a handle: release the
+        // previous one, so that wide objects don't exhaust the scope.
+        marker.flush();
+        if (!shape.plain || !isPropertyNamePrimitive(id))
+          return;
+        if (desc.flags.accessor ||
+            id == Predefined::getSymbolID(Predefined::toJSON)) {
+          shape.plain = false;
+          return;
+        }
+        if (!desc.flags.enumerable)
+          return;
+        StringView name =
+            runtime_->getIdentifierTable().getStringView(runtime_, id);
+        if (toArrayIndex(name)) {
+          shape.plain = false;
+          return;
+        }
+        shape.slots.push_back(desc.slot);
+        quoteStringView(shape.keys, name);
+        shape.keys.push_back(u':');
+        if (gap_.get()) {
+          shape.keys.push_back(u' ');
+        }
+        shape.keyEnds.push_back(shape.keys.size());
+      });
+  return index;
+}
+
 void JSONStringifyer::indent() {
   if (gap_.get()) {
     output_.push_back(u'\n');
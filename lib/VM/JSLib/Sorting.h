@@ -8,38 +8,336 @@
 #ifndef HERMES_VM_JSLIB_SORTING_H
 #define HERMES_VM_JSLIB_SORTING_H
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <vector>
 
 #include "hermes/VM/CallResult.h"
 
 /// Defines custom sorting routines used in cases that we can't use std::sort.
-/// std::sort doesn't always use std::swap, performing operations that bypass
-/// the user-defined swap routines. When calling [[Put]] and [[Delete]], we
-/// can't bypass those operations, so we use a custom SortModel and define our
-/// own swap and less functions, which are used by these sorting functions.
+/// The comparison may call into JavaScript, which can throw, so every
+/// comparison returns a CallResult and the sort stops at the first exception.
+/// std::stable_sort has no way of propagating that.
 
 namespace hermes {
 namespace vm {
 
-/// Abstraction to define a comparison-based sorting routine.  The
-/// SortModel has two operations: swap and compare.  Note that some
-/// implementation of \c swap and \c less can call property accessors
-/// which evaluate JavaScript.  For now, we don't rename these
-/// methods.
-class SortModel {
+/// \return the minimum length of a run when sorting \p n elements with
+/// \c timSort: arrays shorter than 32 elements are sorted as a single run,
+/// otherwise a value in [16, 32] such that n / minRun is a power of two or
+/// slightly less, which keeps the final merges balanced.
+uint32_t timSortMinRun(uint32_t n);
+
+/// A stable merge sort that takes advantage of runs that are already
+/// ascending or strictly descending, as described in Tim Peters' listsort.txt.
+/// \p T is a cheap value type, such as an index or a number, that is copied
+/// around freely. \p Less is called as less(a, b) and returns a
+/// CallResult<bool>; it must not be affected by the order of the elements, and
+/// it may be inconsistent without breaking the sort beyond leaving the
+/// elements in an unspecified order.
+template <typename T, typename Less>
+class TimSort {
  public:
-  // Swap elements at indices a and b.
-  virtual ExecutionStatus swap(uint32_t a, uint32_t b) = 0;
+  TimSort(T *data, uint32_t length, Less &less)
+      : data_(data), length_(length), less_(less) {}
+
+  /// Sort the elements. \return EXCEPTION if a comparison threw, in which case
+  /// the elements are left in an unspecified order.
+  ExecutionStatus sort() {
+    if (length_ < 2) {
+      return ExecutionStatus::RETURNED;
+    }
+    const uint32_t minRun = timSortMinRun(length_);
+    for (uint32_t lo = 0; lo < length_;) {
+      auto runRes = makeAscendingRun(lo);
+      if (LLVM_UNLIKELY(runRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      uint32_t runLength = *runRes;
+      if (runLength < minRun) {
+        // Extend short runs, so that there are few, similarly sized merges.
+        const uint32_t forced = std::min(minRun, length_ - lo);
+        if (LLVM_UNLIKELY(
+                binaryInsertionSort(lo, lo + runLength, lo + forced) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        runLength = forced;
+      }
+      assert(numRuns_ < kMaxRuns && "run stack overflow");
+      runs_[numRuns_++] = Run{lo, runLength};
+      if (LLVM_UNLIKELY(mergeCollapse() == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      lo += runLength;
+    }
+    while (numRuns_ > 1) {
+      uint32_t n = numRuns_ - 2;
+      if (n > 0 && runs_[n - 1].length < runs_[n + 1].length) {
+        --n;
+      }
+      if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+ private:
+  /// A sorted range of elements waiting to be merged with its neighbours.
+  struct Run {
+    uint32_t base;
+    uint32_t length;
+  };
+
+  /// The pending run lengths grow at least as fast as the Fibonacci numbers,
+  /// so this is enough for any 32-bit length.
+  static constexpr unsigned kMaxRuns = 64;
+
+  /// Find the run starting at \p lo, and reverse it if it is strictly
+  /// descending (which keeps the sort stable). \return its length.
+  CallResult<uint32_t> makeAscendingRun(uint32_t lo) {
+    uint32_t hi = lo + 1;
+    if (hi == length_) {
+      return 1;
+    }
+    auto res = less_(data_[hi], data_[lo]);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    const bool descending = *res;
+    for (++hi; hi < length_; ++hi) {
+      res = less_(data_[hi], data_[hi - 1]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res != descending) {
+        break;
+      }
+    }
+    if (descending) {
+      std::reverse(data_ + lo, data_ + hi);
+    }
+    return hi - lo;
+  }
+
+  /// Sort [lo, hi), of which [lo, start) is already sorted.
+  ExecutionStatus binaryInsertionSort(uint32_t lo, uint32_t start, uint32_t hi) {
+    for (; start < hi; ++start) {
+      const T pivot = data_[start];
+      uint32_t left = lo;
+      uint32_t right = start;
+      while (left < right) {
+        const uint32_t mid = left + (right - left) / 2;
+        auto res = less_(pivot, data_[mid]);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        if (*res) {
+          right = mid;
+        } else {
+          left = mid + 1;
+        }
+      }
+      std::move_backward(data_ + left, data_ + start, data_ + start + 1);
+      data_[left] = pivot;
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Merge adjacent runs until the pending run lengths decrease faster than
+  /// the Fibonacci numbers. This checks the invariant on the top three runs
+  /// as well as the one below, which is what makes kMaxRuns sufficient.
+  ExecutionStatus mergeCollapse() {
+    while (numRuns_ > 1) {
+      uint32_t n = numRuns_ - 2;
+      if ((n > 0 &&
+           runs_[n - 1].length <= runs_[n].length + runs_[n + 1].length) ||
+          (n > 1 &&
+           runs_[n - 2].length <= runs_[n - 1].length + runs_[n].length)) {
+        if (runs_[n - 1].length < runs_[n + 1].length) {
+          --n;
+        }
+      } else if (runs_[n].length > runs_[n + 1].length) {
+        break;
+      }
+      if (LLVM_UNLIKELY(mergeAt(n) == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return ExecutionStatus::RETURNED;
+  }
+
+  /// Merge the pending runs \p i and \p i + 1.
+  ExecutionStatus mergeAt(uint32_t i) {
+    uint32_t base1 = runs_[i].base;
+    uint32_t length1 = runs_[i].length;
+    const uint32_t base2 = runs_[i + 1].base;
+    uint32_t length2 = runs_[i + 1].length;
+    runs_[i].length = length1 + length2;
+    if (i + 3 == numRuns_) {
+      runs_[i + 1] = runs_[i + 2];
+    }
+    --numRuns_;
+
+    // Elements of the first run that are not greater than the start of the
+    // second one are already in place.
+    auto countRes = countNotGreater(data_[base2], base1, length1);
+    if (LLVM_UNLIKELY(countRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    base1 += *countRes;
+    length1 -= *countRes;
+    if (length1 == 0) {
+      return ExecutionStatus::RETURNED;
+    }
+    // And so are elements of the second run that are not less than the end of
+    // the first one.
+    countRes = countLess(data_[base1 + length1 - 1], base2, length2);
+    if (LLVM_UNLIKELY(countRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    length2 = *countRes;
+    if (length2 == 0) {
+      return ExecutionStatus::RETURNED;
+    }
+    return length1 <= length2 ? mergeLow(base1, length1, base2, length2)
+                              : mergeHigh(base1, length1, base2, length2);
+  }
+
+  /// \return the number of elements at the start of the sorted range
+  /// [base, base + length) that are not greater than \p key, searching
+  /// outwards from the start before bisecting.
+  CallResult<uint32_t> countNotGreater(T key, uint32_t base, uint32_t length) {
+    uint32_t lastOffset = 0;
+    uint32_t offset = 0;
+    // Invariant: the elements before lastOffset are not greater than key.
+    while (offset < length) {
+      auto res = less_(key, data_[base + offset]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        break;
+      }
+      lastOffset = offset + 1;
+      offset = offset <= (length - 1) / 2 ? offset * 2 + 1 : length;
+    }
+    uint32_t lo = lastOffset;
+    uint32_t hi = std::min(offset, length);
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      auto res = less_(key, data_[base + mid]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  }
+
+  /// \return the number of elements at the start of the sorted range
+  /// [base, base + length) that are less than \p key, searching outwards from
+  /// the end before bisecting.
+  CallResult<uint32_t> countLess(T key, uint32_t base, uint32_t length) {
+    // Offsets are counted back from the end of the range.
+    uint32_t lastOffset = 0;
+    uint32_t offset = 0;
+    // Invariant: the last lastOffset elements are not less than key.
+    while (offset < length) {
+      auto res = less_(data_[base + length - 1 - offset], key);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        break;
+      }
+      lastOffset = offset + 1;
+      offset = offset <= (length - 1) / 2 ? offset * 2 + 1 : length;
+    }
+    uint32_t lo = length - std::min(offset, length);
+    uint32_t hi = length - lastOffset;
+    while (lo < hi) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      auto res = less_(data_[base + mid], key);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*res) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  /// Merge two adjacent runs front to back, buffering the first, shorter one.
+  ExecutionStatus
+  mergeLow(uint32_t base1, uint32_t length1, uint32_t base2, uint32_t length2) {
+    tmp_.assign(data_ + base1, data_ + base1 + length1);
+    uint32_t dest = base1;
+    uint32_t i = 0;
+    uint32_t j = base2;
+    const uint32_t end2 = base2 + length2;
+    ExecutionStatus status = ExecutionStatus::RETURNED;
+    while (i < length1 && j < end2) {
+      auto res = less_(data_[j], tmp_[i]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        status = ExecutionStatus::EXCEPTION;
+        break;
+      }
+      data_[dest++] = *res ? data_[j++] : tmp_[i++];
+    }
+    // The rest of the second run is already in place; the rest of the first
+    // fills the gap before it.
+    std::copy(tmp_.begin() + i, tmp_.end(), data_ + dest);
+    return status;
+  }
+
+  /// Merge two adjacent runs back to front, buffering the second, shorter one.
+  ExecutionStatus
+  mergeHigh(uint32_t base1, uint32_t length1, uint32_t base2, uint32_t length2) {
+    tmp_.assign(data_ + base2, data_ + base2 + length2);
+    uint32_t dest = base2 + length2;
+    uint32_t i = length1;
+    uint32_t j = length2;
+    ExecutionStatus status = ExecutionStatus::RETURNED;
+    while (i > 0 && j > 0) {
+      auto res = less_(tmp_[j - 1], data_[base1 + i - 1]);
+      if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+        status = ExecutionStatus::EXCEPTION;
+        break;
+      }
+      data_[--dest] = *res ? data_[base1 + --i] : tmp_[--j];
+    }
+    std::copy(tmp_.begin(), tmp_.begin() + j, data_ + dest - j);
+    return status;
+  }
+
+  T *const data_;
+  const uint32_t length_;
+  Less &less_;
 
-  // Compare elements at index a and at index b.
-  virtual CallResult<bool> less(uint32_t a, uint32_t b) = 0;
+  /// The runs waiting to be merged, in order.
+  Run runs_[kMaxRuns];
+  unsigned numRuns_{0};
 
-  virtual ~SortModel() = 0;
+  /// Holds the shorter run while merging; reused across merges.
+  std::vector<T> tmp_{};
 };
 
-/// QuickSort to sort elements in the range [begin, end). Returns immediately
-/// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
-ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
+/// Stably sort the \p length elements at \p data with \c TimSort.
+/// \return EXCEPTION if \p less threw.
+template <typename T, typename Less>
+ExecutionStatus timSort(T *data, uint32_t length, Less &less) {
+  return TimSort<T, Less>(data, length, less).sort();
+}
 
 } // namespace vm
 } // namespace hermes
@@ -17,6 +17,9 @@
 #include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
+#include <cstring>
+#include <type_traits>
+
 namespace hermes {
 namespace vm {
 
@@ -264,95 +267,132 @@ CallResult<HermesValue> mapFilterLoop(
   return HermesValue::encodeNumberValue(insert);
 }
 
-/// This is the sort model for use with TypedArray.prototype.sort.
-/// template param \p WithCompareFn should be true if the compare function is
-/// a valid callback to call, and false if it is null or undefined.
-template <bool WithCompareFn>
-class TypedArraySortModel : public SortModel {
- protected:
-  /// Runtime to sort in.
-  Runtime *runtime_;
-
-  /// Scope to allocate handles in, gets destroyed with this.
-  GCScope gcScope_;
-
-  /// JS comparison function, return -1 for less, 0 for equal, 1 for greater.
-  /// If null, then use the built in < operator.
-  Handle<Callable> compareFn_;
-
-  /// Object to sort.
-  Handle<JSTypedArrayBase> self_;
-
-  MutableHandle<HermesValue> aHandle_;
-  MutableHandle<HermesValue> bHandle_;
-
-  /// Marker created after initializing all fields so handles allocated later
-  /// can be flushed.
-  GCScope::Marker gcMarker_;
-
- public:
-  TypedArraySortModel(
-      Runtime *runtime,
-      Handle<JSTypedArrayBase> obj,
-      Handle<Callable> compareFn)
-      : runtime_(runtime),
-        gcScope_(runtime),
-        compareFn_(compareFn),
-        self_(obj),
-        aHandle_(runtime),
-        bHandle_(runtime),
-        gcMarker_(gcScope_.createMarker()) {}
-
-  // Swap elements at indices a and b.
-  virtual ExecutionStatus swap(uint32_t a, uint32_t b) override {
-    aHandle_ = JSObject::getOwnIndexed(*self_, runtime_, a);
-    bHandle_ = JSObject::getOwnIndexed(*self_, runtime_, b);
-    if (JSObject::setOwnIndexed(self_, runtime_, a, bHandle_) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+/// Maps the elements of a TypedArray of \p T to unsigned integers that are
+/// ordered the way TypedArray.prototype.sort orders the elements when it has
+/// no comparator. For integers, this flips the sign bit.
+template <typename T, bool IsFloat = std::is_floating_point<T>::value>
+struct TypedArraySortKey {
+  using Key = typename std::make_unsigned<T>::type;
+  static constexpr Key kFlip = std::is_signed<T>::value
+      ? static_cast<Key>(Key(1) << (sizeof(Key) * 8 - 1))
+      : 0;
+
+  static Key encode(T x) {
+    return static_cast<Key>(static_cast<Key>(x) ^ kFlip);
+  }
+  static T decode(Key k) {
+    return static_cast<T>(static_cast<Key>(k ^ kFlip));
+  }
+};
+
+/// For floating point numbers, negative values have all bits flipped and
+/// positive ones only the sign bit, which puts -0 before +0. Every NaN maps to
+/// the largest key, so that they are sorted last.
+template <typename T>
+struct TypedArraySortKey<T, true> {
+  using Key =
+      typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  static constexpr Key kSign = Key(1) << (sizeof(Key) * 8 - 1);
+
+  static Key encode(T x) {
+    if (std::isnan(x)) {
+      return ~Key(0);
     }
-    if (JSObject::setOwnIndexed(self_, runtime_, b, aHandle_) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+    Key bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits & kSign) ? ~bits : bits | kSign;
+  }
+  static T decode(Key k) {
+    const Key bits = (k & kSign) ? k ^ kSign : ~k;
+    T x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+  }
+};
+
+/// Sort the \p length elements at \p data in numeric order, as
+/// TypedArray.prototype.sort does without a comparator. This is an LSD radix
+/// sort on the keys of the elements, one byte at a time, which is a single
+/// counting sort for the 8-bit types.
+template <typename T>
+void typedArrayNumericSort(T *data, uint32_t length) {
+  using SortKey = TypedArraySortKey<T>;
+  using Key = typename SortKey::Key;
+  if (length < 2) {
+    return;
+  }
+  std::vector<Key> keys(length);
+  for (uint32_t i = 0; i < length; ++i) {
+    keys[i] = SortKey::encode(data[i]);
+  }
+  std::vector<Key> sorted(length);
+  for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+    uint32_t offsets[256] = {};
+    for (Key k : keys) {
+      ++offsets[(k >> shift) & 0xff];
     }
-    return ExecutionStatus::RETURNED;
-  }
-
-  // Compare elements at index a and at index b.
-  virtual CallResult<bool> less(uint32_t a, uint32_t b) override {
-    GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
-    HermesValue aVal = JSObject::getOwnIndexed(*self_, runtime_, a);
-    HermesValue bVal = JSObject::getOwnIndexed(*self_, runtime_, b);
-    if (!WithCompareFn) {
-      double a = aVal.getNumber();
-      double b = bVal.getNumber();
-      if (LLVM_UNLIKELY(a == 0) && LLVM_UNLIKELY(b == 0) &&
-          LLVM_UNLIKELY(std::signbit(a)) && LLVM_UNLIKELY(!std::signbit(b))) {
-        // -0 < +0, according to the spec.
-        return true;
-      }
-      return a < b;
+    if (offsets[(keys[0] >> shift) & 0xff] == length) {
+      // Every key has the same digit, so this pass would change nothing.
+      continue;
+    }
+    uint32_t sum = 0;
+    for (uint32_t &offset : offsets) {
+      const uint32_t count = offset;
+      offset = sum;
+      sum += count;
+    }
+    for (Key k : keys) {
+      sorted[offsets[(k >> shift) & 0xff]++] = k;
     }
-    assert(compareFn_ && "Cannot use this version if the compareFn is null");
+    keys.swap(sorted);
+  }
+  for (uint32_t i = 0; i < length; ++i) {
+    data[i] = SortKey::decode(keys[i]);
+  }
+}
+
+/// Sort the elements of \p self with \p compareFn, as
+/// TypedArray.prototype.sort does. The elements are sorted in a copy, which
+/// compareFn cannot observe, and copied back at the end.
+template <typename T, CellKind C>
+ExecutionStatus typedArrayCompareSort(
+    Runtime *runtime,
+    Handle<JSTypedArray<T, C>> self,
+    Handle<Callable> compareFn) {
+  std::vector<T> values(self->begin(runtime), self->end(runtime));
+  auto less = [runtime, self, compareFn](T a, T b) -> CallResult<bool> {
+    GCScopeMarkerRAII marker{runtime};
     // ES7 22.2.3.26 2a.
     // Let v be toNumber_RJS(Call(comparefn, undefined, x, y)).
     auto callRes = Callable::executeCall2(
-        compareFn_, runtime_, Runtime::getUndefinedValue(), aVal, bVal);
+        compareFn,
+        runtime,
+        Runtime::getUndefinedValue(),
+        SafeNumericEncoder<T>::encode(a),
+        SafeNumericEncoder<T>::encode(b));
     if (callRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
-    auto intRes = toNumber_RJS(runtime_, runtime_->makeHandle(*callRes));
+    auto intRes = toNumber_RJS(runtime, runtime->makeHandle(*callRes));
     if (intRes == ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
     }
     // ES7 22.2.3.26 2b.
     // If IsDetachedBuffer(buffer) is true, throw a TypeError exception.
-    if (LLVM_UNLIKELY(!self_->attached(runtime_))) {
-      return runtime_->raiseTypeError("Callback to sort() detached the array");
+    if (LLVM_UNLIKELY(!self->attached(runtime))) {
+      return runtime->raiseTypeError("Callback to sort() detached the array");
     }
     return intRes->getNumber() < 0;
+  };
+  if (LLVM_UNLIKELY(
+          timSort(values.data(), values.size(), less) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-};
+  // The length of an attached TypedArray never changes.
+  std::copy(values.begin(), values.end(), self->begin(runtime));
+  return ExecutionStatus::RETURNED;
+}
 
 // ES7 22.2.3.23.1
 CallResult<HermesValue> typedArrayPrototypeSetObject(
@@ -1312,17 +1352,28 @@ typedArrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError("TypedArray sort argument must be callable");
   }
 
-  // Use our custom sort routine. We can't use std::sort because it performs
-  // optimizations that allow it to bypass calls to std::swap, but our swap
-  // function is special, since it needs to use the internal Object functions.
-  if (compareFn) {
-    TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
+  // Need to case on the TypedArray type to sort the elements in place,
+  // without encoding them as HermesValues.
+#define TYPED_ARRAY(name, type)                                              \
+  case CellKind::name##ArrayKind: {                                          \
+    using TA = JSTypedArray<type, CellKind::name##ArrayKind>;                \
+    if (compareFn) {                                                         \
+      if (LLVM_UNLIKELY(                                                     \
+              typedArrayCompareSort(                                         \
+                  runtime, Handle<TA>::vmcast(self), compareFn) ==           \
+              ExecutionStatus::EXCEPTION)) {                                 \
+        return ExecutionStatus::EXCEPTION;                                   \
+      }                                                                      \
+    } else {                                                                 \
+      typedArrayNumericSort(vmcast<TA>(*self)->begin(runtime), len);         \
+    }                                                                        \
+    break;                                                                   \
+  }
+
+  switch (self->getKind()) {
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
   }
   return self.getHermesValue();
 }
@@ -174,6 +174,7 @@ static llvm::SmallString<32> canonicalizePath(
     llvm::sys::path::append(canonicalPath, llvm::sys::path::Style::posix, str);
   };
 
+  StringPrimitive::ensureFlat(runtime, target);
   if (target->getStringLength() > 0 && target->at(0) == u'/') {
     // If the dirname is absolute (starts with a '/'), resolve from the module
     // root.
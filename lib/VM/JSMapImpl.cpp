@@ -115,7 +115,7 @@ void JSMapIteratorImpl<C>::MapOrSetIteratorBuildMeta(
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSMapIteratorImpl<C> *>(cell);
   mb.addField("data", &self->data_);
-  mb.addField("itr", &self->itr_);
+  mb.addField("itrTable", &self->itrTable_);
 }
 
 void MapIteratorBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
@@ -135,7 +135,8 @@ void serializeMapOrSetIteratorImpl(Serializer &s, const GCCell *cell) {
   JSObject::serializeObjectImpl(
       s, cell, JSObject::numOverlapSlots<JSMapIteratorImpl<C>>());
   s.writeRelocation(self->data_.get(s.getRuntime()));
-  s.writeRelocation(self->itr_.get(s.getRuntime()));
+  s.writeRelocation(self->itrTable_.get(s.getRuntime()));
+  s.writeInt<uint32_t>(self->itrIndex_);
   s.writeInt<uint8_t>((uint8_t)self->iterationKind_);
   s.writeInt<uint8_t>(self->iterationFinished_);
 }
@@ -144,7 +145,8 @@ template <CellKind C>
 JSMapIteratorImpl<C>::JSMapIteratorImpl(Deserializer &d)
     : JSObject(d, &vt.base) {
   d.readRelocation(&data_, RelocationKind::GCPointer);
-  d.readRelocation(&itr_, RelocationKind::GCPointer);
+  d.readRelocation(&itrTable_, RelocationKind::GCPointer);
+  itrIndex_ = d.readInt<uint32_t>();
   iterationKind_ = (IterationKind)d.readInt<uint8_t>();
   iterationFinished_ = d.readInt<uint8_t>();
 }
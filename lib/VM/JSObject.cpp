@@ -1043,12 +1043,19 @@ CallResult<HermesValue> JSObject::getNamedWithReceiver_RJS(
     SymbolID name,
     Handle<> receiver,
     PropOpFlags opFlags,
-    PropertyCacheEntry *cacheEntry) {
+    PolymorphicPropertyCache *cache) {
   NamedPropertyDescriptor desc;
   // Locate the descriptor. propObj contains the object which may be anywhere
   // along the prototype chain.
   JSObject *propObj = getNamedDescriptor(selfHandle, runtime, name, desc);
   if (!propObj) {
+    // Remember that the prototype chain does not have the property.
+    if (cache) {
+      if (JSObject *parent = selfHandle->getParent(runtime)) {
+        runtime->getProtoChainPropertyCache().add(
+            runtime, parent, name, nullptr, 0);
+      }
+    }
     if (LLVM_UNLIKELY(opFlags.getMustExist())) {
       return runtime->raiseReferenceError(
           TwineChar16("Property '") +
@@ -1062,9 +1069,12 @@ CallResult<HermesValue> JSObject::getNamedWithReceiver_RJS(
           !desc.flags.accessor && !desc.flags.hostObject &&
           !desc.flags.proxyObject)) {
     // Populate the cache if requested.
-    if (cacheEntry && !propObj->getClass(runtime)->isDictionaryNoCache()) {
-      cacheEntry->clazz = propObj->getClassGCPtr().getStorageType();
-      cacheEntry->slot = desc.slot;
+    if (cache && !propObj->getClass(runtime)->isDictionaryNoCache()) {
+      cache->add(propObj->getClassGCPtr().getStorageType(), desc.slot);
+      if (propObj != *selfHandle) {
+        runtime->getProtoChainPropertyCache().add(
+            runtime, selfHandle->getParent(runtime), name, propObj, desc.slot);
+      }
     }
     return getNamedSlotValue(propObj, runtime, desc);
   }
@@ -2560,6 +2570,14 @@ void JSObject::updatePropertyFlagsWithoutTransitions(
   selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
 }
 
+void JSObject::usePropertyCells(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  auto newClazz = HiddenClass::convertToPropertyCells(
+      runtime->makeHandle(selfHandle->clazz_), runtime);
+  selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+}
+
 CallResult<bool> JSObject::isExtensible(
     PseudoHandle<JSObject> self,
     Runtime *runtime) {
@@ -3086,13 +3104,11 @@ ExecutionStatus setProtoClasses(
 /// \param arr Array previously populated by setProtoClasses
 /// \return The index after the terminating null if everything matches,
 /// otherwise 0.
-uint32_t matchesProtoClasses(
-    Runtime *runtime,
-    Handle<JSObject> obj,
-    Handle<BigStorage> arr) {
-  MutableHandle<JSObject> head(runtime, obj->getParent(runtime));
+uint32_t
+matchesProtoClasses(Runtime *runtime, JSObject *obj, BigStorage *arr) {
+  JSObject *head = obj->getParent(runtime);
   uint32_t i = 0;
-  while (head.get()) {
+  while (head) {
     HermesValue protoCls = arr->at(i++);
     if (protoCls.isNull() || protoCls.getObject() != head->getClass(runtime) ||
         head->isProxyObject()) {
@@ -3117,12 +3133,15 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
     uint32_t &endIndex) {
   Handle<HiddenClass> clazz(runtime, obj->getClass(runtime));
 
+  auto &stats = runtime->getRuntimeStats();
+
   // Fast case: Check the cache.
   MutableHandle<BigStorage> arr(runtime, clazz->getForInCache(runtime));
   if (arr) {
-    beginIndex = matchesProtoClasses(runtime, obj, arr);
+    beginIndex = matchesProtoClasses(runtime, *obj, *arr);
     if (beginIndex) {
       // Cache is valid for this object, so use it.
+      ++stats.forInCacheHits;
       endIndex = arr->size();
       return arr;
     }
@@ -3134,6 +3153,7 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
   }
 
   // Slow case: Build the array of properties.
+  ++stats.forInCacheMisses;
   auto ownPropEstimate = clazz->getNumProperties();
   auto arrRes = obj->shouldCacheForIn(runtime)
       ? BigStorage::createLongLived(runtime, ownPropEstimate)
@@ -3160,13 +3180,19 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
   if (canCache && !tooMuchProto) {
     assert(beginIndex > 0 && "cached array must start with proto classes");
 #ifdef HERMES_SLOW_DEBUG
-    assert(beginIndex == matchesProtoClasses(runtime, obj, arr) && "matches");
+    assert(
+        beginIndex == matchesProtoClasses(runtime, *obj, *arr) && "matches");
 #endif
     clazz->setForInCache(*arr, runtime);
   }
   return arr;
 }
 
+bool isForInCacheValid(Runtime *runtime, JSObject *obj, BigStorage *arr) {
+  return obj->getClass(runtime)->getForInCache(runtime) == arr &&
+      matchesProtoClasses(runtime, obj, arr);
+}
+
 //===----------------------------------------------------------------------===//
 // class PropertyAccessor
 
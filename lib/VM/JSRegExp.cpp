@@ -114,7 +114,8 @@ ExecutionStatus JSRegExp::initialize(
     Runtime *runtime,
     Handle<StringPrimitive> pattern,
     Handle<StringPrimitive> flags,
-    OptValue<llvm::ArrayRef<uint8_t>> bytecode) {
+    OptValue<llvm::ArrayRef<uint8_t>> bytecode,
+    bool cacheBytecode) {
   assert(
       pattern && flags &&
       "Null pattern and/or flags passed to initializeWithPatternAndFlags");
@@ -146,35 +147,58 @@ ExecutionStatus JSRegExp::initialize(
       res != ExecutionStatus::EXCEPTION && *res &&
       "defineOwnProperty() failed");
 
-  if (bytecode) {
+  regex::constants::SyntaxFlags nativeFlags = {};
+  if (fbits->ignoreCase)
+    nativeFlags |= regex::constants::icase;
+  if (fbits->multiline)
+    nativeFlags |= regex::constants::multiline;
+  if (fbits->unicode)
+    nativeFlags |= regex::constants::unicode;
+  if (fbits->dotAll)
+    nativeFlags |= regex::constants::dotAll;
+
+  // Compiling a pattern is expensive, so look for the same pattern and flags
+  // in the cache first, and make precompiled bytecode available to later
+  // RegExps built at runtime.
+  RegExpCache &cache = runtime->getRegExpCache();
+  if (bytecode && !(cacheBytecode && cache.isEnabled()))
     return selfHandle->initializeBytecode(*bytecode, runtime);
-  } else {
-    regex::constants::SyntaxFlags nativeFlags = {};
-    if (fbits->ignoreCase)
-      nativeFlags |= regex::constants::icase;
-    if (fbits->multiline)
-      nativeFlags |= regex::constants::multiline;
-    if (fbits->unicode)
-      nativeFlags |= regex::constants::unicode;
-
-    auto patternText = StringPrimitive::createStringView(runtime, pattern);
-    llvm::SmallVector<char16_t, 16> patternText16;
-    patternText.copyUTF16String(patternText16);
-
-    // Build the regex.
-    regex::Regex<regex::UTF16RegexTraits> regex(
-        patternText16.begin(), patternText16.end(), nativeFlags);
-
-    if (!regex.valid()) {
-      runtime->raiseSyntaxError(
-          TwineChar16("Invalid RegExp pattern: ") +
-          regex::constants::messageForError(regex.getError()));
-      return ExecutionStatus::EXCEPTION;
+
+  llvm::SmallVector<char16_t, 16> patternText16;
+  StringPrimitive::createStringView(runtime, pattern)
+      .copyUTF16String(patternText16);
+  RegExpCache::Key key;
+  if (cache.isEnabled()) {
+    key = RegExpCache::makeKey(patternText16, nativeFlags);
+    if (bytecode) {
+      cache.insert(key, *bytecode);
+      return selfHandle->initializeBytecode(*bytecode, runtime);
+    }
+
+    auto &stats = runtime->getRuntimeStats();
+    llvm::ArrayRef<uint8_t> cached = cache.find(key);
+    if (!cached.empty()) {
+      ++stats.regExpCacheHits;
+      return selfHandle->initializeBytecode(cached, runtime);
     }
-    // The regex is valid. Compile and store its bytecode.
-    auto bytecode = regex.compile();
-    return selfHandle->initializeBytecode(bytecode, runtime);
+    ++stats.regExpCacheMisses;
+  }
+
+  // Build the regex.
+  regex::Regex<regex::UTF16RegexTraits> regex(
+      patternText16.begin(), patternText16.end(), nativeFlags);
+
+  if (!regex.valid()) {
+    runtime->raiseSyntaxError(
+        TwineChar16("Invalid RegExp pattern: ") +
+        regex::constants::messageForError(regex.getError()));
+    return ExecutionStatus::EXCEPTION;
   }
+  // The regex is valid. Compile, cache and store its bytecode.
+  auto compiled = regex.compile();
+  if (cache.isEnabled())
+    cache.insert(key, compiled);
+  return selfHandle->initializeBytecode(compiled, runtime);
 }
 
 ExecutionStatus JSRegExp::initializeBytecode(
@@ -10,6 +10,7 @@
 #include "hermes/Support/ErrorHandling.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
 #include "hermes/VM/Operations.h"
 
 #include "llvm/Support/Debug.h"
@@ -17,53 +18,6 @@
 
 namespace hermes {
 namespace vm {
-//===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-VTable HashMapEntry::vt{CellKind::HashMapEntryKind, cellSize<HashMapEntry>()};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.addField("key", &self->key);
-  mb.addField("value", &self->value);
-  mb.addField("prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("nextEntryInBucket", &self->nextEntryInBucket);
-}
-
-#ifdef HERMESVM_SERIALIZE
-HashMapEntry::HashMapEntry(Deserializer &d)
-    : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  d.readHermesValue(&key);
-  d.readHermesValue(&value);
-  d.readRelocation(&prevIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextIterationEntry, RelocationKind::GCPointer);
-  d.readRelocation(&nextEntryInBucket, RelocationKind::GCPointer);
-}
-
-void HashMapEntrySerialize(Serializer &s, const GCCell *cell) {
-  auto *self = vmcast<const HashMapEntry>(cell);
-  s.writeHermesValue(self->key);
-  s.writeHermesValue(self->value);
-  s.writeRelocation(self->prevIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextIterationEntry.get(s.getRuntime()));
-  s.writeRelocation(self->nextEntryInBucket.get(s.getRuntime()));
-  s.endObject(cell);
-}
-
-void HashMapEntryDeserialize(Deserializer &d, CellKind kind) {
-  assert(kind == CellKind::HashMapEntryKind && "Expected HashMapEntry");
-  void *mem = d.getRuntime()->alloc(cellSize<HashMapEntry>());
-  auto *cell = new (mem) HashMapEntry(d);
-  d.endObject(cell);
-}
-#endif
-
-CallResult<HermesValue> HashMapEntry::create(Runtime *runtime) {
-  void *mem = runtime->alloc(cellSize<HashMapEntry>());
-  return HermesValue::encodeObjectValue(new (mem) HashMapEntry(runtime));
-}
-
 //===----------------------------------------------------------------------===//
 // class OrderedHashMap
 
@@ -73,39 +27,23 @@ VTable OrderedHashMap::vt{CellKind::OrderedHashMapKind,
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
   mb.addField("hashTable", &self->hashTable_);
-  mb.addField("firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("entries", &self->entries_);
 }
 
 #ifdef HERMESVM_SERIALIZE
 OrderedHashMap::OrderedHashMap(Deserializer &d)
     : GCCell(&d.getRuntime()->getHeap(), &vt) {
-  if (d.readInt<uint8_t>()) {
-    hashTable_.set(
-        d.getRuntime(),
-        ArrayStorage::deserializeArrayStorage(d),
-        &d.getRuntime()->getHeap());
-  }
-
-  d.readRelocation(&firstIterationEntry_, RelocationKind::GCPointer);
-  d.readRelocation(&lastIterationEntry_, RelocationKind::GCPointer);
+  d.readRelocation(&hashTable_, RelocationKind::GCPointer);
+  // The entry table may be shared with iterators.
+  d.readRelocation(&entries_, RelocationKind::GCPointer);
   capacity_ = d.readInt<uint32_t>();
   size_ = d.readInt<uint32_t>();
 }
 
 void OrderedHashMapSerialize(Serializer &s, const GCCell *cell) {
   auto *self = vmcast<const OrderedHashMap>(cell);
-  // If we have an ArrayStorage, it doesn't store any native pointers. Serialize
-  // it here.
-  bool hasArray = (bool)self->hashTable_;
-  s.writeInt<uint8_t>(hasArray);
-  if (hasArray) {
-    ArrayStorage::serializeArrayStorage(
-        s, self->hashTable_.get(s.getRuntime()));
-  }
-
-  s.writeRelocation(self->firstIterationEntry_.get(s.getRuntime()));
-  s.writeRelocation(self->lastIterationEntry_.get(s.getRuntime()));
+  s.writeRelocation(self->hashTable_.get(s.getRuntime()));
+  s.writeRelocation(self->entries_.get(s.getRuntime()));
   s.writeInt<uint32_t>(self->capacity_);
   s.writeInt<uint32_t>(self->size_);
 
@@ -123,136 +61,118 @@ void OrderedHashMapDeserialize(Deserializer &d, CellKind kind) {
 
 OrderedHashMap::OrderedHashMap(
     Runtime *runtime,
-    Handle<ArrayStorage> hashTableStorage)
+    Handle<SegmentedArray> hashTable,
+    Handle<SegmentedArray> entries)
     : GCCell(&runtime->getHeap(), &vt),
-      hashTable_(runtime, hashTableStorage.get(), &runtime->getHeap()) {}
+      hashTable_(runtime, hashTable.get(), &runtime->getHeap()),
+      entries_(runtime, entries.get(), &runtime->getHeap()) {}
+
+ExecutionStatus OrderedHashMap::allocateTables(
+    Runtime *runtime,
+    uint32_t capacity,
+    MutableHandle<SegmentedArray> &hashTable,
+    MutableHandle<SegmentedArray> &entries) {
+  assert((capacity & (capacity - 1)) == 0 && "capacity must be power of 2");
+  if (LLVM_UNLIKELY(capacity > MAX_CAPACITY)) {
+    return runtime->raiseRangeError("Map or Set has too many elements");
+  }
+  auto hashTableRes =
+      SegmentedArray::create(runtime, capacity / 2, capacity / 2);
+  if (LLVM_UNLIKELY(hashTableRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  hashTable = hashTableRes->get();
+  // The entry table is full-sized from the start, because SegmentedArray may
+  // be trimmed down to its size by the GC.
+  const uint32_t numSlots = kHeaderSize + capacity * kEntrySize;
+  auto entriesRes = SegmentedArray::create(runtime, numSlots, numSlots);
+  if (LLVM_UNLIKELY(entriesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  entries = entriesRes->get();
+  entries->at(kClearedSlot).setNonPtr(HermesValue::encodeBoolValue(false));
+  entries->at(kUsedSlot).setNonPtr(HermesValue::encodeNativeUInt32(0));
+  return ExecutionStatus::RETURNED;
+}
 
 CallResult<HermesValue> OrderedHashMap::create(Runtime *runtime) {
-  auto arrRes =
-      ArrayStorage::create(runtime, INITIAL_CAPACITY, INITIAL_CAPACITY);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+  MutableHandle<SegmentedArray> hashTable{runtime};
+  MutableHandle<SegmentedArray> entries{runtime};
+  if (LLVM_UNLIKELY(
+          allocateTables(runtime, INITIAL_CAPACITY, hashTable, entries) ==
+          ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime->makeHandle<ArrayStorage>(*arrRes);
 
   void *mem = runtime->alloc(cellSize<OrderedHashMap>());
   return HermesValue::encodeObjectValue(
-      new (mem) OrderedHashMap(runtime, hashTableStorage));
+      new (mem) OrderedHashMap(runtime, hashTable, entries));
 }
 
-void OrderedHashMap::removeLinkedListNode(
-    Runtime *runtime,
-    HashMapEntry *entry,
-    GC *gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.get(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
-  }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.get(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
-  }
-  entry->prevIterationEntry = nullptr;
-}
-
-HashMapEntry *OrderedHashMap::lookupInBucket(
+OptValue<uint32_t> OrderedHashMap::lookupInBucket(
     Runtime *runtime,
     uint32_t bucket,
-    HermesValue key) {
-  assert(
-      hashTable_.get(runtime)->size() == capacity_ && "Inconsistent capacity");
-  auto *entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
+    HermesValue key) const {
+  const SegmentedArray *entries = entries_.getNonNull(runtime);
+  const SegmentedArray *hashTable = hashTable_.getNonNull(runtime);
+  const GCHermesValue *link = &hashTable->at(bucket);
+  while (!link->isEmpty()) {
+    const uint32_t i = link->getNativeUInt32();
+    if (isSameValueZero(entries->at(slot(i, kKeyField)), key)) {
+      return i;
+    }
+    link = &entries->at(slot(i, kChainField));
   }
-  return entry;
+  return llvm::None;
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::rehash(
     Handle<OrderedHashMap> self,
-    Runtime *runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the apropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
-    }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
-  }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
+    Runtime *runtime,
+    uint32_t newCapacity) {
+  assert(self->size_ <= newCapacity && "Rehashing into too small a table");
+  MutableHandle<SegmentedArray> newHashTable{runtime};
+  MutableHandle<SegmentedArray> newEntries{runtime};
+  if (LLVM_UNLIKELY(
+          allocateTables(runtime, newCapacity, newHashTable, newEntries) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
   }
-  assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
   // Set new capacity first to update the hash function.
   self->capacity_ = newCapacity;
 
-  // Create a new hash table.
-  auto arrRes = ArrayStorage::create(runtime, newCapacity, newCapacity);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newHashTable = runtime->makeHandle<ArrayStorage>(*arrRes);
-
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
+  // Now copy the live entries over in order, and chain them up again.
   MutableHandle<> keyHandle{runtime};
   GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.get(runtime)->size(); i < len;
+  uint32_t dest = 0;
+  for (uint32_t i = 0, e = usedEntries(self->entries_.getNonNull(runtime));
+       i < e;
        ++i) {
-    entry = dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(i));
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket = nullptr;
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket)),
-            &runtime->getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->at(bucket).set(entry.getHermesValue(), &runtime->getHeap());
-
-      entry = *oldNextInBucket;
+    marker.flush();
+    SegmentedArray *entries = self->entries_.getNonNull(runtime);
+    keyHandle = entries->at(slot(i, kKeyField));
+    if (keyHandle->isEmpty()) {
+      continue;
     }
+    const uint32_t bucket = hashToBucket(self, runtime, keyHandle);
+    entries = self->entries_.getNonNull(runtime);
+    newEntries->at(slot(dest, kKeyField)).set(*keyHandle, &runtime->getHeap());
+    newEntries->at(slot(dest, kValueField))
+        .set(entries->at(slot(i, kValueField)), &runtime->getHeap());
+    newEntries->at(slot(dest, kChainField))
+        .setNonPtr(newHashTable->at(bucket));
+    newHashTable->at(bucket).setNonPtr(HermesValue::encodeNativeUInt32(dest));
+    ++dest;
   }
+  assert(dest == self->size_ && "Inconsistent size");
+  newEntries->at(kUsedSlot).setNonPtr(HermesValue::encodeNativeUInt32(dest));
 
+  // Retire the old entry table, pointing any iterators to the new one.
+  self->entries_.getNonNull(runtime)
+      ->at(kNextTableSlot)
+      .set(newEntries.getHermesValue(), &runtime->getHeap());
   self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
-  assert(
-      self->hashTable_.get(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  self->entries_.set(runtime, newEntries.get(), &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
@@ -261,26 +181,20 @@ bool OrderedHashMap::has(
     Runtime *runtime,
     Handle<> key) {
   auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime *runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  return self->lookupInBucket(runtime, bucket, key.getHermesValue())
+      .hasValue();
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  auto bucket = hashToBucket(self, runtime, key);
+  auto index = self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  if (!index) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return valueAt(self->entries_.getNonNull(runtime), *index);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -289,59 +203,39 @@ ExecutionStatus OrderedHashMap::insert(
     Handle<> key,
     Handle<> value) {
   uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
+  if (auto index =
           self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), &runtime->getHeap());
+    self->entries_.getNonNull(runtime)
+        ->at(slot(*index, kValueField))
+        .set(value.get(), &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime->makeHandle<HashMapEntry>(*crtRes);
-  newMapEntry->key.set(key.get(), &runtime->getHeap());
-  newMapEntry->value.set(value.get(), &runtime->getHeap());
-  auto *curBucketFront =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, &runtime->getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.get(runtime)->at(bucket).set(
-      newMapEntry.getHermesValue(), &runtime->getHeap());
-
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.get(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, &runtime->getHeap());
 
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(
-          runtime, previousLastEntry, &runtime->getHeap());
+  if (usedEntries(self->entries_.getNonNull(runtime)) == self->capacity_) {
+    // The entry table is full. Drop the deleted entries, and grow the table
+    // unless that frees up at least half of it.
+    uint32_t newCapacity = self->capacity_;
+    if (self->size_ >= self->capacity_ / 2) {
+      newCapacity *= 2;
+    }
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, newCapacity) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    bucket = hashToBucket(self, runtime, key);
   }
 
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  SegmentedArray *hashTable = self->hashTable_.getNonNull(runtime);
+  const uint32_t index = usedEntries(entries);
+  entries->at(slot(index, kKeyField)).set(key.get(), &runtime->getHeap());
+  entries->at(slot(index, kValueField)).set(value.get(), &runtime->getHeap());
+  entries->at(slot(index, kChainField)).setNonPtr(hashTable->at(bucket));
+  hashTable->at(bucket).setNonPtr(HermesValue::encodeNativeUInt32(index));
+  entries->at(kUsedSlot).setNonPtr(HermesValue::encodeNativeUInt32(index + 1));
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
@@ -349,97 +243,98 @@ bool OrderedHashMap::erase(
     Runtime *runtime,
     Handle<> key) {
   uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
-    // Element does not exist.
-    return false;
-  }
-
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, &runtime->getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.get(runtime)->at(bucket).set(
-        entry->nextEntryInBucket ? HermesValue::encodeObjectValue(
-                                       entry->nextEntryInBucket.get(runtime))
-                                 : HermesValue::encodeEmptyValue(),
-        &runtime->getHeap());
-  }
-
-  entry->markDeleted();
-  self->size_--;
-
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, &runtime->getHeap());
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  SegmentedArray *hashTable = self->hashTable_.getNonNull(runtime);
+  // The slot that links to the current entry.
+  GCHermesValue *link = &hashTable->at(bucket);
+  while (!link->isEmpty()) {
+    const uint32_t i = link->getNativeUInt32();
+    if (isSameValueZero(entries->at(slot(i, kKeyField)), key.get())) {
+      // Unlink the entry from its chain, and leave it in place, deleted, so
+      // that iterators are not affected.
+      link->setNonPtr(entries->at(slot(i, kChainField)));
+      entries->at(slot(i, kKeyField))
+          .setNonPtr(HermesValue::encodeEmptyValue());
+      entries->at(slot(i, kValueField))
+          .setNonPtr(HermesValue::encodeEmptyValue());
+      entries->at(slot(i, kChainField))
+          .setNonPtr(HermesValue::encodeEmptyValue());
+      self->size_--;
+
+      if (self->size_ < self->capacity_ / 4 &&
+          self->capacity_ > INITIAL_CAPACITY) {
+        // Mostly deleted, shrink the table. Shrinking can't exceed the maximum
+        // size, and so can't fail.
+        auto status = rehash(self, runtime, self->capacity_ / 2);
+        (void)status;
+        assert(status != ExecutionStatus::EXCEPTION && "Shrinking failed");
+      }
+      return true;
+    }
+    link = &entries->at(slot(i, kChainField));
   }
-
-  self->rehashIfNecessary(self, runtime);
-
-  return true;
+  // Element does not exist.
+  return false;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
+bool OrderedHashMap::iteratorNext(
     Runtime *runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
+    SegmentedArray *&table,
+    uint32_t &index) const {
+  if (!table) {
     // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+    table = entries_.getNonNull(runtime);
+    index = 0;
+  }
+  // Follow the table to the current one. Each retired table only holds the
+  // entries that were live when it was replaced, so the index moves down by
+  // the number of deleted entries before it, or to the start after a clear.
+  while (!table->at(kNextTableSlot).isEmpty()) {
+    if (table->at(kClearedSlot).getBool()) {
+      index = 0;
+    } else {
+      uint32_t numDeleted = 0;
+      for (uint32_t i = 0; i < index; ++i) {
+        if (table->at(slot(i, kKeyField)).isEmpty()) {
+          ++numDeleted;
+        }
+      }
+      index -= numDeleted;
+    }
+    table = vmcast<SegmentedArray>(table->at(kNextTableSlot));
   }
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+  // Skip the deleted entries.
+  for (const uint32_t used = usedEntries(table); index < used; ++index) {
+    if (!table->at(slot(index, kKeyField)).isEmpty()) {
+      return true;
+    }
   }
-  return entry;
+  return false;
 }
 
-void OrderedHashMap::clear(Runtime *runtime) {
-  if (!firstIterationEntry_) {
-    // Empty set.
+void OrderedHashMap::clear(Handle<OrderedHashMap> self, Runtime *runtime) {
+  if (self->size_ == 0 && self->capacity_ == INITIAL_CAPACITY) {
+    // Nothing to clear.
     return;
   }
-
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(i));
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted();
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.get(runtime)->at(i).setNonPtr(HermesValue::encodeEmptyValue());
-  }
-  // Resize the hash table to the initial size.
-  ArrayStorage::resizeWithinCapacity(
-      hashTable_.getNonNull(runtime), INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
-
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, &runtime->getHeap());
-  firstIterationEntry_.get(runtime)->prevIterationEntry = nullptr;
-  size_ = 0;
+  MutableHandle<SegmentedArray> newHashTable{runtime};
+  MutableHandle<SegmentedArray> newEntries{runtime};
+  // Allocating tables of the initial size can't fail.
+  auto status =
+      allocateTables(runtime, INITIAL_CAPACITY, newHashTable, newEntries);
+  (void)status;
+  assert(status != ExecutionStatus::EXCEPTION && "Allocation failed");
+
+  // Retire the old entry table, so that any iterators restart in the new one.
+  SegmentedArray *entries = self->entries_.getNonNull(runtime);
+  entries->at(kClearedSlot).setNonPtr(HermesValue::encodeBoolValue(true));
+  entries->at(kNextTableSlot)
+      .set(newEntries.getHermesValue(), &runtime->getHeap());
+  self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
+  self->entries_.set(runtime, newEntries.get(), &runtime->getHeap());
+  self->capacity_ = INITIAL_CAPACITY;
+  self->size_ = 0;
 }
 
 } // namespace vm
@@ -59,6 +59,8 @@ CallResult<Handle<JSString>> JSString::create(
     Runtime *runtime,
     Handle<StringPrimitive> value,
     Handle<JSObject> parentHandle) {
+  // Indexed properties read the characters of the string directly.
+  StringPrimitive::ensureFlat(runtime, value);
   JSObjectAlloc<JSString> mem{runtime};
   auto selfHandle = mem.initToHandle(new (mem) JSString(
       runtime,
@@ -96,6 +98,7 @@ void JSString::setPrimitiveString(
     Handle<JSString> selfHandle,
     Runtime *runtime,
     Handle<StringPrimitive> string) {
+  StringPrimitive::ensureFlat(runtime, string);
   NamedPropertyDescriptor desc;
   bool res = JSObject::getOwnNamedDescriptor(
       selfHandle, runtime, Predefined::getSymbolID(Predefined::length), desc);
@@ -240,6 +243,8 @@ CallResult<HermesValue> JSStringIterator::create(
     Runtime *runtime,
     Handle<StringPrimitive> string) {
   auto proto = Handle<JSObject>::vmcast(&runtime->stringIteratorPrototype);
+  // nextElement() reads the characters of the string directly.
+  StringPrimitive::ensureFlat(runtime, string);
 
   JSObjectAlloc<JSStringIterator> mem{runtime};
   return mem.initToHermesValue(new (mem) JSStringIterator(
@@ -68,6 +68,13 @@ bool InlineCacheProfiler::insertICHit(
   return true;
 }
 
+void InlineCacheProfiler::recordState(
+    CodeBlock *codeblock,
+    uint32_t instOffset,
+    PropertyCacheState state) {
+  getICMissBySourceLocation(codeblock, instOffset).recordState(state);
+}
+
 JSArray *&InlineCacheProfiler::getHiddenClassArray() {
   return cachedHiddenClassesRawPtr_;
 }
@@ -154,6 +161,26 @@ void InlineCacheProfiler::dumpInlineCachingMissRecord(
   ostream.flush();
 }
 
+void InlineCacheProfiler::dumpStateTransitions(
+    ICMiss &icMiss,
+    llvm::raw_ostream &ostream) {
+  ostream << "\tcache state: " << propertyCacheStateName(icMiss.state);
+  const char *sep = ", transitions: ";
+  for (size_t from = 0; from < kNumPropertyCacheStates; ++from) {
+    for (size_t to = 0; to < kNumPropertyCacheStates; ++to) {
+      if (uint64_t count = icMiss.transitions[from][to]) {
+        ostream << sep
+                << propertyCacheStateName(static_cast<PropertyCacheState>(from))
+                << " -> "
+                << propertyCacheStateName(static_cast<PropertyCacheState>(to))
+                << " (" << count << ")";
+        sep = ", ";
+      }
+    }
+  }
+  ostream << "\n";
+}
+
 void InlineCacheProfiler::dumpInfoOfSourceLocation(
     ICSrcKey &srcLoc,
     ICMiss &icMiss,
@@ -189,6 +216,8 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 ///
 /// An example of output for a specific source location is as follows:
 /// [filename:line:column] total access: 2661, miss ratio: 0.3
+///  cache state: polymorphic, transitions: uninitialized -> monomorphic (1),
+///    monomorphic -> polymorphic (1)
 ///  property: children, inline cache misses: 427
 ///    <type, domNamespace, children, childIndex, context, footer>
 ///    <domNamespace, type, children, childIndex, context, footer>
@@ -216,6 +245,7 @@ void InlineCacheProfiler::dumpRankedInlineCachingMisses(
     // dump general information at the source location
     ICSrcKey &srcLoc = cacheMissEntry.first;
     dumpInfoOfSourceLocation(srcLoc, icMiss, runtime, ostream);
+    dumpStateTransitions(icMiss, ostream);
 
     // dump details of each type of inline caching misses at the source location
     for (auto &missHCEntry : icMiss.hiddenClasses) {
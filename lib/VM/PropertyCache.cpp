@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/PropertyCache.h"
+
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/Runtime.h"
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// \return whether the own properties of \p obj are exactly those described
+/// by its class, so that its class can stand in for it in a cache entry.
+bool hasPlainProperties(const JSObject *obj) {
+  return !obj->isLazy() && !obj->isHostObject() && !obj->isProxyObject();
+}
+
+} // namespace
+
+constexpr unsigned ProtoChainPropertyCache::kMaxDepth;
+
+bool ProtoChainPropertyCache::find(
+    Runtime *runtime,
+    JSObject *proto,
+    SymbolID id,
+    JSObject *&holder,
+    SlotIndex &slot) const {
+  const ClassStorageType clazz = proto->getClassGCPtr().getStorageType();
+  const Entry &entry = entries_[index(clazz, id)];
+  if (entry.chain[0] != clazz || entry.id != id) {
+    return false;
+  }
+  JSObject *cur = proto;
+  for (unsigned level = 0;;) {
+    if (LLVM_UNLIKELY(!hasPlainProperties(cur))) {
+      return false;
+    }
+    if (++level == entry.depth) {
+      break;
+    }
+    cur = cur->getParent(runtime);
+    if (!cur || cur->getClassGCPtr().getStorageType() != entry.chain[level]) {
+      return false;
+    }
+  }
+  if (entry.found) {
+    holder = cur;
+    slot = entry.slot;
+    return true;
+  }
+  // The property might be found past the end of the chain we checked.
+  if (cur->getParent(runtime)) {
+    return false;
+  }
+  holder = nullptr;
+  return true;
+}
+
+void ProtoChainPropertyCache::add(
+    Runtime *runtime,
+    JSObject *proto,
+    SymbolID id,
+    JSObject *holder,
+    SlotIndex slot) {
+  Entry entry;
+  entry.id = id;
+  entry.slot = slot;
+  entry.found = holder != nullptr;
+  for (JSObject *cur = proto; cur != holder; cur = cur->getParent(runtime)) {
+    if (!cur) {
+      // The holder was not in the chain.
+      return;
+    }
+    if (entry.depth == kMaxDepth || !hasPlainProperties(cur) ||
+        cur->getClass(runtime)->isDictionary()) {
+      return;
+    }
+    entry.chain[entry.depth++] = cur->getClassGCPtr().getStorageType();
+  }
+  if (holder) {
+    if (entry.depth == kMaxDepth || !hasPlainProperties(holder) ||
+        holder->getClass(runtime)->isDictionaryNoCache()) {
+      return;
+    }
+    entry.chain[entry.depth++] = holder->getClassGCPtr().getStorageType();
+  }
+  if (entry.depth == 0) {
+    return;
+  }
+  entries_[index(entry.chain[0], id)] = entry;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+namespace hermes {
+namespace vm {
+
+llvm::ArrayRef<uint8_t> RegExpCache::find(const Key &key) {
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    return {};
+  }
+  // Move the entry to the front.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->bytecode;
+}
+
+void RegExpCache::insert(const Key &key, llvm::ArrayRef<uint8_t> bytecode) {
+  if (capacity_ == 0) {
+    return;
+  }
+  // Look the key up only once, inserting a placeholder if it's new.
+  auto res = map_.emplace(key, entries_.end());
+  if (!res.second) {
+    Entry &entry = *res.first->second;
+    bytecodeSize_ -= entry.bytecode.size();
+    entry.bytecode.assign(bytecode.begin(), bytecode.end());
+    bytecodeSize_ += entry.bytecode.size();
+    entries_.splice(entries_.begin(), entries_, res.first->second);
+    return;
+  }
+
+  if (map_.size() > capacity_) {
+    // Evict the least recently used entry, which can't be the new one.
+    Entry &last = entries_.back();
+    bytecodeSize_ -= last.bytecode.size();
+    map_.erase(last.key);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, {bytecode.begin(), bytecode.end()}});
+  bytecodeSize_ += bytecode.size();
+  res.first->second = entries_.begin();
+}
+
+void RegExpCache::clear() {
+  map_.clear();
+  entries_.clear();
+  bytecodeSize_ = 0;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -67,6 +67,36 @@ void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
            << inst::getOpCodeString(static_cast<inst::OpCode>(op)).data()
            << std::setw(22) << t[op] << std::setw(11) << f[op] << "\n";
   }
+
+  // Get the most frequent pairs of consecutive opcodes.
+  constexpr size_t kMaxPairs = 50;
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i : idx) {
+    for (size_t j : idx) {
+      if (opcodePairFrequency[i][j])
+        pairs.emplace_back(i, j);
+    }
+  }
+  const auto &p = opcodePairFrequency;
+  sort(pairs.begin(), pairs.end(), [&p](const auto &a, const auto &b) {
+    return p[a.first][a.second] > p[b.first][b.second];
+  });
+  if (pairs.size() > kMaxPairs)
+    pairs.resize(kMaxPairs);
+
+  stream << "\nOpcode pairs sorted by frequency:\n"
+         << std::left << std::setfill(' ') << std::setw(25) << "==Opcode=="
+         << std::setw(25) << "==Next Opcode==" << std::setw(11)
+         << "==Frequency=="
+         << "\n";
+  for (const auto &pair : pairs) {
+    stream
+        << std::left << std::setfill(' ') << std::setw(25)
+        << inst::getOpCodeString(static_cast<inst::OpCode>(pair.first)).data()
+        << std::setw(25)
+        << inst::getOpCodeString(static_cast<inst::OpCode>(pair.second)).data()
+        << std::setw(11) << p[pair.first][pair.second] << "\n";
+  }
   os << stream.str();
 }
 #endif
@@ -154,14 +154,24 @@ Runtime::Runtime(
           runtimeConfig.getGCConfig(),
           runtimeConfig.getCrashMgr(),
           std::move(provider)),
-      jitContext_(runtimeConfig.getEnableJIT(), (1 << 20) * 16, (1 << 20) * 32),
+      jitContext_(
+          runtimeConfig.getEnableJIT(),
+          std::min<size_t>((1 << 20) * 16, runtimeConfig.getJITMaxMemory()),
+          runtimeConfig.getJITMaxMemory(),
+          runtimeConfig.getJITCallThreshold(),
+          runtimeConfig.getJITLoopThreshold(),
+          runtimeConfig.getJITBackgroundCompile(),
+          runtimeConfig.getJITPerfMap(),
+          runtimeConfig.getJITPerfDump()),
       hasES6Proxy_(runtimeConfig.getES6Proxy()),
       hasES6Symbol_(runtimeConfig.getES6Symbol()),
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
+      lazyIdentifiers_(runtimeConfig.getLazyIdentifiers()),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
       runtimeStats_(runtimeConfig.getEnableSampledStats()),
+      regExpCache_(runtimeConfig.getRegExpCacheSize()),
       commonStorage_(
           createRuntimeCommonStorage(runtimeConfig.getTraceEnabled())),
       stackPointer_(),
@@ -313,6 +323,10 @@ Runtime::Runtime(
       vmcast<JSObject>(objectPrototype),
       PropOpFlags().plusThrowOnError()));
 
+  // Global variables are accessed through inline caches on the global object,
+  // which has too many properties for class mode.
+  JSObject::usePropertyCells(getGlobal(), this);
+
   symbolRegistry_.init(this);
 
 #ifdef HERMESVM_SERIALIZE
@@ -548,6 +562,18 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor) {
   acceptor.beginRootSection(RootAcceptor::Section::WeakRefs);
   for (auto &rm : runtimeModuleList_)
     rm.markWeakRoots(acceptor);
+  for (auto &entry : megamorphicPropCache_.entries()) {
+    if (entry.clazz) {
+      acceptor.acceptWeak(entry.clazz);
+    }
+  }
+  for (auto &entry : protoChainPropCache_.entries()) {
+    for (unsigned i = 0; i < entry.depth; ++i) {
+      if (entry.chain[i]) {
+        acceptor.acceptWeak(entry.chain[i]);
+      }
+    }
+  }
   markWeakRefs(acceptor);
   for (auto &fn : customMarkWeakRootFuncs_)
     fn(&getHeap(), acceptor);
@@ -608,6 +634,8 @@ void Runtime::getIOTrackingInfoJSON(llvm::raw_ostream &os) {
     if (tracker) {
       json.openDict();
       json.emitKeyValue("url", module.getSourceURL());
+      json.emitKeyValue("mapped_strings", module.getNumMappedStrings());
+      json.emitKeyValue("lazy_identifiers", module.hasLazyIdentifiers());
       json.emitKey("tracking_info");
       tracker->getJSONStats(json);
       json.closeDict();
@@ -620,6 +648,7 @@ void Runtime::removeRuntimeModule(RuntimeModule *rm) {
 #ifdef HERMES_ENABLE_DEBUGGER
   debugger_.willUnloadModule(rm);
 #endif
+  jitContext_.removeRuntimeModule(rm);
   runtimeModuleList_.remove(*rm);
 }
 
@@ -1837,8 +1866,10 @@ void Runtime::recordHiddenClass(
     const Inst *cacheMissInst,
     SymbolID symbolID,
     HiddenClass *objectHiddenClass,
-    HiddenClass *cachedHiddenClass) {
+    HiddenClass *cachedHiddenClass,
+    PropertyCacheState cacheState) {
   auto offset = codeBlock->getOffsetOf(cacheMissInst);
+  inlineCacheProfiler_.recordState(codeBlock, offset, cacheState);
 
   // inline caching hit
   if (objectHiddenClass == cachedHiddenClass) {
@@ -1965,6 +1996,10 @@ void Runtime::serializeRuntimeFields(Serializer &s) {
   // Ignore for now.
   // TODO: come back later.
 
+  // Field MegamorphicPropertyCache megamorphicPropCache_;
+  // Field ProtoChainPropertyCache protoChainPropCache_;
+  // Caches only; they start out empty.
+
   // Field std::vector<PinnedHermesValue> charStrings_{};
   s.writeInt<uint32_t>(charStrings_.size());
   for (auto &str : charStrings_) {
@@ -2049,6 +2084,10 @@ void Runtime::deserializeRuntimeFields(Deserializer &d) {
   // Ignore for now.
   // TODO: come back later.
 
+  // Field MegamorphicPropertyCache megamorphicPropCache_;
+  // Field ProtoChainPropertyCache protoChainPropCache_;
+  // Caches only; they start out empty.
+
   // Field std::vector<PinnedHermesValue> charStrings_{};
   size_t size = d.readInt<uint32_t>();
   charStrings_.resize(size);
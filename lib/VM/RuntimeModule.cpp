@@ -223,6 +223,8 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   auto strTableSize = bcProvider_->getStringCount();
 
   stringIDMap_.clear();
+  identifierRuns_.clear();
+  numMappedStrings_ = 0;
 
   // Populate the string ID map with empty identifiers.
   stringIDMap_.resize(strTableSize, SymbolID::empty());
@@ -244,10 +246,19 @@ void RuntimeModule::importStringIDMapMayAllocate() {
       hashes.size() <= strTableSize &&
       "Should not have more strings than identifiers");
 
+  // Registering an identifier lazily doesn't allocate, so it can be deferred
+  // until the identifier is first used. Most identifiers of a large bundle
+  // aren't used at startup, and the string table pages holding them are
+  // then never touched.
+  bool lazy = runtime_->hasLazyIdentifiers() && flags_.persistent;
+  perf.addArg("identifiers", hashes.size());
+  perf.addArg("lazy", lazy);
+
   // Preallocate enough space to store all identifiers to prevent
   // unnecessary allocations. NOTE: If this module is not the first module,
   // then this is an underestimate.
-  runtime_->getIdentifierTable().reserve(hashes.size());
+  if (!lazy)
+    runtime_->getIdentifierTable().reserve(hashes.size());
   {
     StringID strID = 0;
     uint32_t hashID = 0;
@@ -259,6 +270,12 @@ void RuntimeModule::importStringIDMapMayAllocate() {
           break;
 
         case StringKind::Identifier:
+          if (lazy) {
+            identifierRuns_.push_back({strID, entry.count(), hashID});
+            strID += entry.count();
+            hashID += entry.count();
+            break;
+          }
           for (uint32_t i = 0; i < entry.count(); ++i, ++strID, ++hashID) {
             createSymbolFromStringIDMayAllocate(
                 strID, bcProvider_->getStringTableEntry(strID), hashes[hashID]);
@@ -290,8 +307,37 @@ void RuntimeModule::importStringIDMapMayAllocate() {
     mapStringMayAllocate(s, 0, hashString(s));
   }
 
-  // Done with hashes, so advise them out if possible.
-  bcProvider_->dontNeedIdentifierHashes();
+  // Done with hashes, so advise them out if possible. Lazy identifiers still
+  // need them.
+  if (identifierRuns_.empty())
+    bcProvider_->dontNeedIdentifierHashes();
+}
+
+SymbolID RuntimeModule::registerLazyIdentifier(StringID stringID) {
+  assert(hasLazyIdentifiers() && "Symbol must exist for this string ID");
+  assert(flags_.persistent && "Only persistent modules have lazy identifiers");
+  return createSymbolFromStringIDMayAllocate(
+      stringID,
+      bcProvider_->getStringTableEntry(stringID),
+      getIdentifierHash(stringID));
+}
+
+OptValue<uint32_t> RuntimeModule::getIdentifierHash(StringID stringID) const {
+  // Find the last run starting at or before stringID.
+  auto it = std::upper_bound(
+      identifierRuns_.begin(),
+      identifierRuns_.end(),
+      stringID,
+      [](StringID id, const IdentifierRun &run) {
+        return id < run.firstStringID;
+      });
+  if (it == identifierRuns_.begin())
+    return llvm::None;
+  --it;
+  uint32_t offset = stringID - it->firstStringID;
+  if (offset >= it->count)
+    return llvm::None;
+  return bcProvider_->getIdentifierHashes()[it->firstHashIndex + offset];
 }
 
 void RuntimeModule::initializeFunctionMap() {
@@ -338,6 +384,15 @@ llvm::ArrayRef<uint8_t> RuntimeModule::getRegExpBytecodeFromRegExpID(
   return bcProvider_->getRegExpStorage().slice(entry.offset, entry.length);
 }
 
+bool RuntimeModule::markRegExpCached(uint32_t regExpId) {
+  if (LLVM_UNLIKELY(regExpsCached_.empty()))
+    regExpsCached_.resize(bcProvider_->getRegExpTable().size());
+  if (regExpsCached_[regExpId])
+    return false;
+  regExpsCached_.set(regExpId);
+  return true;
+}
+
 template <typename T>
 SymbolID RuntimeModule::mapStringMayAllocate(
     llvm::ArrayRef<T> str,
@@ -360,7 +415,9 @@ SymbolID RuntimeModule::mapStringMayAllocate(
     id = *runtime_->ignoreAllocationFailure(
         runtime_->getIdentifierTable().getSymbolHandle(runtime_, str, hash));
   }
+  assert(!stringIDMap_[stringID].isValid() && "String is already mapped");
   stringIDMap_[stringID] = id;
+  ++numMappedStrings_;
   return id;
 }
 
@@ -436,6 +493,12 @@ void RuntimeModule::serialize(Serializer &s) {
   // Serialize std::vector<SymbolID> stringIDMap_.
   s.writeInt<size_t>(stringIDMap_.size());
   s.writeData(stringIDMap_.data(), stringIDMap_.size() * sizeof(SymbolID));
+  // Serialize std::vector<IdentifierRun> identifierRuns_, which is needed to
+  // register the identifiers that haven't been used yet.
+  s.writeInt<size_t>(identifierRuns_.size());
+  s.writeData(
+      identifierRuns_.data(), identifierRuns_.size() * sizeof(IdentifierRun));
+  s.writeInt<uint32_t>(numMappedStrings_);
   // RuntimeModule owns bcProvider_, serialize BCProvider with RuntimeModule.
   bcProvider_->serialize(s);
   // Serialize std::vector<CodeBlock *> functionMap_.
@@ -474,6 +537,11 @@ RuntimeModule *RuntimeModule::deserialize(Deserializer &d) {
   res->stringIDMap_.resize(size);
   d.readData(res->stringIDMap_.data(), size * sizeof(SymbolID));
 
+  size = d.readInt<size_t>();
+  res->identifierRuns_.resize(size);
+  d.readData(res->identifierRuns_.data(), size * sizeof(IdentifierRun));
+  res->numMappedStrings_ = d.readInt<uint32_t>();
+
   // We write both BCProviderFromBuffer and BCProviderFromSrc to bytecode
   // file format. Therefore, when we deserialize, always use
   // BCProviderFromBuffer.
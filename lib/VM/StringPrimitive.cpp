@@ -19,6 +19,9 @@
 namespace hermes {
 namespace vm {
 
+template <typename T>
+static void copyRopeChars(const StringPrimitive *str, T *dst);
+
 // Has nothing to do, just here to stop linker errors.
 void DynamicASCIIStringPrimitiveBuildMeta(
     const GCCell *cell,
@@ -140,12 +143,18 @@ void ExternalUTF16StringPrimitiveBuildMeta(
 template <typename T>
 void serializeExternalStringImpl(Serializer &s, const GCCell *cell) {
   const auto *self = vmcast<const ExternalStringPrimitive<T>>(cell);
-  s.writeInt<uint32_t>(self->lengthAndUniquedFlag_);
+  // A concatenation buffer may have been appended to past its own length, so
+  // write all of its contents.
+  uint32_t length = self->contents_.size();
+  s.writeInt<uint32_t>(
+      length |
+      (self->lengthAndUniquedFlag_ &
+       ExternalStringPrimitive<T>::LENGTH_FLAG_UNIQUED));
   s.writeInt<uint32_t>(
       (self->isUniqued() ? self->getUniqueID() : SymbolID::empty())
           .unsafeGetRaw());
   // Writes the actual string.
-  s.writeData(self->getRawPointer(), self->getStringLength() * sizeof(T));
+  s.writeData(self->contents_.data(), length * sizeof(T));
   // contents_.data() is tracked by IDTracker for heapsnapshot. We should do
   // relocation for it.
   s.endObject((void *)self->contents_.data());
@@ -307,6 +316,16 @@ bool StringPrimitive::sliceEquals(
     uint32_t start,
     uint32_t length,
     const StringPrimitive *other) const {
+  if (LLVM_UNLIKELY(!isFlat() || !other->isFlat())) {
+    // There is no runtime to flatten ropes with, copy the characters.
+    if (length != other->getStringLength())
+      return false;
+    llvm::SmallVector<char16_t, 32> chars, otherChars;
+    copyUTF16String(chars);
+    other->copyUTF16String(otherChars);
+    return stringRefEquals(
+        UTF16Ref(chars).slice(start, length), UTF16Ref(otherChars));
+  }
   if (isASCII()) {
     if (other->isASCII()) {
       return stringRefEquals(
@@ -331,6 +350,13 @@ bool StringPrimitive::equals(const StringPrimitive *other) const {
 }
 
 bool StringPrimitive::equals(const StringView &other) const {
+  if (LLVM_UNLIKELY(!isFlat())) {
+    if (getStringLength() != other.length())
+      return false;
+    llvm::SmallVector<char16_t, 32> chars;
+    copyUTF16String(chars);
+    return other.equals(UTF16Ref(chars));
+  }
   if (isASCII()) {
     return other.equals(castToASCIIRef());
   }
@@ -338,6 +364,12 @@ bool StringPrimitive::equals(const StringView &other) const {
 }
 
 int StringPrimitive::compare(const StringPrimitive *other) const {
+  if (LLVM_UNLIKELY(!isFlat() || !other->isFlat())) {
+    llvm::SmallVector<char16_t, 32> chars, otherChars;
+    copyUTF16String(chars);
+    other->copyUTF16String(otherChars);
+    return stringRefCompare(UTF16Ref(chars), UTF16Ref(otherChars));
+  }
   if (isASCII()) {
     if (other->isASCII()) {
       return stringRefCompare(castToASCIIRef(), other->castToASCIIRef());
@@ -376,8 +408,11 @@ CallResult<HermesValue> StringPrimitive::concat(
 
   if (xyLen.get() >= CONCAT_STRING_MIN_SIZE ||
       isBufferedStringPrimitive(xPtr)) {
-    if (LLVM_UNLIKELY(
-            !runtime->getHeap().canAllocExternalMemory(xyLen.get()))) {
+    // The characters of concatenation buffers and ropes are external memory.
+    uint32_t xyBytes = xPtr->isASCII() && yPtr->isASCII()
+        ? xyLen.get()
+        : xyLen.get() * sizeof(char16_t);
+    if (LLVM_UNLIKELY(!runtime->getHeap().canAllocExternalMemory(xyBytes))) {
       return runtime->raiseRangeError(
           "Cannot allocate an external string primitive.");
     }
@@ -406,6 +441,7 @@ CallResult<HermesValue> StringPrimitive::slice(
 
   SafeUInt32 safeLen(length);
 
+  ensureFlat(runtime, str);
   auto builder =
       StringBuilder::createStringBuilder(runtime, safeLen, str->isASCII());
   if (builder == ExecutionStatus::EXCEPTION) {
@@ -430,6 +466,12 @@ StringView StringPrimitive::createStringView(
 
 void StringPrimitive::copyUTF16String(
     llvm::SmallVectorImpl<char16_t> &str) const {
+  if (LLVM_UNLIKELY(!isFlat())) {
+    auto size = str.size();
+    str.resize(size + getStringLength());
+    copyRopeChars(this, str.data() + size);
+    return;
+  }
   if (isASCII()) {
     const char *ptr = castToASCIIPointer();
     str.append(ptr, ptr + getStringLength());
@@ -440,6 +482,10 @@ void StringPrimitive::copyUTF16String(
 }
 
 void StringPrimitive::copyUTF16String(char16_t *ptr) const {
+  if (LLVM_UNLIKELY(!isFlat())) {
+    copyRopeChars(this, ptr);
+    return;
+  }
   if (isASCII()) {
     const char *src = castToASCIIPointer();
     std::copy(src, src + getStringLength(), ptr);
@@ -451,6 +497,7 @@ void StringPrimitive::copyUTF16String(char16_t *ptr) const {
 
 StringView StringPrimitive::createStringViewMustBeFlat(
     Handle<StringPrimitive> self) {
+  assert(self->isFlat() && "StringPrimitive must be flat");
   return StringView(self);
 }
 
@@ -709,6 +756,12 @@ template <>
 void BufferedStringPrimitive<char>::appendToCopyableString(
     CopyableBasicString<char> &res,
     const StringPrimitive *str) {
+  if (LLVM_UNLIKELY(!str->isFlat())) {
+    auto size = res.size();
+    res.resize(size + str->getStringLength());
+    copyRopeChars(str, &res[size]);
+    return;
+  }
   auto it = str->castToASCIIPointer();
   res.append(it, it + str->getStringLength());
 }
@@ -716,6 +769,12 @@ template <>
 void BufferedStringPrimitive<char16_t>::appendToCopyableString(
     CopyableBasicString<char16_t> &res,
     const StringPrimitive *str) {
+  if (LLVM_UNLIKELY(!str->isFlat())) {
+    auto size = res.size();
+    res.resize(size + str->getStringLength());
+    copyRopeChars(str, &res[size]);
+    return;
+  }
   if (str->isASCII()) {
     auto it = (const uint8_t *)str->castToASCIIPointer();
     res.append(it, it + str->getStringLength());
@@ -793,6 +852,12 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
 
   assertValidLength(left, right);
 
+  // Copying the right string is only cheap if it is small, and copying the
+  // left one defeats the purpose of a rope.
+  bool useRope = right->getStringLength() >=
+          StringPrimitive::CONCAT_STRING_MIN_SIZE ||
+      !left->isFlat();
+
   if (left->isASCII() && right->isASCII()) {
     if (auto *bufLeft = dyn_vmcast<BufferedASCIIStringPrimitive>(left)) {
       if (bufLeft->getStringLength() ==
@@ -802,6 +867,8 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
             runtime,
             rightHnd);
     }
+    if (useRope)
+      return RopeASCIIStringPrimitive::create(runtime, leftHnd, rightHnd);
     return BufferedASCIIStringPrimitive::create(runtime, leftHnd, rightHnd);
   } else {
     if (auto *bufLeft = dyn_vmcast<BufferedUTF16StringPrimitive>(left)) {
@@ -813,16 +880,32 @@ PseudoHandle<StringPrimitive> internalConcatStringPrimitives(
             rightHnd);
       }
     }
+    if (useRope)
+      return RopeUTF16StringPrimitive::create(runtime, leftHnd, rightHnd);
     return BufferedUTF16StringPrimitive::create(runtime, leftHnd, rightHnd);
   }
 }
 
 #ifdef HERMESVM_SERIALIZE
 template <typename T>
-void serializeConcatStringImpl(Serializer &s, const GCCell *cell) {}
+void serializeConcatStringImpl(Serializer &s, const GCCell *cell) {
+  const auto *self = vmcast<const BufferedStringPrimitive<T>>(cell);
+  // Write string length, followed by the concatenation buffer, which is
+  // serialized on its own.
+  s.writeInt<uint32_t>(self->getStringLength());
+  s.writeHermesValue(self->concatBufferHV_);
+  s.endObject(cell);
+}
 
 template <typename T>
-void deserializeConcatStringImpl(Deserializer &d) {}
+void deserializeConcatStringImpl(Deserializer &d) {
+  uint32_t length = d.readInt<uint32_t>();
+  void *mem = d.getRuntime()->alloc</*fixedSize*/ true, HasFinalizer::No>(
+      sizeof(BufferedStringPrimitive<T>));
+  auto *cell = new (mem) BufferedStringPrimitive<T>(d.getRuntime(), length);
+  d.readHermesValue(&cell->concatBufferHV_);
+  d.endObject(cell);
+}
 
 void BufferedASCIIStringPrimitiveSerialize(Serializer &s, const GCCell *cell) {
   serializeConcatStringImpl<char>(s, cell);
@@ -861,5 +944,261 @@ void BufferedStringPrimitive<T>::_snapshotAddNodesImpl(
 
 template class BufferedStringPrimitive<char16_t>;
 template class BufferedStringPrimitive<char>;
+
+//===----------------------------------------------------------------------===//
+// RopeStringPrimitive<T>
+
+void RopeASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const RopeASCIIStringPrimitive *>(cell);
+  mb.addField("left", &self->leftHV_);
+  mb.addField("right", &self->rightHV_);
+}
+void RopeUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const RopeUTF16StringPrimitive *>(cell);
+  mb.addField("left", &self->leftHV_);
+  mb.addField("right", &self->rightHV_);
+}
+
+template <typename T>
+constexpr uint32_t RopeStringPrimitive<T>::kMaxDepth;
+
+#ifdef HERMESVM_SERIALIZE
+template <typename T>
+void serializeRopeStringImpl(Serializer &s, const GCCell *cell) {
+  const auto *self = vmcast<const RopeStringPrimitive<T>>(cell);
+  // Don't flatten the rope while the heap is being walked, copy it instead.
+  std::vector<T> copy;
+  const T *chars = self->flat_;
+  if (!chars) {
+    copy.resize(self->getStringLength());
+    copyRopeChars(self, copy.data());
+    chars = copy.data();
+  }
+  // Write string length, followed by the characters.
+  s.writeInt<uint32_t>(self->getStringLength());
+  s.writeData(chars, self->flatSize());
+  s.endObject(cell);
+}
+
+template <typename T>
+void deserializeRopeStringImpl(Deserializer &d) {
+  uint32_t length = d.readInt<uint32_t>();
+  T *flat = static_cast<T *>(checkedMalloc2(length, sizeof(T)));
+  d.readData(flat, length * sizeof(T));
+
+  // Restore it as a flattened rope.
+  void *mem = d.getRuntime()->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      sizeof(RopeStringPrimitive<T>));
+  auto *cell = new (mem) RopeStringPrimitive<T>(d.getRuntime(), length, flat);
+  d.getRuntime()->getHeap().creditExternalMemory(cell, cell->flatSize());
+  d.endObject(cell);
+}
+
+void RopeASCIIStringPrimitiveSerialize(Serializer &s, const GCCell *cell) {
+  serializeRopeStringImpl<char>(s, cell);
+}
+
+void RopeUTF16StringPrimitiveSerialize(Serializer &s, const GCCell *cell) {
+  serializeRopeStringImpl<char16_t>(s, cell);
+}
+
+void RopeASCIIStringPrimitiveDeserialize(Deserializer &d, CellKind kind) {
+  assert(
+      kind == CellKind::RopeASCIIStringPrimitiveKind &&
+      "Expected RopeASCIIStringPrimitive");
+  deserializeRopeStringImpl<char>(d);
+}
+
+void RopeUTF16StringPrimitiveDeserialize(Deserializer &d, CellKind kind) {
+  assert(
+      kind == CellKind::RopeUTF16StringPrimitiveKind &&
+      "Expected RopeUTF16StringPrimitive");
+  deserializeRopeStringImpl<char16_t>(d);
+}
+#endif
+
+/// \return the children of \p str if it is a rope which hasn't been
+/// flattened, or a pair of nulls otherwise.
+static std::pair<StringPrimitive *, StringPrimitive *> getRopeChildren(
+    const StringPrimitive *str) {
+  if (LLVM_LIKELY(str->isFlat()))
+    return {nullptr, nullptr};
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(str))
+    return {rope->getLeft(), rope->getRight()};
+  auto *rope = vmcast<RopeUTF16StringPrimitive>(str);
+  return {rope->getLeft(), rope->getRight()};
+}
+
+/// \return the depth of \p str as a child of a rope.
+static uint32_t getRopeDepth(const StringPrimitive *str) {
+  if (auto *rope = dyn_vmcast<RopeASCIIStringPrimitive>(str))
+    return rope->getDepth();
+  if (auto *rope = dyn_vmcast<RopeUTF16StringPrimitive>(str))
+    return rope->getDepth();
+  return 0;
+}
+
+/// Copy the characters of \p str to \p dst, which must have room for them.
+/// Ropes which haven't been flattened are walked with an explicit stack, whose
+/// size is bounded by their depth, and are left unchanged.
+template <typename T>
+static void copyRopeChars(const StringPrimitive *str, T *dst) {
+  llvm::SmallVector<const StringPrimitive *, 16> stack{str};
+  while (!stack.empty()) {
+    const StringPrimitive *cur = stack.pop_back_val();
+    auto children = getRopeChildren(cur);
+    if (children.first) {
+      // Push the right child first, so that the left one is copied first.
+      stack.push_back(children.second);
+      stack.push_back(children.first);
+      continue;
+    }
+    if (cur->isASCII()) {
+      auto src = cur->getStringRef<char>();
+      dst = std::copy(src.begin(), src.end(), dst);
+    } else {
+      assert(
+          (std::is_same<T, char16_t>::value) && "cannot copy UTF16 to ASCII");
+      auto src = cur->getStringRef<char16_t>();
+      dst = std::copy(src.begin(), src.end(), dst);
+    }
+  }
+}
+
+/// Concatenate the flat strings \p leftHnd and \p rightHnd, where the right
+/// one is small, the way StringPrimitive::concat() would.
+static PseudoHandle<StringPrimitive> concatFlatStrings(
+    Runtime *runtime,
+    Handle<StringPrimitive> leftHnd,
+    Handle<StringPrimitive> rightHnd) {
+  SafeUInt32 length(leftHnd->getStringLength());
+  length.add(rightHnd->getStringLength());
+  if (length.get() >= StringPrimitive::CONCAT_STRING_MIN_SIZE ||
+      isBufferedStringPrimitive(leftHnd.get())) {
+    return internalConcatStringPrimitives(runtime, leftHnd, rightHnd);
+  }
+
+  auto builder = StringBuilder::createStringBuilder(
+      runtime, length, leftHnd->isASCII() && rightHnd->isASCII());
+  runtime->ignoreAllocationFailure(builder.getStatus());
+  builder->appendStringPrim(leftHnd);
+  builder->appendStringPrim(rightHnd);
+  return createPseudoHandle(builder->getStringPrimitive().get());
+}
+
+void StringPrimitive::flatten(Runtime *runtime) {
+  GC *gc = &runtime->getHeap();
+  if (isASCII())
+    vmcast<RopeASCIIStringPrimitive>(this)->flattenAndCredit(gc);
+  else
+    vmcast<RopeUTF16StringPrimitive>(this)->flattenAndCredit(gc);
+}
+
+template <typename T>
+PseudoHandle<StringPrimitive> RopeStringPrimitive<T>::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> leftHnd,
+    Handle<StringPrimitive> rightHnd) {
+  MutableHandle<StringPrimitive> left{runtime, leftHnd.get()};
+  MutableHandle<StringPrimitive> right{runtime, rightHnd.get()};
+
+  // Concatenating a small string with a rope would nest the rope one level
+  // deeper. When possible, concatenate it with the adjacent child of the rope
+  // instead, which only copies small strings or appends to a concatenation
+  // buffer. This keeps repeated appends and prepends from deepening the rope.
+  if (right->getStringLength() < CONCAT_STRING_MIN_SIZE) {
+    auto children = getRopeChildren(leftHnd.get());
+    if (children.second && children.second->isFlat()) {
+      auto childHnd = runtime->makeHandle(children.second);
+      left = children.first;
+      right = concatFlatStrings(runtime, childHnd, rightHnd).get();
+    }
+  } else if (left->getStringLength() < CONCAT_STRING_MIN_SIZE) {
+    auto children = getRopeChildren(rightHnd.get());
+    if (children.first &&
+        children.first->getStringLength() + left->getStringLength() <
+            CONCAT_STRING_MIN_SIZE) {
+      auto childHnd = runtime->makeHandle(children.first);
+      right = children.second;
+      left = concatFlatStrings(runtime, leftHnd, childHnd).get();
+    }
+  }
+
+  uint32_t length = left->getStringLength() + right->getStringLength();
+  uint32_t depth =
+      std::max(getRopeDepth(left.get()), getRopeDepth(right.get())) + 1;
+  if (LLVM_UNLIKELY(depth > kMaxDepth)) {
+    // Copy the characters to a concatenation buffer, so that appending to the
+    // result doesn't start nesting ropes again.
+    return BufferedStringPrimitive<T>::create(runtime, left, right);
+  }
+  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      sizeof(RopeStringPrimitive<T>));
+  return createPseudoHandle<StringPrimitive>(new (mem) RopeStringPrimitive<T>(
+      runtime, length, depth, left.get(), right.get()));
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::flattenAndCredit(GC *gc) {
+  assert(!flat_ && "rope is already flat");
+  T *flat =
+      static_cast<T *>(checkedMalloc2(this->getStringLength(), sizeof(T)));
+  copyRopeChars(this, flat);
+  flat_ = flat;
+  // The children are no longer needed, let the GC reclaim them.
+  leftHV_.setNonPtr(HermesValue::encodeEmptyValue());
+  rightHV_.setNonPtr(HermesValue::encodeEmptyValue());
+  depth_ = 0;
+  // StringPrimitive::concat() made sure that the GC can take the buffer.
+  gc->creditExternalMemory(this, flatSize());
+}
+
+template <typename T>
+void RopeStringPrimitive<T>::_finalizeImpl(GCCell *cell, GC *gc) {
+  auto *self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (self->flat_)
+    gc->debitExternalMemory(self, self->flatSize());
+  free(self->flat_);
+  self->~RopeStringPrimitive<T>();
+}
+
+template <typename T>
+size_t RopeStringPrimitive<T>::_mallocSizeImpl(GCCell *cell) {
+  auto *self = vmcast<RopeStringPrimitive<T>>(cell);
+  return self->flat_ ? self->flatSize() : 0;
+}
+
+template <typename T>
+gcheapsize_t RopeStringPrimitive<T>::_externalMemorySizeImpl(
+    const GCCell *cell) {
+  auto *self = vmcast<RopeStringPrimitive<T>>(cell);
+  return self->flat_ ? self->flatSize() : 0;
+}
+
+template <typename T>
+std::string RopeStringPrimitive<T>::_snapshotNameImpl(GCCell *cell, GC *gc) {
+  auto *const self = vmcast<RopeStringPrimitive<T>>(cell);
+  if (self->isFlattened())
+    return StringPrimitive::_snapshotNameImpl(cell, gc);
+
+  // Don't flatten the rope while the heap is being walked, copy it instead.
+  std::u16string chars(self->getStringLength(), u'\0');
+  copyRopeChars(self, &chars[0]);
+  std::string out;
+  if (!convertUTF16ToUTF8WithReplacements(
+          out,
+          UTF16Ref(chars.data(), chars.size()),
+          EXTERNAL_STRING_THRESHOLD)) {
+    out += "...(truncated by snapshot)...";
+  }
+  return out;
+}
+
+template class RopeStringPrimitive<char16_t>;
+template class RopeStringPrimitive<char>;
 } // namespace vm
 } // namespace hermes
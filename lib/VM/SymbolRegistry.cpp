@@ -34,10 +34,10 @@ void SymbolRegistry::markRoots(SlotAcceptor &acceptor) {
 CallResult<SymbolID> SymbolRegistry::getSymbolForKey(
     Runtime *runtime,
     Handle<StringPrimitive> key) {
-  HashMapEntry *it = OrderedHashMap::find(
+  HermesValue existing = OrderedHashMap::get(
       Handle<OrderedHashMap>::vmcast(&stringMap_), runtime, key);
-  if (it) {
-    return it->value.getSymbol();
+  if (existing.isSymbol()) {
+    return existing.getSymbol();
   }
 
   auto symbolRes =
@@ -223,6 +223,8 @@ void AlignedHeapSegment::completeMarking(GC *gc, CompleteMarkState *markState) {
 void AlignedHeapSegment::sweepAndInstallForwardingPointers(
     GC *gc,
     SweepResult *sweepResult) {
+  sweepResult->segmentVTableStarts.push_back(
+      sweepResult->displacedVtablePtrs.size());
   deleteDeadObjectIDs(gc);
   MarkBitArrayNC &markBits = markBitArray();
   char *ptr = start();
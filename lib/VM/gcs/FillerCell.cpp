@@ -16,10 +16,12 @@ namespace hermes {
 namespace vm {
 
 const VTable FillerCell::vt{CellKind::FillerCellKind, 0};
+const VTable FreelistCell::vt{CellKind::FreelistCellKind, 0};
 
 // Empty to prevent linker errors, doesn't need to do anything.
 void UninitializedBuildMeta(const GCCell *, Metadata::Builder &) {}
 void FillerCellBuildMeta(const GCCell *, Metadata::Builder &) {}
+void FreelistCellBuildMeta(const GCCell *, Metadata::Builder &) {}
 
 #ifdef HERMESVM_SERIALIZE
 void UninitializedSerialize(Serializer &s, const GCCell *cell) {
@@ -33,12 +35,23 @@ void FillerCellSerialize(Serializer &s, const GCCell *cell) {
   s.endObject(self);
 }
 
+void FreelistCellSerialize(Serializer &s, const GCCell *cell) {
+  LLVM_DEBUG(
+      llvm::dbgs() << "Serialize function not implemented for FreelistCell\n");
+}
+
 void UninitializedDeserialize(Deserializer &d, CellKind kind) {
   LLVM_DEBUG(
       llvm::dbgs()
       << "Deserialize function not implemented for Uninitialized\n");
 }
 
+void FreelistCellDeserialize(Deserializer &d, CellKind kind) {
+  LLVM_DEBUG(
+      llvm::dbgs()
+      << "Deserialize function not implemented for FreelistCell\n");
+}
+
 void FillerCellDeserialize(Deserializer &d, CellKind kind) {
   assert(kind == CellKind::FillerCellKind && "Expected FillerCell");
   uint32_t size = d.readInt<uint32_t>();
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/GCWorkerPool.h"
+
+#include "hermes/Support/OSCompat.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// \return the number of seconds of CPU time in the interval [start, end).
+double cpuDiffSeconds(
+    std::chrono::microseconds start,
+    std::chrono::microseconds end) {
+  return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+GCWorkerPool::GCWorkerPool(unsigned numThreads) {
+  threads_.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i) {
+    threads_.emplace_back(&GCWorkerPool::workerLoop, this, i + 1);
+  }
+}
+
+GCWorkerPool::~GCWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    shutdown_ = true;
+  }
+  workCond_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+}
+
+void GCWorkerPool::workerLoop(unsigned worker) {
+  uint64_t lastRound = 0;
+  std::unique_lock<std::mutex> lk{mtx_};
+  while (true) {
+    workCond_.wait(lk, [this, lastRound]() {
+      return shutdown_ || round_ != lastRound;
+    });
+    if (shutdown_) {
+      return;
+    }
+    lastRound = round_;
+    const std::function<void(unsigned)> &job = *job_;
+    lk.unlock();
+    const auto cpuStart = oscompat::thread_cpu_time();
+    job(worker);
+    const double cpuSecs =
+        cpuDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+    lk.lock();
+    helperCPUSecs_ += cpuSecs;
+    if (--pending_ == 0) {
+      doneCond_.notify_one();
+    }
+  }
+}
+
+double GCWorkerPool::runOnAllWorkers(
+    const std::function<void(unsigned worker)> &fn) {
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    assert(pending_ == 0 && "A round is already running");
+    job_ = &fn;
+    pending_ = threads_.size();
+    helperCPUSecs_ = 0.0;
+    ++round_;
+  }
+  workCond_.notify_all();
+
+  fn(0);
+
+  std::unique_lock<std::mutex> lk{mtx_};
+  doneCond_.wait(lk, [this]() { return pending_ == 0; });
+  job_ = nullptr;
+  return helperCPUSecs_;
+}
+
+double GCWorkerPool::forEachTask(
+    size_t numTasks,
+    const std::function<void(size_t task, unsigned worker)> &task) {
+  std::atomic<size_t> nextTask{0};
+  return runOnAllWorkers([numTasks, &task, &nextTask](unsigned worker) {
+    for (size_t i = nextTask.fetch_add(1, std::memory_order_relaxed);
+         i < numTasks;
+         i = nextTask.fetch_add(1, std::memory_order_relaxed)) {
+      task(i, worker);
+    }
+  });
+}
+
+constexpr size_t ParallelWorkList::kMaxTake;
+
+void ParallelWorkList::shareWork(std::vector<GCCell *> &stack) {
+  const auto mid = stack.begin() + stack.size() / 2;
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    shared_.insert(shared_.end(), stack.begin(), mid);
+  }
+  stack.erase(stack.begin(), mid);
+  cond_.notify_all();
+}
+
+bool ParallelWorkList::takeWork(std::vector<GCCell *> &stack) {
+  std::unique_lock<std::mutex> lk{mtx_};
+  numIdle_.fetch_add(1, std::memory_order_relaxed);
+  while (shared_.empty()) {
+    if (done_ || numIdle_.load(std::memory_order_relaxed) == numWorkers_) {
+      done_ = true;
+      cond_.notify_all();
+      return false;
+    }
+    cond_.wait(lk);
+  }
+  numIdle_.fetch_sub(1, std::memory_order_relaxed);
+  const size_t n = std::min(shared_.size(), kMaxTake);
+  stack.insert(stack.end(), shared_.end() - n, shared_.end());
+  shared_.resize(shared_.size() - n);
+  return true;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -114,6 +114,9 @@ GenGC::GenGC(
       occupancyTarget_(gcConfig.getOccupancyTarget()),
       oomThreshold_(gcConfig.getEffectiveOOMThreshold()),
       weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())) {
+  if (const unsigned numThreads = gcConfig.getNumGCWorkerThreads()) {
+    workerPool_.reset(new GCWorkerPool(numThreads));
+  }
   growTo(gcConfig.getInitHeapSize());
   claimAllocContext();
   updateCrashManagerHeapExtents();
@@ -543,7 +546,20 @@ struct FullMSCDuplicateRootsDetectorAcceptor final
 void GenGC::markPhase() {
   struct FullMSCMarkInitialAcceptor final : public SlotAcceptorDefault {
     using SlotAcceptorDefault::accept;
-    using SlotAcceptorDefault::SlotAcceptorDefault;
+
+    /// If non-null, the cells marked by this acceptor are also recorded here.
+    std::vector<GCCell *> *markedCells;
+
+    FullMSCMarkInitialAcceptor(GC &gc, std::vector<GCCell *> *markedCells)
+        : SlotAcceptorDefault(gc), markedCells(markedCells) {}
+
+    void markCell(GCCell *cell) {
+      if (markedCells && !AlignedHeapSegment::getCellMarkBit(cell)) {
+        markedCells->push_back(cell);
+      }
+      AlignedHeapSegment::setCellMarkBit(cell);
+    }
+
     void accept(void *&ptr) override {
       if (ptr) {
         assert(gc.dbgContains(ptr));
@@ -553,7 +569,7 @@ void GenGC::markPhase() {
           hermes_fatal("HermesGC: marking pointer to invalid object.");
         }
 #endif
-        AlignedHeapSegment::setCellMarkBit(cell);
+        markCell(cell);
       }
     }
     void accept(HermesValue &hv) override {
@@ -567,7 +583,7 @@ void GenGC::markPhase() {
             hermes_fatal("HermesGC: marking pointer to invalid object.");
           }
 #endif
-          AlignedHeapSegment::setCellMarkBit(cell);
+          markCell(cell);
         }
       } else if (hv.isSymbol()) {
         gc.markSymbol(hv.getSymbol());
@@ -580,7 +596,11 @@ void GenGC::markPhase() {
   markedSymbols_.clear();
   markedSymbols_.resize(gcCallbacks_->getSymbolsEnd(), false);
 
-  FullMSCMarkInitialAcceptor acceptor(*this);
+  // The parallel marking starts from the cells marked by the roots, rather
+  // than from a scan of the mark bits.
+  parallelMarkRoots_.clear();
+  FullMSCMarkInitialAcceptor acceptor(
+      *this, workerPool_ ? &parallelMarkRoots_ : nullptr);
   DroppingAcceptor<FullMSCMarkInitialAcceptor> nameAcceptor{acceptor};
   clearMarkBits();
 
@@ -600,6 +620,7 @@ void GenGC::markPhase() {
 #endif
 
   auto markRootsStart = steady_clock::now();
+  auto markRootsCPUStart = oscompat::thread_cpu_time();
   {
     PerfSection fullGCMarkRootsSystraceRegion("fullGCMarkRoots");
     markRoots(nameAcceptor, /*markLongLived*/ true);
@@ -612,15 +633,21 @@ void GenGC::markPhase() {
   oldGen_.clearUnmarkedPropertyMaps();
 
   auto completeMarkingStart = steady_clock::now();
+  auto completeMarkingCPUStart = oscompat::thread_cpu_time();
   {
     PerfSection fullGCCompleteMarkingSystraceRegion("fullGCCompleteMarking");
     completeMarking();
   }
   auto completeMarkingEnd = steady_clock::now();
+  auto completeMarkingCPUEnd = oscompat::thread_cpu_time();
   markRootsSecs_ +=
       GCBase::clockDiffSeconds(markRootsStart, completeMarkingStart);
   markTransitiveSecs_ +=
       GCBase::clockDiffSeconds(completeMarkingStart, completeMarkingEnd);
+  markRootsCPUSecs_ +=
+      GCBase::clockDiffSeconds(markRootsCPUStart, completeMarkingCPUStart);
+  markTransitiveCPUSecs_ +=
+      GCBase::clockDiffSeconds(completeMarkingCPUStart, completeMarkingCPUEnd);
 }
 
 void GenGC::clearMarkBits() {
@@ -630,6 +657,17 @@ void GenGC::clearMarkBits() {
 }
 
 void GenGC::completeMarking() {
+  if (workerPool_) {
+    // The parallel marking has no mark stack limit, but the WeakMap marking
+    // below is serial and may still overflow.  If it does, fall back to the
+    // serial restart loop.
+    completeMarkingParallel();
+    completeWeakMapMarking();
+    if (!markState_.markStackOverflow_) {
+      return;
+    }
+  }
+
   // completeMarking returns a boolean that is true if and only if the mark
   // stack overflowed whilst trying to complete marking.  When this happens, we
   // must restart marking from the beginning (in increasing order of virtual
@@ -649,6 +687,114 @@ void GenGC::completeMarking() {
   } while (markState_.markStackOverflow_);
 }
 
+namespace {
+
+/// Marks the referents of cells for one worker of a parallel marking.  Mark
+/// bits are set atomically, so that each cell is scanned by exactly one
+/// worker.
+struct ParallelMarkAcceptor final : public SlotAcceptorDefault {
+  using SlotAcceptorDefault::accept;
+
+  ParallelWorkList &state;
+
+  /// Marked cells that this worker has yet to scan.
+  std::vector<GCCell *> stack;
+
+  /// The reachable WeakMaps found by this worker.
+  std::vector<JSWeakMap *> reachableWeakMaps;
+
+  /// The symbols marked by this worker, indexed by symbol ID.
+  std::vector<bool> markedSymbols;
+
+  ParallelMarkAcceptor(GC &gc, ParallelWorkList &state, size_t numSymbols)
+      : SlotAcceptorDefault(gc), state(state), markedSymbols(numSymbols) {}
+
+  void accept(void *&ptr) override {
+    if (ptr) {
+      mark(reinterpret_cast<GCCell *>(ptr));
+    }
+  }
+
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      if (void *ptr = hv.getPointer()) {
+        mark(reinterpret_cast<GCCell *>(ptr));
+      }
+    } else if (hv.isSymbol()) {
+      accept(hv.getSymbol());
+    }
+  }
+
+  void accept(SymbolID sym) override {
+    if (LLVM_UNLIKELY(sym.isInvalid())) {
+      return;
+    }
+    assert(
+        sym.unsafeGetIndex() < markedSymbols.size() &&
+        "symbolID out of reported range");
+    markedSymbols[sym.unsafeGetIndex()] = true;
+  }
+
+  void mark(GCCell *cell) {
+    assert(gc.dbgContains(cell));
+    MarkBitArrayNC *markBits = AlignedHeapSegment::markBitArrayCovering(cell);
+    if (markBits->markAtomic(markBits->addressToIndex(cell))) {
+      stack.push_back(cell);
+    }
+  }
+
+  /// Scan cells until no worker has any left.
+  void drain() {
+    do {
+      while (!stack.empty()) {
+        GCCell *cell = stack.back();
+        stack.pop_back();
+        // As in the serial marking, WeakMaps are not marked through here.
+        if (cell->getKind() == CellKind::WeakMapKind) {
+          reachableWeakMaps.push_back(vmcast<JSWeakMap>(cell));
+        } else {
+          GCBase::markCell(cell, &gc, *this);
+        }
+        if (stack.size() > 1 && state.wantsWork()) {
+          state.shareWork(stack);
+        }
+      }
+    } while (state.takeWork(stack));
+  }
+};
+
+} // namespace
+
+void GenGC::completeMarkingParallel() {
+  assert(workerPool_ && "Parallel marking requires a worker pool");
+  const unsigned numWorkers = workerPool_->numWorkers();
+  ParallelWorkList state{numWorkers};
+  std::vector<std::unique_ptr<ParallelMarkAcceptor>> acceptors;
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    acceptors.emplace_back(
+        new ParallelMarkAcceptor(*this, state, markedSymbols_.size()));
+  }
+  for (size_t i = 0, e = parallelMarkRoots_.size(); i < e; ++i) {
+    acceptors[i % numWorkers]->stack.push_back(parallelMarkRoots_[i]);
+  }
+  parallelMarkRoots_.clear();
+
+  markTransitiveCPUSecs_ += workerPool_->runOnAllWorkers(
+      [&acceptors](unsigned worker) { acceptors[worker]->drain(); });
+
+  for (auto &acceptor : acceptors) {
+    markState_.reachableWeakMaps_.insert(
+        markState_.reachableWeakMaps_.end(),
+        acceptor->reachableWeakMaps.begin(),
+        acceptor->reachableWeakMaps.end());
+    for (size_t i = 0, e = acceptor->markedSymbols.size(); i < e; ++i) {
+      if (acceptor->markedSymbols[i]) {
+        markSymbol(SymbolID::unsafeCreate(i));
+      }
+    }
+  }
+}
+
 void GenGC::completeWeakMapMarking() {
   CompleteMarkState::FullMSCMarkTransitiveAcceptor acceptor(*this, &markState_);
 
@@ -695,15 +841,44 @@ void GenGC::sweepAndInstallForwardingPointers(SweepResult *sweepResult) {
   // TODO (T26749007): use the segment API to iterate over segments in each
   // generation.
   auto sweepStart = steady_clock::now();
+  auto sweepCPUStart = oscompat::thread_cpu_time();
 
+  // The sweep assigns new addresses in heap order, so it runs serially.
   oldGen_.sweepAndInstallForwardingPointers(this, sweepResult);
   youngGen_.sweepAndInstallForwardingPointers(this, sweepResult);
 
   sweepSecs_ += GCBase::clockDiffSeconds(sweepStart, steady_clock::now());
+  sweepCPUSecs_ +=
+      GCBase::clockDiffSeconds(sweepCPUStart, oscompat::thread_cpu_time());
+}
+
+void GenGC::sweptSegments(std::vector<AlignedHeapSegment *> &segments) {
+  auto addSegment = [&segments](AlignedHeapSegment &segment) {
+    segments.push_back(&segment);
+  };
+  oldGen_.forUsedSegments(addSegment);
+  youngGen_.forUsedSegments(addSegment);
+}
+
+/* static */ SweepResult::VTablesRemaining GenGC::segmentVTables(
+    const SweepResult &sweepResult,
+    size_t i) {
+  const auto &starts = sweepResult.segmentVTableStarts;
+  const auto &vTables = sweepResult.displacedVtablePtrs;
+  assert(i < starts.size() && "Segment was not swept");
+  return SweepResult::VTablesRemaining(
+      vTables.begin() + starts[i],
+      i + 1 < starts.size() ? vTables.begin() + starts[i + 1] : vTables.end());
+}
+
+bool GenGC::canRunPhasesInParallel() const {
+  return workerPool_ && !idTracker_.isTrackingIDs() &&
+      !allocationLocationTracker_.isEnabled();
 }
 
 void GenGC::updateReferences(const SweepResult &sweepResult) {
   auto updateRefsStart = steady_clock::now();
+  auto updateRefsCPUStart = oscompat::thread_cpu_time();
   PerfSection fullGCUpdateReferencesSystraceRegion("fullGCUpdateReferences");
   std::unique_ptr<FullMSCUpdateAcceptor> acceptor =
       getFullMSCUpdateAcceptor(*this);
@@ -711,51 +886,86 @@ void GenGC::updateReferences(const SweepResult &sweepResult) {
   markRoots(nameAcceptor, /*markLongLived*/ true);
   markWeakRoots(*acceptor);
 
-  SweepResult::VTablesRemaining vTables(
-      sweepResult.displacedVtablePtrs.begin(),
-      sweepResult.displacedVtablePtrs.end());
+  if (canRunPhasesInParallel()) {
+    updateReferencesParallel(sweepResult);
+  } else {
+    SweepResult::VTablesRemaining vTables(
+        sweepResult.displacedVtablePtrs.begin(),
+        sweepResult.displacedVtablePtrs.end());
 
-  // We swept the old gen into itself before sweeping the young gen.  We must
-  // preserve this order here, to match up cells with their displaced VTable
-  // pointers.
-  oldGen_.updateReferences(this, vTables);
-  youngGen_.updateReferences(this, vTables);
+    // We swept the old gen into itself before sweeping the young gen.  We
+    // must preserve this order here, to match up cells with their displaced
+    // VTable pointers.
+    oldGen_.updateReferences(this, vTables);
+    youngGen_.updateReferences(this, vTables);
+  }
 
   updateWeakReferences(/*fullGC*/ true);
   updateReferencesSecs_ +=
       GCBase::clockDiffSeconds(updateRefsStart, steady_clock::now());
+  updateReferencesCPUSecs_ += GCBase::clockDiffSeconds(
+      updateRefsCPUStart, oscompat::thread_cpu_time());
   unmarkWeakReferences();
 }
 
+void GenGC::updateReferencesParallel(const SweepResult &sweepResult) {
+  std::vector<AlignedHeapSegment *> segments;
+  sweptSegments(segments);
+  assert(
+      segments.size() == sweepResult.segmentVTableStarts.size() &&
+      "Segments changed since the sweep");
+
+  // Each segment's cells can be matched with their displaced VTable pointers
+  // independently, given where the segment's pointers start.
+  updateReferencesCPUSecs_ += workerPool_->forEachTask(
+      segments.size(),
+      [this, &segments, &sweepResult](size_t i, unsigned /*worker*/) {
+        FullMSCUpdateAcceptor acceptor(*this);
+        SweepResult::VTablesRemaining vTables =
+            segmentVTables(sweepResult, i);
+        segments[i]->updateReferences(this, &acceptor, vTables);
+        assert(!vTables.hasNext() && "Not all vtable pointers consumed.");
+      });
+
+  oldGen_.updateFinalizableCellListReferences();
+  youngGen_.updateFinalizableCellListReferences();
+}
+
 void GenGC::compact(const SweepResult &sweepResult) {
   auto compactStart = steady_clock::now();
+  auto compactCPUStart = oscompat::thread_cpu_time();
   PerfSection fullGCCompactSystraceRegion("fullGCCompact");
 
   auto &compactionResult = sweepResult.compactionResult;
 
-  SweepResult::VTablesRemaining vTables(
-      sweepResult.displacedVtablePtrs.begin(),
-      sweepResult.displacedVtablePtrs.end());
-
   CompactionResult::ChunksRemaining chunks(
       compactionResult.usedChunks().begin(),
       compactionResult.usedChunks().end());
 
-  // We swept the old gen into itself before sweeping the young gen.  We must
-  // preserve this order here, so that we re-associate the correct VTable
-  // pointers, and match up the chunks we used with the segments they were
-  // created from.
-  auto doCompaction = [&vTables](AlignedHeapSegment &segment) {
-    segment.compact(vTables);
-  };
+  if (workerPool_) {
+    compactParallel(sweepResult);
+  } else {
+    SweepResult::VTablesRemaining vTables(
+        sweepResult.displacedVtablePtrs.begin(),
+        sweepResult.displacedVtablePtrs.end());
+
+    // We swept the old gen into itself before sweeping the young gen.  We
+    // must preserve this order here, so that we re-associate the correct
+    // VTable pointers.
+    auto doCompaction = [&vTables](AlignedHeapSegment &segment) {
+      segment.compact(vTables);
+    };
 
-  oldGen_.forUsedSegments(doCompaction);
-  youngGen_.forUsedSegments(doCompaction);
+    oldGen_.forUsedSegments(doCompaction);
+    youngGen_.forUsedSegments(doCompaction);
+    assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
+  }
 
+  // Match up the chunks we used with the segments they were created from, in
+  // the order they were swept.
   oldGen_.recordLevelAfterCompaction(chunks);
   youngGen_.recordLevelAfterCompaction(chunks);
 
-  assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
   assert(!chunks.hasNext() && "Not all chunks written back to their segments.");
 
   youngGen_.compactFinalizableObjectList();
@@ -771,6 +981,57 @@ void GenGC::compact(const SweepResult &sweepResult) {
   youngGen_.updateEffectiveEndForExternalMemory();
 
   compactSecs_ += GCBase::clockDiffSeconds(compactStart, steady_clock::now());
+  compactCPUSecs_ +=
+      GCBase::clockDiffSeconds(compactCPUStart, oscompat::thread_cpu_time());
+}
+
+void GenGC::compactParallel(const SweepResult &sweepResult) {
+  std::vector<AlignedHeapSegment *> segments;
+  sweptSegments(segments);
+  assert(
+      segments.size() == sweepResult.segmentVTableStarts.size() &&
+      "Segments changed since the sweep");
+
+  // Cells only ever move backwards in sweep order, so if the first live cell
+  // of a segment stays in that segment, all of its cells do, and it only
+  // writes to itself.  Those segments can be compacted in any order.  The rest
+  // write into earlier segments, so they are compacted afterwards, in sweep
+  // order, as in the serial compaction.
+  std::vector<size_t> independent;
+  std::vector<size_t> dependent;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    AlignedHeapSegment *segment = segments[i];
+    bool selfContained = true;
+    if (segment->level() > segment->start()) {
+      MarkBitArrayNC &markBits = segment->markBitArray();
+      const size_t indexLimit =
+          markBits.addressToIndex(segment->level() - 1) + 1;
+      const size_t ind = markBits.findNextMarkedBitFrom(
+          markBits.addressToIndex(segment->start()));
+      if (ind < indexLimit) {
+        const GCCell *firstLive =
+            reinterpret_cast<GCCell *>(markBits.indexToAddress(ind));
+        selfContained = AlignedStorage::start(firstLive->getForwardingPointer()) ==
+            AlignedStorage::start(segment->lowLim());
+      }
+    }
+    (selfContained ? independent : dependent).push_back(i);
+  }
+
+  compactCPUSecs_ += workerPool_->forEachTask(
+      independent.size(),
+      [&segments, &independent, &sweepResult](size_t task, unsigned /*worker*/) {
+        const size_t i = independent[task];
+        SweepResult::VTablesRemaining vTables = segmentVTables(sweepResult, i);
+        segments[i]->compact(vTables);
+        assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
+      });
+
+  for (size_t i : dependent) {
+    SweepResult::VTablesRemaining vTables = segmentVTables(sweepResult, i);
+    segments[i]->compact(vTables);
+    assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
+  }
 }
 
 void GenGC::markSymbol(SymbolID symbolID) {
@@ -1856,11 +2117,20 @@ void GenGC::printFullCollectionStats(llvm::raw_ostream &os, bool trailingComma)
         static_cast<double>(cumPreBytes_);
   }
 
-  os << "\t\t\t\"fullMarkRootsTime\": " << markRootsSecs_ << ",\n"
+  os << "\t\t\t\"fullNumWorkers\": "
+     << (workerPool_ ? workerPool_->numWorkers() : 1) << ",\n"
+     << "\t\t\t\"fullMarkRootsTime\": " << markRootsSecs_ << ",\n"
      << "\t\t\t\"fullMarkTransitiveTime\": " << markTransitiveSecs_ << ",\n"
      << "\t\t\t\"fullSweepTime\": " << sweepSecs_ << ",\n"
      << "\t\t\t\"fullUpdateRefsTime\": " << updateReferencesSecs_ << ",\n"
      << "\t\t\t\"fullCompactTime\": " << compactSecs_ << ",\n"
+     << "\t\t\t\"fullMarkRootsCPUTime\": " << markRootsCPUSecs_ << ",\n"
+     << "\t\t\t\"fullMarkTransitiveCPUTime\": " << markTransitiveCPUSecs_
+     << ",\n"
+     << "\t\t\t\"fullSweepCPUTime\": " << sweepCPUSecs_ << ",\n"
+     << "\t\t\t\"fullUpdateRefsCPUTime\": " << updateReferencesCPUSecs_
+     << ",\n"
+     << "\t\t\t\"fullCompactCPUTime\": " << compactCPUSecs_ << ",\n"
      << "\t\t\t\"fullSurvivalPct\": " << fullSurvivalPct;
 
   if (trailingComma) {
@@ -5,71 +5,1306 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include "hermes/VM/HadesGC.h"
+#include "hermes/VM/GC.h"
+
+#include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/FillerCell.h"
+#include "hermes/VM/GCBase-inline.h"
+#include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/JSWeakMapImpl.h"
+#include "hermes/VM/SlotAcceptorDefault.h"
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <chrono>
+
+#define DEBUG_TYPE "gc"
 
 namespace hermes {
 namespace vm {
 
+namespace {
+
+/// The smallest free region that can be put on a freelist.
+constexpr uint32_t kMinFreelistCellSize = heapAlignSize(sizeof(FreelistCell));
+
+/// The number of cells the background thread marks before yielding the lock.
+constexpr size_t kMarkChunkCells = 1024;
+
+} // namespace
+
+const uint32_t HadesGC::kMinOldGenAllocSize = heapAlignSize(sizeof(FillerCell));
+
+/// Marks old gen cells, and records the state of an old gen marking:
+/// the worklist, the reachable WeakMaps, the cells with weak references, and
+/// the marked symbols.
+///
+/// When \c concurrent_ is true the mutator may be running, so every pointer
+/// read from a cell may be stale or half-written.  Such pointers are only
+/// followed if they point exactly at the start of an old gen cell.
+struct HadesGC::MarkAcceptor final : public SlotAcceptorDefault {
+  /// Cells that are marked, but whose fields have not been scanned.
+  std::vector<GCCell *> worklist_;
+
+  /// The WeakMap objects that have been discovered to be reachable.
+  std::vector<JSWeakMap *> reachableWeakMaps_;
+
+  /// Marked cells that have weak references, which will be marked in the
+  /// final pause.
+  std::vector<GCCell *> weakCells_;
+
+  /// markedSymbols_ represents which symbols have been proven live so far in
+  /// a collection. Symbols allocated after the collection started are beyond
+  /// the end, and are live.
+  std::vector<bool> markedSymbols_;
+
+  /// Whether the mutator may be running concurrently.
+  bool concurrent_{false};
+
+  /// The number of bytes in cells scanned by this marking.
+  uint64_t markedBytes_{0};
+
+  MarkAcceptor(GC &gc) : SlotAcceptorDefault(gc) {}
+
+  using SlotAcceptorDefault::accept;
+
+  void accept(void *&ptr) override {
+    // Only read the slot once: the mutator may be writing it.
+    acceptCell(static_cast<GCCell *>(ptr));
+  }
+
+  void accept(HermesValue &hv) override {
+    const HermesValue val = HermesValue::fromRaw(hv.getRaw());
+    if (val.isPointer()) {
+      acceptCell(static_cast<GCCell *>(val.getPointer()));
+    } else if (val.isSymbol()) {
+      accept(val.getSymbol());
+    }
+  }
+
+  void accept(SymbolID sym) override {
+    if (sym.isInvalid()) {
+      return;
+    }
+    // Symbols past the end were created after marking began, and are live.
+    // When running concurrently, a garbage value may also be out of range.
+    if (sym.unsafeGetIndex() < markedSymbols_.size()) {
+      markedSymbols_[sym.unsafeGetIndex()] = true;
+    }
+  }
+
+  /// Mark \p cell if it is an old gen cell, and queue it for scanning.
+  void acceptCell(GCCell *cell) {
+    if (!cell || gc.inYoungGen(cell)) {
+      // Young gen cells are treated as roots instead.
+      return;
+    }
+    if (concurrent_ ? !gc.isOldGenCellStart(cell) : !gc.inOldGen(cell)) {
+      return;
+    }
+    if (AlignedHeapSegment::getCellMarkBit(cell)) {
+      return;
+    }
+    AlignedHeapSegment::setCellMarkBit(cell);
+    if (cell->getKind() == CellKind::WeakMapKind) {
+      reachableWeakMaps_.push_back(vmcast<JSWeakMap>(cell));
+    } else {
+      worklist_.push_back(cell);
+    }
+  }
+
+  /// Forget everything about the current marking.
+  void reset() {
+    worklist_.clear();
+    reachableWeakMaps_.clear();
+    weakCells_.clear();
+    markedSymbols_.clear();
+    markedBytes_ = 0;
+  }
+};
+
+/// Evacuates the young gen into the old gen.  While the old gen is being
+/// marked, cells that were promoted are black, so their old gen referents are
+/// greyed as they are scanned.
+struct HadesGC::EvacAcceptor final : public SlotAcceptorDefault {
+  /// Promoted cells that have not yet been scanned.
+  std::vector<GCCell *> promoted_;
+
+  /// Whether to grey old gen cells that are reached.
+  bool greyOldGen_{false};
+
+  /// The number of bytes promoted.
+  uint64_t promotedBytes_{0};
+
+  EvacAcceptor(GC &gc) : SlotAcceptorDefault(gc) {}
+
+  using SlotAcceptorDefault::accept;
+
+  void accept(void *&ptr) override {
+    GCCell *cell = static_cast<GCCell *>(ptr);
+    if (!cell) {
+      return;
+    }
+    if (gc.inYoungGen(cell)) {
+      ptr = cell->hasMarkedForwardingPointer()
+          ? cell->getMarkedForwardingPointer()
+          : evacuate(cell);
+    } else if (greyOldGen_) {
+      gc.oldGenMarker_->acceptCell(cell);
+    }
+  }
+
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      void *ptr = hv.getPointer();
+      accept(ptr);
+      hv.setInGC(hv.updatePointer(ptr), &gc);
+    } else if (hv.isSymbol()) {
+      accept(hv.getSymbol());
+    }
+  }
+
+  void accept(SymbolID sym) override {
+    if (greyOldGen_) {
+      gc.oldGenMarker_->accept(sym);
+    }
+  }
+
+  /// Copy \p cell into the old gen and leave a forwarding pointer behind.
+  /// \return the new location.
+  GCCell *evacuate(GCCell *cell) {
+    const uint32_t size = cell->getAllocatedSize();
+    GCCell *newCell = gc.oldGenAlloc(size);
+    if (!newCell) {
+      gc.oom(make_error_code(OOMError::MaxHeapReached));
+    }
+    std::memcpy(newCell, cell, size);
+    cell->setMarkedForwardingPointer(newCell);
+    promoted_.push_back(newCell);
+    promotedBytes_ += size;
+    if (gc.idTracker_.isTrackingIDs()) {
+      gc.idTracker_.moveObject(cell, newCell);
+    }
+    if (gc.allocationLocationTracker_.isEnabled()) {
+      gc.allocationLocationTracker_.moveAlloc(cell, newCell);
+    }
+    return newCell;
+  }
+};
+
+/// Used at the end of old gen marking: marks the weak ref slots of reachable
+/// owners, and clears weak roots to dead old gen cells.
+struct HadesGC::WeakSlotMarkAcceptor final : public WeakRootAcceptorDefault {
+  HadesGC &gc;
+
+  WeakSlotMarkAcceptor(HadesGC &gc) : WeakRootAcceptorDefault(gc), gc(gc) {}
+
+  using WeakRootAcceptorDefault::acceptWeak;
+
+  void accept(WeakRefBase &wr) override {
+    WeakRefSlot *slot = wr.unsafeGetSlot();
+    // A slot may be shared by several owners.
+    if (slot->state() == WeakSlotState::Unmarked) {
+      slot->mark();
+    }
+  }
+
+  void acceptWeak(void *&ptr) override {
+    GCCell *cell = static_cast<GCCell *>(ptr);
+    if (cell && gc.inOldGen(cell) &&
+        !AlignedHeapSegment::getCellMarkBit(cell)) {
+      ptr = nullptr;
+    }
+  }
+};
+
+/// Used at the end of a young gen collection to update weak roots to
+/// evacuated cells, and clear the ones to dead cells.
+struct HadesGC::YoungGenWeakRootAcceptor final
+    : public WeakRootAcceptorDefault {
+  HadesGC &gc;
+
+  YoungGenWeakRootAcceptor(HadesGC &gc)
+      : WeakRootAcceptorDefault(gc), gc(gc) {}
+
+  using WeakRootAcceptorDefault::acceptWeak;
+
+  void accept(WeakRefBase &wr) override {
+    // Weak ref slots are updated separately.
+  }
+
+  void acceptWeak(void *&ptr) override {
+    GCCell *cell = static_cast<GCCell *>(ptr);
+    if (cell && gc.inYoungGen(cell)) {
+      ptr = cell->hasMarkedForwardingPointer()
+          ? cell->getMarkedForwardingPointer()
+          : nullptr;
+    }
+  }
+};
+
+HadesGC::HeapSegment::HeapSegment(AlignedStorage &&storage)
+    : storage_(std::move(storage)) {
+  new (storage_.lowLim()) AlignedHeapSegment::Contents();
+}
+
 HadesGC::HadesGC(
     MetadataTable metaTable,
     GCCallbacks *gcCallbacks,
     PointerBase *pointerBase,
     const GCConfig &gcConfig,
     std::shared_ptr<CrashManager> crashMgr,
-    std::shared_ptr<StorageProvider>)
+    std::shared_ptr<StorageProvider> provider)
     : GCBase(
           metaTable,
           gcCallbacks,
           pointerBase,
           gcConfig,
-          std::move(crashMgr)) {}
+          std::move(crashMgr)),
+      maxHeapSize_(gcConfig.getMaxHeapSize()),
+      occupancyTarget_(gcConfig.getOccupancyTarget()),
+      provider_(std::move(provider)),
+      ogThreshold_(std::max<uint64_t>(
+          gcConfig.getInitHeapSize(),
+          AlignedHeapSegment::maxSize())),
+      oldGenMarker_(new MarkAcceptor(*this)) {
+  auto result = AlignedStorage::create(provider_.get(), "hermes-younggen");
+  if (!result) {
+    oom(result.getError());
+  }
+  youngGen_ = std::move(result.get());
+  ygLevel_ = youngGen_.lowLim();
+  ygEnd_ = youngGen_.hiLim();
+#ifndef NDEBUG
+  std::fill(ygLevel_, ygEnd_, kInvalidHeapValue);
+#endif
+  // Segments are accessed by reference while new ones are added, so make sure
+  // the vector never reallocates.
+  oldGen_.reserve(maxOldGenSegments());
+  backgroundThread_ = std::thread(&HadesGC::backgroundThreadLoop, this);
+}
+
+HadesGC::~HadesGC() {
+  {
+    std::lock_guard<std::mutex> lk{gcMutex_};
+    shutdown_ = true;
+  }
+  bgCond_.notify_all();
+  backgroundThread_.join();
+}
+
+size_t HadesGC::maxOldGenSegments() const {
+  // The heap always has room for the young gen and one old gen segment, even
+  // if the configured limit is smaller.
+  const size_t segSize = AlignedStorage::size();
+  return std::max<size_t>(
+      1, maxHeapSize_ > segSize ? (maxHeapSize_ - segSize) / segSize : 0);
+}
+
+bool HadesGC::addSegment() {
+  if (oldGen_.size() >= maxOldGenSegments()) {
+    return false;
+  }
+  auto result = AlignedStorage::create(provider_.get(), "hermes-oldgen");
+  if (!result) {
+    return false;
+  }
+  const void *lowLim = result->lowLim();
+  oldGen_.emplace_back(std::move(result.get()));
+  oldGenSegmentStarts_.insert(lowLim);
+  for (auto &segs : bucketSegments_) {
+    segs.resize(oldGen_.size());
+  }
+  const size_t idx = oldGen_.size() - 1;
+  HeapSegment &seg = oldGen_[idx];
+  addToFreelist(idx, seg.start(), seg.end());
+  return true;
+}
+
+/* static */ unsigned HadesGC::getFreelistBucket(uint32_t size) {
+  assert(isSizeHeapAligned(size) && "Size must be heap aligned");
+  if (size < (1u << kLogMinLargeFreelistSize)) {
+    return size >> LogHeapAlign;
+  }
+  const unsigned bucket = kNumSmallFreelistBuckets +
+      llvm::Log2_32(size) - kLogMinLargeFreelistSize;
+  assert(bucket < kNumFreelistBuckets && "Size too large for a segment");
+  return bucket;
+}
+
+/* static */ void HadesGC::updateCardBoundaries(char *start, char *end) {
+  CardTable *cardTable = AlignedHeapSegment::cardTableCovering(start);
+  CardTable::Boundary boundary = cardTable->nextBoundary(start);
+  if (boundary.address() < end) {
+    cardTable->updateBoundaries(&boundary, start, end);
+  }
+}
+
+void HadesGC::pushFreelistCell(
+    size_t segmentIdx,
+    unsigned bucket,
+    FreelistCell *cell) {
+  FreelistCell *&head = oldGen_[segmentIdx].freelistHeads[bucket];
+  cell->next_ = head;
+  head = cell;
+  bucketSegments_[bucket].set(segmentIdx);
+  nonEmptyBuckets_.set(bucket);
+}
+
+void HadesGC::clearFreelists(size_t segmentIdx) {
+  HeapSegment &seg = oldGen_[segmentIdx];
+  for (unsigned bucket = 0; bucket < kNumFreelistBuckets; ++bucket) {
+    if (!seg.freelistHeads[bucket]) {
+      continue;
+    }
+    seg.freelistHeads[bucket] = nullptr;
+    bucketSegments_[bucket].reset(segmentIdx);
+    if (bucketSegments_[bucket].none()) {
+      nonEmptyBuckets_.reset(bucket);
+    }
+  }
+}
+
+void HadesGC::addToFreelist(size_t segmentIdx, char *start, char *end) {
+  const uint32_t size = end - start;
+  if (size < sizeof(FillerCell)) {
+    // A single dead cell smaller than a FillerCell.  Its header still
+    // describes it, so leave it in place until a neighbour dies.
+    ogAllocatedBytes_ += size;
+    return;
+  }
+  if (size >= kMinFreelistCellSize) {
+    auto *cell = new (start) FreelistCell(this, size, nullptr);
+    pushFreelistCell(segmentIdx, getFreelistBucket(size), cell);
+#ifndef NDEBUG
+    std::fill(start + sizeof(FreelistCell), end, kInvalidHeapValue);
+#endif
+  } else {
+    // Too small to be reused: it stays allocated until a neighbour dies.
+    new (start) FillerCell(this, size);
+    ogAllocatedBytes_ += size;
+  }
+  updateCardBoundaries(start, end);
+}
+
+GCCell *HadesGC::oldGenFreelistAlloc(uint32_t sz) {
+  const unsigned firstBucket = getFreelistBucket(sz);
+  assert(firstBucket > 0 && "Allocation too small");
+  for (int bucket = nonEmptyBuckets_.find_next(firstBucket - 1); bucket != -1;
+       bucket = nonEmptyBuckets_.find_next(bucket)) {
+    llvm::BitVector &segs = bucketSegments_[bucket];
+    for (int segIdx = segs.find_first(); segIdx != -1;
+         segIdx = segs.find_next(segIdx)) {
+      FreelistCell **prevLoc = &oldGen_[segIdx].freelistHeads[bucket];
+      for (FreelistCell *cell = *prevLoc; cell;
+           prevLoc = &cell->next_, cell = *prevLoc) {
+        const uint32_t cellSize = cell->getAllocatedSize();
+        // Either use the whole cell, or leave enough to stay on a freelist.
+        if (cellSize != sz && cellSize < sz + kMinFreelistCellSize) {
+          continue;
+        }
+        *prevLoc = cell->next_;
+        if (!oldGen_[segIdx].freelistHeads[bucket]) {
+          segs.reset(segIdx);
+          if (segs.none()) {
+            nonEmptyBuckets_.reset(bucket);
+          }
+        }
+        char *res = reinterpret_cast<char *>(cell) + cellSize - sz;
+        if (cellSize != sz) {
+          // Carve from the end, so the remainder keeps its card boundaries.
+          cell->setSize(cellSize - sz);
+          pushFreelistCell(segIdx, getFreelistBucket(cellSize - sz), cell);
+        }
+        // Keep the heap parseable until the caller constructs the real cell.
+        // Only evacuation allocates cells too small for a FillerCell, and it
+        // copies them in before the lock is released (see allocInOldGen).
+        if (sz >= sizeof(FillerCell)) {
+          new (res) FillerCell(this, sz);
+        }
+        updateCardBoundaries(res, res + sz);
+        return reinterpret_cast<GCCell *>(res);
+      }
+    }
+  }
+  return nullptr;
+}
+
+GCCell *HadesGC::oldGenAlloc(uint32_t sz) {
+  assert(isSizeHeapAligned(sz) && "Size must be heap aligned");
+  assert(sz <= maxAllocationSize() && "Allocation too large");
+  GCCell *res = oldGenFreelistAlloc(sz);
+  if (!res && addSegment()) {
+    res = oldGenFreelistAlloc(sz);
+    assert(res && "A new segment must fit any allocation");
+  }
+  if (!res) {
+    return nullptr;
+  }
+  ogAllocatedBytes_ += sz;
+  if (phase_ != Phase::None) {
+    // Allocate black: the cell must survive this collection, and must not be
+    // swept.
+    AlignedHeapSegment::setCellMarkBit(res);
+  }
+  return res;
+}
+
+void *HadesGC::allocSlow(uint32_t sz) {
+  std::unique_lock<std::mutex> lk{gcMutex_};
+  if (sz >= kLargeAllocThreshold) {
+    lk.unlock();
+    return allocInOldGen(sz);
+  }
+  youngGenCollection();
+  assert(
+      static_cast<size_t>(ygEnd_ - ygLevel_) >= sz &&
+      "Young gen must be empty after a collection");
+  void *res = ygLevel_;
+  ygLevel_ += sz;
+  return res;
+}
+
+void *HadesGC::allocInOldGen(uint32_t sz) {
+  assert(
+      sz >= kMinOldGenAllocSize &&
+      "The cell can't be kept parseable until the caller constructs it");
+  std::lock_guard<std::mutex> lk{gcMutex_};
+  if (phase_ == Phase::None &&
+      ogAllocatedBytes_ + externalBytes_ + sz >= ogThreshold_) {
+    // Start before allocating, so that the new cell is allocated black.
+    startOldGenCollection();
+  }
+  GCCell *res = oldGenAlloc(sz);
+  if (!res) {
+    // Free up as much of the old gen as possible and try again.
+    youngGenCollection();
+    finishOldGenCollection();
+    startOldGenCollection();
+    finishOldGenCollection();
+    recordOldGenStats();
+    res = oldGenAlloc(sz);
+    if (!res) {
+      oom(make_error_code(OOMError::MaxHeapReached));
+    }
+  }
+  if (phase_ == Phase::Mark) {
+    rescanCells_.push_back(res);
+  }
+  return res;
+}
+
+bool HadesGC::isOldGenCellStart(const void *ptr) const {
+  if (reinterpret_cast<uintptr_t>(ptr) & (HeapAlign - 1)) {
+    return false;
+  }
+  if (!inOldGen(ptr)) {
+    return false;
+  }
+  const char *target = static_cast<const char *>(ptr);
+  const char *segStart = static_cast<const char *>(AlignedStorage::start(ptr)) +
+      AlignedHeapSegment::offsetOfAllocRegion;
+  if (target < segStart) {
+    return false;
+  }
+  const CardTable *cardTable = AlignedHeapSegment::cardTableCovering(ptr);
+  const char *cur = reinterpret_cast<const char *>(
+      cardTable->firstObjForCard(cardTable->addressToIndex(ptr)));
+  while (cur < target) {
+    cur += reinterpret_cast<const GCCell *>(cur)->getAllocatedSize();
+  }
+  return cur == target &&
+      !FreelistCell::classof(reinterpret_cast<const GCCell *>(cur));
+}
+
+void HadesGC::forYoungGenObjs(const std::function<void(GCCell *)> &callback) {
+  for (char *ptr = youngGen_.lowLim(); ptr < ygLevel_;) {
+    GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+    // Read the size first, in case the callback changes the cell.
+    ptr += cell->getAllocatedSize();
+    callback(cell);
+  }
+}
+
+void HadesGC::ensureOldGenSpace(uint64_t bytes) {
+  const auto freeBytes = [this]() -> uint64_t {
+    const uint64_t capacity = oldGen_.size() * AlignedHeapSegment::maxSize();
+    return capacity > ogAllocatedBytes_ ? capacity - ogAllocatedBytes_ : 0;
+  };
+  while (freeBytes() < bytes && addSegment()) {
+  }
+  if (freeBytes() >= bytes) {
+    return;
+  }
+  // Can't grow: first finish any collection in progress, since it may free
+  // enough, then do a whole collection of the old gen.
+  if (phase_ != Phase::None) {
+    finishOldGenCollection();
+    recordOldGenStats();
+    if (freeBytes() >= bytes) {
+      return;
+    }
+  }
+  startOldGenCollection();
+  finishOldGenCollection();
+  recordOldGenStats();
+  // If there still is not enough, evacuation may fail with an OOM.
+}
+
+void HadesGC::youngGenCollection() {
+  using std::chrono::steady_clock;
+  const auto wallStart = steady_clock::now();
+  const auto cpuStart = oscompat::thread_cpu_time();
+  const uint64_t ygUsed = ygLevel_ - youngGen_.lowLim();
+  const uint64_t usedBefore = ygUsed + ogAllocatedBytes_;
+  ensureOldGenSpace(ygUsed);
+  uint64_t promotedBytes;
+  {
+    GCCycle cycle{this, gcCallbacks_, "Young Gen collection"};
+    const bool marking = phase_ == Phase::Mark;
+    if (marking) {
+      flushBarrierBuffer();
+    }
+    EvacAcceptor acceptor(*this);
+    DroppingAcceptor<EvacAcceptor> nameAcceptor{acceptor};
+    markRoots(nameAcceptor, /*markLongLived*/ false);
 
-HadesGC::~HadesGC() {}
+    // Find the old-to-young pointers through the dirty cards.  Segments
+    // added during this collection only hold promoted cells, which are
+    // scanned below.
+    SlotVisitor<EvacAcceptor> visitor{acceptor};
+    const size_t numSegments = oldGen_.size();
+    for (size_t i = 0; i < numSegments; ++i) {
+      HeapSegment &seg = oldGen_[i];
+      CardTable *cardTable = AlignedHeapSegment::cardTableCovering(seg.start());
+      const size_t endIndex = cardTable->addressToIndex(seg.end());
+      size_t from = cardTable->addressToIndex(seg.start());
+      while (OptValue<size_t> idx =
+                 cardTable->findNextDirtyCard(from, endIndex)) {
+        const char *cardStart = cardTable->indexToAddress(*idx);
+        const char *cardEnd = cardStart + CardTable::kCardSize;
+        for (GCCell *cell = cardTable->firstObjForCard(*idx);
+             reinterpret_cast<char *>(cell) < cardEnd;
+             cell = cell->nextCell()) {
+          if (FreelistCell::classof(cell)) {
+            continue;
+          }
+          // During a sweep, unmarked cells are dead and may have been
+          // finalized already.
+          if (phase_ == Phase::Sweep &&
+              !AlignedHeapSegment::getCellMarkBit(cell)) {
+            continue;
+          }
+          GCBase::markCellWithinRange(
+              visitor, cell, cell->getVT(), this, cardStart, cardEnd);
+        }
+        from = *idx + 1;
+      }
+    }
 
-// TODO: Fill these out
-void HadesGC::getHeapInfoWithMallocSize(HeapInfo &info) {}
-void HadesGC::getCrashManagerHeapInfo(CrashManager::HeapInformation &info) {}
-void HadesGC::createSnapshot(llvm::raw_ostream &os) {}
+    // Scan the promoted cells until there are no more.  If the old gen is
+    // being marked they were allocated black, so grey what they point to.
+    acceptor.greyOldGen_ = marking;
+    while (!acceptor.promoted_.empty()) {
+      GCCell *cell = acceptor.promoted_.back();
+      acceptor.promoted_.pop_back();
+      GCBase::markCell(cell, this, acceptor);
+      if (marking && cell->getVT()->markWeak_) {
+        oldGenMarker_->weakCells_.push_back(cell);
+      }
+    }
+    acceptor.greyOldGen_ = false;
+    promotedBytes = acceptor.promotedBytes_;
 
-void HadesGC::collect() {}
+    // Update weak references into the young gen.
+    for (auto &slot : weakSlots_) {
+      if (slot.state() == WeakSlotState::Free || !slot.hasPointer()) {
+        continue;
+      }
+      auto *cell = static_cast<GCCell *>(slot.getPointer());
+      if (!inYoungGen(cell)) {
+        continue;
+      }
+      if (cell->hasMarkedForwardingPointer()) {
+        slot.setPointer(cell->getMarkedForwardingPointer());
+      } else {
+        slot.clearPointer();
+      }
+    }
+    YoungGenWeakRootAcceptor weakAcceptor(*this);
+    markWeakRoots(weakAcceptor);
 
-void HadesGC::finalizeAll() {}
+    // Tell the trackers about cells that died, before they are finalized.
+    if (idTracker_.isTrackingIDs() || allocationLocationTracker_.isEnabled()) {
+      for (char *ptr = youngGen_.lowLim(); ptr < ygLevel_;) {
+        GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+        if (cell->hasMarkedForwardingPointer()) {
+          ptr += cell->getMarkedForwardingPointer()->getAllocatedSize();
+          continue;
+        }
+        ptr += cell->getAllocatedSize();
+        if (idTracker_.isTrackingIDs()) {
+          idTracker_.untrackObject(cell);
+        }
+        if (allocationLocationTracker_.isEnabled()) {
+          allocationLocationTracker_.freeAlloc(cell);
+        }
+      }
+    }
 
-// TODO: Inline perf check for all write barrier code.
-void HadesGC::writeBarrier(void *loc, HermesValue value) {}
-void HadesGC::writeBarrier(void *loc, void *value) {}
-void HadesGC::writeBarrierRange(GCHermesValue *start, uint32_t numHVs) {}
+    for (GCCell *cell : youngGenFinalizables_) {
+      if (cell->hasMarkedForwardingPointer()) {
+        oldGenFinalizables_.push_back(cell->getMarkedForwardingPointer());
+      } else {
+        cell->getVT()->finalize(cell, this);
+        ++numFinalizedObjects_;
+      }
+    }
+    youngGenFinalizables_.clear();
+
+    // There are no young gen cells left to point to.
+    for (size_t i = 0; i < numSegments; ++i) {
+      AlignedHeapSegment::cardTableCovering(oldGen_[i].start())->clear();
+    }
+#ifndef NDEBUG
+    std::fill(youngGen_.lowLim(), ygLevel_, kInvalidHeapValue);
+#endif
+    ygLevel_ = youngGen_.lowLim();
+  }
+
+  const double wallSecs =
+      GCBase::clockDiffSeconds(wallStart, steady_clock::now());
+  const double cpuSecs =
+      GCBase::clockDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+  const uint64_t usedAfter = ogAllocatedBytes_;
+  recordGCStats(
+      wallSecs,
+      cpuSecs,
+      AlignedStorage::size(),
+      ygUsed,
+      promotedBytes,
+      &youngGenCumStats_);
+  recordGCStats(
+      wallSecs,
+      cpuSecs,
+      AlignedStorage::size() * (1 + oldGen_.size()),
+      usedBefore,
+      usedAfter);
+  updateOldGenCollection();
+}
+
+void HadesGC::updateOldGenCollection() {
+  recordOldGenStats();
+  switch (phase_) {
+    case Phase::None:
+      if (ogAllocatedBytes_ + externalBytes_ >= ogThreshold_) {
+        startOldGenCollection();
+      }
+      break;
+    case Phase::Mark:
+      if (!oldGenMarker_->worklist_.empty()) {
+        // The young gen collection found more to mark.
+        markingDone_ = false;
+        bgCond_.notify_one();
+      } else if (markingDone_) {
+        completeMarking();
+      }
+      break;
+    case Phase::Sweep:
+      break;
+  }
+}
+
+void HadesGC::barrierBufferSlow(HermesValue value) {
+  if (inGC_) {
+    // Stores made by the collector itself need not be recorded.
+    return;
+  }
+  if (value.isPointer()) {
+    void *ptr = value.getPointer();
+    if (!ptr || inYoungGen(ptr)) {
+      return;
+    }
+  } else if (!value.isSymbol()) {
+    return;
+  }
+  barrierBuffer_.push_back(value);
+  if (LLVM_UNLIKELY(barrierBuffer_.size() >= kBarrierBufferLimit)) {
+    std::lock_guard<std::mutex> lk{gcMutex_};
+    flushBarrierBuffer();
+  }
+}
+
+void HadesGC::flushBarrierBuffer() {
+  if (phase_ != Phase::Mark) {
+    barrierBuffer_.clear();
+    return;
+  }
+  MarkAcceptor &marker = *oldGenMarker_;
+  // The recorded values were valid when they were written, and no old gen
+  // cell can be freed before marking is complete.
+  const bool concurrent = marker.concurrent_;
+  marker.concurrent_ = false;
+  for (HermesValue value : barrierBuffer_) {
+    if (value.isPointer()) {
+      marker.acceptCell(static_cast<GCCell *>(value.getPointer()));
+    } else {
+      marker.accept(value.getSymbol());
+    }
+  }
+  marker.concurrent_ = concurrent;
+  barrierBuffer_.clear();
+  if (!marker.worklist_.empty()) {
+    markingDone_ = false;
+    bgCond_.notify_one();
+  }
+}
+
+void HadesGC::startOldGenCollection() {
+  assert(phase_ == Phase::None && "Old gen collection already in progress");
+  using std::chrono::steady_clock;
+  ogCycleStart_ = steady_clock::now();
+  const auto cpuStart = oscompat::thread_cpu_time();
+  ogUsedBefore_ = ogAllocatedBytes_;
+  {
+    GCCycle cycle{this, gcCallbacks_, "Old Gen collection (start)"};
+    inOldGenCollection_ = true;
+    for (HeapSegment &seg : oldGen_) {
+      AlignedHeapSegment::markBitArrayCovering(seg.start())->clear();
+    }
+    MarkAcceptor &marker = *oldGenMarker_;
+    marker.reset();
+    marker.markedSymbols_.resize(gcCallbacks_->getSymbolsEnd(), false);
+    marker.concurrent_ = false;
+    phase_ = Phase::Mark;
+    markingDone_ = false;
+    rescanCells_.clear();
+
+    DroppingAcceptor<MarkAcceptor> nameAcceptor{marker};
+    markRoots(nameAcceptor, /*markLongLived*/ true);
+    // The young gen is not marked, it is treated as a root.
+    forYoungGenObjs(
+        [this, &marker](GCCell *cell) { GCBase::markCell(cell, this, marker); });
+
+    marker.concurrent_ = true;
+    ogMarkingBarriers_ = true;
+    inOldGenCollection_ = false;
+  }
+  const double pauseSecs =
+      GCBase::clockDiffSeconds(ogCycleStart_, steady_clock::now());
+  ogPauseSecs_ += pauseSecs;
+  ogCycleCPUSecs_ =
+      GCBase::clockDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+  bgCond_.notify_one();
+}
+
+bool HadesGC::drainMarkWorklist(size_t maxCells) {
+  MarkAcceptor &marker = *oldGenMarker_;
+  for (size_t i = 0; i < maxCells && !marker.worklist_.empty(); ++i) {
+    GCCell *cell = marker.worklist_.back();
+    marker.worklist_.pop_back();
+    assert(
+        AlignedHeapSegment::getCellMarkBit(cell) &&
+        "Cell on the worklist isn't marked");
+    const VTable *vt = cell->getVT();
+    GCBase::markCell(cell, vt, this, marker);
+    marker.markedBytes_ += cell->getAllocatedSize(vt);
+    if (vt->markWeak_) {
+      marker.weakCells_.push_back(cell);
+    }
+  }
+  return marker.worklist_.empty();
+}
+
+void HadesGC::completeMarking() {
+  assert(phase_ == Phase::Mark && "Old gen is not being marked");
+  using std::chrono::steady_clock;
+  const auto wallStart = steady_clock::now();
+  const auto cpuStart = oscompat::thread_cpu_time();
+  bool sweepNow;
+  {
+    GCCycle cycle{this, gcCallbacks_, "Old Gen collection (complete marking)"};
+    inOldGenCollection_ = true;
+    MarkAcceptor &marker = *oldGenMarker_;
+    marker.concurrent_ = false;
+    flushBarrierBuffer();
+    ogMarkingBarriers_ = false;
+
+    // Anything the mutator could still reach without a barrier is in the
+    // roots, the young gen, or in old gen cells allocated during marking.
+    DroppingAcceptor<MarkAcceptor> nameAcceptor{marker};
+    markRoots(nameAcceptor, /*markLongLived*/ true);
+    forYoungGenObjs(
+        [this, &marker](GCCell *cell) { GCBase::markCell(cell, this, marker); });
+    for (GCCell *cell : rescanCells_) {
+      GCBase::markCell(cell, this, marker);
+      if (cell->getVT()->markWeak_) {
+        marker.weakCells_.push_back(cell);
+      }
+    }
+    rescanCells_.clear();
+    drainMarkWorklist(SIZE_MAX);
+
+    const auto objIsMarked = [this](GCCell *cell) {
+      return !inOldGen(cell) || AlignedHeapSegment::getCellMarkBit(cell);
+    };
+    GCBase::completeWeakMapMarking(
+        this,
+        marker,
+        marker.reachableWeakMaps_,
+        objIsMarked,
+        /*markFromVal*/
+        [this, &marker, &objIsMarked](GCCell *valCell, HermesValue &valRef) {
+          if (objIsMarked(valCell)) {
+            return false;
+          }
+          marker.accept(valRef);
+          drainMarkWorklist(SIZE_MAX);
+          return true;
+        },
+        /*drainMarkStack*/
+        [this](MarkAcceptor &) { drainMarkWorklist(SIZE_MAX); },
+        /*checkMarkStackOverflow (HadesGC does not have mark stack overflow)*/
+        []() { return false; });
+
+    // Mark the weak ref slots that are reachable, and clear weak roots.
+    WeakSlotMarkAcceptor weakAcceptor(*this);
+    for (GCCell *cell : marker.weakCells_) {
+      cell->getVT()->markWeakIfExists(cell, weakAcceptor);
+    }
+    for (JSWeakMap *weakMap : marker.reachableWeakMaps_) {
+      GCCell *cell = weakMap;
+      cell->getVT()->markWeakIfExists(cell, weakAcceptor);
+    }
+    forYoungGenObjs([&weakAcceptor](GCCell *cell) {
+      cell->getVT()->markWeakIfExists(cell, weakAcceptor);
+    });
+    markWeakRoots(weakAcceptor);
+
+    for (auto &slot : weakSlots_) {
+      switch (slot.state()) {
+        case WeakSlotState::Free:
+          break;
+        case WeakSlotState::Unmarked:
+          slot.free(firstFreeWeak_);
+          firstFreeWeak_ = &slot;
+          break;
+        case WeakSlotState::Marked:
+          if (slot.hasPointer()) {
+            auto *cell = static_cast<GCCell *>(slot.getPointer());
+            if (!objIsMarked(cell)) {
+              slot.clearPointer();
+            }
+          }
+          slot.unmark();
+          break;
+      }
+    }
+
+    // Finalize the dead old gen cells.  Their memory is reclaimed by the
+    // sweep.
+    size_t numLive = 0;
+    for (GCCell *cell : oldGenFinalizables_) {
+      if (AlignedHeapSegment::getCellMarkBit(cell)) {
+        oldGenFinalizables_[numLive++] = cell;
+      } else {
+        cell->getVT()->finalize(cell, this);
+        ++numFinalizedObjects_;
+      }
+    }
+    oldGenFinalizables_.resize(numLive);
+
+    marker.markedSymbols_.resize(gcCallbacks_->getSymbolsEnd(), true);
+    gcCallbacks_->freeSymbols(marker.markedSymbols_);
+    if (idTracker_.isTrackingIDs()) {
+      idTracker_.untrackUnmarkedSymbols(marker.markedSymbols_);
+    }
+#ifndef NDEBUG
+    numReachableObjects_ = 0;
+    numCollectedObjects_ = 0;
+#endif
+    marker.reset();
+
+    phase_ = Phase::Sweep;
+    sweepIndex_ = 0;
+    // The trackers are not thread safe, so sweep right away if they need to
+    // be told about dead cells.
+    sweepNow =
+        idTracker_.isTrackingIDs() || allocationLocationTracker_.isEnabled();
+    if (sweepNow) {
+      while (sweepIndex_ < oldGen_.size()) {
+        sweepSegment(sweepIndex_++, /*updateTrackers*/ true);
+      }
+      finishSweep();
+    }
+    inOldGenCollection_ = false;
+  }
+  const double pauseSecs =
+      GCBase::clockDiffSeconds(wallStart, steady_clock::now());
+  ogPauseSecs_ += pauseSecs;
+  ogCycleCPUSecs_ +=
+      GCBase::clockDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+  if (!sweepNow) {
+    bgCond_.notify_one();
+  }
+}
+
+void HadesGC::sweepSegment(size_t segmentIdx, bool updateTrackers) {
+  clearFreelists(segmentIdx);
+  HeapSegment &seg = oldGen_[segmentIdx];
+  char *freeStart = nullptr;
+  uint64_t freedBytes = 0;
+  for (char *ptr = seg.start(); ptr < seg.end();) {
+    GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+    const uint32_t size = cell->getAllocatedSize();
+    const bool isFree = FreelistCell::classof(cell);
+    const bool isDead = !isFree && !AlignedHeapSegment::getCellMarkBit(cell);
+    if (isDead) {
+      freedBytes += size;
+      if (updateTrackers) {
+        if (idTracker_.isTrackingIDs()) {
+          idTracker_.untrackObject(cell);
+        }
+        if (allocationLocationTracker_.isEnabled()) {
+          allocationLocationTracker_.freeAlloc(cell);
+        }
+      }
+#ifndef NDEBUG
+      ++numCollectedObjects_;
+#endif
+    }
+#ifndef NDEBUG
+    if (!isFree && !isDead) {
+      ++numReachableObjects_;
+    }
+#endif
+    if (isFree || isDead) {
+      if (!freeStart) {
+        freeStart = ptr;
+      }
+    } else if (freeStart) {
+      addToFreelist(segmentIdx, freeStart, ptr);
+      freeStart = nullptr;
+    }
+    ptr += size;
+  }
+  if (freeStart) {
+    addToFreelist(segmentIdx, freeStart, seg.end());
+  }
+  assert(ogAllocatedBytes_ >= freedBytes && "Freed more than was allocated");
+  ogAllocatedBytes_ -= freedBytes;
+}
+
+void HadesGC::finishSweep() {
+  assert(phase_ == Phase::Sweep && "Old gen is not being swept");
+  phase_ = Phase::None;
+  ogCollectionCompleted_ = true;
+}
+
+void HadesGC::finishOldGenCollection() {
+  if (phase_ == Phase::Mark) {
+    drainMarkWorklist(SIZE_MAX);
+    completeMarking();
+  }
+  if (phase_ == Phase::Sweep) {
+    using std::chrono::steady_clock;
+    const auto wallStart = steady_clock::now();
+    const auto cpuStart = oscompat::thread_cpu_time();
+    while (sweepIndex_ < oldGen_.size()) {
+      sweepSegment(sweepIndex_++, /*updateTrackers*/ false);
+    }
+    finishSweep();
+    ogSweepSecs_ += GCBase::clockDiffSeconds(wallStart, steady_clock::now());
+    ogCycleCPUSecs_ +=
+        GCBase::clockDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+  }
+}
+
+void HadesGC::recordOldGenStats() {
+  if (!ogCollectionCompleted_) {
+    return;
+  }
+  ogCollectionCompleted_ = false;
+  const double wallSecs = GCBase::clockDiffSeconds(
+      ogCycleStart_, std::chrono::steady_clock::now());
+  const uint64_t liveBytes = ogAllocatedBytes_;
+  const gcheapsize_t heapSize = AlignedStorage::size() * (1 + oldGen_.size());
+  recordGCStats(
+      wallSecs,
+      ogCycleCPUSecs_,
+      heapSize,
+      ogUsedBefore_,
+      liveBytes,
+      &oldGenCumStats_);
+  recordGCStats(wallSecs, ogCycleCPUSecs_, heapSize, ogUsedBefore_, liveBytes);
+  checkTripwire(liveBytes + externalBytes_);
+  // Start the next collection once the old gen has grown enough that live
+  // data would take up occupancyTarget_ of it.
+  const uint64_t maxOldGenBytes =
+      maxOldGenSegments() * AlignedHeapSegment::maxSize();
+  ogThreshold_ = std::min<uint64_t>(
+      maxOldGenBytes,
+      std::max<uint64_t>(
+          AlignedHeapSegment::maxSize(),
+          (liveBytes + externalBytes_) / occupancyTarget_));
+}
+
+void HadesGC::backgroundThreadLoop() {
+  using std::chrono::steady_clock;
+  std::unique_lock<std::mutex> lk{gcMutex_};
+  while (true) {
+    bgCond_.wait(lk, [this]() { return shutdown_ || hasBackgroundWork(); });
+    if (shutdown_) {
+      return;
+    }
+    const auto wallStart = steady_clock::now();
+    const auto cpuStart = oscompat::thread_cpu_time();
+    if (phase_ == Phase::Mark) {
+      markingDone_ = drainMarkWorklist(kMarkChunkCells);
+      ogMarkSecs_ += GCBase::clockDiffSeconds(wallStart, steady_clock::now());
+    } else {
+      assert(phase_ == Phase::Sweep && "No background work to do");
+      if (sweepIndex_ < oldGen_.size()) {
+        sweepSegment(sweepIndex_++, /*updateTrackers*/ false);
+      } else {
+        finishSweep();
+        ++numConcurrentOGCollections_;
+      }
+      ogSweepSecs_ += GCBase::clockDiffSeconds(wallStart, steady_clock::now());
+    }
+    ogCycleCPUSecs_ +=
+        GCBase::clockDiffSeconds(cpuStart, oscompat::thread_cpu_time());
+    // Give the mutator a chance to take the lock between chunks of work.
+    lk.unlock();
+    std::this_thread::yield();
+    lk.lock();
+  }
+}
+
+void HadesGC::collect() {
+  assert(noAllocLevel_ == 0 && "no GC allowed right now");
+  std::lock_guard<std::mutex> lk{gcMutex_};
+  youngGenCollection();
+  finishOldGenCollection();
+  recordOldGenStats();
+  startOldGenCollection();
+  finishOldGenCollection();
+  recordOldGenStats();
+}
+
+void HadesGC::finalizeAll() {
+  std::lock_guard<std::mutex> lk{gcMutex_};
+  // Abandon any collection in progress.  Cells that were found dead have
+  // already been finalized and removed from oldGenFinalizables_.
+  phase_ = Phase::None;
+  ogMarkingBarriers_ = false;
+  markingDone_ = false;
+  oldGenMarker_->reset();
+  barrierBuffer_.clear();
+  rescanCells_.clear();
+  for (GCCell *cell : youngGenFinalizables_) {
+    cell->getVT()->finalize(cell, this);
+  }
+  youngGenFinalizables_.clear();
+  for (GCCell *cell : oldGenFinalizables_) {
+    cell->getVT()->finalize(cell, this);
+  }
+  oldGenFinalizables_.clear();
+}
+
+void HadesGC::writeBarrierRange(GCHermesValue *start, uint32_t numHVs) {
+  if (inYoungGen(start)) {
+    return;
+  }
+  AlignedHeapSegment::cardTableCovering(start)->dirtyCardsForAddressRange(
+      start, start + numHVs);
+  if (LLVM_UNLIKELY(ogMarkingBarriers_)) {
+    for (uint32_t i = 0; i < numHVs; ++i) {
+      barrierBufferSlow(start[i]);
+    }
+  }
+}
+
+void HadesGC::writeBarrierRangeFill(
+    GCHermesValue *start,
+    uint32_t numHVs,
+    HermesValue value) {
+  if (inYoungGen(start)) {
+    return;
+  }
+  if (LLVM_UNLIKELY(ogMarkingBarriers_)) {
+    barrierBufferSlow(value);
+  }
+  if (value.isPointer() && inYoungGen(value.getPointer())) {
+    AlignedHeapSegment::cardTableCovering(start)->dirtyCardsForAddressRange(
+        start, start + numHVs);
+  }
+}
+
+void HadesGC::creditExternalMemory(GCCell *, uint32_t size) {
+  externalBytes_ += size;
+}
+
+void HadesGC::debitExternalMemory(GCCell *, uint32_t size) {
+  assert(externalBytes_ >= size && "Debiting more than was credited");
+  externalBytes_ -= size;
+}
 
 bool HadesGC::canAllocExternalMemory(uint32_t size) {
-  return false;
+  return size <= maxHeapSize_;
 }
 
-void HadesGC::markSymbol(SymbolID symbolID) {}
+void HadesGC::markSymbol(SymbolID symbolID) {
+  assert(phase_ == Phase::Mark && "Old gen is not being marked");
+  oldGenMarker_->accept(symbolID);
+}
 
 WeakRefSlot *HadesGC::allocWeakSlot(HermesValue init) {
-  return nullptr;
+  if (firstFreeWeak_) {
+    WeakRefSlot *slot = firstFreeWeak_;
+    firstFreeWeak_ = slot->nextFree();
+    slot->reset(init);
+    return slot;
+  }
+  weakSlots_.push_back({init});
+  return &weakSlots_.back();
+}
+
+void HadesGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
+  std::lock_guard<std::mutex> lk{gcMutex_};
+  forYoungGenObjs(callback);
+  for (HeapSegment &seg : oldGen_) {
+    for (char *ptr = seg.start(); ptr < seg.end();) {
+      GCCell *cell = reinterpret_cast<GCCell *>(ptr);
+      ptr += cell->getAllocatedSize();
+      if (!FreelistCell::classof(cell)) {
+        callback(cell);
+      }
+    }
+  }
+}
+
+void HadesGC::getHeapInfo(HeapInfo &info) {
+  GCBase::getHeapInfo(info);
+  info.allocatedBytes = (ygLevel_ - youngGen_.lowLim()) + ogAllocatedBytes_;
+  info.heapSize = AlignedStorage::size() * (1 + oldGen_.size());
+  info.totalAllocatedBytes = totalAllocatedBytes_;
+  info.va = info.heapSize;
+  info.youngGenStats = youngGenCumStats_;
+  info.fullStats = oldGenCumStats_;
 }
 
-void HadesGC::forAllObjs(const std::function<void(GCCell *)> &callback) {}
+void HadesGC::getHeapInfoWithMallocSize(HeapInfo &info) {
+  getHeapInfo(info);
+  info.mallocSizeEstimate = 0;
+  forAllObjs([&info](GCCell *cell) {
+    info.mallocSizeEstimate += cell->getVT()->getMallocSize(cell);
+  });
+}
+
+void HadesGC::getCrashManagerHeapInfo(CrashManager::HeapInformation &info) {
+  HeapInfo heapInfo;
+  getHeapInfo(heapInfo);
+  info.size_ = heapInfo.heapSize;
+  info.used_ = heapInfo.allocatedBytes;
+}
+
+void HadesGC::createSnapshot(llvm::raw_ostream &os) {
+  hermes_fatal("No snapshots allowed with HadesGC");
+}
+
+void HadesGC::printStats(llvm::raw_ostream &os, bool trailingComma) {
+  if (!recordGcStats_) {
+    return;
+  }
+  GCBase::printStats(os, true);
+  os << "\t\"specific\": {\n"
+     << "\t\t\"collector\": \"hades\",\n"
+     << "\t\t\"stats\": {\n"
+     << "\t\t\t\"ygNumCollections\": " << youngGenCumStats_.numCollections
+     << ",\n"
+     << "\t\t\t\"ygTotalGCTime\": "
+     << formatSecs(youngGenCumStats_.gcWallTime.sum()).secs << ",\n"
+     << "\t\t\t\"ygMaxGCPause\": "
+     << formatSecs(youngGenCumStats_.gcWallTime.max()).secs << ",\n"
+     << "\t\t\t\"ogNumCollections\": " << oldGenCumStats_.numCollections
+     << ",\n"
+     << "\t\t\t\"ogNumConcurrentCollections\": "
+     << numConcurrentOGCollections_ << ",\n"
+     << "\t\t\t\"ogTotalPauseTime\": " << formatSecs(ogPauseSecs_).secs
+     << ",\n"
+     << "\t\t\t\"ogMarkTime\": " << formatSecs(ogMarkSecs_).secs << ",\n"
+     << "\t\t\t\"ogSweepTime\": " << formatSecs(ogSweepSecs_).secs << ",\n"
+     << "\t\t\t\"ogTotalGCCPUTime\": "
+     << formatSecs(oldGenCumStats_.gcCPUTime.sum()).secs << ",\n"
+     << "\t\t\t\"ogFinalSize\": "
+     << formatSize(oldGenCumStats_.finalHeapSize).bytes << "\n"
+     << "\t\t}\n"
+     << "\t},\n";
+  gcCallbacks_->printRuntimeGCStats(os);
+  if (trailingComma) {
+    os << ",";
+  }
+  os << "\n";
+}
+
+#ifdef HERMESVM_SERIALIZE
+void HadesGC::serializeWeakRefs(Serializer &s) {
+  hermes_fatal("serializeWeakRefs not implemented for current GC");
+}
+
+void HadesGC::deserializeWeakRefs(Deserializer &d) {
+  hermes_fatal("deserializeWeakRefs not implemented for current GC");
+}
+
+void HadesGC::serializeHeap(Serializer &s) {
+  hermes_fatal("serializeHeap not implemented for current GC");
+}
+
+void HadesGC::deserializeHeap(Deserializer &d) {
+  hermes_fatal("deserializeHeap not implemented for current GC");
+}
+
+void HadesGC::deserializeStart() {
+  hermes_fatal("Serialization/Deserialization not allowed with HadesGC");
+}
+
+void HadesGC::deserializeEnd() {
+  hermes_fatal("Serialization/Deserialization not allowed with HadesGC");
+}
+#endif
 
 #ifndef NDEBUG
 
 bool HadesGC::validPointer(const void *ptr) const {
-  return false;
+  return dbgContains(ptr) && static_cast<const GCCell *>(ptr)->isValid();
 }
 
 bool HadesGC::dbgContains(const void *ptr) const {
-  return false;
+  return inYoungGen(ptr) || inOldGen(ptr);
 }
 
 void HadesGC::trackReachable(CellKind kind, unsigned sz) {}
 
 size_t HadesGC::countUsedWeakRefs() const {
-  return 0;
+  size_t count = 0;
+  for (auto &slot : weakSlots_) {
+    if (slot.state() != WeakSlotState::Free) {
+      ++count;
+    }
+  }
+  return count;
 }
 
 bool HadesGC::isMostRecentFinalizableObj(const GCCell *cell) const {
-  return false;
+  if (inYoungGen(cell)) {
+    return isMostRecentCellInFinalizerVector(youngGenFinalizables_, cell);
+  }
+  return isMostRecentCellInFinalizerVector(oldGenFinalizables_, cell);
 }
 
 #endif
@@ -305,10 +305,12 @@ void OldGen::updateEffectiveEndForExternalMemory() {
   trueActiveSegment().setEffectiveEnd(clampedEnd.ptr);
 }
 
-void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
+std::vector<OldGen::YoungGenPointerRegion> OldGen::youngGenPointerRegions(
+    OldGen::Location originalLevel) {
+  std::vector<YoungGenPointerRegion> regions;
   if (used() == 0) {
     // Nothing to do if the old gen is empty.
-    return;
+    return regions;
   }
 
 #ifdef HERMES_SLOW_DEBUG
@@ -365,36 +367,6 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
   verifyCardTableBoundaries();
 #endif // HERMES_SLOW_DEBUG
 
-  struct OldGenObjEvacAcceptor final : public SlotAcceptorDefault {
-    using SlotAcceptorDefault::accept;
-    using SlotAcceptorDefault::SlotAcceptorDefault;
-
-    // NOTE: C++ does not allow templates on local classes, so duplicate the
-    // body of \c helper for ensureReferentCopied.
-    void helper(GCCell **slotAddr, void *slotContents) {
-      if (gc.youngGen_.contains(slotContents)) {
-        gc.youngGen_.ensureReferentCopied(slotAddr);
-      }
-    }
-    void helper(HermesValue *slotAddr, void *slotContents) {
-      if (gc.youngGen_.contains(slotContents)) {
-        gc.youngGen_.ensureReferentCopied(slotAddr);
-      }
-    }
-
-    void accept(void *&ptr) {
-      helper(reinterpret_cast<GCCell **>(&ptr), ptr);
-    }
-    void accept(HermesValue &hv) {
-      if (hv.isPointer()) {
-        helper(&hv, hv.getPointer());
-      }
-    }
-  };
-
-  OldGenObjEvacAcceptor acceptor(*gc_);
-  SlotVisitor<OldGenObjEvacAcceptor> visitor(acceptor);
-
   auto segs = GCSegmentRange::concat(
       OldGenFilledSegmentRange::create(this),
       GCSegmentRange::singleton(&activeSegment()));
@@ -406,18 +378,28 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
 
     const char *const origSegLevel =
         i == originalLevel.segmentNum ? originalLevel.ptr : seg->level();
+    regions.push_back(
+        {seg->lowLim(), seg->hiLim(), seg->start(), origSegLevel});
+    i++;
+  }
+  return regions;
+}
 
-    auto &cardTable = seg->cardTable();
+template <typename Acceptor>
+void OldGen::markYoungGenPointersInRegionImpl(
+    const YoungGenPointerRegion &region,
+    Acceptor &acceptor) {
+  SlotVisitor<Acceptor> visitor(acceptor);
+  const char *const origSegLevel = region.level;
+  if (region.start < origSegLevel) {
+    auto &cardTable = *AlignedHeapSegment::cardTableCovering(region.start);
 #ifdef HERMES_EXTRA_DEBUG
-    // Capture the bounds of the segment at the start.  If seg points to the
-    // active segment, and we allocate a new active segment *seg, can change, so
-    // don't access after this.
     // TODO(T48709128): remove this when the problem is diagnosed.
-    const char *segLo = seg->lowLim();
-    const char *segHi = seg->hiLim();
+    const char *segLo = region.lowLim;
+    const char *segHi = region.hiLim;
 #endif
 
-    size_t from = cardTable.addressToIndex(seg->start());
+    size_t from = cardTable.addressToIndex(region.start);
     size_t to = cardTable.addressToIndex(origSegLevel - 1) + 1;
 
     while (const auto oiBegin = cardTable.findNextDirtyCard(from, to)) {
@@ -490,9 +472,49 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
 
       from = iEnd;
     }
-    cardTable.clear();
-    i++;
   }
+  AlignedHeapSegment::cardTableCovering(region.lowLim)->clear();
+}
+
+void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
+  struct OldGenObjEvacAcceptor final : public SlotAcceptorDefault {
+    using SlotAcceptorDefault::accept;
+    using SlotAcceptorDefault::SlotAcceptorDefault;
+
+    // NOTE: C++ does not allow templates on local classes, so duplicate the
+    // body of \c helper for ensureReferentCopied.
+    void helper(GCCell **slotAddr, void *slotContents) {
+      if (gc.youngGen_.contains(slotContents)) {
+        gc.youngGen_.ensureReferentCopied(slotAddr);
+      }
+    }
+    void helper(HermesValue *slotAddr, void *slotContents) {
+      if (gc.youngGen_.contains(slotContents)) {
+        gc.youngGen_.ensureReferentCopied(slotAddr);
+      }
+    }
+
+    void accept(void *&ptr) {
+      helper(reinterpret_cast<GCCell **>(&ptr), ptr);
+    }
+    void accept(HermesValue &hv) {
+      if (hv.isPointer()) {
+        helper(&hv, hv.getPointer());
+      }
+    }
+  };
+
+  OldGenObjEvacAcceptor acceptor(*gc_);
+  for (const YoungGenPointerRegion &region :
+       youngGenPointerRegions(originalLevel)) {
+    markYoungGenPointersInRegionImpl(region, acceptor);
+  }
+}
+
+void OldGen::markYoungGenPointersInRegion(
+    const YoungGenPointerRegion &region,
+    YoungGen::ParallelEvacAcceptor &acceptor) {
+  markYoungGenPointersInRegionImpl(region, acceptor);
 }
 
 void OldGen::youngGenTransitiveClosure(
@@ -25,7 +25,10 @@
 #include "hermes/VM/HiddenClass.h"
 #include "hermes/VM/YoungGenNC-inline.h"
 
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
 
 using llvm::dbgs;
 using std::chrono::steady_clock;
@@ -199,6 +202,9 @@ void YoungGen::printStats(llvm::raw_ostream &os, bool trailingComma) const {
      << "\t\t\t\"ygScanTransitiveTime\": " << scanTransitiveSecs_ << ",\n"
      << "\t\t\t\"ygUpdateWeakRefsTime\": " << updateWeakRefsSecs_ << ",\n"
      << "\t\t\t\"ygFinalizersTime\": " << finalizersSecs_ << ",\n"
+     << "\t\t\t\"ygNumWorkers\": "
+     << (gc_->workerPool_ ? gc_->workerPool_->numWorkers() : 1) << ",\n"
+     << "\t\t\t\"ygEvacuationCPUTime\": " << evacuationCPUSecs_ << ",\n"
      << "\t\t\t\"ygSurvivalPct\": " << youngGenSurvivalPct;
   if (trailingComma) {
     os << ",";
@@ -292,7 +298,7 @@ YoungGen::recordAllocSizes() {
   forAllObjs([&allocSizes](GCCell *cell) {
     std::string str;
     auto stringPrim = dyn_vmcast_or_null<StringPrimitive>(cell);
-    if (stringPrim && stringPrim->isASCII()) {
+    if (stringPrim && stringPrim->isASCII() && stringPrim->isFlat()) {
       auto strRef = stringPrim->getStringRef<char>();
       str = std::string(strRef.data(), strRef.size());
     }
@@ -350,32 +356,46 @@ void YoungGen::collect() {
       dbgs() << "\nStarting (young-gen, " << formatSize(youngGenSizeBefore)
              << ") garbage collection; collection # " << gc_->numGCs() << "\n");
 
-  // Remember the point in the older generation into which we started
-  // promoting objects.
-  OldGen::Location toScan = nextGen_->levelDirect();
-
-  // We do this first, before marking from the roots, so that we can take
-  // a "snapshot" of the level of the old gen, and only iterate over pointers
-  // in old-gen objects allocated at the start of the collection.
+  const auto evacuationCPUStart = oscompat::thread_cpu_time();
   auto markOldToYoungStart = steady_clock::now();
-  {
-    PerfSection ygMarkOldToYoungSystraceRegion("ygMarkOldToYoung");
-    nextGen_->markYoungGenPointers(toScan);
-  }
+  auto markRootsStart = markOldToYoungStart;
+  auto scanTransitiveStart = markOldToYoungStart;
+  const bool parallel = canEvacuateInParallel();
+  size_t parallelPromotedBytes = 0;
+  if (parallel) {
+    // The workers scan the old-to-young pointers while the roots are marked,
+    // so all the time until the roots are done is counted as marking roots.
+    PerfSection ygEvacuateParallelSystraceRegion("ygEvacuateParallel");
+    parallelPromotedBytes = evacuateParallel(scanTransitiveStart);
+  } else {
+    // Remember the point in the older generation into which we started
+    // promoting objects.
+    OldGen::Location toScan = nextGen_->levelDirect();
+
+    // We do this first, before marking from the roots, so that we can take
+    // a "snapshot" of the level of the old gen, and only iterate over
+    // pointers in old-gen objects allocated at the start of the collection.
+    {
+      PerfSection ygMarkOldToYoungSystraceRegion("ygMarkOldToYoung");
+      nextGen_->markYoungGenPointers(toScan);
+    }
 
-  auto markRootsStart = steady_clock::now();
-  EvacAcceptor acceptor(*gc_, *this);
-  DroppingAcceptor<EvacAcceptor> nameAcceptor{acceptor};
-  {
-    PerfSection ygMarkRootsSystraceRegion("ygMarkRoots");
-    gc_->markRoots(nameAcceptor, /*markLongLived*/ false);
-  }
+    markRootsStart = steady_clock::now();
+    EvacAcceptor acceptor(*gc_, *this);
+    DroppingAcceptor<EvacAcceptor> nameAcceptor{acceptor};
+    {
+      PerfSection ygMarkRootsSystraceRegion("ygMarkRoots");
+      gc_->markRoots(nameAcceptor, /*markLongLived*/ false);
+    }
 
-  auto scanTransitiveStart = steady_clock::now();
-  {
-    PerfSection ygScanTransitiveSystraceRegion("ygScanTransitive");
-    nextGen_->youngGenTransitiveClosure(toScan, acceptor);
+    scanTransitiveStart = steady_clock::now();
+    {
+      PerfSection ygScanTransitiveSystraceRegion("ygScanTransitive");
+      nextGen_->youngGenTransitiveClosure(toScan, acceptor);
+    }
   }
+  evacuationCPUSecs_ += GCBase::clockDiffSeconds(
+      evacuationCPUStart, oscompat::thread_cpu_time());
 
   if (gc_->getIDTracker().isTrackingIDs()) {
     PerfSection fixupTrackedObjectsSystraceRegion("updateIDTracker");
@@ -444,8 +464,12 @@ void YoungGen::collect() {
   resetNumAllHiddenClasses();
 #endif // !NDEBUG
 
-  // Track the bytes of promoted objects.
-  const size_t promotedBytes = (nextGen_->used() - oldGenUsedBefore);
+  // Track the bytes of promoted objects.  A parallel evacuation leaves unused
+  // space at the ends of the promotion buffers, so the growth of the old gen
+  // overstates them.
+  const size_t promotedBytes = parallel
+      ? parallelPromotedBytes
+      : (nextGen_->used() - oldGenUsedBefore);
   assert(
       promotedBytes <= youngGenUsedBefore &&
       "Can't have promoted more bytes than existed in the young gen before "
@@ -578,6 +602,191 @@ GCCell *YoungGen::forwardPointer(GCCell *ptr) {
   return newCell;
 }
 
+bool YoungGen::canEvacuateInParallel() {
+  // Without card boundaries being kept up to date, the workers cannot make
+  // their buffers parseable by the card scan of later collections.
+  if (!gc_->workerPool_ || !gc_->allocContextFromYG_) {
+    return false;
+  }
+  // A buffer filled by a worker may have an unused end of up to
+  // kMaxBufferedCellSize bytes, which is less than 1/16 of a buffer.  The
+  // buffers in use when the evacuation completes may be almost unused, and
+  // one more may be lost to the end of an old-gen segment.
+  const size_t ygUsed = usedDirect();
+  return nextGen_->ensureFits(
+      ygUsed + ygUsed / 16 +
+      (gc_->workerPool_->numWorkers() + 2) * kPromotionBufferSize);
+}
+
+size_t YoungGen::evacuateParallel(steady_clock::time_point &rootsEnd) {
+  GCWorkerPool &pool = *gc_->workerPool_;
+  const unsigned numWorkers = pool.numWorkers();
+
+  // Find the old-gen regions to scan for old-to-young pointers before
+  // anything is promoted, since promotion may add segments to the old gen.
+  const std::vector<OldGen::YoungGenPointerRegion> regions =
+      nextGen_->youngGenPointerRegions(nextGen_->levelDirect());
+
+  ParallelWorkList workList{numWorkers};
+  std::mutex allocMutex;
+  std::vector<std::unique_ptr<ParallelEvacAcceptor>> acceptors;
+  for (unsigned i = 0; i < numWorkers; ++i) {
+    acceptors.emplace_back(
+        new ParallelEvacAcceptor(*gc_, *this, workList, allocMutex));
+  }
+
+  std::atomic<size_t> nextRegion{0};
+  evacuationCPUSecs_ += pool.runOnAllWorkers([this,
+                                              &regions,
+                                              &acceptors,
+                                              &nextRegion,
+                                              &rootsEnd](unsigned worker) {
+    ParallelEvacAcceptor &acceptor = *acceptors[worker];
+    if (worker == 0) {
+      DroppingAcceptor<ParallelEvacAcceptor> nameAcceptor{acceptor};
+      gc_->markRoots(nameAcceptor, /*markLongLived*/ false);
+      rootsEnd = steady_clock::now();
+    }
+    for (size_t i = nextRegion.fetch_add(1, std::memory_order_relaxed);
+         i < regions.size();
+         i = nextRegion.fetch_add(1, std::memory_order_relaxed)) {
+      nextGen_->markYoungGenPointersInRegion(regions[i], acceptor);
+    }
+    acceptor.drain();
+  });
+
+#ifndef NDEBUG
+  // Filler cells are variable sized.
+  gc_->lastAllocWasFixedSize_ = GCBase::FixedSizeValue::Unknown;
+  // Each buffer was counted as one allocated object in the old gen; count the
+  // cells in it instead.
+  unsigned numBuffered = 0;
+  unsigned numBuffers = 0;
+#endif
+  size_t promotedBytes = 0;
+  for (auto &acceptor : acceptors) {
+    acceptor->retireBuffer();
+    // Fill the unused ends of the buffers, so that the old gen stays
+    // parseable.
+    for (const auto &range : acceptor->unusedRanges) {
+      new (range.first) FillerCell(gc_, range.second - range.first);
+      CardTable *cardTable = AlignedHeapSegment::cardTableCovering(range.first);
+      CardTable::Boundary boundary = cardTable->nextBoundary(range.first);
+      if (boundary.address() < range.second) {
+        cardTable->updateBoundaries(&boundary, range.first, range.second);
+      }
+    }
+    promotedBytes += acceptor->promotedBytes;
+#ifndef NDEBUG
+    numReachableObjects_ += acceptor->numPromoted;
+    numHiddenClasses_ += acceptor->numHiddenClasses;
+    numLeafHiddenClasses_ += acceptor->numLeafHiddenClasses;
+    numBuffered += acceptor->numBuffered;
+    numBuffers += acceptor->numBuffers;
+#endif
+  }
+#ifndef NDEBUG
+  nextGen_->incNumAllocatedObjects(numBuffered - numBuffers);
+#endif
+  return promotedBytes;
+}
+
+void YoungGen::ParallelEvacAcceptor::drain() {
+  do {
+    while (!stack.empty()) {
+      GCCell *cell = stack.back();
+      stack.pop_back();
+      GCBase::markCell(cell, &gc, *this);
+      if (stack.size() > 1 && workList.wantsWork()) {
+        workList.shareWork(stack);
+      }
+    }
+  } while (workList.takeWork(stack));
+}
+
+void YoungGen::ParallelEvacAcceptor::retireBuffer() {
+  if (bufLevel != bufEnd) {
+    unusedRanges.emplace_back(bufLevel, bufEnd);
+  }
+  bufLevel = bufEnd = nullptr;
+}
+
+GCCell *YoungGen::ParallelEvacAcceptor::forward(GCCell *cell) {
+  assert(gen.contains(cell));
+  const VTable *vt = cell->tryClaimForForwarding();
+  if (!vt) {
+    // Another worker is forwarding the cell, or already has.
+    return cell->waitForMarkedForwardingPointer();
+  }
+
+  const uint32_t size = cell->getAllocatedSize(vt);
+  char *dest = allocPromoted(size);
+  cell->copyClaimedTo(dest, vt, size);
+  GCCell *newCell = reinterpret_cast<GCCell *>(dest);
+  cell->publishMarkedForwardingPointer(newCell);
+  promotedBytes += size;
+#ifndef NDEBUG
+  numPromoted++;
+  if (auto *hiddenClass = dyn_vmcast<HiddenClass>(newCell)) {
+    ++numHiddenClasses;
+    numLeafHiddenClasses += hiddenClass->isKnownLeaf();
+  }
+#endif
+
+  stack.push_back(newCell);
+  return newCell;
+}
+
+char *YoungGen::ParallelEvacAcceptor::allocPromoted(uint32_t size) {
+  // A cell fits in the buffer if it fills it exactly, or leaves room for the
+  // filler cell that will cover the unused end.
+  const auto fitsInBuffer = [this, size]() {
+    const size_t avail = bufEnd - bufLevel;
+    return avail == size || avail >= size + sizeof(FillerCell);
+  };
+
+  if (size <= kMaxBufferedCellSize) {
+    if (!fitsInBuffer()) {
+      retireBuffer();
+      AllocResult res;
+      {
+        std::lock_guard<std::mutex> lk{allocMutex};
+        res = gen.nextGen_->allocRaw(kPromotionBufferSize, HasFinalizer::No);
+      }
+      // If there is no room for a whole buffer, the old gen still has room
+      // for the cell itself.
+      if (res.success) {
+        bufLevel = static_cast<char *>(res.ptr);
+        bufEnd = bufLevel + kPromotionBufferSize;
+        bufBoundary = AlignedHeapSegment::cardTableCovering(bufLevel)
+                          ->nextBoundary(bufLevel);
+#ifndef NDEBUG
+        numBuffers++;
+#endif
+      }
+    }
+    if (fitsInBuffer()) {
+      char *res = bufLevel;
+      bufLevel += size;
+      if (bufBoundary.address() < bufLevel) {
+        AlignedHeapSegment::cardTableCovering(res)->updateBoundaries(
+            &bufBoundary, res, bufLevel);
+      }
+#ifndef NDEBUG
+      numBuffered++;
+#endif
+      return res;
+    }
+  }
+
+  std::lock_guard<std::mutex> lk{allocMutex};
+  AllocResult res = gen.nextGen_->allocRaw(size, HasFinalizer::No);
+  // As in forwardPointer, the collection only started if the old gen could
+  // hold every young-gen cell.
+  assert(res.success && "Old gen cannot hold promoted cell");
+  return static_cast<char *>(res.ptr);
+}
+
 void YoungGen::updateIDTracker() {
   updateTrackers</* idTracker */ true, /* allocationLocationTracker */ false>();
 }
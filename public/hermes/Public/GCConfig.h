@@ -140,6 +140,10 @@ enum class GCEventKind {
   /* Whether to track allocation traces starting in the Runtime ctor. */  \
   F(constexpr, bool, AllocationLocationTrackerFromStart, false)           \
                                                                           \
+  /* Number of extra threads that help with full collections (0 means */  \
+  /* that the thread that triggered the collection does all the work). */ \
+  F(constexpr, unsigned, NumGCWorkerThreads, 0)                           \
+                                                                          \
   /* Callout for an analytics event. */                                   \
   F(HERMES_NON_CONSTEXPR,                                                 \
     std::function<void(const GCAnalyticsEvent &)>,                        \
@@ -47,6 +47,29 @@ class Deserializer;
   /* Whether or not the JIT is enabled */                                      \
   F(constexpr, bool, EnableJIT, false)                                         \
                                                                                \
+  /* Number of calls after which the JIT compiles a function. 0 compiles */    \
+  /* every function on its first call. */                                      \
+  F(constexpr, uint32_t, JITCallThreshold, 0)                                  \
+                                                                               \
+  /* Number of backward jumps after which the JIT compiles a function. */      \
+  F(constexpr, uint32_t, JITLoopThreshold, 1000)                               \
+                                                                               \
+  /* Whether the JIT compiles on a background thread, started when the */      \
+  /* first function gets hot. Otherwise the interpreter thread compiles a */   \
+  /* function as soon as it reaches a threshold. */                            \
+  F(constexpr, bool, JITBackgroundCompile, false)                              \
+                                                                               \
+  /* Maximum executable memory used by the JIT. Once it is used up, the JIT */ \
+  /* evicts cold functions to make room. */                                    \
+  F(constexpr, uint32_t, JITMaxMemory, 32 * 1024 * 1024)                       \
+                                                                               \
+  /* Whether to describe JIT compiled code in /tmp/perf-<pid>.map. */          \
+  F(constexpr, bool, JITPerfMap, false)                                        \
+                                                                               \
+  /* Whether to describe JIT compiled code in /tmp/jit-<pid>.dump, in the */   \
+  /* jitdump format for perf inject. */                                        \
+  F(constexpr, bool, JITPerfDump, false)                                       \
+                                                                               \
   /* Whether to allow eval and Function ctor */                                \
   F(constexpr, bool, EnableEval, true)                                         \
                                                                                \
@@ -81,6 +104,10 @@ class Deserializer;
   /* Whether to enable sampling profiler */                                    \
   F(constexpr, bool, EnableSampleProfiling, false)                             \
                                                                                \
+  /* Number of compiled RegExps kept for reuse by identical RegExps. */        \
+  /* 0 disables the cache. */                                                  \
+  F(constexpr, unsigned, RegExpCacheSize, 64)                                  \
+                                                                               \
   /* Whether to randomize stack placement etc. */                              \
   F(constexpr, bool, RandomizeMemoryLayout, false)                             \
                                                                                \
@@ -91,6 +118,10 @@ class Deserializer;
   /* all bytecode buffers > 64 kB passed to Hermes must be mmap:ed. */         \
   F(constexpr, bool, TrackIO, false)                                           \
                                                                                \
+  /* Register the identifiers of persistent bytecode modules when they are */  \
+  /* first used, instead of all of them when the module is loaded. */          \
+  F(constexpr, bool, LazyIdentifiers, false)                                   \
+                                                                               \
   /* Enable contents of HermesInternal */                                      \
   F(constexpr, bool, EnableHermesInternal, true)                               \
                                                                                \
@@ -102,6 +133,12 @@ class Deserializer;
   /* runtime with CompileFlags::allowFunctionToStringWithRuntimeSource set. */ \
   F(constexpr, bool, AllowFunctionToStringWithRuntimeSource, false)            \
                                                                                \
+  /* Directory where prepareJavaScript() caches the bytecode it compiles */    \
+  /* from source, keyed by the hash of the source. Empty disables it. */       \
+  /* The cache has no size bound and never evicts files: the embedder */       \
+  /* must clean up the directory. */                                           \
+  F(HERMES_NON_CONSTEXPR, std::string, BytecodeCacheDir, "")                   \
+                                                                               \
   /* An interface for managing crashes. */                                     \
   F(HERMES_NON_CONSTEXPR,                                                      \
     std::shared_ptr<CrashManager>,                                             \
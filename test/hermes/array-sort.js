@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// CHECK-LABEL: Start
+print("Start");
+
+// Equal elements keep their order, in runs and in random data alike.
+function checkStable(n, makeKey) {
+  var a = [];
+  for (var i = 0; i < n; ++i) {
+    a.push({key: makeKey(i), index: i});
+  }
+  a.sort(function(x, y) {
+    return x.key - y.key;
+  });
+  for (var i = 1; i < n; ++i) {
+    if (a[i - 1].key > a[i].key ||
+        (a[i - 1].key === a[i].key && a[i - 1].index > a[i].index)) {
+      return false;
+    }
+  }
+  return a.length === n;
+}
+var seed = 1;
+function random() {
+  seed = (seed * 1103515245 + 12345) % 2147483648;
+  return seed;
+}
+print(checkStable(2000, function(i) { return random() % 10; }));
+// CHECK-NEXT: true
+print(checkStable(2000, function(i) { return Math.floor(i / 7); }));
+// CHECK-NEXT: true
+print(checkStable(2000, function(i) { return -Math.floor(i / 7); }));
+// CHECK-NEXT: true
+print(checkStable(2000, function(i) { return (i % 100) < 50 ? i : 3000 - i; }));
+// CHECK-NEXT: true
+
+// Strictly descending runs are reversed, others are not.
+print([5, 4, 3, 2, 1, 1, 0].sort().join());
+// CHECK-NEXT: 0,1,1,2,3,4,5
+
+// Undefined values go after everything else, and holes after them.
+var holes = [3, undefined, , 1, , 'b', undefined, 2];
+holes.sort();
+print(holes.length, holes.join(), 6 in holes, 7 in holes);
+// CHECK-NEXT: 8 1,2,3,b,,,, false false
+
+// Without a comparator, values are compared as strings.
+print([10, 9, 1, -1, 'a', true, null].sort().join());
+// CHECK-NEXT: -1,1,10,9,a,,true
+
+// Array-like objects are sorted too, and keep their holes at the end.
+var obj = {0: 'c', 2: 'a', 3: 'b', length: 4};
+Array.prototype.sort.call(obj);
+print(obj[0], obj[1], obj[2], 3 in obj);
+// CHECK-NEXT: a b c false
+
+// The comparator sees the values, not the object, while it sorts.
+var arr = [3, 2, 1];
+arr.sort(function(x, y) {
+  arr[0] = 100;
+  return x - y;
+});
+print(arr.join());
+// CHECK-NEXT: 1,2,3
+
+// An exception from the comparator leaves the array unchanged.
+var arr2 = [3, 2, 1];
+try {
+  arr2.sort(function() { throw new Error('oops'); });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: oops
+print(arr2.join());
+// CHECK-NEXT: 3,2,1
+
+// Frozen arrays cannot be sorted in place.
+try {
+  Object.freeze([2, 1]).sort();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+// TypedArrays sort numerically, with -0 before +0 and NaN last.
+print(Array.prototype.join.call(
+    new Float64Array([NaN, 1, -Infinity, -0, 0, -2.5, Infinity, NaN]).sort()));
+// CHECK-NEXT: -Infinity,-2.5,0,0,1,Infinity,NaN,NaN
+var zeros = new Float32Array([0, -0, 0, -0]).sort();
+print(1 / zeros[0], 1 / zeros[1], 1 / zeros[2], 1 / zeros[3]);
+// CHECK-NEXT: -Infinity -Infinity Infinity Infinity
+print(new Int8Array([5, -128, 127, 0, -1]).sort().join());
+// CHECK-NEXT: -128,-1,0,5,127
+print(new Uint16Array([65535, 256, 1, 0]).sort().join());
+// CHECK-NEXT: 0,1,256,65535
+print(new Int32Array([2147483647, -2147483648, 0, -1, 1]).sort().join());
+// CHECK-NEXT: -2147483648,-1,0,1,2147483647
+var big = new Uint32Array(1000);
+for (var i = 0; i < big.length; ++i) {
+  big[i] = random() * 2;
+}
+big.sort();
+var sorted = true;
+for (var i = 1; i < big.length; ++i) {
+  sorted = sorted && big[i - 1] <= big[i];
+}
+print(sorted);
+// CHECK-NEXT: true
+
+// A comparator is still called for TypedArrays.
+print(new Int16Array([1, 3, 2]).sort(function(x, y) { return y - x; }).join());
+// CHECK-NEXT: 3,2,1
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// CHECK-LABEL: Start
+print("Start");
+
+function keys(o) {
+  var result = [];
+  for (var k in o) {
+    result.push(k);
+  }
+  return result.join();
+}
+
+function make(i) {
+  return {a: i, b: i, c: i};
+}
+
+// Objects of the same shape share their names after the first loop.
+var before = HermesInternal.getInstrumentedStats();
+for (var i = 0; i < 10; ++i) {
+  keys(make(i));
+}
+var after = HermesInternal.getInstrumentedStats();
+print(after.js_forInCacheHits - before.js_forInCacheHits >= 9);
+// CHECK-NEXT: true
+print(after.js_forInCacheMisses - before.js_forInCacheMisses <= 1);
+// CHECK-NEXT: true
+
+// Properties deleted during the loop are skipped, even with a cached list.
+var o = make(0);
+keys(o);
+var seen = [];
+for (var k in o) {
+  seen.push(k);
+  delete o.c;
+}
+print(seen.join());
+// CHECK-NEXT: a,b
+
+// So are properties deleted from a prototype.
+var proto = {p: 1, q: 2};
+var child = Object.create(proto);
+child.x = 0;
+keys(child);
+seen = [];
+for (var k in child) {
+  seen.push(k);
+  delete proto.q;
+}
+print(seen.join());
+// CHECK-NEXT: x,p
+
+// A changed prototype chain is noticed.
+var other = Object.create({r: 3});
+other.x = 0;
+print(keys(other));
+// CHECK-NEXT: x,r
+Object.setPrototypeOf(other, {s: 4});
+print(keys(other));
+// CHECK-NEXT: x,s
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -lazy %s | %FileCheck --match-full-lines %s
+
+// Cached global accesses observe deletes and reconfigurations.
+
+var declared = 1;
+implicit = 2;
+
+function read() {
+  return typeof implicit === "undefined" ? "none" : implicit;
+}
+
+function write(v) {
+  declared = v;
+  return declared;
+}
+
+print("start");
+//CHECK-LABEL: start
+
+for (var i = 0; i < 3; ++i) {
+  read();
+  write(i);
+}
+
+print(read(), write(10));
+//CHECK-NEXT: 2 10
+
+delete implicit;
+print(read());
+//CHECK-NEXT: none
+
+Object.defineProperty(globalThis, "implicit", {
+  get: function() { return "getter"; },
+  configurable: true,
+});
+print(read());
+//CHECK-NEXT: getter
+
+Object.defineProperty(globalThis, "declared", {writable: false});
+print(write(20), declared);
+//CHECK-NEXT: 10 10
+
+// Globals added later are cached as well.
+for (var i = 0; i < 100; ++i) {
+  globalThis["g" + i] = i;
+}
+print(read(), write(30));
+//CHECK-NEXT: getter 10
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// JSON.parse reuses the hidden class of the previous object at the same
+// nesting level. Objects whose keys differ must still come out right.
+
+print('json parse shapes');
+// CHECK-LABEL: json parse shapes
+
+function show(v) {
+  print(JSON.stringify(v), Object.keys(v).join());
+}
+
+// Records of the same shape.
+var a = JSON.parse('[{"x":1,"y":2},{"x":3,"y":4},{"x":5,"y":6}]');
+show(a);
+// CHECK-NEXT: [{"x":1,"y":2},{"x":3,"y":4},{"x":5,"y":6}] 0,1,2
+a[1].z = 7;
+delete a[2].x;
+show(a);
+// CHECK-NEXT: [{"x":1,"y":2},{"x":3,"y":4,"z":7},{"y":6}] 0,1,2
+
+// Fewer, more, reordered and different keys.
+show(JSON.parse(
+    '[{"a":1,"b":2,"c":3},{"a":4,"b":5},{"a":6,"b":7,"c":8,"d":9},' +
+    '{"b":10,"a":11},{"e":12},{},{"a":13,"b":14,"c":15}]'));
+// CHECK-NEXT: [{"a":1,"b":2,"c":3},{"a":4,"b":5},{"a":6,"b":7,"c":8,"d":9},{"b":10,"a":11},{"e":12},{},{"a":13,"b":14,"c":15}] 0,1,2,3,4,5,6
+var r = JSON.parse('[{"a":1,"b":2},{"a":3,"c":4}]');
+print(r[1].a, r[1].b, r[1].c, 'b' in r[1]);
+// CHECK-NEXT: 3 undefined 4 false
+
+// Duplicate and index-like keys.
+show(JSON.parse('[{"a":1,"a":2},{"a":3,"a":4},{"a":5}]'));
+// CHECK-NEXT: [{"a":2},{"a":4},{"a":5}] 0,1,2
+show(JSON.parse('[{"1":1,"a":2},{"1":3,"a":4},{"a":5,"0":6}]'));
+// CHECK-NEXT: [{"1":1,"a":2},{"1":3,"a":4},{"0":6,"a":5}] 0,1,2
+
+// "__proto__" is an ordinary key.
+var p = JSON.parse('[{"__proto__":1,"k":2},{"__proto__":3,"k":4}]');
+print(p[1].__proto__ === Object.prototype,
+      Object.getOwnPropertyDescriptor(p[1], '__proto__').value, p[1].k);
+// CHECK-NEXT: false 3 4
+
+// Nested records, with shapes at each level.
+var n = JSON.parse(
+    '[{"id":1,"pt":{"x":1,"y":2},"tags":["a"]},' +
+    '{"id":2,"pt":{"x":3,"y":4},"tags":[]},' +
+    '{"id":3,"pt":{"y":5,"x":6},"tags":[{"t":1}]},' +
+    '{"id":4,"pt":{"x":7,"y":8,"z":9},"tags":[{"t":2}]}]');
+show(n);
+// CHECK-NEXT: [{"id":1,"pt":{"x":1,"y":2},"tags":["a"]},{"id":2,"pt":{"x":3,"y":4},"tags":[]},{"id":3,"pt":{"y":5,"x":6},"tags":[{"t":1}]},{"id":4,"pt":{"x":7,"y":8,"z":9},"tags":[{"t":2}]}] 0,1,2,3
+
+// Many records with many properties.
+var parts = [];
+for (var i = 0; i < 200; ++i) {
+  var rec = [];
+  for (var j = 0; j < 20; ++j)
+    rec.push('"p' + j + '":' + (i * j));
+  parts.push('{' + rec.join(',') + '}');
+}
+var many = JSON.parse('[' + parts.join(',') + ']');
+print(many.length, many[199].p19, Object.keys(many[150]).length);
+// CHECK-NEXT: 200 3781 20
+
+// The reviver sees every property.
+var seen = [];
+JSON.parse('[{"u":1,"v":2},{"u":3,"v":4}]', function(k, v) {
+  seen.push(k);
+  return v;
+});
+print(seen.join());
+// CHECK-NEXT: u,v,0,u,v,1,
+
+// Strings mixing long plain runs with escapes and non-ASCII characters.
+var long = 'abcdefghijklmnopqrstuvwxyz0123456789';
+var s = JSON.parse('"' + long + '\\n' + long + '\\"\\\\\\u0041é' + long + '"');
+print(s.length, s === long + '\n' + long + '"\\Aé' + long);
+// CHECK-NEXT: 113 true
+print(JSON.parse('"x\\u00e9yz"'), JSON.parse('"é€😀abc"').length);
+// CHECK-NEXT: xéyz 7
+
+// Control characters are still rejected inside long runs.
+try {
+  JSON.parse('"' + long + '\u0001' + long + '"');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+try {
+  JSON.parse('"' + long);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
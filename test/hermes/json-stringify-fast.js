@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xes6-proxy -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// JSON.stringify serializes plain data without calling into JS. Anything else
+// must still be handled as the spec says.
+
+print('json stringify fast');
+// CHECK-LABEL: json stringify fast
+
+var s = JSON.stringify;
+
+// Plain data.
+print(s({a: 1, b: 'x', c: true, d: null, e: [1, 2.5, -3, 1e21, -0], f: {}}));
+// CHECK-NEXT: {"a":1,"b":"x","c":true,"d":null,"e":[1,2.5,-3,1e+21,0],"f":{}}
+print(s([NaN, Infinity, -Infinity, [], [0, []], {x: {y: {z: 'deep'}}}]));
+// CHECK-NEXT: [null,null,null,[],[0,[]],{"x":{"y":{"z":"deep"}}}]
+print(s([{a: 1, b: 2}, {a: 3, b: 4}, {b: 5, a: 6}, {a: 7}]));
+// CHECK-NEXT: [{"a":1,"b":2},{"a":3,"b":4},{"b":5,"a":6},{"a":7}]
+
+// Values that serialize to undefined.
+print(s({a: undefined, b: function() {}, c: Symbol('c'), d: 1}));
+// CHECK-NEXT: {"d":1}
+print(s([undefined, function() {}, Symbol('c')]));
+// CHECK-NEXT: [null,null,null]
+print(s({a: undefined}), s([undefined]));
+// CHECK-NEXT: {} [null]
+
+// Strings needing escapes, mixed with long plain runs.
+var long = 'abcdefghijklmnopqrstuvwxyz';
+print(s([long + '"' + long, '\\\b\f\n\r\t', '\u0001\u001f', 'é€😀' + long]));
+// CHECK-NEXT: ["abcdefghijklmnopqrstuvwxyz\"abcdefghijklmnopqrstuvwxyz","\\\b\f\n\r\t","\u0001\u001f","é€😀abcdefghijklmnopqrstuvwxyz"]
+print(s({'a"b': 1, 'é': 2, '\n': 3}));
+// CHECK-NEXT: {"a\"b":1,"é":2,"\n":3}
+
+// Index-like keys come first.
+print(s({b: 1, 2: 2, a: 3, 1: 4}));
+// CHECK-NEXT: {"1":4,"2":2,"b":1,"a":3}
+
+// Non-enumerable properties, symbol keys, deleted properties.
+var o = {a: 1, b: 2, c: 3};
+Object.defineProperty(o, 'h', {value: 4, enumerable: false});
+o[Symbol('s')] = 5;
+delete o.b;
+print(s([o, o]));
+// CHECK-NEXT: [{"a":1,"c":3},{"a":1,"c":3}]
+
+// Getters, toJSON and boxed primitives.
+var g = {x: 1};
+Object.defineProperty(g, 'y', {get: function() { return 'got'; },
+                               enumerable: true});
+print(s([g, {toJSON: function(k) { return 'key ' + k; }}]));
+// CHECK-NEXT: [{"x":1,"y":"got"},"key 1"]
+print(s({n: new Number(3), s: new String('str'), b: new Boolean(false)}));
+// CHECK-NEXT: {"n":3,"s":"str","b":false}
+print(s({d: new Date(0)}));
+// CHECK-NEXT: {"d":"1970-01-01T00:00:00.000Z"}
+
+// Inherited toJSON.
+Object.prototype.toJSON = function() { return 'O'; };
+print(s({a: {b: 1}}), s([[1]]));
+// CHECK-NEXT: "O" "O"
+delete Object.prototype.toJSON;
+Array.prototype.toJSON = function() { return 'A'; };
+print(s({a: [1]}));
+// CHECK-NEXT: {"a":"A"}
+delete Array.prototype.toJSON;
+var arr = [1, 2];
+arr.toJSON = function() { return 'own'; };
+print(s({a: arr}));
+// CHECK-NEXT: {"a":"own"}
+function Point(x) { this.x = x; }
+Point.prototype.toJSON = function() { return 'P' + this.x; };
+print(s([new Point(1), {p: new Point(2)}]));
+// CHECK-NEXT: ["P1",{"p":"P2"}]
+print(s({a: Object.create(null), b: Object.create({inherited: 1})}));
+// CHECK-NEXT: {"a":{},"b":{}}
+
+// Holes are looked up in the prototype chain.
+print(s([1, , 3]));
+// CHECK-NEXT: [1,null,3]
+Array.prototype[1] = 'proto';
+print(s({a: [1, , 3]}));
+// CHECK-NEXT: {"a":[1,"proto",3]}
+delete Array.prototype[1];
+
+// Proxies.
+print(s({p: new Proxy({a: 1}, {})}));
+// CHECK-NEXT: {"p":{"a":1}}
+
+// Replacers and indentation.
+print(s({a: 1, b: [2, {c: 3}]}, function(k, v) {
+  return typeof v === 'number' ? v * 10 : v;
+}));
+// CHECK-NEXT: {"a":10,"b":[20,{"c":30}]}
+print(s({a: 1, b: 2, c: {a: 3, d: 4}}, ['a', 'c']));
+// CHECK-NEXT: {"a":1,"c":{"a":3}}
+print(s({a: [1, {b: {}}], c: []}, null, 2));
+// CHECK-NEXT: {
+// CHECK-NEXT:   "a": [
+// CHECK-NEXT:     1,
+// CHECK-NEXT:     {
+// CHECK-NEXT:       "b": {}
+// CHECK-NEXT:     }
+// CHECK-NEXT:   ],
+// CHECK-NEXT:   "c": []
+// CHECK-NEXT: }
+print(s([{x: 1}, {x: undefined, y: 2}], null, '--'));
+// CHECK-NEXT: [
+// CHECK-NEXT: --{
+// CHECK-NEXT: ----"x": 1
+// CHECK-NEXT: --},
+// CHECK-NEXT: --{
+// CHECK-NEXT: ----"y": 2
+// CHECK-NEXT: --}
+// CHECK-NEXT: ]
+
+// Cycles, including through objects serialized by the slow path.
+var c = {a: [1]};
+c.a.push(c);
+try {
+  s(c);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+var c2 = {n: new Number(1), d: {}};
+c2.d.self = c2;
+try {
+  s({x: c2});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+var shared = {v: 1};
+print(s([shared, shared, {a: shared}]));
+// CHECK-NEXT: [{"v":1},{"v":1},{"a":{"v":1}}]
+
+// Too deep.
+var deep = [];
+for (var i = 0; i < 1000; ++i)
+  deep = [deep];
+try {
+  s(deep);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: RangeError
+
+// Large data round trips.
+var records = [];
+for (var i = 0; i < 500; ++i)
+  records.push({id: i, name: 'n' + i, tags: ['t', i % 7], sub: {v: i / 4}});
+var text = s(records);
+print(text.length, s(JSON.parse(text)) === text);
+// CHECK-NEXT: 28341 true
+
+// A toJSON method deep in a structure, next to plain data at every level.
+var nested = {leaf: {toJSON: function() { return 'leaf'; }}};
+for (var i = 0; i < 50; ++i)
+  nested = {i: i, data: [i, {v: 'x'}], next: nested};
+var nestedText = s(nested);
+print(nestedText.length, nestedText.slice(0, 60));
+print(nestedText.slice(-70));
+// CHECK-NEXT: 1895 {"i":49,"data":[49,{"v":"x"}],"next":{"i":48,"data":[48,{"v"
+// CHECK-NEXT: ext":{"leaf":"leaf"}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}}
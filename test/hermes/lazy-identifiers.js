@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes -Xlazy-identifiers %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xlazy-identifiers -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Identifiers which are registered when first used behave like the others.
+
+print('lazy identifiers');
+// CHECK-LABEL: lazy identifiers
+
+var o = {alpha: 1, beta: 2};
+o.gamma = o.alpha + o.beta;
+print(Object.keys(o).join(), o.gamma, 'delta' in o);
+// CHECK-NEXT: alpha,beta,gamma 3 false
+
+// A property name created at runtime is the same as the identifier used later.
+var name = ['ep', 'silon'].join('');
+o[name] = 4;
+print(o.epsilon, JSON.stringify(o));
+// CHECK-NEXT: 4 {"alpha":1,"beta":2,"gamma":3,"epsilon":4}
+
+// An identifier used as a string first.
+var s = 'zeta';
+o.zeta = 5;
+print(o[s], delete o.zeta, o.zeta);
+// CHECK-NEXT: 5 true undefined
+
+function get(x) {
+  return x.theta;
+}
+print(get({theta: 6}), get({}));
+// CHECK-NEXT: 6 undefined
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// CHECK-LABEL: Start
+print("Start");
+
+function collect(it, n) {
+  var out = [];
+  for (var i = 0; i < n; ++i) {
+    var r = it.next();
+    if (r.done) {
+      out.push('done');
+      break;
+    }
+    out.push(r.value);
+  }
+  return out.join();
+}
+
+// Entries added during iteration are visited, deleted ones are not.
+var m = new Map([[1, 'a'], [2, 'b'], [3, 'c']]);
+var seen = [];
+m.forEach(function(v, k) {
+  seen.push(k + v);
+  if (k === 1) {
+    m.delete(2);
+    m.set(4, 'd');
+  }
+});
+print(seen.join());
+// CHECK-NEXT: 1a,3c,4d
+
+// An iterator keeps its place while the table grows.
+var s = new Set([0, 1, 2]);
+var it = s.values();
+print(collect(it, 2));
+// CHECK-NEXT: 0,1
+for (var i = 3; i < 100; ++i) {
+  s.add(i);
+}
+var rest = collect(it, 200).split(',');
+print(rest.length, rest[0], rest[97], rest[98]);
+// CHECK-NEXT: 99 2 99 done
+
+// ...and while it is compacted after deletions.
+s = new Set();
+for (var i = 0; i < 64; ++i) {
+  s.add(i);
+}
+it = s.values();
+print(collect(it, 10));
+// CHECK-NEXT: 0,1,2,3,4,5,6,7,8,9
+for (var i = 0; i < 60; ++i) {
+  if (i !== 5 && i !== 20) {
+    s.delete(i);
+  }
+}
+s.add('x');
+print(s.size, collect(it, 10));
+// CHECK-NEXT: 7 20,60,61,62,63,x,done
+
+// Several iterators at different positions survive the same rehash.
+s = new Set(['a', 'b', 'c', 'd']);
+var it1 = s.values();
+var it2 = s.values();
+it2.next();
+it2.next();
+it2.next();
+s.delete('a');
+s.delete('c');
+for (var i = 0; i < 20; ++i) {
+  s.add(i);
+}
+print(collect(it1, 3), '|', collect(it2, 3));
+// CHECK-NEXT: b,d,0 | d,0,1
+
+// Clearing restarts live iterators at the new entries.
+m = new Map([['a', 1], ['b', 2]]);
+var entries = m.entries();
+print(collect(entries, 1));
+// CHECK-NEXT: a,1
+m.clear();
+m.set('c', 3);
+print(m.size, collect(entries, 3));
+// CHECK-NEXT: 1 c,3,done
+print(collect(entries, 1));
+// CHECK-NEXT: done
+
+// Keys are compared with SameValueZero.
+m = new Map();
+m.set(NaN, 'nan');
+m.set(-0, 'zero');
+print(m.get(NaN), m.get(0), m.has(+0), m.size);
+// CHECK-NEXT: nan zero true 2
+m.delete(0);
+print(m.has(-0), m.size);
+// CHECK-NEXT: false 1
+
+// Deleting and re-adding keeps the map consistent across many rehashes.
+m = new Map();
+var ok = true;
+for (var round = 0; round < 5; ++round) {
+  for (var i = 0; i < 500; ++i) {
+    m.set('k' + i, i + round);
+  }
+  for (var i = 0; i < 500; i += 2) {
+    m.delete('k' + i);
+  }
+  for (var i = 1; i < 500; i += 2) {
+    ok = ok && m.get('k' + i) === i + round;
+  }
+  ok = ok && m.size === 250;
+  for (var i = 1; i < 500; i += 2) {
+    m.delete('k' + i);
+  }
+  ok = ok && m.size === 0;
+}
+print(ok);
+// CHECK-NEXT: true
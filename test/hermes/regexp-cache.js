@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// CHECK-LABEL: Start
+print("Start");
+
+function stats() {
+  return HermesInternal.getInstrumentedStats();
+}
+
+// RegExps built from the same source share their compiled bytecode.
+var before = stats();
+for (var i = 0; i < 10; ++i) {
+  new RegExp('(\\d+)-(\\w+)', 'g');
+}
+var after = stats();
+print(after.js_regExpCacheMisses - before.js_regExpCacheMisses);
+// CHECK-NEXT: 1
+print(after.js_regExpCacheHits - before.js_regExpCacheHits);
+// CHECK-NEXT: 9
+print(after.js_regExpCacheEntries > 0, after.js_regExpCacheBytes > 0);
+// CHECK-NEXT: true true
+
+// A RegExp literal makes its bytecode available to identical RegExps.
+/literal[0-9]x/.test('');
+before = stats();
+print(new RegExp('literal[0-9]x').test('literal5x'));
+// CHECK-NEXT: true
+print(stats().js_regExpCacheHits - before.js_regExpCacheHits);
+// CHECK-NEXT: 1
+
+// Flags that change the compiled bytecode are part of the key, others are
+// not.
+print(new RegExp('abc').test('ABC'), new RegExp('abc', 'i').test('ABC'));
+// CHECK-NEXT: false true
+print(new RegExp('^b', 'g').test('a\nb'), new RegExp('^b', 'm').test('a\nb'));
+// CHECK-NEXT: false true
+print(new RegExp('a.b').test('a\nb'), new RegExp('a.b', 's').test('a\nb'));
+// CHECK-NEXT: false true
+
+// Cached RegExps keep their own flags and state.
+var g = new RegExp('o', 'g');
+var y = new RegExp('o', 'y');
+print(g.global, g.sticky, y.global, y.sticky);
+// CHECK-NEXT: true false false true
+g.lastIndex = 0;
+print('foo'.replace(g, '0'), 'foo'.replace(new RegExp('o'), '0'));
+// CHECK-NEXT: f00 f0o
+
+// Invalid patterns are still reported every time.
+for (var i = 0; i < 2; ++i) {
+  try {
+    new RegExp('(');
+  } catch (e) {
+    print(e.name);
+  }
+}
+// CHECK-NEXT: SyntaxError
+// CHECK-NEXT: SyntaxError
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -gc-sanitize-handles=0 %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Concatenations with large operands produce ropes, which must behave like
+// any other string.
+
+print('rope strings');
+// CHECK-LABEL: rope strings
+
+var big = '';
+for (var i = 0; i < 64; ++i)
+  big += 'abcdefgh';
+
+// Repeated prepends don't copy the growing string.
+var s = big;
+for (var i = 0; i < 100000; ++i)
+  s = (i % 10) + s;
+print(s.length, s.charAt(0), s.charAt(99999), s.slice(100000, 100008));
+// CHECK-NEXT: 100512 9 0 abcdefgh
+print(s.indexOf('abcdefgh'), s.lastIndexOf('9'));
+// CHECK-NEXT: 100000 99990
+
+// Two large strings are joined without copying them.
+var t = big + big;
+print(t.length, t === big.repeat(2), t.slice(508, 516));
+// CHECK-NEXT: 1024 true efghabcd
+
+// Tree shaped concatenation.
+function build(depth) {
+  if (depth === 0)
+    return big;
+  return build(depth - 1) + '|' + build(depth - 1);
+}
+var tree = build(10);
+print(tree.length, tree.split('|').length, tree === build(10));
+// CHECK-NEXT: 525311 1024 true
+
+// Mixing ASCII and UTF-16.
+var u = 'ሴ'.repeat(300);
+var m = big + u + big;
+print(m.length, m.charCodeAt(511), m.charCodeAt(512), m.charCodeAt(812));
+// CHECK-NEXT: 1324 104 4660 97
+m = 'x' + m + 'y';
+print(m.length, m[0], m[m.length - 1], m.charCodeAt(600));
+// CHECK-NEXT: 1326 x y 4660
+
+// Ropes can be used as property names and in JSON.
+var o = {};
+o[big + big] = 1;
+print(o[t], JSON.parse(JSON.stringify({k: t})).k === t);
+// CHECK-NEXT: 1 true
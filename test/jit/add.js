@@ -50,12 +50,17 @@ print(this['add'](undefined, 'xyz'));
 //JIT-NEXT: pushq	%r15
 //JIT-NEXT: pushq	%rbx
 //JIT-NEXT: movq	%rdi, %rbx
-//JIT-NEXT: pushq	3968(%rbx)
-//JIT-NEXT: pushq	%rcx
-//JIT-NEXT: movq	3952(%rbx), %r15
-//JIT-NEXT: movq	%r15, 3968(%rbx)
+//JIT-NEXT: pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT: pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT: movq	{{[0-9]+}}(%rbx), %r15
+//JIT-NEXT: movq	%r15, {{[0-9]+}}(%rbx)
+//JIT-NEXT: movq	{{.*}}(%rip), %rax
+//JIT-NEXT: movq	%rax, -8(%r15)
+//JIT-NEXT: movq	%rax, -16(%r15)
+//JIT-NEXT: movq	%rax, -24(%r15)
+//JIT-NEXT: movq	%rax, -32(%r15)
 //JIT-NEXT: leaq	{{.*}}, %rax
-//JIT-NEXT: movq	%rax, 3952(%rbx)
+//JIT-NEXT: movq	%rax, {{[0-9]+}}(%rbx)
 //JIT-NEXT:  BB0:
 //JIT-NEXT:  movq {{.*}}
 //JIT-NEXT:  cmpl {{.*}}
@@ -77,9 +82,9 @@ print(this['add'](undefined, 'xyz'));
 //JIT-NEXT:  movq {{.*}}
 //JIT-NEXT:  movl {{.*}}
 //JIT-NEXT:  BB1:
-//JIT-NEXT: movq	%r15, 3952(%rbx)
-//JIT-NEXT: popq	%rcx
-//JIT-NEXT: popq	3968(%rbx)
+//JIT-NEXT: movq	%r15, {{[0-9]+}}(%rbx)
+//JIT-NEXT: popq	{{[0-9]+}}(%rbx)
+//JIT-NEXT: popq	{{[0-9]+}}(%rbx)
 //JIT-NEXT: popq	%rbx
 //JIT-NEXT: popq	%r15
 //JIT-NEXT: popq	%rbp
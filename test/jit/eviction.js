@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O0 -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-max-memory=16K %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+function stats() {
+  return HermesInternal.getInstrumentedStats();
+}
+
+var fns = [];
+for (var i = 0; i < 100; ++i) {
+  fns.push(new Function('x', 'return x * 2 + ' + i + ';'));
+}
+
+function callAll(count) {
+  var sum = 0;
+  for (var i = 0; i < count; ++i) {
+    for (var j = 0; j < 3; ++j) {
+      sum += fns[i](j);
+    }
+  }
+  return sum;
+}
+
+// CHECK-LABEL: Start
+print('Start');
+
+// The functions don't all fit in the executable memory, so cold ones are
+// evicted to make room.
+print(callAll(fns.length));
+// CHECK-NEXT: 15450
+var s = stats();
+print(s.js_jitEvictions > 0, s.js_jitCompiledBytes <= 16 * 1024);
+// CHECK-NEXT: true true
+
+// Evicted functions are recompiled once they are hot again.
+print(callAll(10));
+// CHECK-NEXT: 195
+s = stats();
+print(s.js_jitRecompiles > 0, s.js_jitCompiledBytes <= 16 * 1024);
+// CHECK-NEXT: true true
@@ -0,0 +1,13 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-crash-on-error %S/../hermes/global-property-cells.js \
+RUN:     | %FileCheck --match-full-lines %S/../hermes/global-property-cells.js
+REQUIRES: jit
+*/
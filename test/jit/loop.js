@@ -54,12 +54,22 @@ logger(power(2, 10));
 //JIT-NEXT:pushq	%r15
 //JIT-NEXT:pushq	%rbx
 //JIT-NEXT:movq	%rdi, %rbx
-//JIT-NEXT:pushq	3968(%rbx)
-//JIT-NEXT:pushq	%rcx
-//JIT-NEXT:movq	3952(%rbx), %r15
-//JIT-NEXT:movq	%r15, 3968(%rbx)
+//JIT-NEXT:pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT:pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT:movq	{{[0-9]+}}(%rbx), %r15
+//JIT-NEXT:movq	%r15, {{[0-9]+}}(%rbx)
+//JIT-NEXT:movq	{{.*}}(%rip), %rax
+//JIT-NEXT:movq	%rax, -8(%r15)
+//JIT-NEXT:movq	%rax, -16(%r15)
+//JIT-NEXT:movq	%rax, -24(%r15)
+//JIT-NEXT:movq	%rax, -32(%r15)
+//JIT-NEXT:movq	%rax, -40(%r15)
+//JIT-NEXT:movq	%rax, -48(%r15)
+//JIT-NEXT:movq	%rax, -56(%r15)
+//JIT-NEXT:movq	%rax, -64(%r15)
+//JIT-NEXT:movq	%rax, -72(%r15)
 //JIT-NEXT:leaq	{{.*}}, %rax
-//JIT-NEXT:movq	%rax, 3952(%rbx)
+//JIT-NEXT:movq	%rax, {{[0-9]+}}(%rbx)
 //JIT-NEXT: BB0:
 //JIT-NEXT: movq {{.*}}
 //JIT-NEXT: cmpl{{.*}}
@@ -107,13 +117,25 @@ logger(power(2, 10));
 //JIT-NEXT: movq {{.*}}
 //JIT-NEXT: movl {{.*}}
 //JIT-NEXT: BB3:
-//JIT-NEXT:movq	%r15, 3952(%rbx)
-//JIT-NEXT:popq	%rcx
-//JIT-NEXT:popq	3968(%rbx)
+//JIT-NEXT:movq	%r15, {{[0-9]+}}(%rbx)
+//JIT-NEXT:popq	{{[0-9]+}}(%rbx)
+//JIT-NEXT:popq	{{[0-9]+}}(%rbx)
 //JIT-NEXT:popq	%rbx
 //JIT-NEXT:popq	%r15
 //JIT-NEXT:popq	%rbp
 //JIT-NEXT:retq
+//JIT-NEXT: OSR:
+//JIT-NEXT:pushq	%rbp
+//JIT-NEXT:movq	%rsp, %rbp
+//JIT-NEXT:pushq	%r15
+//JIT-NEXT:pushq	%rbx
+//JIT-NEXT:movq	%rdi, %rbx
+//JIT-NEXT:pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT:pushq	{{[0-9]+}}(%rbx)
+//JIT-NEXT:movq	{{[0-9]+}}(%rbx), %r15
+//JIT-NEXT:cmpl	${{[0-9]+}}, %esi
+//JIT-NEXT:je	{{.*}}
+//JIT-NEXT:ud2
 
 //JIT-LABEL:;SLOW PATHS
 //JIT-NEXT: leaq {{.*}}
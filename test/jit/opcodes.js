@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O0 -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-crash-on-error %s | %FileCheck --match-full-lines %s
+RUN: %hermes -O -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-crash-on-error %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+"use strict";
+
+function incElements(a, n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) {
+    a[i] = a[i] + 1;
+    sum += a[i];
+  }
+  return sum;
+}
+
+function select(x) {
+  switch (x) {
+    case 3: return "a"; case 4: return "b"; case 5: return "c";
+    case 6: return "d"; case 7: return "e"; case 8: return "f";
+    case 10: return "g"; case 11: return "h"; case 12: return "i";
+    case 13: return "j";
+    default: return "-";
+  }
+}
+
+function* count(n) {
+  for (var i = 0; i < n; ++i) {
+    var skip = yield i;
+    if (skip)
+      i += skip;
+  }
+  return "done";
+}
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function movePoints(points) {
+  var sum = 0;
+  for (var i = 0; i < points.length; ++i) {
+    points[i].x = points[i].x + 1;
+    sum += points[i].x + points[i].y;
+  }
+  return sum;
+}
+
+function counter() {
+  var c = 0;
+  function inc() {
+    c = c + 1;
+    return c;
+  }
+  for (var i = 0; i < 10; ++i)
+    inc();
+  return c;
+}
+
+function entries(m) {
+  var s = "";
+  for (var [k, v] of m)
+    s += k + v;
+  return s;
+}
+
+function tdz() {
+  try {
+    x;
+  } catch (e) {
+    return e.name;
+  }
+  let x = 1;
+}
+
+function test() {
+  // Arrays: holes, doubles and frozen arrays take the slow path.
+  var a = [1, 2.5, 3, , 5];
+  print(incElements(a, 5), a.join(","));
+  var frozen = Object.freeze([1, 2]);
+  try {
+    incElements(frozen, 2);
+  } catch (e) {
+    print(e.name, frozen.join(","));
+  }
+
+  var s = "";
+  for (var i = -1; i < 15; ++i)
+    s += select(i);
+  print(s, select(3.5), select("4"), select(NaN), select(-2147483648));
+
+  var g = count(10);
+  print(g.next().value, g.next(2).value, g.next().value, g.return(7).value);
+  g = count(3);
+  g.next();
+  try {
+    g.throw(new Error("thrown"));
+  } catch (e) {
+    print(e.message, g.next().done);
+  }
+
+  // Property accesses hit the inline caches for several classes.
+  var points = [
+    new Point(1, 2),
+    new Point(3, 4),
+    {y: 1, x: 2},
+    {a: 1, x: 5, y: 6},
+  ];
+  print(movePoints(points), points[0].x, points[2].x);
+  var p = new Point(1, 1);
+  p.x = "s";
+  print(movePoints([p]), p.x);
+
+  print(counter(), entries(new Map([["a", 1], ["b", 2]])), tdz());
+}
+
+// The first run fills the caches that the second one hits.
+print("First");
+test();
+// CHECK-LABEL: First
+// CHECK-NEXT: NaN 2,3.5,4,NaN,6
+// CHECK-NEXT: TypeError 1,2
+// CHECK-NEXT: ----abcdef-ghij- - - - -
+// CHECK-NEXT: 0 3 4 7
+// CHECK-NEXT: thrown true
+// CHECK-NEXT: 28 2 3
+// CHECK-NEXT: 0s11 s1
+// CHECK-NEXT: 10 a1b2 ReferenceError
+print("Second");
+test();
+// CHECK-LABEL: Second
+// CHECK-NEXT: NaN 2,3.5,4,NaN,6
+// CHECK-NEXT: TypeError 1,2
+// CHECK-NEXT: ----abcdef-ghij- - - - -
+// CHECK-NEXT: 0 3 4 7
+// CHECK-NEXT: thrown true
+// CHECK-NEXT: 28 2 3
+// CHECK-NEXT: 0s11 s1
+// CHECK-NEXT: 10 a1b2 ReferenceError
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: (! %hermes -O0 -jit -jit-background=false -jit-call-threshold=1000 \
+RUN:     -jit-loop-threshold=100 %s 2>&1 ) | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+function stats() {
+  return HermesInternal.getInstrumentedStats();
+}
+
+// CHECK-LABEL: Start
+print("Start");
+
+// A loop inside a try block is continued in native code, and errors thrown
+// from it are caught by the compiled handler.
+var before = stats().js_jitOSREntries;
+try {
+  for (var i = 0; i < 1000; ++i) {
+    if (i === 999) {
+      throw new Error("thrown at " + i);
+    }
+  }
+} catch (e) {
+  print("Caught:", e.message, stats().js_jitOSREntries - before);
+}
+// CHECK-NEXT: Caught: thrown at 999 1
+
+// The rest of the global function now runs in native code, where uncatchable
+// errors skip the catch and finally blocks.
+try {
+  quit();
+  print("Didn't quit");
+} catch (e) {
+  print("Caught:", e);
+} finally {
+  print("Finally");
+}
+// CHECK-NEXT: QuitError: Quit
+// CHECK-NEXT:     at quit (native)
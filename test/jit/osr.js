@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O0 -jit -jit-background=false -jit-call-threshold=1000 \
+RUN:     -jit-loop-threshold=100 %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+function stats() {
+  return HermesInternal.getInstrumentedStats();
+}
+
+// A function called only once continues its hot loop in native code.
+function sumTo(n) {
+  var sum = 0;
+  for (var i = 0; i < n; ++i) {
+    sum += i;
+  }
+  return sum;
+}
+
+function thrower(n) {
+  var i = 0;
+  while (true) {
+    if (++i === n) {
+      throw new Error("thrown at " + i);
+    }
+  }
+}
+
+function catcher(n) {
+  var i = 0;
+  try {
+    while (true) {
+      if (++i === n) {
+        throw i;
+      }
+    }
+  } catch (e) {
+    return "caught " + e;
+  }
+}
+
+// CHECK-LABEL: Start
+print("Start");
+
+var before = stats().js_jitOSREntries;
+print(sumTo(50), stats().js_jitOSREntries - before);
+// CHECK-NEXT: 1225 0
+print(sumTo(1000), stats().js_jitOSREntries - before);
+// CHECK-NEXT: 499500 1
+
+// An exception escaping the native code is handled in the caller.
+try {
+  thrower(1000);
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: thrown at 1000
+
+print(catcher(1000));
+// CHECK-NEXT: caught 1000
+print(stats().js_jitOSREntries - before);
+// CHECK-NEXT: 3
+
+// Top-level code can also be continued in native code.
+before = stats().js_jitOSREntries;
+var total = 0;
+for (var k = 0; k < 1000; ++k) {
+  total += k;
+}
+print(total, stats().js_jitOSREntries - before);
+// CHECK-NEXT: 499500 1
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O0 -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-crash-on-error %s | %FileCheck --match-full-lines %s
+RUN: %hermes -O -jit -jit-background=false -jit-call-threshold=1 \
+RUN:     -jit-crash-on-error %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// A native getter called from the slow path of compiled code records the
+// location of the property access.
+function getBuffer(ta) {
+  var buffer = ta.buffer;
+  return print(buffer);
+}
+
+function test() {
+  try {
+    getBuffer(Uint8Array.prototype);
+  } catch (e) {
+    print(e.stack);
+  }
+}
+
+// CHECK-LABEL: Start
+print("Start");
+// The first call is interpreted and compiles the functions.
+for (var i = 0; i < 2; ++i)
+  test();
+// CHECK-NEXT: TypeError: A TypedArray function was called on a non TypedArray
+// CHECK-NEXT:     at get buffer (native)
+// CHECK-NEXT:     at getBuffer ({{.*}}stack-trace.js:19:18)
+// CHECK-NEXT:     at test ({{.*}}stack-trace.js:25:14)
+// CHECK-NEXT:     at global ({{.*}}stack-trace.js:35:7)
+// CHECK-NEXT: TypeError: A TypedArray function was called on a non TypedArray
+// CHECK-NEXT:     at get buffer (native)
+// CHECK-NEXT:     at getBuffer ({{.*}}stack-trace.js:19:18)
+// CHECK-NEXT:     at test ({{.*}}stack-trace.js:25:14)
+// CHECK-NEXT:     at global ({{.*}}stack-trace.js:35:7)
@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+RUN: %hermes -O0 -jit -jit-background=false -jit-call-threshold=5 \
+RUN:     -jit-loop-threshold=100 %s | %FileCheck --match-full-lines %s
+RUN: %hermes -O0 -jit -jit-background -jit-call-threshold=10 %s \
+RUN:     | %FileCheck --match-full-lines -check-prefix BG %s
+REQUIRES: jit
+*/
+
+function compiled() {
+  return HermesInternal.getInstrumentedStats().js_jitCompiledFunctions;
+}
+
+function add(x, y) {
+  return x + y;
+}
+
+function power(base, pow) {
+  var res = 1;
+  while (--pow >= 0) {
+    res *= base;
+  }
+  return res;
+}
+
+// Get compiled() itself past the call threshold before measuring with it.
+for (var i = 0; i < 10; ++i) {
+  compiled();
+}
+
+// CHECK-LABEL: Start
+// BG-LABEL: Start
+print("Start");
+
+// Functions are only compiled once they have been called often enough.
+var before = compiled();
+var sum = 0;
+for (var i = 0; i < 5; ++i) {
+  sum = add(sum, i);
+}
+print(sum, compiled() - before);
+// CHECK-NEXT: 10 0
+sum = add(sum, 1);
+print(sum, compiled() - before);
+// CHECK-NEXT: 11 1
+
+// ...or once their loops have run often enough.
+before = compiled();
+print(power(2, 10), compiled() - before);
+// CHECK-NEXT: 1024 0
+print(power(2, 100) > 1e30, compiled() - before);
+// CHECK-NEXT: true 1
+print(power(3, 3));
+// CHECK-NEXT: 27
+
+// In the background, the interpreter keeps running the function until the
+// compiled code is installed.
+before = compiled();
+sum = 0;
+for (var i = 0; i < 1e8 && compiled() === before; ++i) {
+  sum = add(sum, 1);
+}
+print(compiled() > before, add(sum, 1) === sum + 1);
+// BG: true true
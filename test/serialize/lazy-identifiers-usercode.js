@@ -0,0 +1,25 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -emit-binary -out %t.hbc %s
+// RUN: %hermes -Xlazy-identifiers -serializevm-path=%t %t.hbc
+// RUN: %hermes -Xlazy-identifiers -deserialize-file=%t %t.hbc | %FileCheck --match-full-lines %s
+// REQUIRES: serializer
+"use strict";
+
+// Identifiers of the module which are first used after deserialization are
+// still registered on demand.
+var o = {alpha: 1};
+
+serializeVM(function() {
+  print('lazy identifiers');
+  // CHECK-LABEL: lazy identifiers
+  o.beta = 2;
+  o.gamma = o.alpha + o.beta;
+  print(Object.keys(o).join(), o.gamma, 'delta' in o);
+  // CHECK-NEXT: alpha,beta,gamma 3 false
+})
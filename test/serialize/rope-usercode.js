@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -target=HBC -serializevm-path=%t %s
+// RUN: %hermes -O -deserialize-file=%t -target=HBC %s | %FileCheck --match-full-lines %s
+// REQUIRES: serializer
+"use strict";
+
+// Ropes and buffered strings that are alive when the VM is serialized.
+var big = 'x'.repeat(300);
+var rope = 'a' + big;
+var nested = rope + (big + 'b');
+var utf16Rope = 'αβ' + big;
+var flattened = 'c' + big;
+flattened.indexOf('x');
+var buffered = big + 'd';
+var appended = buffered + 'e';
+
+serializeVM(function() {
+  print('rope');
+  // CHECK-LABEL: rope
+  print(rope.length, rope[0], rope[300]);
+  // CHECK-NEXT: 301 a x
+  print(nested.length, nested[0], nested[nested.length - 1]);
+  // CHECK-NEXT: 602 a b
+  print(utf16Rope.length, utf16Rope.slice(0, 3));
+  // CHECK-NEXT: 302 αβx
+  print(flattened.length, flattened[0]);
+  // CHECK-NEXT: 301 c
+  print(buffered.length, buffered[300], appended.length, appended[301]);
+  // CHECK-NEXT: 301 d 302 e
+  print(rope + nested === 'a' + big + 'a' + big + big + 'b');
+  // CHECK-NEXT: true
+})
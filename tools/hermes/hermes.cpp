@@ -36,7 +36,41 @@ static opt<bool> EnableJIT(
 
 static opt<bool> DumpJITCode(
     "dump-jitcode",
-    llvm::cl::desc("dump JIT'ed code"),
+    llvm::cl::desc("dump JIT'ed code, compiling every function on first call"),
+    llvm::cl::init(false));
+
+static opt<unsigned> JITCallThreshold(
+    "jit-call-threshold",
+    llvm::cl::desc("number of calls after which a function is JIT compiled"),
+    llvm::cl::init(0));
+
+static opt<unsigned> JITLoopThreshold(
+    "jit-loop-threshold",
+    llvm::cl::desc(
+        "number of backward jumps after which a function is JIT compiled"),
+    llvm::cl::init(1000));
+
+static opt<bool> JITBackground(
+    "jit-background",
+    llvm::cl::desc("JIT compile functions on a background thread"),
+    llvm::cl::init(false));
+
+static opt<MemorySize, false, MemorySizeParser> JITMaxMemory(
+    "jit-max-memory",
+    llvm::cl::desc(
+        "maximum executable memory used by the JIT before it evicts cold "
+        "functions.  Format: <unsigned>{{K,M,G}{iB}"),
+    llvm::cl::init(MemorySize{32 * 1024 * 1024}));
+
+static opt<bool> JITPerfMap(
+    "jit-perf-map",
+    llvm::cl::desc("describe JIT compiled code in /tmp/perf-<pid>.map"),
+    llvm::cl::init(false));
+
+static opt<bool> JITPerfDump(
+    "jit-perf-dump",
+    llvm::cl::desc(
+        "describe JIT compiled code in /tmp/jit-<pid>.dump for perf inject"),
     llvm::cl::init(false));
 
 static opt<bool> JITCrashOnError(
@@ -103,6 +137,7 @@ static int executeHBCBytecodeFromCL(
                   .withInitHeapSize(cl::InitHeapSize.bytes)
                   .withMaxHeapSize(cl::MaxHeapSize.bytes)
                   .withOccupancyTarget(cl::OccupancyTarget)
+                  .withNumGCWorkerThreads(cl::GCNumWorkerThreads)
                   .withSanitizeConfig(
                       vm::GCSanitizeConfig::Builder()
                           .withSanitizeRate(cl::GCSanitizeRate)
@@ -115,6 +150,12 @@ static int executeHBCBytecodeFromCL(
                   .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
                   .build())
           .withEnableJIT(cl::DumpJITCode || cl::EnableJIT)
+          .withJITCallThreshold(cl::DumpJITCode ? 0 : cl::JITCallThreshold)
+          .withJITLoopThreshold(cl::JITLoopThreshold)
+          .withJITBackgroundCompile(cl::JITBackground)
+          .withJITMaxMemory(cl::JITMaxMemory.bytes)
+          .withJITPerfMap(cl::JITPerfMap)
+          .withJITPerfDump(cl::JITPerfDump)
           .withEnableEval(cl::EnableEval)
           .withVerifyEvalIR(cl::VerifyIR)
           .withVMExperimentFlags(cl::VMExperimentFlags)
@@ -123,6 +164,7 @@ static int executeHBCBytecodeFromCL(
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withLazyIdentifiers(cl::LazyIdentifiers)
           .withEnableHermesInternal(cl::EnableHermesInternal)
           .withEnableHermesInternalTestMethods(
               cl::EnableHermesInternalTestMethods)
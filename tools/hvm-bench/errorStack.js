@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 200;
+  var depth = 100;
+  var numStatements = 2000;
+
+  // Build a long function, like the module factories of a bundle, so that
+  // each frame has many source locations before the one of its call.
+  var body = ['x = x | 0;'];
+  for (var i = 0; i < numStatements; i++) {
+    body.push('x = (x + ' + i + ') * 3 % 1000;');
+  }
+  body.push('return n === 0 ? symbolicate() : recurse(n - 1, x);');
+  var recurse = Function('symbolicate', 'return function recurse(n, x) {' +
+      body.join('\n') + '};')(symbolicate);
+
+  function symbolicate() {
+    var length = 0;
+    for (var i = 0; i < numIter; i++) {
+      length += new Error('deep').stack.length;
+    }
+    return length;
+  }
+
+  recurse(depth, 0);
+  print('done');
+})();
@@ -208,8 +208,8 @@ int main(int argc, char **argv) {
   llvm::outs()
       << StringPrimitive::createStringView(runtime.get(), res).getUTF16Ref(tmp)
       << "\n";
-#ifdef HERMESVM_OPCODE_STATS
-  Runtime::dumpOpcodeStats(llvm::outs());
+#ifdef HERMESVM_PROFILER_OPCODE
+  runtime->dumpOpcodeStats(llvm::outs());
 #endif
   return 0;
 }
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 200;
+  var len = 1000;
+  var keys = Array(len);
+  for (var i = 0; i < len; i++) {
+    keys[i] = 'k' + i;
+  }
+
+  for (var i = 0; i < numIter; i++) {
+    var m = new Map();
+    var s = new Set();
+    for (var j = 0; j < len; j++) {
+      m.set(keys[j], j);
+      s.add(j);
+    }
+    for (var j = 0; j < len; j++) {
+      m.get(keys[j]);
+      s.has(j);
+    }
+    // Delete every other entry, then iterate over the survivors.
+    for (var j = 0; j < len; j += 2) {
+      m.delete(keys[j]);
+      s.delete(j);
+    }
+    m.forEach(function(v, k) {});
+    for (var v of s) {
+    }
+  }
+
+  print('done');
+})();
@@ -109,6 +109,7 @@ int main(int argc, char **argv) {
               vm::GCConfig::Builder()
                   .withInitHeapSize(cl::InitHeapSize.bytes)
                   .withMaxHeapSize(cl::MaxHeapSize.bytes)
+                  .withNumGCWorkerThreads(cl::GCNumWorkerThreads)
                   .withSanitizeConfig(
                       vm::GCSanitizeConfig::Builder()
                           .withSanitizeRate(cl::GCSanitizeRate)
@@ -123,6 +124,7 @@ int main(int argc, char **argv) {
           .withES6Proxy(cl::ES6Proxy)
           .withES6Symbol(cl::ES6Symbol)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withLazyIdentifiers(cl::LazyIdentifiers)
           .withEnableHermesInternal(cl::EnableHermesInternal)
           .withEnableHermesInternalTestMethods(
               cl::EnableHermesInternalTestMethods)
@@ -9,22 +9,14 @@
 #include <hermes/CompileJS.h>
 #include <hermes/hermes.h>
 
-using namespace facebook::jsi;
-using namespace facebook::hermes;
+#include "HermesTestHelper.h"
 
-struct HermesTestHelper {
-  static size_t rootsListLength(const HermesRuntime &rt) {
-    return rt.rootsListLength();
-  }
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
-  static int64_t calculateRootsListChange(
-      const HermesRuntime &rt,
-      std::function<void(void)> f) {
-    auto before = rootsListLength(rt);
-    f();
-    return rootsListLength(rt) - before;
-  }
-};
+using namespace facebook::jsi;
+using namespace facebook::hermes;
 
 namespace {
 
@@ -143,6 +135,121 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptInvalidSourceThrows) {
   EXPECT_TRUE(caught) << "prepareJavaScript should have thrown an exception";
 }
 
+TEST(HermesRuntimeBytecodeCacheTest, PreparedJavaScriptCacheTest) {
+  llvm::SmallString<128> prefix;
+  llvm::sys::path::system_temp_directory(true, prefix);
+  llvm::sys::path::append(prefix, "hermes-bc-cache");
+  llvm::SmallString<128> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(prefix, dir));
+  auto config = ::hermes::vm::RuntimeConfig::Builder()
+                    .withBytecodeCacheDir(dir.str())
+                    .build();
+  const char *source = "var q = (typeof q === 'number' ? q : 0) + 1; q";
+  const char *source2 = "var q = (typeof q === 'number' ? q : 0) + 2; q";
+
+  // Run \p src in a new runtime, and return its result and the number of
+  // bytecode cache hits and misses.
+  auto run = [&config](const char *src) {
+    auto rt = makeHermesRuntime(config);
+    auto prep = rt->prepareJavaScript(std::make_unique<StringBuffer>(src), "");
+    double res = rt->evaluatePreparedJavaScript(prep).getNumber();
+    res = rt->evaluatePreparedJavaScript(prep).getNumber() * 10 + res;
+    auto stats = rt->global()
+                     .getPropertyAsObject(*rt, "HermesInternal")
+                     .getPropertyAsFunction(*rt, "getInstrumentedStats")
+                     .call(*rt)
+                     .getObject(*rt);
+    EXPECT_EQ(
+        1, stats.getProperty(*rt, "js_compileJSCount").getNumber() +
+            stats.getProperty(*rt, "js_bytecodeCacheHits").getNumber());
+    return std::make_tuple(
+        res,
+        stats.getProperty(*rt, "js_bytecodeCacheHits").getNumber(),
+        stats.getProperty(*rt, "js_bytecodeCacheMisses").getNumber());
+  };
+
+  // The first run compiles the source and caches the bytecode, which the
+  // second one loads.
+  EXPECT_EQ(std::make_tuple(21.0, 0.0, 1.0), run(source));
+  EXPECT_EQ(std::make_tuple(21.0, 1.0, 0.0), run(source));
+  // Different source has a different key.
+  EXPECT_EQ(std::make_tuple(42.0, 0.0, 1.0), run(source2));
+  EXPECT_EQ(std::make_tuple(42.0, 1.0, 0.0), run(source2));
+
+  // Invalid files in the cache are ignored and replaced.
+  std::error_code EC;
+  int numFiles = 0;
+  for (llvm::sys::fs::directory_iterator it{dir, EC}, end; it != end && !EC;
+       it.increment(EC)) {
+    llvm::raw_fd_ostream OS{it->path(), EC, llvm::sys::fs::F_None};
+    OS << "garbage";
+    ++numFiles;
+  }
+  EXPECT_EQ(2, numFiles);
+  EXPECT_EQ(std::make_tuple(21.0, 0.0, 1.0), run(source));
+  EXPECT_EQ(std::make_tuple(21.0, 1.0, 0.0), run(source));
+
+  llvm::sys::fs::remove_directories(dir);
+}
+
+TEST_F(HermesRuntimeTest, CreateValueFromJsonUtf8Test) {
+  auto parse = [this](const std::string &json) {
+    return Value::createFromJsonUtf8(
+        *rt, reinterpret_cast<const uint8_t *>(json.data()), json.size());
+  };
+  auto toJSON = [this](const Value &value) {
+    return rt->global()
+        .getPropertyAsObject(*rt, "JSON")
+        .getPropertyAsFunction(*rt, "stringify")
+        .call(*rt, value)
+        .getString(*rt)
+        .utf8(*rt);
+  };
+
+  EXPECT_EQ(
+      R"({"0":{"b":"x"},"a":[1,-2.5,true,null],"c":{"b":"y"}})",
+      toJSON(parse(R"( {"a": [1, -25e-1, true, null], "0": {"b": "x"},)"
+                   R"( "c": {"b": "y"}} )")));
+  // Objects which start like the previous one and then differ.
+  EXPECT_EQ(
+      R"([{"a":1,"ab":2},{"ab":3,"a":4},{"a":6},{"a":7,"ab":8,"c":9}])",
+      toJSON(parse(R"([{"a":1,"ab":2},{"ab":3,"a":4},{"a":5,"a":6},)"
+                   R"({"a":7,"ab":8,"c":9}])")));
+  // Non-ASCII characters, in keys and values, and escapes.
+  EXPECT_EQ(
+      u8"{\"caf\u00e9\":\"\u00e9\u4e2d\U0001F600\",\"k\":\"\\n\u00e9\"}",
+      toJSON(parse(u8"{\"caf\u00e9\": \"\u00e9\u4e2d\U0001F600\","
+                   u8" \"k\": \"\\n\\u00e9\"}")));
+  eval("function check(o) { return o['caf\\u00e9'] === 1 && o.k === 'a'; }");
+  EXPECT_TRUE(rt->global()
+                  .getPropertyAsFunction(*rt, "check")
+                  .call(*rt, parse(u8"{\"caf\u00e9\": 1, \"k\": \"a\"}"))
+                  .getBool());
+  // Invalid UTF-8 is replaced with U+FFFD.
+  EXPECT_EQ(
+      u8"[\"a\uFFFDb\",\"\uFFFD\"]", toJSON(parse("[\"a\xff"
+                                          "b\", \"\xe4\"]")));
+
+  EXPECT_THROW(parse("{\"a\": 1,}"), JSIException);
+  EXPECT_THROW(parse("[\"\xc3\xa9"), JSIException);
+  EXPECT_THROW(parse("\xc3\xa9"), JSIException);
+
+  // Larger inputs give the same result as JSON.parse.
+  std::string records = "[";
+  for (int i = 0; i < 5000; ++i) {
+    std::string id = std::to_string(i);
+    records += (i ? ",{\"id\":" : "{\"id\":") + id + ",\"name\":\"user" + id +
+        "\",\"score\":" + id + ".25,\"tags\":[\"alpha\",\"beta\"]," +
+        "\"city\":\"Z\xc3\xbcrich\",\"note\":\"a\\nb\",\"parent\":null}";
+  }
+  records += ']';
+  Value viaString = rt->global()
+                        .getPropertyAsObject(*rt, "JSON")
+                        .getPropertyAsFunction(*rt, "parse")
+                        .call(*rt, String::createFromUtf8(*rt, records));
+  EXPECT_EQ(toJSON(viaString), toJSON(parse(records)));
+}
+
 TEST_F(HermesRuntimeTest, NoCorruptionOnJSError) {
   // If the test crashes or infinite loops, the likely cause is that
   // Hermes API library is not built with proper compiler flags
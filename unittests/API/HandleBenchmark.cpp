@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <hermes/hermes.h>
+#include <jsi/instrumentation.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "HermesTestHelper.h"
+
+using namespace facebook::jsi;
+using namespace facebook::hermes;
+
+namespace {
+
+/// Microbenchmarks of the handles the runtime hands out to JSI, which record
+/// their timings as test properties.
+class HandleBenchmark : public ::testing::Test {
+ public:
+  HandleBenchmark() : rt(makeHermesRuntime()) {}
+
+ protected:
+  /// \return the time it takes to run \p f, in nanoseconds.
+  template <typename F>
+  static double timeNs(const F &f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  std::shared_ptr<HermesRuntime> rt;
+};
+
+/// Create and release handles, with a varying number of other handles alive.
+TEST_F(HandleBenchmark, DISABLED_Churn) {
+  constexpr int kIterations = 1000000;
+  std::vector<Object> live;
+  for (size_t numLive : {0, 1000, 100000}) {
+    while (live.size() < numLive)
+      live.push_back(Object(*rt));
+
+    double ns = timeNs([&] {
+      for (int i = 0; i < kIterations; ++i) {
+        Object object = rt->global();
+        (void)object;
+      }
+    });
+    RecordProperty(
+        "ns_per_handle_" + std::to_string(numLive) + "_live",
+        (int)(ns / kIterations));
+
+    // The released handles are reused.
+    EXPECT_LT(HermesTestHelper::rootsListLength(*rt), numLive + 2048);
+  }
+}
+
+/// Create and release handles in scopes.
+TEST_F(HandleBenchmark, DISABLED_ScopeChurn) {
+  constexpr int kIterations = 100000;
+  constexpr int kPerScope = 10;
+  auto before = HermesTestHelper::rootsListLength(*rt);
+  double ns = timeNs([&] {
+    for (int i = 0; i < kIterations; ++i) {
+      Scope scope{*rt};
+      for (int j = 0; j < kPerScope; ++j) {
+        Object object = rt->global();
+        (void)object;
+      }
+    }
+  });
+  RecordProperty("ns_per_handle", (int)(ns / (kIterations * kPerScope)));
+  EXPECT_EQ(before, HermesTestHelper::rootsListLength(*rt));
+}
+
+/// Collect garbage with a varying number of handles alive, which the GC scans
+/// as roots. The handles all refer to the global object, so that the time is
+/// spent scanning the roots rather than marking the heap.
+TEST_F(HandleBenchmark, DISABLED_RootScan) {
+  constexpr int kCollections = 10;
+  std::vector<Object> live;
+  for (size_t numLive : {0, 100000, 1000000}) {
+    // Interleave the live handles with released ones.
+    std::vector<Object> released;
+    while (live.size() < numLive) {
+      live.push_back(rt->global());
+      released.push_back(rt->global());
+    }
+    released.clear();
+
+    double ns = timeNs([&] {
+      for (int i = 0; i < kCollections; ++i)
+        rt->instrumentation().collectGarbage();
+    });
+    RecordProperty(
+        "us_per_gc_" + std::to_string(numLive) + "_live",
+        (int)(ns / kCollections / 1e3));
+  }
+}
+
+} // namespace
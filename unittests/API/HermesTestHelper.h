@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_UNITTESTS_API_HERMESTESTHELPER_H
+#define HERMES_UNITTESTS_API_HERMESTESTHELPER_H
+
+#include <hermes/hermes.h>
+
+#include <functional>
+
+/// Gives the tests access to the internals of HermesRuntime, of which it is a
+/// friend.
+struct HermesTestHelper {
+  static size_t rootsListLength(const facebook::hermes::HermesRuntime &rt) {
+    return rt.rootsListLength();
+  }
+
+  static int64_t calculateRootsListChange(
+      const facebook::hermes::HermesRuntime &rt,
+      std::function<void(void)> f) {
+    auto before = rootsListLength(rt);
+    f();
+    return rootsListLength(rt) - before;
+  }
+};
+
+#endif // HERMES_UNITTESTS_API_HERMESTESTHELPER_H
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+#include <hermes/hermes.h>
+#include <jsi/instrumentation.h>
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+
+using namespace facebook::jsi;
+using namespace facebook::hermes;
+
+namespace {
+
+/// Compares parsing JSON from a UTF-8 buffer with createFromJsonUtf8, which
+/// builds the values directly from the buffer, against first creating a JS
+/// string from it and passing that to JSON.parse. It is disabled by default:
+/// run it with --gtest_also_run_disabled_tests, and find the best time of each
+/// in the properties of the test in --gtest_output.
+class JSONBenchmark : public ::testing::Test {
+ public:
+  // Start with a heap large enough for the biggest payload, so that growing
+  // it doesn't add to the time of the first runs.
+  JSONBenchmark()
+      : rt(makeHermesRuntime(
+            ::hermes::vm::RuntimeConfig::Builder()
+                .withGCConfig(::hermes::vm::GCConfig::Builder()
+                                  .withInitHeapSize(1 << 30)
+                                  .withMaxHeapSize(1 << 30)
+                                  .build())
+                .build())) {}
+
+ protected:
+  /// \return the CPU time it takes to run \p f, in milliseconds. It is less
+  /// sensitive than the wall time to other load on the machine.
+  template <typename F>
+  static double timeMs(const F &f) {
+    auto start = std::clock();
+    f();
+    return (std::clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+  }
+
+  /// \return a JSON array of records, of about \p size bytes.
+  static std::string makePayload(size_t size) {
+    std::string json = "[";
+    for (size_t numRecords = 0; json.size() < size; ++numRecords) {
+      if (numRecords)
+        json += ',';
+      std::string id = std::to_string(numRecords);
+      json += "{\"id\":" + id + ",\"name\":\"user" + id +
+          "\",\"score\":" + std::to_string(numRecords % 1000) +
+          ".25,\"active\":" + (numRecords % 2 ? "true" : "false") +
+          ",\"tags\":[\"alpha\",\"beta\"],\"city\":\"Z\xc3\xbcrich\"," +
+          "\"note\":\"line\\nbreak\",\"parent\":null}";
+    }
+    json += ']';
+    return json;
+  }
+
+  std::shared_ptr<HermesRuntime> rt;
+};
+
+TEST_F(JSONBenchmark, DISABLED_CreateFromJsonUtf8) {
+  Function parse = rt->global()
+                       .getPropertyAsObject(*rt, "JSON")
+                       .getPropertyAsFunction(*rt, "parse");
+  for (size_t mb : {1, 10, 50}) {
+    std::string json = makePayload(mb << 20);
+    auto *data = reinterpret_cast<const uint8_t *>(json.data());
+
+    // The time is dominated by allocation, and varies a lot from run to run,
+    // so collect garbage before each run, and keep the best of several.
+    constexpr int kRuns = 5;
+    double directMs = 1e9;
+    double viaStringMs = 1e9;
+    for (int i = 0; i < kRuns; ++i) {
+      rt->instrumentation().collectGarbage();
+      directMs = std::min(directMs, timeMs([&] {
+        Value::createFromJsonUtf8(*rt, data, json.size());
+      }));
+      rt->instrumentation().collectGarbage();
+      viaStringMs = std::min(viaStringMs, timeMs([&] {
+        parse.call(*rt, String::createFromUtf8(*rt, data, json.size()));
+      }));
+    }
+    std::string size = std::to_string(mb) + "MB";
+    RecordProperty("createFromJsonUtf8_ms_" + size, (int)directMs);
+    RecordProperty("JSON.parse_ms_" + size, (int)viaStringMs);
+  }
+}
+
+} // namespace
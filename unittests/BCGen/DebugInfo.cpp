@@ -163,4 +163,46 @@ TEST(DebugInfo, TestGetAddress) {
   EXPECT_EQ(3u, result->functionIndex);
   EXPECT_EQ(2u, result->bytecodeOffset);
 }
+
+TEST(DebugInfo, TestLongFunction) {
+  // Lookups in a function long enough to be indexed must find the same
+  // locations as a decode from its start, in any order.
+  auto dbg = makeGenerator();
+  std::vector<Loc> locs;
+  for (uint32_t i = 0; i < 500; ++i) {
+    // Every third instruction shares its address with the previous one.
+    uint32_t address = i % 3 == 2 ? locs.back().address : 2 * i;
+    locs.push_back(Loc{address, i < 250 ? 1u : 2u, i + 2, i % 7 + 1, i / 4});
+  }
+  auto offset = dbg.appendSourceLocations(Loc{0, 1, 1, 1, 0}, 0, locs);
+  auto shortOffset = dbg.appendSourceLocations(
+      Loc{0, 1, 1, 1, 0}, 1, {Loc{0, 1, 5, 1, 1}, Loc{4, 1, 6, 2, 1}});
+  DebugInfo info = dbg.serializeWithMove();
+
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint32_t n = 0; n < 500; ++n) {
+      // Visit the locations out of order.
+      uint32_t i = (n * 191) % 500;
+      // The last location at an address wins.
+      uint32_t last = i;
+      while (last + 1 < locs.size() &&
+             locs[last + 1].address == locs[i].address) {
+        ++last;
+      }
+      const Loc &expected = locs[last];
+      for (uint32_t delta = 0; delta < 2; ++delta) {
+        checkAddress(
+            &info,
+            offset,
+            expected.address + delta,
+            expected.filenameId,
+            expected.line,
+            expected.column,
+            expected.statement);
+      }
+    }
+    checkAddress(&info, shortOffset, 2, 1, 5, 1, 1);
+    checkAddress(&info, shortOffset, 7, 1, 6, 2, 1);
+  }
+}
 } // end anonymous namespace
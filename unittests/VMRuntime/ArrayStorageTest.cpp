@@ -107,6 +107,8 @@ TEST_F(ArrayStorageTest, PushBackTest) {
   ASSERT_EQ(5.0_hd, st->at(4));
 }
 
+#ifndef HERMESVM_GC_HADES
+// Hades does not move old-gen cells, so it never trims them.
 TEST_F(ArrayStorageTest, AllowTrimming) {
   MutableHandle<ArrayStorage> st(runtime);
   constexpr ArrayStorage::size_type originalCapacity = 4;
@@ -126,6 +128,7 @@ TEST_F(ArrayStorageTest, AllowTrimming) {
   // The array should be trimmed.
   EXPECT_EQ(st->size(), st->capacity());
 }
+#endif
 
 using ArrayStorageBigHeapTest = LargeHeapRuntimeTestFixture;
 
@@ -138,6 +138,9 @@ TEST_F(DictPropertyMapTest, CreateOverCapacityTest) {
       DictPropertyMap::create(runtime, DictPropertyMap::getMaxCapacity() + 1));
 }
 
+#ifndef HERMESVM_GC_HADES
+// A map of the maximum capacity needs a whole empty segment, which Hades can't
+// guarantee in this heap without compacting the old gen.
 TEST_F(DictPropertyMapTest, GrowOverCapacityTest) {
   // Don't do the test if it requires too many properties. Just cross our
   // fingers and hope it works.
@@ -179,4 +182,5 @@ TEST_F(DictPropertyMapTest, GrowOverCapacityTest) {
       DictPropertyMap::add(map, runtime, **symRes, desc));
   runtime->clearThrownValue();
 }
+#endif
 } // namespace
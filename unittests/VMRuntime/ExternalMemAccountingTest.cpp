@@ -27,10 +27,13 @@ MetadataTableForTests getMetadataTable() {
       cellKindsContiguousAscending(
           CellKind::UninitializedKind,
           CellKind::FillerCellKind,
+          CellKind::FreelistCellKind,
           CellKind::DynamicUTF16StringPrimitiveKind,
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -39,10 +42,13 @@ MetadataTableForTests getMetadataTable() {
   static const Metadata storage[] = {
       Metadata(), // Uninitialized
       Metadata(), // FillerCell
+      Metadata(), // FreelistCell
       Metadata(), // DynamicUTF16StringPrimitive
       Metadata(), // DynamicASCIIStringPrimitive
       Metadata(), // BufferedUTF16StringPrimitive
       Metadata(), // BufferedASCIIStringPrimitive
+      Metadata(), // RopeUTF16StringPrimitive
+      Metadata(), // RopeASCIIStringPrimitive
       Metadata(), // DynamicUniquedUTF16StringPrimitive
       Metadata(), // DynamicUniquedASCIIStringPrimitive
       Metadata(), // ExternalUTF16StringPrimitive
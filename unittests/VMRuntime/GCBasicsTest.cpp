@@ -465,9 +465,19 @@ TEST(GCCallbackTest, TestCallbackInvoked) {
   auto rt =
       Runtime::create(RuntimeConfig::Builder().withGCConfig(config).build());
   rt->collect();
+#ifdef HERMESVM_GC_HADES
+  // Hades reports each of the pauses that make up a full collection.
+  ASSERT_FALSE(ev.empty());
+  ASSERT_EQ(0u, ev.size() % 2);
+  for (size_t i = 0; i < ev.size(); i += 2) {
+    EXPECT_EQ(GCEventKind::CollectionStart, ev[i]);
+    EXPECT_EQ(GCEventKind::CollectionEnd, ev[i + 1]);
+  }
+#else
   EXPECT_EQ(2, ev.size());
   EXPECT_EQ(GCEventKind::CollectionStart, ev[0]);
   EXPECT_EQ(GCEventKind::CollectionEnd, ev[1]);
+#endif
 }
 
 #ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
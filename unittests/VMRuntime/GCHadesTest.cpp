@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_HADES
+#include "gtest/gtest.h"
+
+#include "TestHelpers.h"
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/FillerCell.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCCell.h"
+
+#include <mutex>
+
+using namespace hermes::vm;
+
+namespace {
+
+/// A cell holding a single reference, used to build object graphs in the old
+/// gen.  The cell is padded to the size given on creation.
+struct Node final : public VariableSizeRuntimeCell {
+  static const VTable vt;
+  GCHermesValue ref;
+  int *numFinalized{nullptr};
+
+  Node(GC *gc, uint32_t size) : VariableSizeRuntimeCell(gc, &vt, size) {
+    ref.setNonPtr(HermesValue::encodeEmptyValue());
+  }
+
+  static void finalize(GCCell *cell, GC *) {
+    auto *self = static_cast<Node *>(cell);
+    if (self->numFinalized) {
+      ++*self->numFinalized;
+    }
+  }
+
+  static Node *create(DummyRuntime &runtime, uint32_t size = sizeof(Node)) {
+    return new (runtime.alloc</*fixedSize*/ false>(size))
+        Node(&runtime.getHeap(), size);
+  }
+
+  /// Create a Node directly in the old gen.  If \p numFinalized is given, it
+  /// is incremented when the node dies.
+  static Node *createLongLived(
+      DummyRuntime &runtime,
+      uint32_t size,
+      int *numFinalized = nullptr) {
+    Node *self = numFinalized
+        ? new (runtime.allocLongLived<HasFinalizer::Yes>(size))
+              Node(&runtime.getHeap(), size)
+        : new (runtime.allocLongLived(size)) Node(&runtime.getHeap(), size);
+    self->numFinalized = numFinalized;
+    return self;
+  }
+
+  /// Point this node at \p next, if there is one.
+  void link(GC *gc, GCCell *next) {
+    if (next) {
+      ref.set(HermesValue::encodeObjectValue(next), gc);
+    }
+  }
+
+  Node *next() const {
+    return ref.isPointer() ? static_cast<Node *>(ref.getPointer()) : nullptr;
+  }
+};
+
+const VTable Node::vt{CellKind::UninitializedKind, 0, Node::finalize};
+
+void NodeBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  mb.addField(&static_cast<const Node *>(cell)->ref);
+}
+
+MetadataTableForTests getMetadataTable() {
+  static_assert(
+      cellKindsContiguousAscending(
+          CellKind::UninitializedKind,
+          CellKind::FillerCellKind,
+          CellKind::FreelistCellKind),
+      "Cell kinds in unexpected order");
+  static const Metadata storage[] = {
+      buildMetadata(CellKind::UninitializedKind, NodeBuildMeta),
+      Metadata(), // FillerCell
+      Metadata(), // FreelistCell
+  };
+  return MetadataTableForTests(storage);
+}
+
+/// Big enough to go straight to the old gen.
+constexpr uint32_t kNodeSize = 1024;
+
+class GCHadesTest : public ::testing::Test {
+ public:
+  /// The heap has room for a few old gen segments, so that collecting the
+  /// young gen doesn't have to wait for the old gen collection to finish.
+  GCHadesTest()
+      : runtime(DummyRuntime::create(getMetadataTable(), kTestGCConfigLarge)),
+        rt(*runtime),
+        gc(rt.gc) {}
+
+ protected:
+  /// \return the phase of the old gen collection, which is owned by the
+  /// background thread while it runs.
+  GC::Phase phase() {
+    std::lock_guard<std::mutex> lk{gc.gcMutex_};
+    return gc.phase_;
+  }
+
+  /// \return true if \p cell is still allocated in the old gen.
+  bool isLive(const GCCell *cell) {
+    std::lock_guard<std::mutex> lk{gc.gcMutex_};
+    return gc.isOldGenCellStart(cell);
+  }
+
+  std::shared_ptr<DummyRuntime> runtime;
+  DummyRuntime &rt;
+  GC &gc;
+};
+
+TEST_F(GCHadesTest, InsertionBarrierKeepsStoredCellAlive) {
+  GCCell *holder = Node::createLongLived(rt, kNodeSize);
+  rt.pointerRoots.push_back(&holder);
+  // Neither is reachable when marking starts.
+  Node *stored = Node::createLongLived(rt, kNodeSize);
+  Node *garbage = Node::createLongLived(rt, kNodeSize);
+
+  {
+    std::lock_guard<std::mutex> lk{gc.gcMutex_};
+    gc.startOldGenCollection();
+  }
+  // The holder may have been scanned already: only the barrier can tell the
+  // marker about the new reference.
+  static_cast<Node *>(holder)->link(&gc, stored);
+  {
+    std::lock_guard<std::mutex> lk{gc.gcMutex_};
+    gc.finishOldGenCollection();
+  }
+
+  EXPECT_EQ(GC::Phase::None, phase());
+  EXPECT_TRUE(isLive(holder));
+  EXPECT_TRUE(isLive(stored));
+  EXPECT_FALSE(isLive(garbage));
+  EXPECT_EQ(stored, static_cast<Node *>(holder)->next());
+}
+
+TEST_F(GCHadesTest, ConcurrentCollectionWithMutatorAllocation) {
+  constexpr int kNumNodes = 100;
+  int numFinalized = 0;
+  // A list of live nodes, interleaved with garbage.
+  GCCell *head = nullptr;
+  rt.pointerRoots.push_back(&head);
+  for (int i = 0; i < kNumNodes; ++i) {
+    Node *node = Node::createLongLived(rt, kNodeSize);
+    node->link(&gc, head);
+    head = node;
+    Node::createLongLived(rt, kNodeSize, &numFinalized);
+  }
+
+  {
+    std::lock_guard<std::mutex> lk{gc.gcMutex_};
+    gc.startOldGenCollection();
+  }
+  // Keep allocating while the background thread marks and sweeps.  Young gen
+  // collections let the collection move from marking to sweeping.
+  int numAdded = 0;
+  for (size_t i = 0; i < (1u << 24) && phase() != GC::Phase::None; ++i) {
+    Node::create(rt, 64);
+    if (numAdded < kNumNodes && i % 64 == 0) {
+      // Allocated black, and linked in after the list may have been marked.
+      Node *node = Node::createLongLived(rt, kNodeSize);
+      node->link(&gc, head);
+      head = node;
+      ++numAdded;
+    }
+  }
+  ASSERT_EQ(GC::Phase::None, phase());
+  EXPECT_EQ(1u, gc.numConcurrentOGCollections_);
+
+  EXPECT_EQ(kNumNodes, numFinalized);
+  int length = 0;
+  for (Node *node = static_cast<Node *>(head); node; node = node->next()) {
+    EXPECT_TRUE(isLive(node));
+    ++length;
+  }
+  EXPECT_EQ(kNumNodes + numAdded, length);
+}
+
+TEST_F(GCHadesTest, FreelistSplitsAndCoalesces) {
+  GCCell *cells[4];
+  for (GCCell *&cell : cells) {
+    cell = Node::createLongLived(rt, kNodeSize);
+  }
+  ASSERT_EQ(1u, gc.oldGen_.size());
+  // The cells are carved one after the other from the end of the free space of
+  // the segment.
+  auto *base = reinterpret_cast<char *>(cells[3]);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(base + (3 - i) * kNodeSize, reinterpret_cast<char *>(cells[i]));
+  }
+
+  // Only the outer two survive, and the middle ones are merged into one free
+  // cell.
+  rt.pointerRoots.push_back(&cells[0]);
+  rt.pointerRoots.push_back(&cells[3]);
+  gc.collect();
+  char *freed = reinterpret_cast<char *>(cells[2]);
+  auto *freeCell = reinterpret_cast<GCCell *>(freed);
+  ASSERT_TRUE(FreelistCell::classof(freeCell));
+  EXPECT_EQ(2 * kNodeSize, freeCell->getAllocatedSize());
+
+  // A smaller allocation takes the end of the merged cell, leaving the rest on
+  // a freelist.
+  Node *tail = Node::createLongLived(rt, kNodeSize);
+  EXPECT_EQ(freed + kNodeSize, reinterpret_cast<char *>(tail));
+  ASSERT_TRUE(FreelistCell::classof(freeCell));
+  EXPECT_EQ(kNodeSize, freeCell->getAllocatedSize());
+  // Which an allocation of the same size then uses up.
+  Node *front = Node::createLongLived(rt, kNodeSize);
+  EXPECT_EQ(freed, reinterpret_cast<char *>(front));
+  EXPECT_EQ(1u, gc.oldGen_.size());
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_HADES
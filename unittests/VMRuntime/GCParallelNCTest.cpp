@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+
+#include "hermes/VM/GCWorkerPool.h"
+
+#include "TestHelpers.h"
+#include "gtest/gtest.h"
+#include "hermes/VM/ArrayStorage.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+TEST(GCWorkerPoolTest, RunsEveryWorkerOnce) {
+  GCWorkerPool pool{3};
+  ASSERT_EQ(4u, pool.numWorkers());
+  for (int round = 0; round < 10; ++round) {
+    std::vector<std::atomic<int>> calls(pool.numWorkers());
+    pool.runOnAllWorkers([&calls](unsigned worker) { ++calls[worker]; });
+    for (auto &count : calls) {
+      EXPECT_EQ(1, count.load());
+    }
+  }
+}
+
+TEST(GCWorkerPoolTest, RunsEveryTaskOnce) {
+  GCWorkerPool pool{2};
+  constexpr size_t kNumTasks = 1000;
+  std::vector<std::atomic<int>> calls(kNumTasks);
+  pool.forEachTask(kNumTasks, [&calls](size_t task, unsigned) {
+    ++calls[task];
+  });
+  for (auto &count : calls) {
+    EXPECT_EQ(1, count.load());
+  }
+}
+
+TEST(GCWorkerPoolTest, NoThreads) {
+  GCWorkerPool pool{0};
+  ASSERT_EQ(1u, pool.numWorkers());
+  size_t sum = 0;
+  pool.forEachTask(10, [&sum](size_t task, unsigned worker) {
+    EXPECT_EQ(0u, worker);
+    sum += task;
+  });
+  EXPECT_EQ(45u, sum);
+}
+
+class GCParallelNCTest : public RuntimeTestFixtureBase {
+ public:
+  GCParallelNCTest()
+      : RuntimeTestFixtureBase(
+            RuntimeConfig::Builder()
+                .withGCConfig(GCConfig::Builder(kTestGCConfigBuilder)
+                                  .withInitHeapSize(1 << 20)
+                                  .withMaxHeapSize(64 << 20)
+                                  .withNumGCWorkerThreads(3)
+                                  .build())
+                .build()) {}
+};
+
+/// Build a graph that spans several segments, with garbage in between the
+/// live cells, and check that it survives full collections intact.
+TEST_F(GCParallelNCTest, FullCollectionPreservesGraph) {
+  constexpr ArrayStorage::size_type kNumNodes = 40000;
+  auto outerRes = ArrayStorage::create(runtime, kNumNodes);
+  ASSERT_FALSE(isException(outerRes));
+  MutableHandle<ArrayStorage> outer{runtime, vmcast<ArrayStorage>(*outerRes)};
+  MutableHandle<ArrayStorage> node{runtime};
+  MutableHandle<> prev{runtime, HermesValue::encodeNullValue()};
+
+  for (ArrayStorage::size_type i = 0; i < kNumNodes; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    // Garbage, so that the live nodes have to be moved.
+    ASSERT_FALSE(isException(ArrayStorage::create(runtime, 8)));
+
+    auto nodeRes = ArrayStorage::create(runtime, 2);
+    ASSERT_FALSE(isException(nodeRes));
+    node = vmcast<ArrayStorage>(*nodeRes);
+    ASSERT_FALSE(isException(ArrayStorage::push_back(
+        node, runtime, runtime->makeHandle(HermesValue::encodeNumberValue(i)))));
+    ASSERT_FALSE(isException(ArrayStorage::push_back(node, runtime, prev)));
+    ASSERT_FALSE(isException(ArrayStorage::push_back(outer, runtime, node)));
+    prev = node.getHermesValue();
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    runtime->collect();
+  }
+
+  ASSERT_EQ(kNumNodes, outer->size());
+  for (ArrayStorage::size_type i = 0; i < kNumNodes; ++i) {
+    auto *cur = vmcast<ArrayStorage>(outer->at(i));
+    ASSERT_EQ(static_cast<double>(i), cur->at(0).getNumber());
+    if (i == 0) {
+      EXPECT_TRUE(cur->at(1).isNull());
+    } else {
+      EXPECT_EQ(outer->at(i - 1).getPointer(), cur->at(1).getPointer());
+    }
+  }
+}
+
+/// Hang young cells off an old-gen array, and off each other, so that the
+/// young-gen collections that promote them find them both through dirty cards
+/// and through other promoted cells.
+TEST_F(GCParallelNCTest, YoungGenCollectionPreservesGraph) {
+  constexpr ArrayStorage::size_type kNumNodes = 100000;
+  auto outerRes = ArrayStorage::create(runtime, kNumNodes);
+  ASSERT_FALSE(isException(outerRes));
+  MutableHandle<ArrayStorage> outer{runtime, vmcast<ArrayStorage>(*outerRes)};
+  // Move the array to the old gen.
+  runtime->collect();
+
+  GCBase::HeapInfo info;
+  runtime->getHeap().getHeapInfo(info);
+  const unsigned numYoungGenCollectionsBefore =
+      info.youngGenStats.numCollections;
+
+  MutableHandle<ArrayStorage> node{runtime};
+  MutableHandle<> prev{runtime, HermesValue::encodeNullValue()};
+  for (ArrayStorage::size_type i = 0; i < kNumNodes; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    ASSERT_FALSE(isException(ArrayStorage::create(runtime, 8)));
+
+    auto nodeRes = ArrayStorage::create(runtime, 2);
+    ASSERT_FALSE(isException(nodeRes));
+    node = vmcast<ArrayStorage>(*nodeRes);
+    ASSERT_FALSE(isException(ArrayStorage::push_back(
+        node, runtime, runtime->makeHandle(HermesValue::encodeNumberValue(i)))));
+    ASSERT_FALSE(isException(ArrayStorage::push_back(node, runtime, prev)));
+    ASSERT_FALSE(isException(ArrayStorage::push_back(outer, runtime, node)));
+    prev = node.getHermesValue();
+  }
+
+  runtime->getHeap().getHeapInfo(info);
+  EXPECT_LT(numYoungGenCollectionsBefore, info.youngGenStats.numCollections);
+
+  ASSERT_EQ(kNumNodes, outer->size());
+  for (ArrayStorage::size_type i = 0; i < kNumNodes; ++i) {
+    auto *cur = vmcast<ArrayStorage>(outer->at(i));
+    ASSERT_EQ(static_cast<double>(i), cur->at(0).getNumber());
+    if (i == 0) {
+      EXPECT_TRUE(cur->at(1).isNull());
+    } else {
+      EXPECT_EQ(outer->at(i - 1).getPointer(), cur->at(1).getPointer());
+    }
+  }
+}
+
+} // namespace
+
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -464,4 +464,73 @@ TEST_F(HiddenClassTest, ReservedSlots) {
   }
 }
 
+TEST_F(HiddenClassTest, PropertyCells) {
+  GCScope gcScope{runtime, "HiddenClassTest.PropertyCells", 48};
+
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+  auto cHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"c"));
+
+  MutableHandle<HiddenClass> clazz{
+      runtime,
+      vmcast<HiddenClass>(
+          runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)))};
+  for (auto sym : {*aHnd, *bHnd}) {
+    auto addRes = HiddenClass::addProperty(
+        clazz, runtime, sym, PropertyFlags::defaultNewNamedPropertyFlags());
+    ASSERT_RETURNED(addRes);
+    clazz = *addRes->first;
+  }
+  EXPECT_TRUE(clazz->canCacheWrites());
+
+  clazz = *HiddenClass::convertToPropertyCells(clazz, runtime);
+  EXPECT_TRUE(clazz->isDictionary());
+  EXPECT_TRUE(clazz->hasPropertyCells());
+  EXPECT_TRUE(clazz->canCacheWrites());
+
+  // Adding a property keeps the class and the slots of the others.
+  Handle<HiddenClass> initial = runtime->makeHandle(*clazz);
+  auto addRes = HiddenClass::addProperty(
+      clazz, runtime, *cHnd, PropertyFlags::defaultNewNamedPropertyFlags());
+  ASSERT_RETURNED(addRes);
+  EXPECT_EQ(*initial, *addRes->first);
+  EXPECT_EQ(2u, addRes->second);
+
+  // Every update and delete moves to a new class which is still cacheable.
+  NamedPropertyDescriptor desc;
+  auto found = HiddenClass::findProperty(
+      clazz, runtime, *aHnd, PropertyFlags::invalid(), desc);
+  ASSERT_TRUE(found);
+  PropertyFlags flags = desc.flags;
+  flags.writable = 0;
+  clazz = *HiddenClass::updateProperty(clazz, runtime, *found, flags);
+  EXPECT_NE(*initial, *clazz);
+  EXPECT_FALSE(clazz->isDictionaryNoCache());
+  EXPECT_TRUE(clazz->hasPropertyCells());
+
+  Handle<HiddenClass> updated = runtime->makeHandle(*clazz);
+  found = HiddenClass::findProperty(
+      clazz, runtime, *bHnd, PropertyFlags::invalid(), desc);
+  ASSERT_TRUE(found);
+  clazz = *HiddenClass::deleteProperty(clazz, runtime, *found);
+  EXPECT_NE(*updated, *clazz);
+  EXPECT_FALSE(clazz->isDictionaryNoCache());
+
+  Handle<HiddenClass> deleted = runtime->makeHandle(*clazz);
+  PropertyFlags clearFlags;
+  clearFlags.configurable = 1;
+  clazz = *HiddenClass::updatePropertyFlagsWithoutTransitions(
+      clazz, runtime, clearFlags, PropertyFlags{}, llvm::None);
+  EXPECT_NE(*deleted, *clazz);
+  EXPECT_FALSE(clazz->isDictionaryNoCache());
+
+  // The remaining property kept its slot.
+  ASSERT_TRUE(HiddenClass::findProperty(
+      clazz, runtime, *cHnd, PropertyFlags::invalid(), desc));
+  EXPECT_EQ(2u, desc.slot);
+}
+
 } // namespace
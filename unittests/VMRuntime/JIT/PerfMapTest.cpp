@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+#include <unistd.h>
+
+using namespace hermes::vm;
+
+namespace {
+
+static std::string readFile(const std::string &path) {
+  auto buf = llvm::MemoryBuffer::getFile(path);
+  return buf ? (*buf)->getBuffer().str() : std::string{};
+}
+
+static std::string perfMapPath() {
+  return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+}
+
+static std::string jitDumpPath() {
+  return "/tmp/jit-" + std::to_string(getpid()) + ".dump";
+}
+
+TEST(PerfMapTest, PerfMap) {
+  auto *code = reinterpret_cast<const uint8_t *>(0x1000);
+  {
+    JITPerfMap map{true, false};
+    ASSERT_TRUE(map.isEnabled());
+    map.addCode(code, 0x20, "JS:foo");
+    map.addCode(code + 0x100, 0x8, "JS:bar (a.js:1:2)");
+    EXPECT_EQ(
+        "1000 20 JS:foo\n"
+        "1100 8 JS:bar (a.js:1:2)\n",
+        readFile(perfMapPath()));
+
+    // The maps of other runtimes write to the same file.
+    {
+      JITPerfMap other{true, false};
+      ASSERT_TRUE(other.isEnabled());
+      other.addCode(code + 0x200, 0x10, "JS:baz");
+    }
+
+    // New code at the same addresses is described after the old entries.
+    map.addCode(code, 0x10, "JS:qux");
+    EXPECT_EQ(
+        "1000 20 JS:foo\n"
+        "1100 8 JS:bar (a.js:1:2)\n"
+        "1200 10 JS:baz\n"
+        "1000 10 JS:qux\n",
+        readFile(perfMapPath()));
+  }
+  // The map outlives the process, and later runtimes append to it.
+  {
+    JITPerfMap map{true, false};
+    map.addCode(code + 0x300, 0x4, "JS:quux");
+  }
+  EXPECT_EQ(
+      "1000 20 JS:foo\n"
+      "1100 8 JS:bar (a.js:1:2)\n"
+      "1200 10 JS:baz\n"
+      "1000 10 JS:qux\n"
+      "1300 4 JS:quux\n",
+      readFile(perfMapPath()));
+  ::unlink(perfMapPath().c_str());
+}
+
+TEST(PerfMapTest, JITDump) {
+  static const uint8_t code[] = {0x90, 0xc3};
+  {
+    JITPerfMap map{false, true};
+    ASSERT_TRUE(map.isEnabled());
+    map.addCode(code, sizeof(code), "JS:foo");
+    // The maps of other runtimes write to the same file.
+    JITPerfMap other{false, true};
+    other.addCode(code, sizeof(code), "JS:bar");
+  }
+
+  std::string dump = readFile(jitDumpPath());
+  // A 40 byte header, two code load records with the name and the code, and
+  // a close record once the last map is destroyed.
+  const size_t loadSize = 56 + sizeof("JS:foo") + sizeof(code);
+  ASSERT_EQ(40 + 2 * loadSize + 16, dump.size());
+  auto word = [&dump](size_t offset) {
+    uint32_t res;
+    memcpy(&res, dump.data() + offset, sizeof(res));
+    return res;
+  };
+  auto dword = [&dump](size_t offset) {
+    uint64_t res;
+    memcpy(&res, dump.data() + offset, sizeof(res));
+    return res;
+  };
+
+  EXPECT_EQ(0x4A695444u, word(0));
+  EXPECT_EQ(1u, word(4));
+  EXPECT_EQ(40u, word(8));
+  EXPECT_EQ((uint32_t)getpid(), word(20));
+
+  // JIT_CODE_LOAD.
+  EXPECT_EQ(0u, word(40));
+  EXPECT_EQ(loadSize, word(44));
+  EXPECT_EQ((uint32_t)getpid(), word(56));
+  EXPECT_EQ((uint64_t)code, dword(64));
+  EXPECT_EQ((uint64_t)code, dword(72));
+  EXPECT_EQ(sizeof(code), dword(80));
+  uint64_t codeIndex = dword(88);
+  EXPECT_STREQ("JS:foo", dump.data() + 96);
+  EXPECT_EQ(0, memcmp(code, dump.data() + 96 + sizeof("JS:foo"), sizeof(code)));
+
+  // The second JIT_CODE_LOAD, with the next code index.
+  const size_t second = 40 + loadSize;
+  EXPECT_EQ(0u, word(second));
+  EXPECT_EQ(codeIndex + 1, dword(second + 48));
+  EXPECT_STREQ("JS:bar", dump.data() + second + 56);
+
+  // JIT_CODE_CLOSE.
+  EXPECT_EQ(3u, word(40 + 2 * loadSize));
+  EXPECT_EQ(16u, word(40 + 2 * loadSize + 4));
+  ::unlink(jitDumpPath().c_str());
+}
+
+} // namespace
@@ -345,6 +345,10 @@ TEST(x86_64_EmitterTest, Test) {
   CHECK("48 21 c3                      andq %rax, %rbx");
   emitter.andRmToReg<S::Q, 2>(Reg::rax, Reg::rdx, 10, Reg::rbx);
   CHECK("48 23 5c 50 0a                andq 10(%rax,%rdx,2), %rbx");
+  emitter.addRmToReg<S::Q, 2>(Reg::rax, Reg::rdx, 10, Reg::rbx);
+  CHECK("48 03 5c 50 0a                addq 10(%rax,%rdx,2), %rbx");
+  emitter.shlImm8ToReg(16, Reg::rax);
+  CHECK("48 c1 e0 10                   shlq $16, %rax");
   emitter.cmpRegToReg<S::Q>(Reg::rax, Reg::rbx);
   CHECK("48 3b d8                      cmpq %rax, %rbx");
   emitter.cmpRmToReg<S::Q, 2>(Reg::rax, Reg::rdx, 10, Reg::rbx);
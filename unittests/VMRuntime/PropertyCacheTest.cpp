@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/PropertyCache.h"
+
+#include "TestHelpers.h"
+#include "gtest/gtest.h"
+#include "hermes/VM/JSArray.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using PropertyCacheTest = RuntimeTestFixture;
+using ClassStorageType = PolymorphicPropertyCache::ClassStorageType;
+
+/// Run \p source, which must produce an array of objects kept alive by a
+/// global, and \return the classes of those objects.
+std::vector<ClassStorageType> classesOf(Runtime *runtime, const char *source) {
+  hermes::hbc::CompileFlags flags;
+  CallResult<HermesValue> res =
+      runtime->run(source, "file:///fake.js", flags);
+  EXPECT_FALSE(isException(runtime, res));
+  std::vector<ClassStorageType> classes;
+  auto *arr = vmcast<JSArray>(*res);
+  for (JSArray::size_type i = 0, e = JSArray::getLength(arr); i < e; ++i) {
+    classes.push_back(vmcast<JSObject>(arr->at(runtime, i))
+                          ->getClassGCPtr()
+                          .getStorageType());
+  }
+  return classes;
+}
+
+TEST_F(PropertyCacheTest, PolymorphicStates) {
+  auto classes = classesOf(
+      runtime,
+      "var shapes = [{a: 1}, {b: 1, a: 1}, {c: 1, a: 1}, {d: 1, a: 1}, "
+      "{e: 1, a: 1}]; shapes;");
+  ASSERT_EQ(5u, classes.size());
+
+  PolymorphicPropertyCache cache{};
+  EXPECT_EQ(PropertyCacheState::Uninitialized, cache.getState());
+  EXPECT_EQ(nullptr, cache.find(classes[0]));
+
+  EXPECT_TRUE(cache.add(classes[0], 0));
+  EXPECT_EQ(PropertyCacheState::Monomorphic, cache.getState());
+  EXPECT_EQ(classes[0], cache.getFirstClass());
+
+  for (unsigned i = 1; i < PolymorphicPropertyCache::kNumEntries; ++i) {
+    EXPECT_TRUE(cache.add(classes[i], i));
+    EXPECT_EQ(PropertyCacheState::Polymorphic, cache.getState());
+  }
+  for (unsigned i = 0; i < PolymorphicPropertyCache::kNumEntries; ++i) {
+    auto *entry = cache.find(classes[i]);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(i, entry->slot);
+  }
+
+  // Re-adding a cached class only updates its slot.
+  EXPECT_TRUE(cache.add(classes[1], 7));
+  EXPECT_EQ(7u, cache.find(classes[1])->slot);
+  EXPECT_FALSE(cache.isMegamorphic());
+
+  // One class too many makes the site megamorphic, but keeps the entries.
+  EXPECT_FALSE(cache.add(classes[4], 4));
+  EXPECT_TRUE(cache.isMegamorphic());
+  EXPECT_EQ(PropertyCacheState::Megamorphic, cache.getState());
+  EXPECT_EQ(nullptr, cache.find(classes[4]));
+  EXPECT_NE(nullptr, cache.find(classes[0]));
+  EXPECT_FALSE(cache.add(classes[4], 4));
+}
+
+TEST_F(PropertyCacheTest, PolymorphicReusesClearedEntries) {
+  auto classes = classesOf(
+      runtime, "var shapes2 = [{a: 1}, {b: 1, a: 1}, {c: 1, a: 1}]; shapes2;");
+  ASSERT_EQ(3u, classes.size());
+
+  PolymorphicPropertyCache cache{};
+  EXPECT_TRUE(cache.add(classes[0], 0));
+  EXPECT_TRUE(cache.add(classes[1], 1));
+  // Clear the first entry, as the GC does when its class dies.
+  cache.entries()[0].clazz = ClassStorageType{};
+  EXPECT_EQ(PropertyCacheState::Monomorphic, cache.getState());
+  EXPECT_EQ(classes[1], cache.getFirstClass());
+  EXPECT_TRUE(cache.add(classes[2], 2));
+  EXPECT_EQ(&cache.entries()[0], cache.find(classes[2]));
+}
+
+TEST_F(PropertyCacheTest, Megamorphic) {
+  auto classes =
+      classesOf(runtime, "var shapes3 = [{a: 1}, {b: 1, a: 1}]; shapes3;");
+  ASSERT_EQ(2u, classes.size());
+  const SymbolID a = runtime->getIdentifierTable().registerLazyIdentifier(
+      createASCIIRef("a"));
+  const SymbolID b = runtime->getIdentifierTable().registerLazyIdentifier(
+      createASCIIRef("b"));
+
+  auto &cache = runtime->getMegamorphicPropertyCache();
+  cache.add(classes[0], a, 0, true);
+  cache.add(classes[1], b, 0, false);
+  cache.add(classes[1], a, 1, true);
+
+  auto *entry = cache.find(classes[0], a);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(0u, entry->slot);
+  EXPECT_TRUE(entry->writable);
+  EXPECT_EQ(nullptr, cache.find(classes[0], b));
+
+  entry = cache.find(classes[1], a);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(1u, entry->slot);
+}
+
+/// A site that sees more shapes than it can cache must still read and write
+/// the right slots.
+TEST_F(PropertyCacheTest, MegamorphicSiteCorrectness) {
+  hermes::hbc::CompileFlags flags;
+  CallResult<HermesValue> res = runtime->run(
+      "var objs = [];"
+      "for (var i = 0; i < 12; ++i) {"
+      "  var o = {};"
+      "  for (var j = 0; j < i; ++j) o['p' + j] = j;"
+      "  o.x = i;"
+      "  objs.push(o);"
+      "}"
+      "function get(o) { return o.x; }"
+      "function set(o, v) { o.x = v; }"
+      "var sum = 0;"
+      "for (var k = 0; k < 3; ++k) {"
+      "  for (var i = 0; i < objs.length; ++i) {"
+      "    set(objs[i], get(objs[i]) + 1);"
+      "  }"
+      "}"
+      "for (var i = 0; i < objs.length; ++i) sum += objs[i].x;"
+      "Object.freeze(objs[3]);"
+      "set(objs[3], 100);"
+      "sum + objs[3].x;",
+      "file:///fake.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  // Each x is i + 3: sum is 66 + 36, and the frozen object keeps 6.
+  EXPECT_EQ(108.0, res->getNumber());
+}
+
+TEST_F(PropertyCacheTest, ProtoChain) {
+  const SymbolID m = runtime->getIdentifierTable().registerLazyIdentifier(
+      createASCIIRef("m"));
+  const SymbolID missing =
+      runtime->getIdentifierTable().registerLazyIdentifier(
+          createASCIIRef("missing"));
+  hermes::hbc::CompileFlags flags;
+  CallResult<HermesValue> res = runtime->run(
+      "var base = Object.create(null);"
+      "base.m = 1;"
+      "var mid = Object.create(base);"
+      "mid.n = 2;"
+      "var top = Object.create(mid);"
+      "[top, base];",
+      "file:///fake.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  auto *arr = vmcast<JSArray>(*res);
+  auto *top = vmcast<JSObject>(arr->at(runtime, 0));
+  auto *base = vmcast<JSObject>(arr->at(runtime, 1));
+
+  ProtoChainPropertyCache cache{};
+  JSObject *holder = nullptr;
+  SlotIndex slot = 0;
+  EXPECT_FALSE(cache.find(runtime, top, m, holder, slot));
+
+  cache.add(runtime, top, m, base, 0);
+  ASSERT_TRUE(cache.find(runtime, top, m, holder, slot));
+  EXPECT_EQ(base, holder);
+  EXPECT_EQ(0u, slot);
+
+  cache.add(runtime, top, missing, nullptr, 0);
+  ASSERT_TRUE(cache.find(runtime, top, missing, holder, slot));
+  EXPECT_EQ(nullptr, holder);
+  // A lookup that starts further up the chain has an entry of its own.
+  EXPECT_FALSE(cache.find(runtime, base, missing, holder, slot));
+}
+
+/// Cached prototype lookups, found or not, must see changes to the chain.
+TEST_F(PropertyCacheTest, ProtoChainInvalidation) {
+  hermes::hbc::CompileFlags flags;
+  CallResult<HermesValue> res = runtime->run(
+      "var base = {m: 'base'};"
+      "var mid = Object.create(base);"
+      "var top = Object.create(mid);"
+      "var obj = Object.create(top);"
+      "function getM(o) { return o.m; }"
+      "function getMissing(o) { return o.missing; }"
+      "var out = [];"
+      "function record() {"
+      "  for (var i = 0; i < 3; ++i) {"
+      "    out.push(String(getM(obj)) + ':' + String(getMissing(obj)));"
+      "  }"
+      "}"
+      "record();"
+      "mid.m = 'mid';"
+      "record();"
+      "delete mid.m;"
+      "record();"
+      "Object.prototype.missing = 'found';"
+      "record();"
+      "delete Object.prototype.missing;"
+      "Object.setPrototypeOf(mid, {m: 'other'});"
+      "record();"
+      "Object.defineProperty(Object.getPrototypeOf(mid), 'm', "
+      "    {get: function() { return 'getter'; }});"
+      "record();"
+      "var expected = ['base:undefined', 'mid:undefined', 'base:undefined',"
+      "    'base:found', 'other:undefined', 'getter:undefined'];"
+      "var firstWrong = -1;"
+      "for (var i = 0; i < out.length && firstWrong < 0; ++i) {"
+      "  if (out[i] !== expected[Math.floor(i / 3)]) firstWrong = i;"
+      "}"
+      "firstWrong;",
+      "file:///fake.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  // The index of the first lookup that saw a stale result, if any.
+  EXPECT_EQ(-1.0, res->getNumber());
+}
+
+} // namespace
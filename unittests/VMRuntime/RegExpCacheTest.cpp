@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/RegExpCache.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+RegExpCache::Key key(const char16_t *pattern, uint8_t flags = 0) {
+  return RegExpCache::makeKey(
+      llvm::makeArrayRef(pattern, std::char_traits<char16_t>::length(pattern)),
+      flags);
+}
+
+TEST(RegExpCacheTest, KeysIncludeFlags) {
+  RegExpCache cache{4};
+  const uint8_t bytecode[] = {1, 2, 3};
+  cache.insert(key(u"ab"), bytecode);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(3u, cache.getBytecodeSize());
+  EXPECT_EQ(llvm::makeArrayRef(bytecode), cache.find(key(u"ab")));
+  EXPECT_TRUE(cache.find(key(u"ab", 1)).empty());
+  EXPECT_TRUE(cache.find(key(u"a")).empty());
+
+  // Inserting an existing key replaces its bytecode.
+  const uint8_t other[] = {4, 5};
+  cache.insert(key(u"ab"), other);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(2u, cache.getBytecodeSize());
+  EXPECT_EQ(llvm::makeArrayRef(other), cache.find(key(u"ab")));
+}
+
+TEST(RegExpCacheTest, EvictsLeastRecentlyUsed) {
+  RegExpCache cache{2};
+  EXPECT_TRUE(cache.isEnabled());
+  const uint8_t bytecode[] = {1};
+  cache.insert(key(u"a"), bytecode);
+  cache.insert(key(u"b"), bytecode);
+  // Replacing an entry doesn't evict another one.
+  const uint8_t bytecode2[] = {2, 3};
+  cache.insert(key(u"a"), bytecode2);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(3u, cache.getBytecodeSize());
+  // Using a makes b the least recently used.
+  EXPECT_FALSE(cache.find(key(u"a")).empty());
+  cache.insert(key(u"c"), bytecode);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_FALSE(cache.find(key(u"a")).empty());
+  EXPECT_TRUE(cache.find(key(u"b")).empty());
+  EXPECT_FALSE(cache.find(key(u"c")).empty());
+
+  cache.clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.getBytecodeSize());
+  EXPECT_TRUE(cache.find(key(u"a")).empty());
+}
+
+TEST(RegExpCacheTest, Disabled) {
+  RegExpCache cache{0};
+  EXPECT_FALSE(cache.isEnabled());
+  const uint8_t bytecode[] = {1};
+  cache.insert(key(u"a"), bytecode);
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_TRUE(cache.find(key(u"a")).empty());
+}
+
+} // namespace
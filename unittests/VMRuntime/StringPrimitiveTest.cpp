@@ -12,6 +12,7 @@
 
 #include "TestHelpers.h"
 
+#include <chrono>
 #include <climits>
 #include <random>
 
@@ -324,4 +325,156 @@ TEST_F(StringPrimTest, FastConcatTest) {
   EXPECT_TRUE(utf16Ref.size() == utfStr3.size());
   EXPECT_TRUE(std::equal(utfStr3.begin(), utfStr3.end(), utf16Ref.begin()));
 }
+
+TEST_F(StringPrimTest, RopeConcatTest) {
+  CallResult<HermesValue> cr{ExecutionStatus::EXCEPTION};
+  std::string bigStrA(300, 'a');
+  std::string bigStrB(300, 'b');
+
+  //=======================================
+  // Two large strings are joined without copying them.
+  auto a = StringPrimitive::createNoThrow(runtime, bigStrA);
+  auto b = StringPrimitive::createNoThrow(runtime, bigStrB);
+  cr = StringPrimitive::concat(runtime, a, b);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto rope = runtime->makeHandle<RopeASCIIStringPrimitive>(*cr);
+  EXPECT_FALSE(rope->isFlat());
+  EXPECT_EQ(1u, rope->getDepth());
+  EXPECT_EQ(600u, rope->getStringLength());
+
+  // Comparisons read the characters without flattening the rope.
+  std::string ab = bigStrA + bigStrB;
+  auto abStr = StringPrimitive::createNoThrow(runtime, ab);
+  EXPECT_TRUE(rope->equals(abStr.get()));
+  EXPECT_EQ(0, rope->compare(abStr.get()));
+  EXPECT_FALSE(rope->isFlat());
+  EXPECT_EQ(0u, rope->externalMemorySize());
+
+  // ensureFlat() gathers the characters and credits them to the GC.
+  StringPrimitive::ensureFlat(runtime, rope);
+  EXPECT_TRUE(rope->isFlat());
+  EXPECT_EQ(0u, rope->getDepth());
+  EXPECT_EQ(600u, rope->externalMemorySize());
+  auto asciiRef = rope->getStringRef<char>();
+  EXPECT_TRUE(std::equal(ab.begin(), ab.end(), asciiRef.begin()));
+
+  //=======================================
+  // Repeated prepends of a small string don't copy the growing string, and
+  // only deepen the rope once the small strings add up to a large one.
+  std::u16string strC(u"\u1234c");
+  auto c = StringPrimitive::createNoThrow(
+      runtime, UTF16Ref(strC.data(), strC.size()));
+  MutableHandle<StringPrimitive> str{runtime, a.get()};
+  const unsigned kPrepends = 10000;
+  for (unsigned i = 0; i < kPrepends; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    cr = StringPrimitive::concat(runtime, c, str);
+    ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+    str = vmcast<StringPrimitive>(*cr);
+  }
+  auto *prepended = vmcast<RopeUTF16StringPrimitive>(str.get());
+  EXPECT_FALSE(prepended->isFlat());
+  EXPECT_LE(
+      prepended->getDepth(),
+      kPrepends * strC.size() / StringPrimitive::CONCAT_STRING_MIN_SIZE + 1);
+
+  std::u16string expected;
+  for (unsigned i = 0; i < kPrepends; ++i)
+    expected += strC;
+  expected.append(bigStrA.begin(), bigStrA.end());
+  EXPECT_EQ(expected.size(), str->getStringLength());
+
+  //=======================================
+  // ensureFlat() gathers the characters of every nested rope.
+  StringPrimitive::ensureFlat(runtime, str);
+  EXPECT_TRUE(str->isFlat());
+  EXPECT_EQ(expected.size() * sizeof(char16_t), str->externalMemorySize());
+  auto utf16Ref = str->getStringRef<char16_t>();
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), utf16Ref.begin()));
+
+  //=======================================
+  // A flattened rope can be a child of another one.
+  cr = StringPrimitive::concat(runtime, str, b);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto rope2 = runtime->makeHandle<RopeUTF16StringPrimitive>(*cr);
+  EXPECT_EQ(1u, rope2->getDepth());
+  expected.append(bigStrB.begin(), bigStrB.end());
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, rope2)
+                  .equals(UTF16Ref(expected.data(), expected.size())));
+}
+
+using StringPrimLargeHeapTest = LargeHeapRuntimeTestFixture;
+
+TEST_F(StringPrimLargeHeapTest, RopeDepthTest) {
+  CallResult<HermesValue> cr{ExecutionStatus::EXCEPTION};
+  std::string bigStrB(300, 'b');
+  auto b = StringPrimitive::createNoThrow(runtime, bigStrB);
+
+  // Repeated prepends of a large string never nest deeper than the bound: the
+  // characters are copied to a flat string once it would be exceeded.
+  MutableHandle<StringPrimitive> deep{runtime, b.get()};
+  const unsigned kMaxDepth = RopeASCIIStringPrimitive::kMaxDepth;
+  for (unsigned i = 1; i < 2 * kMaxDepth; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    cr = StringPrimitive::concat(runtime, b, deep);
+    ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+    deep = vmcast<StringPrimitive>(*cr);
+    ASSERT_EQ(
+        i % (kMaxDepth + 1),
+        deep->isFlat() ? 0u
+                       : vmcast<RopeASCIIStringPrimitive>(*deep)->getDepth());
+  }
+  EXPECT_EQ(2 * kMaxDepth * bigStrB.size(), deep->getStringLength());
+  StringPrimitive::ensureFlat(runtime, deep);
+  auto asciiRef = deep->getStringRef<char>();
+  EXPECT_TRUE(std::all_of(
+      asciiRef.begin(), asciiRef.end(), [](char ch) { return ch == 'b'; }));
+}
+
+TEST_F(StringPrimLargeHeapTest, RopeConcatLinearTest) {
+  std::string bigStr(StringPrimitive::CONCAT_STRING_MIN_SIZE, 'a');
+  auto big = StringPrimitive::createNoThrow(runtime, bigStr);
+  auto small = StringPrimitive::createNoThrow(runtime, "s");
+
+  // \return the shortest time in seconds, out of a few runs, to concatenate
+  // \p piece \p count times to a large string, appending or prepending it,
+  // and to flatten the result.
+  auto timeConcats = [&](Handle<StringPrimitive> piece,
+                         unsigned count,
+                         bool prepend) {
+    double best = std::numeric_limits<double>::max();
+    for (unsigned run = 0; run < 3; ++run) {
+      GCScopeMarkerRAII marker{runtime};
+      auto start = std::chrono::steady_clock::now();
+      MutableHandle<StringPrimitive> str{runtime, big.get()};
+      for (unsigned i = 0; i < count; ++i) {
+        GCScopeMarkerRAII iterMarker{runtime};
+        auto cr = prepend ? StringPrimitive::concat(runtime, piece, str)
+                          : StringPrimitive::concat(runtime, str, piece);
+        str = vmcast<StringPrimitive>(runtime->ignoreAllocationFailure(cr));
+      }
+      StringPrimitive::ensureFlat(runtime, str);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  };
+
+  // Quadratic behavior would make four times as many concatenations take
+  // sixteen times as long. Allow for noise and caches, but not for that. The
+  // large appends outgrow the caches in both cases, so that they don't only
+  // slow down the longer run.
+  const unsigned kBigAppends = 8192;
+  EXPECT_LT(
+      timeConcats(big, 4 * kBigAppends, false),
+      10 * timeConcats(big, kBigAppends, false));
+  const unsigned kSmallConcats = 16384;
+  EXPECT_LT(
+      timeConcats(small, 4 * kSmallConcats, false),
+      10 * timeConcats(small, kSmallConcats, false));
+  EXPECT_LT(
+      timeConcats(small, 4 * kSmallConcats, true),
+      10 * timeConcats(small, kSmallConcats, true));
+}
 } // namespace